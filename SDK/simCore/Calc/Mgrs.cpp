@@ -146,13 +146,14 @@ int Mgrs::breakMgrsString(const std::string& mgrs, int& zone, std::string& gzdLe
   else if ((position.size() & 1) == 0)
   {
     size_t numDigitsInPosition = position.size() / 2;
-    if (!isValidNumber(position.substr(0, numDigitsInPosition), easting, false))
+    const std::string_view positionView = position;
+    if (!isValidNumber(positionView.substr(0, numDigitsInPosition), easting, false))
     {
       if (err)
         *err = "Invalid MGRS string: Numeric easting location is not a valid number.";
       return 1;
     }
-    if (!isValidNumber(position.substr(numDigitsInPosition, std::string::npos), northing, false))
+    if (!isValidNumber(positionView.substr(numDigitsInPosition), northing, false))
     {
       if (err)
         *err = "Invalid MGRS string: Numeric northing location is not a valid number.";
@@ -20,6 +20,8 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include "simCore/Calc/Math.h"
 #include "simCore/EM/Constants.h"
 #include "simCore/EM/Decibel.h"
@@ -103,23 +105,122 @@ double getOneWayFreeSpaceRangeAndLoss(double xmtGaindB, double xmtFreqMhz, doubl
   return esmRngKm * 1000.0;
 }
 
-double lossToPpf(double slantRange, double freqMHz, double loss_dB)
+double lossToPpf(double slantRange, double freqMhz, double loss_dB)
 {
   if (!finite(loss_dB) || loss_dB <= simCore::SMALL_DB_VAL)
     return simCore::SMALL_DB_VAL;
-  if (slantRange <= 0.0 || freqMHz <= 0.0)
+  if (slantRange <= 0.0 || freqMhz <= 0.0)
   {
     assert(0); // Should not receive <=0
     return simCore::SMALL_DB_VAL;
   }
   // loss_db (power pattern path loss) and ppf_db (power pattern propagation factor) are related by:
   // loss_db = one way free space loss - ppf_db
+  const double ppf_dB = getOneWayFreeSpaceLoss(slantRange, freqMhz) - loss_dB;
+  return ppf_dB;
+}
+
+double getOneWayFreeSpaceLoss(double slantRange, double freqMhz)
+{
   // one way free space loss: 20 * log10(2 * k0 * R)
   // k0: vacuum wavenumber
-  const double vacuumWavenumber = (M_TWOPI * 1e6 * freqMHz) / simCore::LIGHT_SPEED_VACUUM;
-  const double fsLossDb = 20 * log10(2 * vacuumWavenumber * slantRange);
-  const double ppf_dB = fsLossDb - loss_dB;
-  return ppf_dB;
+  const double vacuumWavenumber = (M_TWOPI * 1e6 * freqMhz) / simCore::LIGHT_SPEED_VACUUM;
+  return 20 * log10(2 * vacuumWavenumber * slantRange);
+}
+
+namespace {
+
+/** Adds the optional per-point gains into the received power array */
+void addGains(size_t count, const double* xmtGaindB, const double* rcvGaindB, double* rcvdPowerdB)
+{
+  if (xmtGaindB)
+  {
+    for (size_t k = 0; k < count; ++k)
+      rcvdPowerdB[k] += xmtGaindB[k];
+  }
+  if (rcvGaindB)
+  {
+    for (size_t k = 0; k < count; ++k)
+      rcvdPowerdB[k] += rcvGaindB[k];
+  }
+}
+
+}
+
+void getRcvdPowerFreeSpace(size_t count, const double* rngMeters, const double* xmtGaindB, const double* rcvGaindB,
+  double freqMhz, double powerWatts, double rcsSqm, double systemLossdB, bool oneWay, double* rcvdPowerdB)
+{
+  if (count == 0)
+    return;
+  if (freqMhz == 0.0)
+  {
+    assert(0); // Must be non-zero to avoid divide by zero below
+    std::fill(rcvdPowerdB, rcvdPowerdB + count, 0.0);
+    return;
+  }
+
+  // Same equations as the scalar form, with the range dependence split out of the log:
+  //   linear2dB(numerator / R^n) = linear2dB(numerator) - 10 * n * log10(R)
+  const double lamdaSqrd = square(simCore::LIGHT_SPEED_AIR / (1e6 * freqMhz));
+  const double numerator = oneWay ? ((powerWatts * lamdaSqrd) / square(4. * M_PI)) : ((rcsSqm * powerWatts * lamdaSqrd) / simCore::RRE_CONSTANT);
+  if (numerator > 0.0)
+  {
+    const double constantdB = simCore::linear2dB(numerator) - systemLossdB;
+    const double rangeFactor = oneWay ? 20. : 40.;
+    for (size_t k = 0; k < count; ++k)
+      rcvdPowerdB[k] = constantdB - rangeFactor * log10(fabs(rngMeters[k]));
+  }
+  else
+  {
+    // linear2dB() floors the power term, independent of range
+    std::fill(rcvdPowerdB, rcvdPowerdB + count, simCore::linear2dB(0.0) - systemLossdB);
+  }
+  addGains(count, xmtGaindB, rcvGaindB, rcvdPowerdB);
+
+  // Match the scalar form's guard against zero range
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (rngMeters[k] == 0.0)
+      rcvdPowerdB[k] = 0.0;
+  }
+}
+
+void getRcvdPowerBlake(size_t count, const double* rngMeters, const double* ppfdB, const double* xmtGaindB, const double* rcvGaindB,
+  double freqMhz, double powerWatts, double rcsSqm, double systemLossdB, bool oneWay, double* rcvdPowerdB)
+{
+  getRcvdPowerFreeSpace(count, rngMeters, xmtGaindB, rcvGaindB, freqMhz, powerWatts, rcsSqm, systemLossdB, oneWay, rcvdPowerdB);
+  // Blake's equation 1.18: apply the propagation factor to the free space value
+  const double ppfFactor = oneWay ? 2. : 4.;
+  for (size_t k = 0; k < count; ++k)
+    rcvdPowerdB[k] += ppfFactor * ppfdB[k];
+}
+
+void getSignalToNoise(size_t count, const double* rcvdPowerdB, double noisePowerdB, double* snrdB)
+{
+  for (size_t k = 0; k < count; ++k)
+    snrdB[k] = (rcvdPowerdB[k] <= simCore::SMALL_DB_VAL) ? simCore::SMALL_DB_VAL : (rcvdPowerdB[k] - noisePowerdB);
+}
+
+void lossToPpf(size_t count, const double* slantRange, const double* loss_dB, double freqMhz, double* ppf_dB)
+{
+  if (count == 0)
+    return;
+  if (freqMhz <= 0.0)
+  {
+    assert(0); // Should not receive <=0
+    std::fill(ppf_dB, ppf_dB + count, simCore::SMALL_DB_VAL);
+    return;
+  }
+
+  // Free space loss at each range, less the path loss; invalid inputs are patched afterwards
+  const double lossScale = (2. * M_TWOPI * 1e6 * freqMhz) / simCore::LIGHT_SPEED_VACUUM;
+  for (size_t k = 0; k < count; ++k)
+    ppf_dB[k] = 20 * log10(lossScale * slantRange[k]) - loss_dB[k];
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (!std::isfinite(loss_dB[k]) || loss_dB[k] <= simCore::SMALL_DB_VAL || slantRange[k] <= 0.0)
+      ppf_dB[k] = simCore::SMALL_DB_VAL;
+  }
 }
 
 FrequencyBandUsEcm toUsEcm(double freqMhz)
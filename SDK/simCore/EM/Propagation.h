@@ -23,6 +23,7 @@
 #ifndef SIMCORE_EM_PROPAGATION_H
 #define SIMCORE_EM_PROPAGATION_H
 
+#include <cstddef>
 #include "simCore/Common/Common.h"
 
 namespace simCore
@@ -101,7 +102,69 @@ namespace simCore
   * @param loss_dB  power pattern path loss (dB)
   * @return power pattern propagation factor (dB)
   */
-  SDKCORE_EXPORT double lossToPpf(double slantRange, double freqMHz, double loss_dB);
+  SDKCORE_EXPORT double lossToPpf(double slantRange, double freqMhz, double loss_dB);
+
+  /**
+  * This function returns the one way free space path loss (dB), 20 * log10(4 * pi * R / lambda), using the vacuum wavelength
+  * @param slantRange  range to target (m), must be > 0
+  * @param freqMhz  Transmitter frequency (MHz), must be > 0
+  * @return one way free space path loss (dB)
+  */
+  SDKCORE_EXPORT double getOneWayFreeSpaceLoss(double slantRange, double freqMhz);
+
+  /**
+  * Array form of getRcvdPowerFreeSpace() for many points sharing one transmitter, e.g. every sample of an RF
+  * propagation profile.  Terms that do not vary per point are computed once, leaving a loop over the arrays
+  * that the compiler can vectorize.  Results match the scalar function to within floating point round-off.
+  * @param count Number of values in each array
+  * @param rngMeters Ranges from radar to target (m); zero ranges produce 0.0, matching the scalar function
+  * @param xmtGaindB Xmt antenna gains (dB); nullptr for 0 dB at every point
+  * @param rcvGaindB Rcv antenna gains (dB); nullptr for 0 dB at every point
+  * @param freqMhz Transmitter frequency (MHz), must be non-zero
+  * @param powerWatts Transmitter peak power (Watts)
+  * @param rcsSqm Target radar cross section (sqm), unused for one way power
+  * @param systemLossdB Total system loss (dB)
+  * @param oneWay calculates the one way power (dB) at an isotropic antenna
+  * @param rcvdPowerdB Output array of count free space received powers (dB)
+  */
+  SDKCORE_EXPORT void getRcvdPowerFreeSpace(size_t count, const double* rngMeters, const double* xmtGaindB, const double* rcvGaindB,
+    double freqMhz, double powerWatts, double rcsSqm, double systemLossdB, bool oneWay, double* rcvdPowerdB);
+
+  /**
+  * Array form of getRcvdPowerBlake(); see the array form of getRcvdPowerFreeSpace() for the shared parameters
+  * @param count Number of values in each array
+  * @param rngMeters Ranges from radar to target (m)
+  * @param ppfdB Pattern propagation factors (dB)
+  * @param xmtGaindB Xmt antenna gains (dB); nullptr for 0 dB at every point
+  * @param rcvGaindB Rcv antenna gains (dB); nullptr for 0 dB at every point
+  * @param freqMhz Transmitter frequency (MHz), must be non-zero
+  * @param powerWatts Transmitter peak power (Watts)
+  * @param rcsSqm Target radar cross section (sqm), unused for one way power
+  * @param systemLossdB Total system loss (dB)
+  * @param oneWay calculates the one way power (dB) at an isotropic antenna
+  * @param rcvdPowerdB Output array of count received powers (dB)
+  */
+  SDKCORE_EXPORT void getRcvdPowerBlake(size_t count, const double* rngMeters, const double* ppfdB, const double* xmtGaindB, const double* rcvGaindB,
+    double freqMhz, double powerWatts, double rcsSqm, double systemLossdB, bool oneWay, double* rcvdPowerdB);
+
+  /**
+  * Converts received powers to signal to noise ratios.  Powers at or below SMALL_DB_VAL remain SMALL_DB_VAL.
+  * @param count Number of values in each array
+  * @param rcvdPowerdB Received powers (dB)
+  * @param noisePowerdB Noise power (dB), as in RadarParameters::noisePowerdB
+  * @param snrdB Output array of count signal to noise ratios (dB); may be the same array as rcvdPowerdB
+  */
+  SDKCORE_EXPORT void getSignalToNoise(size_t count, const double* rcvdPowerdB, double noisePowerdB, double* snrdB);
+
+  /**
+  * Array form of lossToPpf() for many points at one frequency
+  * @param count Number of values in each array
+  * @param slantRange Ranges to target (m); ranges <= 0 produce SMALL_DB_VAL
+  * @param loss_dB Power pattern path losses (dB)
+  * @param freqMhz Transmitter frequency (MHz), must be > 0
+  * @param ppf_dB Output array of count power pattern propagation factors (dB)
+  */
+  SDKCORE_EXPORT void lossToPpf(size_t count, const double* slantRange, const double* loss_dB, double freqMhz, double* ppf_dB);
 
   /// As defined in https://en.wikipedia.org/wiki/Radio_spectrum
   enum FrequencyBandUsEcm
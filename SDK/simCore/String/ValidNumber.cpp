@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <charconv>
 #include <sstream>
 #include <string>
 #include <iostream>
@@ -84,212 +85,126 @@ bool stringIsTrueToken(const std::string& str)
     (simCore::caseCompare(str, "yes") == 0);
 }
 
-bool isValidNumber(const std::string& token, uint64_t& val, bool permitSign)
+namespace {
+
+/**
+ * Removes a leading '+' from the token if permitted.  Returns false if the token
+ * is invalid because of the plus sign.  std::from_chars does not accept '+', and
+ * would accept "+-1" once the '+' is removed, which strto*() never permitted.
+ */
+bool stripPlusToken(std::string_view& token, bool permitPlusToken)
 {
-  if (!stringIsIntegerNumber(token, true, false, permitSign))
-  {
-    val = 0;
+  if (token.empty() || token[0] != '+')
+    return true;
+  if (!permitPlusToken)
     return false;
-  }
+  token.remove_prefix(1);
+  return token.empty() || token[0] != '-';
+}
 
-  errno = 0;
-#ifdef WIN32
-  val = _strtoui64(token.c_str(), nullptr, 10);
-#else
-  val = strtoull(token.c_str(), nullptr, 10);
-#endif
-  if (errno != 0)
-  {
-    val = 0;
+/** Converts an integer token using std::from_chars, requiring the entire token be consumed */
+template <typename T>
+bool isValidIntegerT(std::string_view token, T& val, bool permitPlusToken)
+{
+  val = 0;
+  if (!stripPlusToken(token, permitPlusToken))
     return false;
-  }
+  const char* end = token.data() + token.size();
+  T parsed = 0;
+  const std::from_chars_result result = std::from_chars(token.data(), end, parsed, 10);
+  if (result.ec != std::errc() || result.ptr != end)
+    return false;
+  val = parsed;
   return true;
 }
 
-bool isValidNumber(const std::string& token, uint32_t& val, bool permitPlusToken)
+/** Converts a real number with std::strtod, requiring the entire token be consumed */
+bool strtodFullToken(const std::string& token, double& val)
 {
   const char* start = token.c_str();
   char* end;
-  errno = 0;
-  unsigned long longVal = strtoul(token.c_str(), &end, 10);
-
-  // Error conditions are: Failed to convert, failed to end on a nullptr, or having leading white space or leading minus sign
-  if ((errno != 0) || (end == start) || (*end != '\0') || isspace(*start) || (*start == '-'))
-  {
-    val = 0;
-    return false;
-  }
-
-  // If plus token is not permitted need to return error if there is one
-  if (!permitPlusToken && (*start == '+'))
-  {
-    val = 0;
-    return false;
-  }
-
-  if ((longVal >= std::numeric_limits<uint32_t>::min()) &&
-    (longVal <= std::numeric_limits<uint32_t>::max()))
-  {
-    val = static_cast<uint32_t>(longVal);
-    return true;
-  }
+  val = std::strtod(start, &end);
+  // Some versions of std::strtod process hex numbers which we don't want, so kick out if there is an x or X
+  return (end != start) && (*end == '\0') && !isspace(static_cast<unsigned char>(*start)) &&
+    token.find_first_of("xX") == std::string::npos;
+}
 
-  val = 0;
-  return false;
 }
 
-bool isValidNumber(const std::string& token, uint16_t& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, uint64_t& val, bool permitPlusToken)
 {
-  val = 0;
-  // For 8 bit values, use a 32 bit then bounds check
-  uint32_t val32;
-  if (!isValidNumber(token, val32, permitPlusToken))
-    return false;
-  // Bounds check
-  if (val32 < std::numeric_limits<uint16_t>::min() || val32 > std::numeric_limits<uint16_t>::max())
-    return false;
-  // Convert
-  val = static_cast<uint16_t>(val32);
-  return true;
+  return isValidIntegerT(token, val, permitPlusToken);
 }
 
-bool isValidNumber(const std::string& token, uint8_t& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, uint32_t& val, bool permitPlusToken)
 {
-  val = 0; // Default return value to return 0 for error case
-  // For 8 bit values, use a 32 bit then bounds check
-  uint32_t val32;
-  if (!isValidNumber(token, val32, permitPlusToken))
-    return false;
-  // Bounds check
-  if (val32 < std::numeric_limits<uint8_t>::min() || val32 > std::numeric_limits<uint8_t>::max())
-    return false;
-  // Convert
-  val = static_cast<uint8_t>(val32);
-  return true;
+  return isValidIntegerT(token, val, permitPlusToken);
 }
 
-bool isValidNumber(const std::string& token, int64_t& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, uint16_t& val, bool permitPlusToken)
 {
-  if (!stringIsIntegerNumber(token, false, false, permitPlusToken))
-  {
-    val = 0;
-    return false;
-  }
-  errno = 0;
-#ifdef WIN32
-  val = _atoi64(token.c_str());
-#else
-  val = strtoll(token.c_str(), nullptr, 10);
-#endif
-  if (errno != 0)
-  {
-    val = 0;
-    return false;
-  }
-  return true;
+  return isValidIntegerT(token, val, permitPlusToken);
 }
 
-bool isValidNumber(const std::string& token, int32_t& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, uint8_t& val, bool permitPlusToken)
 {
-  const char* start = token.c_str();
-  char* end;
-  errno = 0;
-  long longVal = strtol(token.c_str(), &end, 10);
-
-  // Error conditions are: Failed to convert, failed to end on a nullptr, or having leading white space
-  if ((errno != 0) || (end == start) || (*end != '\0') || isspace(*start))
-  {
-    val = 0;
-    return false;
-  }
-
-  // If plus token is not permitted need to return error if there is one
-  if (!permitPlusToken && (*start == '+'))
-  {
-    val = 0;
-    return false;
-  }
+  return isValidIntegerT(token, val, permitPlusToken);
+}
 
-  if ((longVal >= std::numeric_limits<int32_t>::min()) &&
-      (longVal <= std::numeric_limits<int32_t>::max()))
-  {
-    val = static_cast<int32_t>(longVal);
-    return true;
-  }
+bool isValidNumber(std::string_view token, int64_t& val, bool permitPlusToken)
+{
+  return isValidIntegerT(token, val, permitPlusToken);
+}
 
-  val = 0;
-  return false;
+bool isValidNumber(std::string_view token, int32_t& val, bool permitPlusToken)
+{
+  return isValidIntegerT(token, val, permitPlusToken);
 }
 
-bool isValidNumber(const std::string& token, int16_t& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, int16_t& val, bool permitPlusToken)
 {
-  val = 0;
-  int32_t val32;
-  if (!isValidNumber(token, val32, permitPlusToken))
-    return false;
-  // Bounds check
-  if (val32 < std::numeric_limits<int16_t>::min() || val32 > std::numeric_limits<int16_t>::max())
-    return false;
-  // Convert
-  val = static_cast<int16_t>(val32);
-  return true;
+  return isValidIntegerT(token, val, permitPlusToken);
 }
 
-bool isValidNumber(const std::string& token, int8_t& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, int8_t& val, bool permitPlusToken)
 {
-  val = 0; // Default return value to return 0 for error case
-  // For 8 bit values, use a 16 bit then bounds check
-  int32_t val32;
-  if (!isValidNumber(token, val32, permitPlusToken))
-    return false;
-  // Bounds check
-  if (val32 < std::numeric_limits<int8_t>::min() || val32 > std::numeric_limits<int8_t>::max())
-    return false;
-  // Convert
-  val = static_cast<int8_t>(val32);
-  return true;
+  return isValidIntegerT(token, val, permitPlusToken);
 }
 
-bool isValidNumber(const std::string& token, double& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, double& val, bool permitPlusToken)
 {
   // This routine does not allow leading or trailing whitespace
-
-  const char* start = token.c_str();
-  char* end;
-  val = std::strtod(start, &end);
-
-  // Error conditions are: Failed to convert, failed to end on a nullptr, or having leading white space
-  if ((end == start) || (*end != '\0') || (isspace(*start)))
-  {
-    val = 0.0;
+  val = 0.0;
+  if (!stripPlusToken(token, permitPlusToken))
     return false;
-  }
 
-  // Must be finite
-  if (!finite(val))
-  {
-    val = 0.0;
+  double parsed = 0.0;
+#ifdef __cpp_lib_to_chars
+  const char* end = token.data() + token.size();
+  const std::from_chars_result result = std::from_chars(token.data(), end, parsed);
+  if (result.ptr != end)
     return false;
-  }
-
-  // Some versions of std::strtod process hex numbers which we don't want, so kick out if there is an x or X
-  if (token.find_first_of("xX") != std::string::npos)
+  // Underflow is accepted by std::strtod (and was by this routine); let it decide on range errors
+  if (result.ec == std::errc::result_out_of_range)
   {
-    val = 0.0;
-    return false;
+    if (!strtodFullToken(std::string(token), parsed))
+      return false;
   }
-
-  // If plus token is not permitted need to return error if there is one
-  if (!permitPlusToken && (*start == '+'))
-  {
-    val = 0.0;
+  else if (result.ec != std::errc())
     return false;
-  }
+#else
+  if (!strtodFullToken(std::string(token), parsed))
+    return false;
+#endif
 
+  // Must be finite
+  if (!std::isfinite(parsed))
+    return false;
+  val = parsed;
   return true;
 }
 
-bool isValidNumber(const std::string& token, float& val, bool permitPlusToken)
+bool isValidNumber(std::string_view token, float& val, bool permitPlusToken)
 {
   val = 0.f;
   double dVal;
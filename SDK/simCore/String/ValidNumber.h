@@ -24,6 +24,7 @@
 #define SIMCORE_STRING_VALIDNUMBER_H
 
 #include <string>
+#include <string_view>
 #include "simCore/Common/Common.h"
 
 namespace simCore
@@ -63,21 +64,23 @@ namespace simCore
   /**
    * Determines if the incoming string is a valid number and then performs the conversion.
    * Hexadecimal values will fail, as will values outside the bounds of the data type.
+   * Conversion uses std::from_chars and is locale independent; the token is not required
+   * to be null terminated, so substrings may be passed directly as a std::string_view.
    * @param[in ] token String to validate
    * @param[out] val Converted number, set to 0 if conversion fails
    * @param[in ] permitPlusToken Permits positive '+' signs on the string; if false, having '+' is an error
    * @return true if valid, false if not
    */
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, uint64_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, uint32_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, uint16_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, uint8_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, int64_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, int32_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, int16_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, int8_t& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, double& val, bool permitPlusToken=true);
-  SDKCORE_EXPORT bool isValidNumber(const std::string& token, float& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, uint64_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, uint32_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, uint16_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, uint8_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, int64_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, int32_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, int16_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, int8_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, double& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(std::string_view token, float& val, bool permitPlusToken=true);
   ///@}
 
   ///@{
@@ -39,6 +39,45 @@
 namespace simCore
 {
 
+namespace
+{
+
+/** Performs the same test as SecondsTimeFormatter::isStrictSecondsString(), returning the parsed value */
+bool parseStrictSeconds(const std::string& timeString, double& seconds)
+{
+  return (isValidNumber(timeString, seconds, false) && seconds >= 0 && seconds < SECPERMIN && timeString[0] != '.');
+}
+
+/** Performs the same test as HoursTimeFormatter::isStrictHoursString(), returning the value that HoursTimeFormatter::fromString() would */
+bool parseStrictHours(const std::string& timeString, simCore::Seconds& seconds)
+{
+  std::vector<std::string> hhmmss;
+  simCore::stringTokenizer(hhmmss, simCore::StringUtils::trim(simCore::removeQuotes(timeString)), ":", false, false);
+  int hours = 0;
+  int minutes = 0;
+  double sec = 0.;
+  if (hhmmss.size() != 3 ||
+    !isValidNumber(hhmmss[0], hours, false) ||
+    hours < 0 || hours >= HOURPERDAY ||
+    !isValidNumber(hhmmss[1], minutes, false) ||
+    minutes < 0 || minutes >= MINPERHOUR ||
+    !parseStrictSeconds(hhmmss[2], sec))
+    return false;
+  seconds = hours * SECPERHOUR + minutes * MINPERHOUR + sec;
+  return true;
+}
+
+}
+
+int TimeFormatter::tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const
+{
+  if (!canConvert(timeString))
+    return -1;
+  return fromString(timeString, timeStamp, referenceYear);
+}
+
+///////////////////////////////////////////////////////////////////////
+
 std::string NullTimeFormatter::toString(const simCore::TimeStamp& timeStamp, int referenceYear, unsigned short precision) const
 {
   std::stringstream ss;
@@ -85,6 +124,15 @@ int SecondsTimeFormatter::fromString(const std::string& timeString, simCore::Tim
   return 1;
 }
 
+int SecondsTimeFormatter::tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const
+{
+  double tmpVal;
+  if (!simCore::isValidNumber(simCore::StringUtils::trim(simCore::removeQuotes(timeString)), tmpVal))
+    return -1;
+  timeStamp = simCore::TimeStamp(referenceYear, tmpVal);
+  return 0;
+}
+
 void SecondsTimeFormatter::toStream(std::ostream& os, const simCore::Seconds& seconds, unsigned short precision)
 {
   os.precision(precision);
@@ -96,7 +144,7 @@ void SecondsTimeFormatter::toStream(std::ostream& os, const simCore::Seconds& se
 bool SecondsTimeFormatter::isStrictSecondsString(const std::string& timeString)
 {
   double seconds = 0;
-  return (isValidNumber(timeString, seconds, false) && seconds >= 0 && seconds < SECPERMIN && timeString[0] != '.');
+  return parseStrictSeconds(timeString, seconds);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -137,6 +185,18 @@ int MinutesTimeFormatter::fromString(const std::string& timeString, simCore::Tim
   return 1;
 }
 
+int MinutesTimeFormatter::tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const
+{
+  std::vector<std::string> mmss;
+  simCore::stringTokenizer(mmss, simCore::StringUtils::trim(simCore::removeQuotes(timeString)), ":", false, false);
+  int min;
+  double sec;
+  if (mmss.size() != 2 || !parseStrictSeconds(mmss[1], sec) || !isValidNumber(mmss[0], min))
+    return -1;
+  timeStamp = simCore::TimeStamp(referenceYear, min * SECPERMIN + sec);
+  return 0;
+}
+
 void MinutesTimeFormatter::toStream(std::ostream& os, simCore::Seconds seconds, unsigned short precision)
 {
   const bool isNegative = (seconds < 0);
@@ -235,6 +295,24 @@ int HoursTimeFormatter::fromString(const std::string& timeString, simCore::Secon
   return 1;
 }
 
+int HoursTimeFormatter::tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const
+{
+  std::vector<std::string> hhmmss;
+  simCore::stringTokenizer(hhmmss, simCore::StringUtils::trim(simCore::removeQuotes(timeString)), ":", false, false);
+  int hours = 0;
+  int minutes = 0;
+  double sec = 0.;
+  if (hhmmss.size() != 3 ||
+    !isValidNumber(hhmmss[0], hours) ||
+    !isValidNumber(hhmmss[1], minutes, false) ||
+    minutes < 0 || minutes >= MINPERHOUR ||
+    !parseStrictSeconds(hhmmss[2], sec))
+    return -1;
+  const simCore::Seconds seconds = hours * SECPERHOUR + minutes * MINPERHOUR + sec;
+  timeStamp = simCore::TimeStamp(referenceYear, seconds);
+  return 0;
+}
+
 void HoursTimeFormatter::toStream(std::ostream& os, simCore::Seconds seconds, unsigned short precision)
 {
   toStream(os, seconds, precision, false);
@@ -349,6 +427,30 @@ int OrdinalTimeFormatter::fromString(const std::string& timeString, simCore::Tim
   return 1;
 }
 
+int OrdinalTimeFormatter::tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const
+{
+  const std::string& cleanString = simCore::StringUtils::trim(simCore::removeQuotes(timeString));
+  if (cleanString.empty())
+    return -1;
+  std::vector<std::string> dayYearHours;
+  simCore::stringTokenizer(dayYearHours, cleanString, " ", false, true);
+  if (dayYearHours.size() != 3 || dayYearHours[0].size() > 3 || dayYearHours[1].size() != 4)
+    return -1;
+
+  int year;
+  if (!simCore::isValidNumber(dayYearHours[1], year, false) || year < 1900 || year > 9999)
+    return -1;
+  int day;
+  if (!OrdinalTimeFormatter::isValidOrdinal(dayYearHours[0], year, day))
+    return -1;
+  // Validate and convert the hours portion in the same pass
+  simCore::Seconds seconds;
+  if (!parseStrictHours(dayYearHours[2], seconds))
+    return -1;
+  timeStamp = simCore::TimeStamp(year, seconds + simCore::Seconds((day - 1) * SECPERDAY, 0));
+  return 0;
+}
+
 void OrdinalTimeFormatter::toStream(std::ostream& os, const simCore::TimeStamp& timeStamp, unsigned short precision)
 {
   const int refYear = timeStamp.referenceYear();
@@ -583,7 +685,7 @@ bool DtgTimeFormatter::canConvert(const std::string& timeString) const
   if (month == -1)
     return false;
   int year; // Need to decode the year in order to validate month-day
-  if (!isValidNumber(monthYearString.substr(3), year, false))
+  if (!isValidNumber(std::string_view(monthYearString).substr(3), year, false))
     return false;
   year += (year >= 70) ? 1900 : 2000; // Valid from 1970 to 2069
 
@@ -594,12 +696,13 @@ bool DtgTimeFormatter::canConvert(const std::string& timeString) const
     int dayOfMonth = 0;
     int hours = 0;
     int minutes = 0;
+    const std::string_view timesView = times;
     return SecondsTimeFormatter::isStrictSecondsString(times.substr(7)) &&
-      isValidNumber(times.substr(0, 2), dayOfMonth, false) &&
+      isValidNumber(timesView.substr(0, 2), dayOfMonth, false) &&
       dayOfMonth >= 1 && dayOfMonth <= simCore::daysPerMonth(year - 1900, month) &&
-      isValidNumber(times.substr(2, 2), hours, false) &&
+      isValidNumber(timesView.substr(2, 2), hours, false) &&
       hours >= 0 && hours < HOURPERDAY &&
-      isValidNumber(times.substr(4, 2), minutes, false) &&
+      isValidNumber(timesView.substr(4, 2), minutes, false) &&
       minutes >= 0 && minutes < MINPERHOUR;
   }
   catch (const simCore::TimeException&)
@@ -627,8 +730,8 @@ int DtgTimeFormatter::fromString(const std::string& timeString, simCore::TimeSta
   int hours;
   int minutes;
   double seconds;
-  const std::string& times = timesZoneMonth[0];
-  if (isValidNumber(timesZoneMonth[2].substr(3), year) &&
+  const std::string_view times = timesZoneMonth[0];
+  if (isValidNumber(std::string_view(timesZoneMonth[2]).substr(3), year) &&
     isValidNumber(times.substr(0, 2), monthDay) &&
     isValidNumber(times.substr(2, 2), hours) &&
     isValidNumber(times.substr(4, 2), minutes) &&
@@ -783,7 +886,7 @@ struct Iso8601Components
     }
 
     // Check for YYYY format.  Note, we do not support negative years
-    const std::string& dateString = daytime[0];
+    const std::string_view dateString = daytime[0];
     if (dateString.size() == 4 && isValidNumber(dateString, year))
     {
       // Cannot have a time, if given just a year.  We also limit the years between certain values.
@@ -864,17 +967,18 @@ struct Iso8601Components
     if (timeZone[0] != '+' && timeZone[0] != '-')
       return 0;
     // Can be in HH, HH:MM, or HHMM format
-    if (timeZone.size() == 3 && simCore::isValidNumber(timeZone.substr(1), tzHour))
+    const std::string_view zone = timeZone;
+    if (zone.size() == 3 && simCore::isValidNumber(zone.substr(1), tzHour))
     {
       if (tzHour > 24)
         return 0;
     }
-    if (timeZone.size() == 5 && simCore::isValidNumber(timeZone.substr(1, 2), tzHour) && simCore::isValidNumber(timeZone.substr(3), tzMin))
+    if (zone.size() == 5 && simCore::isValidNumber(zone.substr(1, 2), tzHour) && simCore::isValidNumber(zone.substr(3), tzMin))
     {
       if (tzHour > 24 || tzMin > 60)
         return 0;
     }
-    if (timeZone.size() == 6 && simCore::isValidNumber(timeZone.substr(1, 2), tzHour) && simCore::isValidNumber(timeZone.substr(4), tzMin))
+    if (zone.size() == 6 && simCore::isValidNumber(zone.substr(1, 2), tzHour) && simCore::isValidNumber(zone.substr(4), tzMin))
     {
       if (tzHour > 24 || tzMin > 60)
         return 0;
@@ -922,11 +1026,12 @@ private:
     if (timeZone[0] != '+' && timeZone[0] != '-')
       return false;
     // Can be in HH, HH:MM, or HHMM format
-    if (timeZone.size() == 3 && simCore::isValidNumber(timeZone.substr(1), tzHour))
+    const std::string_view zone = timeZone;
+    if (zone.size() == 3 && simCore::isValidNumber(zone.substr(1), tzHour))
       return tzHour <= 24;
-    if (timeZone.size() == 5 && simCore::isValidNumber(timeZone.substr(1, 2), tzHour) && simCore::isValidNumber(timeZone.substr(3), tzMin))
+    if (zone.size() == 5 && simCore::isValidNumber(zone.substr(1, 2), tzHour) && simCore::isValidNumber(zone.substr(3), tzMin))
       return tzHour <= 24 && tzMin <= 60;
-    if (timeZone.size() == 6 && simCore::isValidNumber(timeZone.substr(1, 2), tzHour) && simCore::isValidNumber(timeZone.substr(4), tzMin))
+    if (zone.size() == 6 && simCore::isValidNumber(zone.substr(1, 2), tzHour) && simCore::isValidNumber(zone.substr(4), tzMin))
       return tzHour <= 24 && tzMin <= 60;
     return false;
   }
@@ -942,7 +1047,7 @@ private:
     const size_t zoneStart = timeString.find_first_not_of(":1234567890.");
     if (zoneStart != std::string::npos && zoneStart < 6)
       return 1;
-    const std::string& timePart = timeString.substr(0, zoneStart);
+    const std::string_view timePart = std::string_view(timeString).substr(0, zoneStart);
     // Time part cannot end in a decimal, even if that is a valid double value
     if (timePart[timePart.size() - 1] == '.')
       return 1;
@@ -984,6 +1089,15 @@ int Iso8601TimeFormatter::fromString(const std::string& timeString, simCore::Tim
   return comps.valid ? 0 : 1;
 }
 
+int Iso8601TimeFormatter::tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const
+{
+  Iso8601Components comps(timeString);
+  if (!comps.valid)
+    return -1;
+  timeStamp = comps.toStamp();
+  return 0;
+}
+
 ///////////////////////////////////////////////////////////////////////
 
 TimeFormatterRegistry::TimeFormatterRegistry(bool wrappedFormatters, bool addDefaults)
@@ -1075,8 +1189,68 @@ std::string TimeFormatterRegistry::toString(simCore::TimeFormat format, const si
 
 int TimeFormatterRegistry::fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const
 {
-  const TimeFormatter& parser = formatter(timeString);
-  return parser.fromString(timeString, timeStamp, referenceYear);
+  TimeFormatterPtr lastFormatter = lastUsedFormatter_;
+  const int rv = fromString_(timeString, timeStamp, referenceYear, lastFormatter);
+  lastUsedFormatter_ = lastFormatter;
+  return rv;
+}
+
+size_t TimeFormatterRegistry::fromStrings(const std::vector<std::string>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear, std::vector<int>* errors) const
+{
+  timeStamps.resize(timeStrings.size());
+  if (errors)
+    errors->resize(timeStrings.size());
+
+  // Lock onto the detected format locally, publishing it back to the cache once at the end
+  TimeFormatterPtr lastFormatter = lastUsedFormatter_;
+  size_t numFailures = 0;
+  for (size_t k = 0; k < timeStrings.size(); ++k)
+  {
+    const int rv = fromString_(timeStrings[k], timeStamps[k], referenceYear, lastFormatter);
+    if (rv != 0)
+      ++numFailures;
+    if (errors)
+      (*errors)[k] = rv;
+  }
+  lastUsedFormatter_ = lastFormatter;
+  return numFailures;
+}
+
+int TimeFormatterRegistry::fromString_(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear, TimeFormatterPtr& lastFormatter) const
+{
+  // Examine the locked-in formatter first; most time columns use a single format
+  int rv = lastFormatter->tryFromString(timeString, timeStamp, referenceYear);
+  if (rv >= 0)
+    return rv;
+
+  // Look through foreign formatters first
+  for (std::vector<TimeFormatterPtr>::const_iterator i = foreignFormatters_.begin(); i != foreignFormatters_.end(); ++i)
+  {
+    // Don't double-check the last-used formatter
+    if (*i == lastFormatter)
+      continue;
+    rv = (*i)->tryFromString(timeString, timeStamp, referenceYear);
+    if (rv >= 0)
+    {
+      lastFormatter = *i;
+      return rv;
+    }
+  }
+
+  // Check our well-known formatters
+  for (std::map<int, TimeFormatterPtr>::const_iterator i = knownFormatters_.begin(); i != knownFormatters_.end(); ++i)
+  {
+    if (i->second == lastFormatter)
+      continue;
+    rv = i->second->tryFromString(timeString, timeStamp, referenceYear);
+    if (rv >= 0)
+    {
+      lastFormatter = i->second;
+      return rv;
+    }
+  }
+  lastFormatter = nullFormatter_;
+  return nullFormatter_->fromString(timeString, timeStamp, referenceYear);
 }
 
 }
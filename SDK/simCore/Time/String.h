@@ -85,6 +85,18 @@ public:
    *   on error, and timeStamp will be set to simCore::TimeStamp(1970, 0).
    */
   virtual int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const = 0;
+
+  /**
+   * Combines canConvert() and fromString() into a single call, so that formatters can validate and
+   * convert the time string in one scan instead of parsing it twice.  The default implementation
+   * calls canConvert() and then fromString().
+   * @param timeString Time string to check and convert
+   * @param timeStamp Value to fill with the interpreted time.  Left unchanged if canConvert() would
+   *   return false for the time string.
+   * @param referenceYear Reference year epoch for time formats that require a reference year.
+   * @return -1 if canConvert() would return false; otherwise the return value of fromString().
+   */
+  virtual int tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 };
 
 /** Null object pattern formatter. */
@@ -103,6 +115,7 @@ public:
   virtual std::string toString(const simCore::TimeStamp& timeStamp, int referenceYear, unsigned short precision=5) const;
   virtual bool canConvert(const std::string& timeString) const;
   virtual int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
+  virtual int tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 
   /** Converts a Seconds value to a seconds string for an ostream. */
   static void toStream(std::ostream& os, const simCore::Seconds& seconds, unsigned short precision);
@@ -117,6 +130,7 @@ public:
   virtual std::string toString(const simCore::TimeStamp& timeStamp, int referenceYear, unsigned short precision=5) const;
   virtual bool canConvert(const std::string& timeString) const;
   virtual int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
+  virtual int tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 
   /** Converts a Seconds value to a minutes string for an ostream. */
   static void toStream(std::ostream& os, simCore::Seconds seconds, unsigned short precision);
@@ -140,6 +154,7 @@ public:
   virtual std::string toString(const simCore::TimeStamp& timeStamp, int referenceYear, unsigned short precision=5) const;
   virtual bool canConvert(const std::string& timeString) const;
   virtual int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
+  virtual int tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 
   /** Converts a Seconds value to an hours string for an ostream. */
   static void toStream(std::ostream& os, simCore::Seconds seconds, unsigned short precision);
@@ -170,6 +185,7 @@ public:
   virtual std::string toString(const simCore::TimeStamp& timeStamp, int referenceYear, unsigned short precision=5) const;
   virtual bool canConvert(const std::string& timeString) const;
   virtual int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
+  virtual int tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 
   /** Converts a Seconds value to an hours string for an ostream. */
   static void toStream(std::ostream& os, const simCore::TimeStamp& timeStamp, unsigned short precision);
@@ -286,6 +302,7 @@ public:
    *   on error, and timeStamp will be set to simCore::TimeStamp(1970, 0).
    */
   virtual int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
+  virtual int tryFromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 };
 
 
@@ -365,7 +382,27 @@ public:
    */
   int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 
+  /**
+   * Converts a column of time strings to time stamps.  Results are identical to calling fromString() on
+   * each string in turn, but the format detected for one string is locked in for the rest of the column,
+   * and the full formatter search is only repeated when a string does not match the locked format.
+   * @param timeStrings Time strings to convert
+   * @param timeStamps Resized to match timeStrings and filled with the interpreted times.  Strings that
+   *   fail to convert are set to simCore::TimeStamp(1970, 0).
+   * @param referenceYear Reference year epoch for time formats that require a reference year.
+   * @param errors If non-null, resized to match timeStrings and filled with the per-string return value
+   *   of the conversion, 0 on success and non-zero on error.
+   * @return Number of time strings that failed to convert; 0 when all conversions succeed.
+   */
+  size_t fromStrings(const std::vector<std::string>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear, std::vector<int>* errors=nullptr) const;
+
 private:
+  /**
+   * Single-pass detect and convert, starting with the formatter in lastFormatter and updating it to the
+   * formatter that matched.  Same formatter priority as formatter(const std::string&).
+   */
+  int fromString_(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear, TimeFormatterPtr& lastFormatter) const;
+
   /** Maps built-in formatters by simCore::TimeFormat enumeration */
   std::map<int, TimeFormatterPtr> knownFormatters_;
   /** Vector of all registered formatters from foreign sources */
@@ -61,7 +61,7 @@ void BeamMemoryCommandSlice::update(DataStore *ds, ObjectId id, double time)
   if ((!lastBeamCommand || time >= lastBeamCommand->time()) && (earliestInsert_ > lastUpdateTime_))
   {
     // time moved forward: execute all commands from lastUpdateTime_ to new current time
-    hasChanged_ = advance_(lastUpdateTime_, time);
+    hasChanged_ = advanceTo_(time);
 
     // Check for repeated scalars in the command, forcing complete replacement instead of add-value
     conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
@@ -80,8 +80,8 @@ void BeamMemoryCommandSlice::update(DataStore *ds, ObjectId id, double time)
     prefs->clear_targetid();
     prefs->mutable_commonprefs()->set_datadraw(false);
 
-    // advance time forward, execute all commands from 0.0 (use -1.0 since we need a time before 0.0) to new current time
-    advance_(-1.0, time);
+    // rebuild the command state from the start to new current time, seeking through the field history
+    replay_(time);
     conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
 
     hasChanged_ = true;
@@ -22,6 +22,7 @@
  */
 #include <algorithm>
 #include <cassert>
+#include <mutex>
 #include "simCore/String/Format.h"
 #include "simData/CategoryData/CategoryNameManager.h"
 
@@ -40,12 +41,14 @@ const int CategoryNameManager::UNLISTED_CATEGORY_VALUE = -3;
 //----------------------------------------------------------------------------
 CategoryNameManager::CategoryNameManager()
   : caseSensitive_(true),
-    nextInt_(1)
+    nextInt_(1),
+    firstInt_(1)
 {
 }
 
 int CategoryNameManager::setCaseSensitive(bool caseSensitive)
 {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   if (!map_.empty())
     return 1;
 
@@ -55,15 +58,23 @@ int CategoryNameManager::setCaseSensitive(bool caseSensitive)
 
 void CategoryNameManager::clear()
 {
-  map_.clear();
-  reverseMap_.clear();
-  categoryStringInts_.clear();
-  for (std::vector<ListenerPtr>::const_iterator i = listeners_.begin(); i != listeners_.end(); ++i)
+  std::vector<ListenerPtr> listeners;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    map_.clear();
+    reverseMap_.clear();
+    // IDs are not reused after a clear, so stale IDs held elsewhere will not resolve to new strings
+    firstInt_ = nextInt_;
+    categoryStringInts_.clear();
+    listeners = listeners_;
+  }
+
+  for (std::vector<ListenerPtr>::const_iterator i = listeners.begin(); i != listeners.end(); ++i)
   {
     (*i)->onClear();
   }
 
-  for (std::vector<ListenerPtr>::const_iterator i = listeners_.begin(); i != listeners_.end(); ++i)
+  for (std::vector<ListenerPtr>::const_iterator i = listeners.begin(); i != listeners.end(); ++i)
   {
     (*i)->doneClearing();
   }
@@ -81,7 +92,7 @@ std::string CategoryNameManager::fixString_(const std::string &str) const
 int CategoryNameManager::getOrCreateStringId_(const std::string &str)
 {
   std::string key = fixString_(str);
-  std::map<std::string, int>::const_iterator i = map_.find(key);
+  std::unordered_map<std::string, int>::const_iterator i = map_.find(key);
 
   if (i != map_.end())
     return i->second;
@@ -90,27 +101,52 @@ int CategoryNameManager::getOrCreateStringId_(const std::string &str)
   int id = nextInt_;
   ++nextInt_;
 
-  map_[key] = id;
-  reverseMap_[id] = str;  // Use str so the original case is maintained
+  map_.emplace(std::move(key), id);
+  // IDs are sequential, so the new string lands at index id - firstInt_
+  assert(static_cast<size_t>(id - firstInt_) == reverseMap_.size());
+  reverseMap_.push_back(str);  // Use str so the original case is maintained
 
   return id;
 }
 
+const std::string* CategoryNameManager::findString_(int id) const
+{
+  if (id < firstInt_)
+    return nullptr;
+  const size_t index = static_cast<size_t>(id - firstInt_);
+  if (index >= reverseMap_.size())
+    return nullptr;
+  return &reverseMap_[index];
+}
+
 /// add a new category
 ///@return new id that was assigned
 int CategoryNameManager::addCategoryName(const std::string &name)
 {
-  int catInt = getOrCreateStringId_(name);
+  // Existing categories only need a shared lock
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::unordered_map<std::string, int>::const_iterator i = map_.find(fixString_(name));
+    if (i != map_.end() && categoryStringInts_.find(i->second) != categoryStringInts_.end())
+      return i->second;
+  }
 
-  if (categoryStringInts_.find(catInt) == categoryStringInts_.end())
+  int catInt = NO_CATEGORY_NAME;
+  std::vector<ListenerPtr> listeners;
   {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    catInt = getOrCreateStringId_(name);
+    // Another writer may have added the category since the shared lock was released
+    if (categoryStringInts_.find(catInt) != categoryStringInts_.end())
+      return catInt;
     // add the key "catInt" to the map
     categoryStringInts_[catInt];
+    listeners = listeners_;
+  }
 
-    for (std::vector<ListenerPtr>::const_iterator i = listeners_.begin(); i != listeners_.end(); ++i)
-    {
-      (*i)->onAddCategory(catInt);
-    }
+  for (std::vector<ListenerPtr>::const_iterator i = listeners.begin(); i != listeners.end(); ++i)
+  {
+    (*i)->onAddCategory(catInt);
   }
 
   return catInt;
@@ -120,28 +156,35 @@ int CategoryNameManager::addCategoryName(const std::string &name)
 ///@return new id that was assigned
 int CategoryNameManager::addCategoryValue(int nameInt, const std::string &value)
 {
-  // 1. get an id for the value
-  int valueInt = getOrCreateStringId_(value);
+  // Values already in the category only need a shared lock
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    std::unordered_map<std::string, int>::const_iterator i = map_.find(fixString_(value));
+    if (i != map_.end())
+    {
+      std::map<int, CategoryValues>::const_iterator cat = categoryStringInts_.find(nameInt);
+      if (cat != categoryStringInts_.end() && cat->second.valueSet.count(i->second) != 0)
+        return i->second;
+    }
+  }
 
-  // 2. add the value to the category list
-  std::map<int, std::vector<int> >::iterator i = categoryStringInts_.find(nameInt);
-  if (i != categoryStringInts_.end())
+  int valueInt = NO_CATEGORY_VALUE;
+  std::vector<ListenerPtr> listeners;
   {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    // 1. get an id for the value
+    valueInt = getOrCreateStringId_(value);
+
+    // 2. add the value to the category list, creating the category entry if needed
+    CategoryValues& category = categoryStringInts_[nameInt];
     // check if the category already has the value
-    std::vector<int>& vecInt = i->second;
-    std::vector<int>::const_iterator valueIter = std::find(vecInt.begin(), vecInt.end(), valueInt);
-    if (valueIter != vecInt.end())
+    if (!category.valueSet.insert(valueInt).second)
       return valueInt; // it does, done
-
-    //else add it
-    vecInt.push_back(valueInt);
-  }
-  else // category has no values
-  {
-    categoryStringInts_[nameInt].push_back(valueInt);
+    category.values.push_back(valueInt);
+    listeners = listeners_;
   }
 
-  for (std::vector<ListenerPtr>::const_iterator i = listeners_.begin(); i != listeners_.end(); ++i)
+  for (std::vector<ListenerPtr>::const_iterator i = listeners.begin(); i != listeners.end(); ++i)
   {
     (*i)->onAddValue(nameInt, valueInt);
   }
@@ -151,7 +194,8 @@ int CategoryNameManager::addCategoryValue(int nameInt, const std::string &value)
 
 void CategoryNameManager::removeCategory(int nameInt)
 {
-  std::map<int, std::vector<int> >::iterator i = categoryStringInts_.find(nameInt);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::map<int, CategoryValues>::iterator i = categoryStringInts_.find(nameInt);
   if (i != categoryStringInts_.end())
     categoryStringInts_.erase(i);
 
@@ -160,20 +204,20 @@ void CategoryNameManager::removeCategory(int nameInt)
 
 void CategoryNameManager::removeValue(int nameInt, int valueInt)
 {
-  std::map<int, std::vector<int> >::iterator i = categoryStringInts_.find(nameInt);
-  if (i != categoryStringInts_.end())
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  std::map<int, CategoryValues>::iterator i = categoryStringInts_.find(nameInt);
+  if (i != categoryStringInts_.end() && i->second.valueSet.erase(valueInt) != 0)
   {
-    std::vector<int>& vecInt = i->second;
-    std::vector<int>::iterator j = std::find(vecInt.begin(), vecInt.end(), valueInt);
-    if (j != vecInt.end())
-      vecInt.erase(j);
+    std::vector<int>& vecInt = i->second.values;
+    vecInt.erase(std::find(vecInt.begin(), vecInt.end(), valueInt));
   }
 }
 
 // provide one mapping: string to int
 int CategoryNameManager::nameToInt(const std::string &name) const
 {
-  std::map<std::string, int>::const_iterator i = map_.find(fixString_(name));
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::unordered_map<std::string, int>::const_iterator i = map_.find(fixString_(name));
   if (i == map_.end())
     return CategoryNameManager::NO_CATEGORY_NAME; // category name not found
 
@@ -182,7 +226,8 @@ int CategoryNameManager::nameToInt(const std::string &name) const
 
 int CategoryNameManager::valueToInt(const std::string &value) const
 {
-  std::map<std::string, int>::const_iterator i = map_.find(fixString_(value));
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  std::unordered_map<std::string, int>::const_iterator i = map_.find(fixString_(value));
   if (i == map_.end())
     return CategoryNameManager::NO_CATEGORY_VALUE; // category value not found
 
@@ -192,22 +237,22 @@ int CategoryNameManager::valueToInt(const std::string &value) const
 // provide mapping: int to string
 std::string CategoryNameManager::nameIntToString(int nameInt) const
 {
-  std::map<int, std::string>::const_iterator i = reverseMap_.find(nameInt);
-  if (i == reverseMap_.end())
   {
-    if (nameInt == CategoryNameManager::NO_CATEGORY_VALUE)
-      return CategoryNameManager::NO_CATEGORY_VALUE_STR;
-    else if (nameInt == CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME)
-      return CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME_STR;
-    else if (nameInt == CategoryNameManager::NO_CATEGORY_NAME)
-      return CategoryNameManager::NO_CATEGORY_NAME_STR;
-    else if (nameInt == CategoryNameManager::UNLISTED_CATEGORY_VALUE)
-      return CategoryNameManager::UNLISTED_CATEGORY_VALUE_STR;
-    else
-      return ""; // not found
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    const std::string* str = findString_(nameInt);
+    if (str != nullptr)
+      return *str;
   }
 
-  return i->second;
+  if (nameInt == CategoryNameManager::NO_CATEGORY_VALUE)
+    return CategoryNameManager::NO_CATEGORY_VALUE_STR;
+  else if (nameInt == CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME)
+    return CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME_STR;
+  else if (nameInt == CategoryNameManager::NO_CATEGORY_NAME)
+    return CategoryNameManager::NO_CATEGORY_NAME_STR;
+  else if (nameInt == CategoryNameManager::UNLISTED_CATEGORY_VALUE)
+    return CategoryNameManager::UNLISTED_CATEGORY_VALUE_STR;
+  return ""; // not found
 }
 
 std::string CategoryNameManager::valueIntToString(int valueInt) const
@@ -218,20 +263,22 @@ std::string CategoryNameManager::valueIntToString(int valueInt) const
 // retrieve all the category names (as strings or ints)
 void CategoryNameManager::allCategoryNames(std::vector<std::string> &nameVec) const
 {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   // for each entry in the category string ints
-  for (std::map<int, std::vector<int> >::const_iterator i = categoryStringInts_.begin(); i != categoryStringInts_.end(); ++i)
+  for (std::map<int, CategoryValues>::const_iterator i = categoryStringInts_.begin(); i != categoryStringInts_.end(); ++i)
   {
     // add the name (which we get from the reverse map, using the category id)
-    std::map<int, std::string>::const_iterator j = reverseMap_.find(i->first);
-    if (j != reverseMap_.end())
-      nameVec.push_back(j->second);
+    const std::string* str = findString_(i->first);
+    if (str != nullptr)
+      nameVec.push_back(*str);
   }
 }
 
 void CategoryNameManager::allCategoryNameInts(std::vector<int> &nameIntVec) const
 {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   // for each entry in the category string ints
-  for (std::map<int, std::vector<int> >::const_iterator i = categoryStringInts_.begin(); i != categoryStringInts_.end(); ++i)
+  for (std::map<int, CategoryValues>::const_iterator i = categoryStringInts_.begin(); i != categoryStringInts_.end(); ++i)
   {
     // add the name id
     nameIntVec.push_back(i->first);
@@ -241,38 +288,34 @@ void CategoryNameManager::allCategoryNameInts(std::vector<int> &nameIntVec) cons
 // retrieve all the values in a given category
 void CategoryNameManager::allValuesInCategory(int categoryInt, std::vector<std::string> &categoryValueVec) const
 {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   // find category in the category string ints
-  std::map<int, std::vector<int> >::const_iterator i = categoryStringInts_.find(categoryInt);
+  std::map<int, CategoryValues>::const_iterator i = categoryStringInts_.find(categoryInt);
   if (i != categoryStringInts_.end())
   {
     //for each value in the category
-    for (std::vector<int>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
+    for (std::vector<int>::const_iterator j = i->second.values.begin(); j != i->second.values.end(); ++j)
     {
       // add the string value (which we get from the reverse map, using the value id)
-      std::map<int, std::string>::const_iterator k = reverseMap_.find(*j);
-      if (k != reverseMap_.end())
-        categoryValueVec.push_back(k->second);
+      const std::string* str = findString_(*j);
+      if (str != nullptr)
+        categoryValueVec.push_back(*str);
     }
   }
 }
 
 void CategoryNameManager::allValueIntsInCategory(int categoryInt, std::vector<int> &categoryValueIntVec) const
 {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   // find category in the category string ints
-  std::map<int, std::vector<int> >::const_iterator i = categoryStringInts_.find(categoryInt);
+  std::map<int, CategoryValues>::const_iterator i = categoryStringInts_.find(categoryInt);
   if (i != categoryStringInts_.end())
-  {
-    //for each value in the category
-    for (std::vector<int>::const_iterator j = i->second.begin(); j != i->second.end(); ++j)
-    {
-      // add the string value (which we get from the reverse map, using the value id)
-      categoryValueIntVec.push_back(*j);
-    }
-  }
+    categoryValueIntVec.insert(categoryValueIntVec.end(), i->second.values.begin(), i->second.values.end());
 }
 
 void CategoryNameManager::addListener(CategoryNameManager::ListenerPtr callback)
 {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   // don't add it twice
   assert(std::find(listeners_.begin(), listeners_.end(), callback) == listeners_.end());
   listeners_.push_back(callback);
@@ -280,6 +323,7 @@ void CategoryNameManager::addListener(CategoryNameManager::ListenerPtr callback)
 
 void CategoryNameManager::removeListener(CategoryNameManager::ListenerPtr callback)
 {
+  std::unique_lock<std::shared_mutex> lock(mutex_);
   // Removing something that does not exist
   assert(std::find(listeners_.begin(), listeners_.end(), callback) != listeners_.end());
   listeners_.erase(std::remove(listeners_.begin(), listeners_.end(), callback), listeners_.end());
@@ -287,6 +331,7 @@ void CategoryNameManager::removeListener(CategoryNameManager::ListenerPtr callba
 
 void CategoryNameManager::getListeners(std::vector<ListenerPtr>& listeners)
 {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
   listeners = listeners_;
 }
 
@@ -25,6 +25,9 @@
 
 #include <map>
 #include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include "simData/CategoryData/CategoryData.h"
 
@@ -34,6 +37,10 @@ namespace simData {
  *
  * There should be one category manager, which is used by the other category
  * data elements to convert between int and string
+ *
+ * Lookups are safe to call from reader threads while another thread adds names and
+ * values.  Listeners are notified after the internal lock is released, so they may
+ * query the manager from their callbacks.
  */
 class SDKDATA_EXPORT CategoryNameManager
 {
@@ -135,19 +142,33 @@ private:
   /// Return the string if caseSensitive_ is true or return an upper case version of the string if caseSensitive_ is false
   std::string fixString_(const std::string &str) const;
 
-  /// Get or create an ID for the given string
+  /// Get or create an ID for the given string; requires a unique lock on mutex_
   int getOrCreateStringId_(const std::string &str);
+  /// Returns the original string for the ID, or nullptr if not found; requires a lock on mutex_
+  const std::string* findString_(int id) const;
+
+  /// All the values for a given category name, in the order added
+  struct CategoryValues
+  {
+    std::vector<int> values;
+    std::unordered_set<int> valueSet;
+  };
 
   bool caseSensitive_;
   int nextInt_;
+  /// ID of reverseMap_[0]; IDs are handed out sequentially, so reverse lookup is an index
+  int firstInt_;
 
   /// all the values for a given category name
-  std::map<int, std::vector<int> > categoryStringInts_;
+  std::map<int, CategoryValues> categoryStringInts_;
 
-  std::map<std::string, int> map_;
-  std::map<int, std::string> reverseMap_;
+  std::unordered_map<std::string, int> map_;
+  std::vector<std::string> reverseMap_;
 
   std::vector<ListenerPtr> listeners_;
+
+  /// Protects all of the above; readers share, writers are exclusive
+  mutable std::shared_mutex mutex_;
 };
 }
 
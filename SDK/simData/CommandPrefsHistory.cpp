@@ -0,0 +1,372 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include "google/protobuf/descriptor.h"
+#include "google/protobuf/message.h"
+#include "simData/CommandPrefsHistory.h"
+
+namespace simData
+{
+
+namespace
+{
+
+template <typename T>
+uint64_t toBits(T value)
+{
+  uint64_t bits = 0;
+  static_assert(sizeof(T) <= sizeof(bits), "Value must fit in 64 bits");
+  std::memcpy(&bits, &value, sizeof(T));
+  return bits;
+}
+
+template <typename T>
+T fromBits(uint64_t bits)
+{
+  T value;
+  std::memcpy(&value, &bits, sizeof(T));
+  return value;
+}
+
+/** Encodes a single (possibly repeated) scalar value; strings are not handled here */
+uint64_t encodeScalar(const google::protobuf::Message& message, const google::protobuf::FieldDescriptor& field, int index)
+{
+  const google::protobuf::Reflection& refl = *message.GetReflection();
+  const bool repeated = field.is_repeated();
+  switch (field.cpp_type())
+  {
+  case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+    return toBits(repeated ? refl.GetRepeatedInt32(message, &field, index) : refl.GetInt32(message, &field));
+  case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+    return toBits(repeated ? refl.GetRepeatedInt64(message, &field, index) : refl.GetInt64(message, &field));
+  case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+    return toBits(repeated ? refl.GetRepeatedUInt32(message, &field, index) : refl.GetUInt32(message, &field));
+  case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+    return repeated ? refl.GetRepeatedUInt64(message, &field, index) : refl.GetUInt64(message, &field);
+  case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+    return toBits(repeated ? refl.GetRepeatedDouble(message, &field, index) : refl.GetDouble(message, &field));
+  case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+    return toBits(repeated ? refl.GetRepeatedFloat(message, &field, index) : refl.GetFloat(message, &field));
+  case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+    return (repeated ? refl.GetRepeatedBool(message, &field, index) : refl.GetBool(message, &field)) ? 1 : 0;
+  case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+    return toBits(repeated ? refl.GetRepeatedEnumValue(message, &field, index) : refl.GetEnumValue(message, &field));
+  case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+  case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+    break;
+  }
+  assert(0);
+  return 0;
+}
+
+/** Writes a single scalar value, appending if the field is repeated */
+void decodeScalar(google::protobuf::Message& message, const google::protobuf::FieldDescriptor& field, uint64_t bits)
+{
+  const google::protobuf::Reflection& refl = *message.GetReflection();
+  const bool repeated = field.is_repeated();
+  switch (field.cpp_type())
+  {
+  case google::protobuf::FieldDescriptor::CPPTYPE_INT32:
+    repeated ? refl.AddInt32(&message, &field, fromBits<int32_t>(bits)) : refl.SetInt32(&message, &field, fromBits<int32_t>(bits));
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_INT64:
+    repeated ? refl.AddInt64(&message, &field, fromBits<int64_t>(bits)) : refl.SetInt64(&message, &field, fromBits<int64_t>(bits));
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_UINT32:
+    repeated ? refl.AddUInt32(&message, &field, fromBits<uint32_t>(bits)) : refl.SetUInt32(&message, &field, fromBits<uint32_t>(bits));
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_UINT64:
+    repeated ? refl.AddUInt64(&message, &field, bits) : refl.SetUInt64(&message, &field, bits);
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_DOUBLE:
+    repeated ? refl.AddDouble(&message, &field, fromBits<double>(bits)) : refl.SetDouble(&message, &field, fromBits<double>(bits));
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_FLOAT:
+    repeated ? refl.AddFloat(&message, &field, fromBits<float>(bits)) : refl.SetFloat(&message, &field, fromBits<float>(bits));
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_BOOL:
+    repeated ? refl.AddBool(&message, &field, bits != 0) : refl.SetBool(&message, &field, bits != 0);
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_ENUM:
+    repeated ? refl.AddEnumValue(&message, &field, fromBits<int>(bits)) : refl.SetEnumValue(&message, &field, fromBits<int>(bits));
+    break;
+  case google::protobuf::FieldDescriptor::CPPTYPE_STRING:
+  case google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE:
+    assert(0);
+    break;
+  }
+}
+
+}
+
+CommandPrefsHistory::CommandPrefsHistory()
+  : numRecords_(0),
+    valid_(true)
+{
+}
+
+CommandPrefsHistory::~CommandPrefsHistory()
+{
+}
+
+void CommandPrefsHistory::clear()
+{
+  columns_.clear();
+  columnIndex_.clear();
+  commandTimes_.clear();
+  commandIsClear_.clear();
+  strings_.clear();
+  lists_.clear();
+  numRecords_ = 0;
+  valid_ = true;
+}
+
+void CommandPrefsHistory::invalidate()
+{
+  valid_ = false;
+}
+
+bool CommandPrefsHistory::isValid() const
+{
+  return valid_;
+}
+
+void CommandPrefsHistory::add(double time, bool isClearCommand, const google::protobuf::Message& updatePrefs)
+{
+  if (!valid_)
+    return;
+
+  if (!commandTimes_.empty())
+  {
+    if (time < commandTimes_.back())
+    {
+      valid_ = false;
+      return;
+    }
+    // Merging a clear and a non-clear command at the same time does not reduce to sequential application
+    if (time == commandTimes_.back() && (commandIsClear_.back() != 0) != isClearCommand)
+    {
+      valid_ = false;
+      return;
+    }
+  }
+  if (commandTimes_.empty() || time != commandTimes_.back())
+  {
+    commandTimes_.push_back(time);
+    commandIsClear_.push_back(isClearCommand ? 1 : 0);
+  }
+
+  FieldPath path;
+  addMessage_(time, isClearCommand, updatePrefs, path);
+}
+
+void CommandPrefsHistory::addMessage_(double time, bool isClearCommand, const google::protobuf::Message& message, FieldPath& path)
+{
+  std::vector<const google::protobuf::FieldDescriptor*> fields;
+  message.GetReflection()->ListFields(message, &fields);
+  for (const google::protobuf::FieldDescriptor* field : fields)
+  {
+    if (!valid_)
+      return;
+    path.push_back(field);
+    if (field->is_repeated() && (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE ||
+      field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING))
+    {
+      // Replay appends these rather than replacing them; not supported
+      valid_ = false;
+    }
+    else if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+    {
+      const google::protobuf::Message& subMessage = message.GetReflection()->GetMessage(message, field);
+      std::vector<const google::protobuf::FieldDescriptor*> subFields;
+      subMessage.GetReflection()->ListFields(subMessage, &subFields);
+      // An empty sub-message still makes the sub-message present in the merged state; clear commands ignore it
+      if (!subFields.empty())
+        addMessage_(time, isClearCommand, subMessage, path);
+      else if (!isClearCommand)
+        addRecord_(time, false, path, 0);
+    }
+    else
+      addRecord_(time, isClearCommand, path, isClearCommand ? 0 : encode_(message, *field));
+    path.pop_back();
+  }
+}
+
+void CommandPrefsHistory::addRecord_(double time, bool isClearCommand, const FieldPath& path, uint64_t value)
+{
+  auto iter = columnIndex_.find(path);
+  if (iter == columnIndex_.end())
+  {
+    iter = columnIndex_.insert(std::make_pair(path, columns_.size())).first;
+    columns_.push_back(Column());
+    columns_.back().path = path;
+    columns_.back().firstSetTime = std::numeric_limits<double>::max();
+  }
+
+  Column& column = columns_[iter->second];
+  if (!isClearCommand && time < column.firstSetTime)
+    column.firstSetTime = time;
+  if (!column.times.empty() && column.times.back() == time)
+  {
+    // Merged into the previous command at this time; later values win
+    column.values.back() = value;
+    column.cleared.back() = isClearCommand ? 1 : 0;
+    return;
+  }
+  column.times.push_back(time);
+  column.values.push_back(value);
+  column.cleared.push_back(isClearCommand ? 1 : 0);
+  ++numRecords_;
+}
+
+uint64_t CommandPrefsHistory::encode_(const google::protobuf::Message& message, const google::protobuf::FieldDescriptor& field)
+{
+  const google::protobuf::Reflection& refl = *message.GetReflection();
+  if (field.cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING)
+  {
+    strings_.push_back(refl.GetString(message, &field));
+    return strings_.size() - 1;
+  }
+  if (field.is_repeated())
+  {
+    const int size = refl.FieldSize(message, &field);
+    std::vector<uint64_t> list;
+    list.reserve(size);
+    for (int k = 0; k < size; ++k)
+      list.push_back(encodeScalar(message, field, k));
+    lists_.push_back(std::move(list));
+    return lists_.size() - 1;
+  }
+  return encodeScalar(message, field, 0);
+}
+
+void CommandPrefsHistory::decode_(google::protobuf::Message& message, const google::protobuf::FieldDescriptor& field, uint64_t value) const
+{
+  if (field.cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_STRING)
+  {
+    message.GetReflection()->SetString(&message, &field, strings_[value]);
+    return;
+  }
+  if (field.is_repeated())
+  {
+    for (uint64_t bits : lists_[value])
+      decodeScalar(message, field, bits);
+    return;
+  }
+  decodeScalar(message, field, value);
+}
+
+google::protobuf::Message* CommandPrefsHistory::parentOf_(google::protobuf::Message& prefs, const FieldPath& path, size_t depth)
+{
+  google::protobuf::Message* message = &prefs;
+  for (size_t k = 0; k < depth; ++k)
+    message = message->GetReflection()->MutableMessage(message, path[k]);
+  return message;
+}
+
+bool CommandPrefsHistory::seek(double time, google::protobuf::Message& prefs, double& lastCommandTime) const
+{
+  if (!valid_)
+    return false;
+
+  prefs.Clear();
+  for (const Column& column : columns_)
+  {
+    // Fields never set by this time leave no trace, not even their parent messages
+    if (column.firstSetTime > time)
+      continue;
+
+    const google::protobuf::FieldDescriptor* field = column.path.back();
+    if (field->cpp_type() == google::protobuf::FieldDescriptor::CPPTYPE_MESSAGE)
+    {
+      parentOf_(prefs, column.path, column.path.size());
+      continue;
+    }
+
+    google::protobuf::Message* parent = parentOf_(prefs, column.path, column.path.size() - 1);
+    const auto iter = std::upper_bound(column.times.begin(), column.times.end(), time);
+    assert(iter != column.times.begin());
+    const size_t index = (iter - column.times.begin()) - 1;
+    if (!column.cleared[index])
+      decode_(*parent, *field, column.values[index]);
+  }
+
+  const auto iter = std::upper_bound(commandTimes_.begin(), commandTimes_.end(), time);
+  if (iter != commandTimes_.begin())
+    lastCommandTime = *(iter - 1);
+  return true;
+}
+
+size_t CommandPrefsHistory::numCommands(double startTime, double endTime) const
+{
+  if (endTime <= startTime)
+    return 0;
+  const auto first = std::upper_bound(commandTimes_.begin(), commandTimes_.end(), startTime);
+  const auto last = std::upper_bound(first, commandTimes_.end(), endTime);
+  return last - first;
+}
+
+size_t CommandPrefsHistory::numCommands() const
+{
+  return commandTimes_.size();
+}
+
+size_t CommandPrefsHistory::numFields() const
+{
+  return columns_.size();
+}
+
+size_t CommandPrefsHistory::numRecords() const
+{
+  return numRecords_;
+}
+
+size_t CommandPrefsHistory::memoryUsage() const
+{
+  size_t bytes = sizeof(*this);
+  bytes += columns_.capacity() * sizeof(Column);
+  for (const Column& column : columns_)
+  {
+    bytes += column.path.capacity() * sizeof(FieldPath::value_type);
+    bytes += column.times.capacity() * sizeof(double);
+    bytes += column.values.capacity() * sizeof(uint64_t);
+    bytes += column.cleared.capacity() * sizeof(uint8_t);
+  }
+  // Approximate map node size: key, value and tree links
+  for (const auto& entry : columnIndex_)
+    bytes += sizeof(entry) + 4 * sizeof(void*) + entry.first.capacity() * sizeof(FieldPath::value_type);
+  bytes += commandTimes_.capacity() * sizeof(double);
+  bytes += commandIsClear_.capacity() * sizeof(uint8_t);
+  bytes += strings_.capacity() * sizeof(std::string);
+  for (const std::string& str : strings_)
+    bytes += (str.capacity() > 15 ? str.capacity() : 0);
+  bytes += lists_.capacity() * sizeof(std::vector<uint64_t>);
+  for (const auto& list : lists_)
+    bytes += list.capacity() * sizeof(uint64_t);
+  return bytes;
+}
+
+}
@@ -0,0 +1,133 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_COMMANDPREFSHISTORY_H
+#define SIMDATA_COMMANDPREFSHISTORY_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+#include "simCore/Common/Common.h"
+
+namespace google { namespace protobuf {
+  class FieldDescriptor;
+  class Message;
+} }
+
+namespace simData
+{
+
+/**
+ * Stores a command history as typed change records per preference field, so that the accumulated command state at
+ * any time can be reconstructed directly instead of replaying every command from the start.
+ *
+ * Each leaf field set by a command gets a column of (time, value) records; clear commands add "cleared" records.
+ * Reconstruction at a time does a binary search per column, so a seek costs O(F log N) for F distinct fields and N
+ * commands, independent of how many commands precede the seek time.
+ *
+ * The reconstruction matches the replay rules of MemoryCommandSlice: set fields overwrite, non-empty repeated
+ * fields replace the previous list, clear commands clear the fields they set, and sub-messages remain present once
+ * any command has set a field within them.  Repeated string and repeated message fields are not supported; a history
+ * containing them reports itself invalid so that callers fall back to replay.
+ */
+class SDKDATA_EXPORT CommandPrefsHistory
+{
+public:
+  CommandPrefsHistory();
+  virtual ~CommandPrefsHistory();
+
+  /** Removes all records and marks the history valid, ready to be rebuilt with add() */
+  void clear();
+
+  /** Marks the history out of date; add() is ignored until the next clear() */
+  void invalidate();
+
+  /** Returns false if invalidate() was called or unsupported content was added since the last clear() */
+  bool isValid() const;
+
+  /**
+   * Adds a command to the end of the history.  Commands must be added in time order; a command at the same time as
+   * the previous one is merged into it, as MemoryCommandSlice does when inserting.  Out-of-order commands invalidate.
+   * @param time  time of the command
+   * @param isClearCommand  true if the command clears the fields set in updatePrefs
+   * @param updatePrefs  the command's prefs message
+   */
+  void add(double time, bool isClearCommand, const google::protobuf::Message& updatePrefs);
+
+  /**
+   * Reconstructs the accumulated command state at the given time.
+   * @param time  commands at or before this time are included
+   * @param prefs  cleared and filled in with the command state; must be the same type as the added prefs
+   * @param lastCommandTime  set to the time of the last command at or before time; unchanged if there is none
+   * @return true on success, false if the history is not valid
+   */
+  bool seek(double time, google::protobuf::Message& prefs, double& lastCommandTime) const;
+
+  /** Returns the number of commands with time in (startTime, endTime] */
+  size_t numCommands(double startTime, double endTime) const;
+  /** Returns the total number of commands in the history */
+  size_t numCommands() const;
+  /** Returns the number of distinct fields with records */
+  size_t numFields() const;
+  /** Returns the total number of change records across all fields */
+  size_t numRecords() const;
+  /** Returns the approximate number of bytes allocated by the history */
+  size_t memoryUsage() const;
+
+private:
+  typedef std::vector<const google::protobuf::FieldDescriptor*> FieldPath;
+
+  /** Change records for a single field; values are raw bits, or an index into strings_ or lists_ */
+  struct Column
+  {
+    FieldPath path;
+    double firstSetTime = 0.0;
+    std::vector<double> times;
+    std::vector<uint64_t> values;
+    std::vector<uint8_t> cleared;
+  };
+
+  /** Walks the set fields of the message, adding a record for each leaf */
+  void addMessage_(double time, bool isClearCommand, const google::protobuf::Message& message, FieldPath& path);
+  /** Adds or overwrites the record for the given column at the given time */
+  void addRecord_(double time, bool isClearCommand, const FieldPath& path, uint64_t value);
+  /** Encodes the value of a set leaf field */
+  uint64_t encode_(const google::protobuf::Message& message, const google::protobuf::FieldDescriptor& field);
+  /** Writes an encoded value into the leaf field */
+  void decode_(google::protobuf::Message& message, const google::protobuf::FieldDescriptor& field, uint64_t value) const;
+  /** Returns the message containing the last field of the path, creating sub-messages along the way */
+  static google::protobuf::Message* parentOf_(google::protobuf::Message& prefs, const FieldPath& path, size_t depth);
+
+  std::vector<Column> columns_;
+  std::map<FieldPath, size_t> columnIndex_;
+  std::vector<double> commandTimes_;
+  std::vector<uint8_t> commandIsClear_;
+  std::vector<std::string> strings_;
+  std::vector<std::vector<uint64_t> > lists_;
+  size_t numRecords_;
+  bool valid_;
+};
+
+}
+
+#endif // SIMDATA_COMMANDPREFSHISTORY_H
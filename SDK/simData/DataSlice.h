@@ -197,6 +197,12 @@ public:
   /// Returns the delta between the given time and the time of the data point before the given time; returns -1 if there is no previous point
   virtual double deltaTime(double time) const = 0;
 
+  /**
+   * Counter that changes whenever items are added to, removed from, or modified in the slice, so that values
+   * derived from the slice contents can be cached.  Returns 0 if the slice does not track changes.
+   */
+  virtual uint64_t revision() const { return 0; }
+
 protected:
   /// Helper function to return an iterator to first index
   virtual IteratorImpl* iterator_() const = 0;
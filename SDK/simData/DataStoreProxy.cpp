@@ -21,12 +21,784 @@
  *
  */
 #include <algorithm>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include "simData/CategoryData/CategoryData.h"
+#include "simData/DataSlice.h"
 #include "simData/DataTable.h"
 #include "simData/DataStoreProxy.h"
 
 namespace simData
 {
 
+namespace
+{
+
+/// Maps entity IDs of the incoming data store to the IDs used in the retained data store
+typedef std::map<ObjectId, ObjectId> IdMap;
+
+/** Returns the retained ID for an incoming ID, or 0 if the incoming ID is not mapped */
+ObjectId mapId(const IdMap& ids, ObjectId incomingId)
+{
+  const auto it = ids.find(incomingId);
+  return (it == ids.end()) ? 0 : it->second;
+}
+
+/** Platforms have no host */
+void remapHost(PlatformProperties& props, const IdMap& ids)
+{
+}
+
+template <typename PropT>
+void remapHost(PropT& props, const IdMap& ids)
+{
+  props.set_hostid(mapId(ids, props.hostid()));
+}
+
+/** Rewrites entity IDs referenced by prefs from incoming IDs to retained IDs */
+void remapCommonPrefs(CommonPrefs& prefs, const IdMap& ids)
+{
+  for (int k = 0; k < prefs.acceptprojectorids_size(); ++k)
+    prefs.set_acceptprojectorids(k, mapId(ids, prefs.acceptprojectorids(k)));
+}
+
+template <typename PrefT>
+void remapPrefs(PrefT& prefs, const IdMap& ids)
+{
+  if (prefs.has_commonprefs())
+    remapCommonPrefs(*prefs.mutable_commonprefs(), ids);
+}
+
+void remapPrefs(BeamPrefs& prefs, const IdMap& ids)
+{
+  if (prefs.has_commonprefs())
+    remapCommonPrefs(*prefs.mutable_commonprefs(), ids);
+  if (prefs.has_targetid())
+    prefs.set_targetid(mapId(ids, prefs.targetid()));
+}
+
+/** Updates, category data, and generic data do not reference entities */
+template <typename T>
+void remapMessage(T& message, const IdMap& ids)
+{
+}
+
+/** Commands carry prefs, which may reference entities */
+template <typename CommandT>
+void remapCommand(CommandT& command, const IdMap& ids)
+{
+  if (command.has_updateprefs())
+    remapPrefs(*command.mutable_updateprefs(), ids);
+}
+
+void remapMessage(PlatformCommand& command, const IdMap& ids) { remapCommand(command, ids); }
+void remapMessage(BeamCommand& command, const IdMap& ids) { remapCommand(command, ids); }
+void remapMessage(GateCommand& command, const IdMap& ids) { remapCommand(command, ids); }
+void remapMessage(LaserCommand& command, const IdMap& ids) { remapCommand(command, ids); }
+void remapMessage(ProjectorCommand& command, const IdMap& ids) { remapCommand(command, ids); }
+void remapMessage(LobGroupCommand& command, const IdMap& ids) { remapCommand(command, ids); }
+void remapMessage(CustomRenderingCommand& command, const IdMap& ids) { remapCommand(command, ids); }
+
+/** Returns a byte representation of a message, for comparison */
+template <typename T>
+std::string serialize(const T& message)
+{
+  return message.SerializeAsString();
+}
+
+/** Appends the bytes of a value */
+template <typename T>
+void appendBytes(std::string& bytes, T value)
+{
+  bytes.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+/** PlatformUpdate is not a protobuf message, so serialize its fields directly */
+std::string serialize(const PlatformUpdate& update)
+{
+  std::string bytes;
+  appendBytes(bytes, update.time());
+  appendBytes(bytes, update.x());
+  appendBytes(bytes, update.y());
+  appendBytes(bytes, update.z());
+  appendBytes(bytes, update.psi());
+  appendBytes(bytes, update.theta());
+  appendBytes(bytes, update.phi());
+  appendBytes(bytes, update.vx());
+  appendBytes(bytes, update.vy());
+  appendBytes(bytes, update.vz());
+  return bytes;
+}
+
+/** Serializes each visited message, remapping incoming IDs if an ID map is supplied */
+template <typename T, typename VisitorBase>
+class SerializeVisitor : public VisitorBase
+{
+public:
+  SerializeVisitor(std::vector<std::string>& serialized, const IdMap* ids)
+    : serialized_(serialized),
+      ids_(ids)
+  {
+  }
+
+  virtual void operator()(const T* message)
+  {
+    if (!ids_)
+    {
+      serialized_.push_back(serialize(*message));
+      return;
+    }
+    T copy(*message);
+    remapMessage(copy, *ids_);
+    serialized_.push_back(serialize(copy));
+  }
+
+private:
+  std::vector<std::string>& serialized_;
+  const IdMap* ids_;
+};
+
+/** Adds each visited incoming message to an entity in the retained data store */
+template <typename T, typename VisitorBase>
+class CopyVisitor : public VisitorBase
+{
+public:
+  /// Function on the data store that adds a message for an entity
+  typedef T* (DataStore::*AddFunction)(ObjectId, DataStore::Transaction*);
+
+  CopyVisitor(DataStore& dataStore, ObjectId id, AddFunction add, const IdMap& ids)
+    : dataStore_(dataStore),
+      id_(id),
+      add_(add),
+      ids_(ids)
+  {
+  }
+
+  virtual void operator()(const T* message)
+  {
+    DataStore::Transaction txn;
+    T* added = (dataStore_.*add_)(id_, &txn);
+    if (!added)
+      return;
+    added->CopyFrom(*message);
+    remapMessage(*added, ids_);
+    txn.complete(&added);
+  }
+
+private:
+  DataStore& dataStore_;
+  ObjectId id_;
+  AddFunction add_;
+  const IdMap& ids_;
+};
+
+/**
+ * Returns true if the two slices hold the same messages, after remapping incoming IDs.  Unordered
+ * comparison is used for slices that visit in key order rather than time order.
+ */
+template <typename T, typename VisitorBase, typename SliceT>
+bool sameData(const SliceT* retained, const SliceT* incoming, const IdMap& ids, bool unordered)
+{
+  std::vector<std::string> retainedMessages;
+  std::vector<std::string> incomingMessages;
+  if (retained)
+  {
+    SerializeVisitor<T, VisitorBase> visitor(retainedMessages, nullptr);
+    retained->visit(&visitor);
+  }
+  if (incoming)
+  {
+    SerializeVisitor<T, VisitorBase> visitor(incomingMessages, &ids);
+    incoming->visit(&visitor);
+  }
+  if (retainedMessages.size() != incomingMessages.size())
+    return false;
+  if (unordered)
+  {
+    std::sort(retainedMessages.begin(), retainedMessages.end());
+    std::sort(incomingMessages.begin(), incomingMessages.end());
+  }
+  return retainedMessages == incomingMessages;
+}
+
+/** Adds all the messages of the incoming slice to the retained entity */
+template <typename T, typename VisitorBase, typename SliceT>
+void copyData(const SliceT* incoming, DataStore& retained, ObjectId retainedId, T* (DataStore::*add)(ObjectId, DataStore::Transaction*), const IdMap& ids)
+{
+  if (!incoming)
+    return;
+  CopyVisitor<T, VisitorBase> visitor(retained, retainedId, add, ids);
+  incoming->visit(&visitor);
+}
+
+/** Writes the cells of a table row by column name */
+class CellWriter : public TableRow::CellVisitor
+{
+public:
+  CellWriter(const DataTable& table, std::ostream& os)
+    : table_(table),
+      os_(os)
+  {
+  }
+
+  virtual void visit(TableColumnId columnId, uint8_t value) { write_(columnId, static_cast<unsigned int>(value)); }
+  virtual void visit(TableColumnId columnId, int8_t value) { write_(columnId, static_cast<int>(value)); }
+  virtual void visit(TableColumnId columnId, uint16_t value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, int16_t value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, uint32_t value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, int32_t value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, uint64_t value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, int64_t value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, float value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, double value) { write_(columnId, value); }
+  virtual void visit(TableColumnId columnId, const std::string& value) { write_(columnId, value); }
+
+private:
+  template <typename T>
+  void write_(TableColumnId columnId, const T& value)
+  {
+    const TableColumn* column = table_.column(columnId);
+    os_ << (column ? column->name() : std::string()) << '=' << value << ';';
+  }
+
+  const DataTable& table_;
+  std::ostream& os_;
+};
+
+/** Copies the cells of a table row into a row for another table, by column */
+class CellCopier : public TableRow::CellVisitor
+{
+public:
+  CellCopier(const std::map<TableColumnId, TableColumnId>& columns, TableRow& row)
+    : columns_(columns),
+      row_(row)
+  {
+  }
+
+  virtual void visit(TableColumnId columnId, uint8_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, int8_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, uint16_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, int16_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, uint32_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, int32_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, uint64_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, int64_t value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, float value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, double value) { copy_(columnId, value); }
+  virtual void visit(TableColumnId columnId, const std::string& value) { copy_(columnId, value); }
+
+private:
+  template <typename T>
+  void copy_(TableColumnId columnId, const T& value)
+  {
+    const auto it = columns_.find(columnId);
+    if (it != columns_.end())
+      row_.setValue(it->second, value);
+  }
+
+  const std::map<TableColumnId, TableColumnId>& columns_;
+  TableRow& row_;
+};
+
+/** Collects the tables of an owner, sorted by name */
+class TableCollector : public TableList::Visitor
+{
+public:
+  virtual void visit(DataTable* table)
+  {
+    tables[table->tableName()] = table;
+  }
+  std::map<std::string, DataTable*> tables;
+};
+
+/** Collects the columns of a table */
+class ColumnCollector : public DataTable::ColumnVisitor
+{
+public:
+  virtual void visit(TableColumn* column)
+  {
+    columns.push_back(column);
+  }
+  std::vector<TableColumn*> columns;
+};
+
+/** Writes each visited row, or copies it into a destination table if one is given */
+class RowVisitor : public DataTable::RowVisitor
+{
+public:
+  RowVisitor(const DataTable& source, std::ostream* os, DataTable* destination, const std::map<TableColumnId, TableColumnId>* columns)
+    : source_(source),
+      os_(os),
+      destination_(destination),
+      columns_(columns)
+  {
+  }
+
+  virtual VisitReturn visit(const TableRow& row)
+  {
+    if (os_)
+    {
+      *os_ << row.time() << ':';
+      CellWriter writer(source_, *os_);
+      row.accept(writer);
+      *os_ << '\n';
+    }
+    if (destination_ && columns_)
+    {
+      TableRow newRow;
+      newRow.setTime(row.time());
+      CellCopier copier(*columns_, newRow);
+      row.accept(copier);
+      destination_->addRow(newRow);
+    }
+    return VISIT_CONTINUE;
+  }
+
+private:
+  const DataTable& source_;
+  std::ostream* os_;
+  DataTable* destination_;
+  const std::map<TableColumnId, TableColumnId>* columns_;
+};
+
+/** Returns the tables of an owner, sorted by name */
+std::map<std::string, DataTable*> ownedTables(const DataTableManager& manager, ObjectId ownerId)
+{
+  TableCollector collector;
+  const TableList* tables = manager.tablesForOwner(ownerId);
+  if (tables)
+    tables->accept(collector);
+  return collector.tables;
+}
+
+/** Serializes the structure and contents of an owner's tables, for comparison */
+std::string serializeTables(const DataTableManager& manager, ObjectId ownerId)
+{
+  std::ostringstream os;
+  os.precision(17);
+  for (const auto& nameTable : ownedTables(manager, ownerId))
+  {
+    const DataTable& table = *nameTable.second;
+    os << "table " << nameTable.first << '\n';
+    ColumnCollector collector;
+    table.accept(collector);
+    std::vector<std::string> columns;
+    for (const TableColumn* column : collector.columns)
+    {
+      std::ostringstream columnOs;
+      columnOs << "column " << column->name() << ' ' << column->variableType() << ' ' << column->unitType() << '\n';
+      columns.push_back(columnOs.str());
+    }
+    std::sort(columns.begin(), columns.end());
+    for (const std::string& column : columns)
+      os << column;
+    RowVisitor writer(table, &os, nullptr, nullptr);
+    table.accept(-std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), writer);
+  }
+  return os.str();
+}
+
+/** Copies a table, including its columns and rows, to a new owner */
+void copyTable(const DataTable& source, DataTableManager& manager, ObjectId ownerId)
+{
+  DataTable* table = nullptr;
+  if (manager.addDataTable(ownerId, source.tableName(), &table).isError() || !table)
+    return;
+  ColumnCollector collector;
+  source.accept(collector);
+  std::map<TableColumnId, TableColumnId> columns;
+  for (const TableColumn* column : collector.columns)
+  {
+    TableColumn* newColumn = nullptr;
+    if (table->addColumn(column->name(), column->variableType(), column->unitType(), &newColumn).isSuccess() && newColumn)
+      columns[column->columnId()] = newColumn->columnId();
+  }
+  RowVisitor copier(source, nullptr, table, &columns);
+  source.accept(-std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), copier);
+}
+
+/** Data store functions for one entity type, used to diff and copy entities generically */
+template <typename PropT, typename PrefT, typename UpdateT, typename CommandT>
+struct EntityFunctions
+{
+  PropT* (DataStore::*add)(DataStore::Transaction*);
+  const PropT* (DataStore::*properties)(ObjectId, DataStore::Transaction*) const;
+  PropT* (DataStore::*mutableProperties)(ObjectId, DataStore::Transaction*);
+  const PrefT* (DataStore::*prefs)(ObjectId, DataStore::Transaction*) const;
+  PrefT* (DataStore::*mutablePrefs)(ObjectId, DataStore::Transaction*);
+  /// nullptr for entities without updates
+  const DataSlice<UpdateT>* (DataStore::*updateSlice)(ObjectId) const;
+  UpdateT* (DataStore::*addUpdate)(ObjectId, DataStore::Transaction*);
+  const DataSlice<CommandT>* (DataStore::*commandSlice)(ObjectId) const;
+  CommandT* (DataStore::*addCommand)(ObjectId, DataStore::Transaction*);
+};
+
+const EntityFunctions<PlatformProperties, PlatformPrefs, PlatformUpdate, PlatformCommand> PLATFORM_FUNCTIONS = {
+  &DataStore::addPlatform, &DataStore::platformProperties, &DataStore::mutable_platformProperties,
+  &DataStore::platformPrefs, &DataStore::mutable_platformPrefs,
+  &DataStore::platformUpdateSlice, &DataStore::addPlatformUpdate, &DataStore::platformCommandSlice, &DataStore::addPlatformCommand
+};
+const EntityFunctions<BeamProperties, BeamPrefs, BeamUpdate, BeamCommand> BEAM_FUNCTIONS = {
+  &DataStore::addBeam, &DataStore::beamProperties, &DataStore::mutable_beamProperties,
+  &DataStore::beamPrefs, &DataStore::mutable_beamPrefs,
+  &DataStore::beamUpdateSlice, &DataStore::addBeamUpdate, &DataStore::beamCommandSlice, &DataStore::addBeamCommand
+};
+const EntityFunctions<GateProperties, GatePrefs, GateUpdate, GateCommand> GATE_FUNCTIONS = {
+  &DataStore::addGate, &DataStore::gateProperties, &DataStore::mutable_gateProperties,
+  &DataStore::gatePrefs, &DataStore::mutable_gatePrefs,
+  &DataStore::gateUpdateSlice, &DataStore::addGateUpdate, &DataStore::gateCommandSlice, &DataStore::addGateCommand
+};
+const EntityFunctions<LaserProperties, LaserPrefs, LaserUpdate, LaserCommand> LASER_FUNCTIONS = {
+  &DataStore::addLaser, &DataStore::laserProperties, &DataStore::mutable_laserProperties,
+  &DataStore::laserPrefs, &DataStore::mutable_laserPrefs,
+  &DataStore::laserUpdateSlice, &DataStore::addLaserUpdate, &DataStore::laserCommandSlice, &DataStore::addLaserCommand
+};
+const EntityFunctions<ProjectorProperties, ProjectorPrefs, ProjectorUpdate, ProjectorCommand> PROJECTOR_FUNCTIONS = {
+  &DataStore::addProjector, &DataStore::projectorProperties, &DataStore::mutable_projectorProperties,
+  &DataStore::projectorPrefs, &DataStore::mutable_projectorPrefs,
+  &DataStore::projectorUpdateSlice, &DataStore::addProjectorUpdate, &DataStore::projectorCommandSlice, &DataStore::addProjectorCommand
+};
+const EntityFunctions<LobGroupProperties, LobGroupPrefs, LobGroupUpdate, LobGroupCommand> LOB_GROUP_FUNCTIONS = {
+  &DataStore::addLobGroup, &DataStore::lobGroupProperties, &DataStore::mutable_lobGroupProperties,
+  &DataStore::lobGroupPrefs, &DataStore::mutable_lobGroupPrefs,
+  &DataStore::lobGroupUpdateSlice, &DataStore::addLobGroupUpdate, &DataStore::lobGroupCommandSlice, &DataStore::addLobGroupCommand
+};
+const EntityFunctions<CustomRenderingProperties, CustomRenderingPrefs, CustomRenderingUpdate, CustomRenderingCommand> CUSTOM_RENDERING_FUNCTIONS = {
+  &DataStore::addCustomRendering, &DataStore::customRenderingProperties, &DataStore::mutable_customRenderingProperties,
+  &DataStore::customRenderingPrefs, &DataStore::mutable_customRenderingPrefs,
+  nullptr, nullptr, &DataStore::customRenderingCommandSlice, &DataStore::addCustomRenderingCommand
+};
+
+/** Entity types in an order where hosts always precede the entities they host */
+const ObjectType HOST_ORDER[] = { PLATFORM, CUSTOM_RENDERING, BEAM, GATE, LASER, PROJECTOR, LOB_GROUP };
+
+/**
+ * Applies the contents of an incoming data store to a retained data store as a set of differences.
+ * Entities are matched on type, original ID, and host; unmatched retained entities are removed and
+ * unmatched incoming entities are added.  Transactions on the retained store only notify listeners
+ * when values actually change, so copying matched properties and prefs is sufficient for those.
+ */
+class DifferentialReset
+{
+public:
+  DifferentialReset(DataStore& retained, const DataStore& incoming)
+    : retained_(retained),
+      incoming_(incoming)
+  {
+  }
+
+  void apply()
+  {
+    match_();
+    removeUnmatched_();
+    addUnmatched_();
+
+    // Apply properties, prefs, and data to all entities, now that every incoming ID is mapped
+    for (const auto& entity : entities_)
+    {
+      const ObjectId retainedId = mapId(ids_, entity.first);
+      if (retainedId == 0)
+        continue;
+      const bool added = (added_.count(retainedId) != 0);
+      switch (entity.second)
+      {
+      case PLATFORM:
+        applyEntity_(PLATFORM_FUNCTIONS, entity.first, retainedId, added);
+        break;
+      case BEAM:
+        applyEntity_(BEAM_FUNCTIONS, entity.first, retainedId, added);
+        break;
+      case GATE:
+        applyEntity_(GATE_FUNCTIONS, entity.first, retainedId, added);
+        break;
+      case LASER:
+        applyEntity_(LASER_FUNCTIONS, entity.first, retainedId, added);
+        break;
+      case PROJECTOR:
+        applyEntity_(PROJECTOR_FUNCTIONS, entity.first, retainedId, added);
+        break;
+      case LOB_GROUP:
+        applyEntity_(LOB_GROUP_FUNCTIONS, entity.first, retainedId, added);
+        break;
+      case CUSTOM_RENDERING:
+        applyEntity_(CUSTOM_RENDERING_FUNCTIONS, entity.first, retainedId, added);
+        break;
+      default:
+        break;
+      }
+    }
+
+    applyScenario_();
+  }
+
+private:
+  /** Matches incoming entities to retained entities by type, original ID, and matched host */
+  void match_()
+  {
+    for (ObjectType type : HOST_ORDER)
+    {
+      DataStore::IdList incomingIds;
+      incoming_.idList(&incomingIds, type);
+      for (ObjectId incomingId : incomingIds)
+      {
+        entities_.push_back(std::make_pair(incomingId, type));
+
+        const ObjectId incomingHost = (type == PLATFORM) ? 0 : incoming_.entityHostId(incomingId);
+        const ObjectId retainedHost = mapId(ids_, incomingHost);
+        // Children of unmatched hosts cannot match
+        if (incomingHost != 0 && retainedHost == 0)
+          continue;
+
+        DataStore::IdList candidates;
+        retained_.idListByOriginalId(&candidates, originalId_(incoming_, incomingId, type), type);
+        std::sort(candidates.begin(), candidates.end());
+        for (ObjectId candidate : candidates)
+        {
+          if (claimed_.count(candidate) != 0)
+            continue;
+          const ObjectId candidateHost = (type == PLATFORM) ? 0 : retained_.entityHostId(candidate);
+          if (candidateHost != retainedHost)
+            continue;
+          ids_[incomingId] = candidate;
+          claimed_.insert(candidate);
+          break;
+        }
+      }
+    }
+  }
+
+  /** Removes retained entities that have no incoming match, children first */
+  void removeUnmatched_()
+  {
+    for (auto typeIter = std::rbegin(HOST_ORDER); typeIter != std::rend(HOST_ORDER); ++typeIter)
+    {
+      DataStore::IdList retainedIds;
+      retained_.idList(&retainedIds, *typeIter);
+      for (ObjectId retainedId : retainedIds)
+      {
+        // Entity may have been removed along with its host
+        if (claimed_.count(retainedId) == 0 && retained_.objectType(retainedId) != NONE)
+          retained_.removeEntity(retainedId);
+      }
+    }
+  }
+
+  /** Adds incoming entities that have no retained match, hosts first */
+  void addUnmatched_()
+  {
+    for (const auto& entity : entities_)
+    {
+      if (ids_.count(entity.first) != 0)
+        continue;
+      ObjectId retainedId = 0;
+      switch (entity.second)
+      {
+      case PLATFORM:
+        retainedId = addEntity_(PLATFORM_FUNCTIONS, entity.first);
+        break;
+      case BEAM:
+        retainedId = addEntity_(BEAM_FUNCTIONS, entity.first);
+        break;
+      case GATE:
+        retainedId = addEntity_(GATE_FUNCTIONS, entity.first);
+        break;
+      case LASER:
+        retainedId = addEntity_(LASER_FUNCTIONS, entity.first);
+        break;
+      case PROJECTOR:
+        retainedId = addEntity_(PROJECTOR_FUNCTIONS, entity.first);
+        break;
+      case LOB_GROUP:
+        retainedId = addEntity_(LOB_GROUP_FUNCTIONS, entity.first);
+        break;
+      case CUSTOM_RENDERING:
+        retainedId = addEntity_(CUSTOM_RENDERING_FUNCTIONS, entity.first);
+        break;
+      default:
+        break;
+      }
+      if (retainedId != 0)
+      {
+        ids_[entity.first] = retainedId;
+        added_.insert(retainedId);
+      }
+    }
+  }
+
+  /** Adds an entity with the incoming entity's properties, returning its retained ID */
+  template <typename PropT, typename PrefT, typename UpdateT, typename CommandT>
+  ObjectId addEntity_(const EntityFunctions<PropT, PrefT, UpdateT, CommandT>& functions, ObjectId incomingId)
+  {
+    DataStore::Transaction incomingTxn;
+    const PropT* incomingProps = (incoming_.*functions.properties)(incomingId, &incomingTxn);
+    if (!incomingProps)
+      return 0;
+    DataStore::Transaction txn;
+    PropT* props = (retained_.*functions.add)(&txn);
+    if (!props)
+      return 0;
+    const ObjectId retainedId = props->id();
+    props->CopyFrom(*incomingProps);
+    props->set_id(retainedId);
+    remapHost(*props, ids_);
+    txn.complete(&props);
+    return retainedId;
+  }
+
+  /** Copies properties and prefs, and replaces any data that differs */
+  template <typename PropT, typename PrefT, typename UpdateT, typename CommandT>
+  void applyEntity_(const EntityFunctions<PropT, PrefT, UpdateT, CommandT>& functions, ObjectId incomingId, ObjectId retainedId, bool added)
+  {
+    DataStore::Transaction incomingTxn;
+    const PropT* incomingProps = (incoming_.*functions.properties)(incomingId, &incomingTxn);
+    if (incomingProps && !added)
+    {
+      DataStore::Transaction txn;
+      PropT* props = (retained_.*functions.mutableProperties)(retainedId, &txn);
+      if (props)
+      {
+        props->CopyFrom(*incomingProps);
+        props->set_id(retainedId);
+        remapHost(*props, ids_);
+        txn.complete(&props);
+      }
+    }
+
+    const PrefT* incomingPrefs = (incoming_.*functions.prefs)(incomingId, &incomingTxn);
+    if (incomingPrefs)
+    {
+      DataStore::Transaction txn;
+      PrefT* prefs = (retained_.*functions.mutablePrefs)(retainedId, &txn);
+      if (prefs)
+      {
+        prefs->CopyFrom(*incomingPrefs);
+        remapPrefs(*prefs, ids_);
+        txn.complete(&prefs);
+      }
+    }
+
+    typedef typename VisitableDataSlice<UpdateT>::Visitor UpdateVisitor;
+    typedef typename VisitableDataSlice<CommandT>::Visitor CommandVisitor;
+    int fields = 0;
+    if (functions.updateSlice && !sameData<UpdateT, UpdateVisitor>((retained_.*functions.updateSlice)(retainedId),
+      (incoming_.*functions.updateSlice)(incomingId), ids_, false))
+      fields |= DataStore::FLUSH_UPDATES;
+    if (!sameData<CommandT, CommandVisitor>((retained_.*functions.commandSlice)(retainedId),
+      (incoming_.*functions.commandSlice)(incomingId), ids_, false))
+      fields |= DataStore::FLUSH_COMMANDS;
+    fields |= differingData_(incomingId, retainedId);
+
+    flushData_(retainedId, fields, added);
+    if (fields & DataStore::FLUSH_UPDATES)
+      copyData<UpdateT, UpdateVisitor>((incoming_.*functions.updateSlice)(incomingId), retained_, retainedId, functions.addUpdate, ids_);
+    if (fields & DataStore::FLUSH_COMMANDS)
+      copyData<CommandT, CommandVisitor>((incoming_.*functions.commandSlice)(incomingId), retained_, retainedId, functions.addCommand, ids_);
+    copyData_(incomingId, retainedId, fields);
+  }
+
+  /** Copies scenario properties, and replaces scenario generic data and data tables if they differ */
+  void applyScenario_()
+  {
+    DataStore::Transaction incomingTxn;
+    const ScenarioProperties* incomingProps = incoming_.scenarioProperties(&incomingTxn);
+    if (incomingProps)
+    {
+      DataStore::Transaction txn;
+      ScenarioProperties* props = retained_.mutable_scenarioProperties(&txn);
+      if (props)
+      {
+        props->CopyFrom(*incomingProps);
+        txn.complete(&props);
+      }
+    }
+
+    const int fields = differingData_(0, 0);
+    flushData_(0, fields, false);
+    copyData_(0, 0, fields);
+  }
+
+  /** Returns the flush fields for category data, generic data, and data tables that differ */
+  int differingData_(ObjectId incomingId, ObjectId retainedId) const
+  {
+    int fields = 0;
+    if (!sameData<CategoryData, CategoryDataSlice::Visitor>(retained_.categoryDataSlice(retainedId), incoming_.categoryDataSlice(incomingId), ids_, true))
+      fields |= DataStore::FLUSH_CATEGORY_DATA;
+    if (!sameData<GenericData, GenericDataSlice::Visitor>(retained_.genericDataSlice(retainedId), incoming_.genericDataSlice(incomingId), ids_, true))
+      fields |= DataStore::FLUSH_GENERIC_DATA;
+    if (serializeTables(retained_.dataTableManager(), retainedId) != serializeTables(incoming_.dataTableManager(), incomingId))
+      fields |= DataStore::FLUSH_DATA_TABLES;
+    return fields;
+  }
+
+  /** Flushes differing data from a retained entity, other than tables, which are replaced instead */
+  void flushData_(ObjectId retainedId, int fields, bool added)
+  {
+    const int flushFields = fields & ~DataStore::FLUSH_DATA_TABLES;
+    if (!added && flushFields != 0)
+      retained_.flush(retainedId, DataStore::FLUSH_NONRECURSIVE, static_cast<DataStore::FlushFields>(flushFields));
+  }
+
+  /** Copies the category data, generic data, and data tables named by fields */
+  void copyData_(ObjectId incomingId, ObjectId retainedId, int fields)
+  {
+    if (fields & DataStore::FLUSH_CATEGORY_DATA)
+      copyData<CategoryData, CategoryDataSlice::Visitor>(incoming_.categoryDataSlice(incomingId), retained_, retainedId, &DataStore::addCategoryData, ids_);
+    if (fields & DataStore::FLUSH_GENERIC_DATA)
+      copyData<GenericData, GenericDataSlice::Visitor>(incoming_.genericDataSlice(incomingId), retained_, retainedId, &DataStore::addGenericData, ids_);
+    if (fields & DataStore::FLUSH_DATA_TABLES)
+    {
+      DataTableManager& manager = retained_.dataTableManager();
+      for (const auto& nameTable : ownedTables(manager, retainedId))
+        manager.deleteTable(nameTable.second->tableId());
+      for (const auto& nameTable : ownedTables(incoming_.dataTableManager(), incomingId))
+        copyTable(*nameTable.second, manager, retainedId);
+    }
+  }
+
+  /** Returns the original ID of an entity */
+  static uint64_t originalId_(const DataStore& dataStore, ObjectId id, ObjectType type)
+  {
+    DataStore::Transaction txn;
+    switch (type)
+    {
+    case PLATFORM:
+      return dataStore.platformProperties(id, &txn)->originalid();
+    case BEAM:
+      return dataStore.beamProperties(id, &txn)->originalid();
+    case GATE:
+      return dataStore.gateProperties(id, &txn)->originalid();
+    case LASER:
+      return dataStore.laserProperties(id, &txn)->originalid();
+    case PROJECTOR:
+      return dataStore.projectorProperties(id, &txn)->originalid();
+    case LOB_GROUP:
+      return dataStore.lobGroupProperties(id, &txn)->originalid();
+    case CUSTOM_RENDERING:
+      return dataStore.customRenderingProperties(id, &txn)->originalid();
+    default:
+      break;
+    }
+    return 0;
+  }
+
+  DataStore& retained_;
+  const DataStore& incoming_;
+  /// Incoming entities with their types, hosts before children
+  std::vector<std::pair<ObjectId, ObjectType> > entities_;
+  /// Incoming ID to retained ID
+  IdMap ids_;
+  /// Retained IDs that have been matched to an incoming entity
+  std::set<ObjectId> claimed_;
+  /// Retained IDs of entities added from the incoming data store
+  std::set<ObjectId> added_;
+};
+
+}
+
 DataStoreProxy::DataStoreProxy(DataStore* dataStore)
   : dataStore_(dataStore),
     interpolator_(nullptr)
@@ -34,11 +806,19 @@ DataStoreProxy::DataStoreProxy(DataStore* dataStore)
   assert(dataStore_);
 }
 
-void DataStoreProxy::reset(DataStore* newDataStore)
+void DataStoreProxy::reset(DataStore* newDataStore, ResetMode mode)
 {
   if (dataStore_ == newDataStore)
     return;
 
+  if (mode == RESET_DIFFERENTIAL && newDataStore)
+  {
+    // Current data store and all its listeners stay in place; only the differences are applied
+    DifferentialReset(*dataStore_, *newDataStore).apply();
+    delete newDataStore;
+    return;
+  }
+
   // only capture old internals if there is somewhere new to put them
   InternalsMemento *oldInternals = newDataStore ? dataStore_->createInternalsMemento() : nullptr;
 
@@ -57,11 +57,27 @@ public: // methods
   /// Returns a pointer to the RealSubject
   const DataStore* dataStore() const {return dataStore_;}
 
+  /// Strategy used by reset() to move from the current data store to a new one
+  enum ResetMode
+  {
+    /// Replace the data store outright; listeners see every entity of the new store as new
+    RESET_REPLACE = 0,
+    /**
+     * Keep the current data store and apply only the differences from the new one.
+     * Entities are matched on type, original ID, and (matched) host.  Matched entities keep
+     * their IDs; listeners are notified of added and removed entities, of properties and
+     * prefs that differ, and with onFlush() for entities whose data differs.
+     */
+    RESET_DIFFERENTIAL
+  };
+
   /** Deletes the current dataStore_ and sets the new one to dataStore.
    *
+   * With RESET_DIFFERENTIAL, the contents of dataStore are instead applied to the current data
+   * store as a set of differences, after which dataStore is deleted.
    * @note ownership of dataStore is given to the proxy
    */
-  void reset(DataStore* dateStore);
+  void reset(DataStore* dateStore, ResetMode mode = RESET_REPLACE);
 
   virtual ~DataStoreProxy();
 
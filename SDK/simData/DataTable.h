@@ -23,6 +23,7 @@
 #ifndef SIMDATA_DATATABLE_H
 #define SIMDATA_DATATABLE_H
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
@@ -432,6 +433,31 @@ public:
   /** Remove rows in the given time range; up to but not including endTime */
   virtual void flush(double startTime, double endTime) = 0;
 
+  /** Methods for computing column values between samples, used by resample() */
+  enum ResampleMethod
+  {
+    /** Value at or immediately before the requested time, as in TableColumn::findAtOrBeforeTime() */
+    RESAMPLE_SAMPLE_AND_HOLD = 0,
+    /** Linear interpolation between bracketing samples, as in TableColumn::interpolate() with no interpolator */
+    RESAMPLE_LINEAR
+  };
+
+  /**
+   * Retrieves several columns on a common time grid in one merged pass, instead of a separate
+   * search per column per time.  Neither method extrapolates before a column's first sample; both
+   * hold the last value past the end of a column.
+   * @param columnIds Columns to resample; must be numeric columns in this table.
+   * @param times Time grid, sorted in ascending order.
+   * @param method Method used for times between samples.
+   * @param values Resized to columnIds.size() * times.size() and filled one column after another, such
+   *   that the value of columnIds[c] at times[t] is values[c * times.size() + t].
+   * @param noValue Value written where a column has no value at a time.
+   * @return Success, or an error if times are not sorted or a column ID is invalid.  When a column ID
+   *   is invalid, all of its values are noValue and the remaining columns are still filled.
+   */
+  virtual TableStatus resample(const std::vector<TableColumnId>& columnIds, const std::vector<double>& times,
+    ResampleMethod method, std::vector<double>& values, double noValue = std::numeric_limits<double>::quiet_NaN()) const = 0;
+
   /**
   * Defines an observer interface to notify when rows or columns are added or removed.
   */
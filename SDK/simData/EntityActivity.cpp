@@ -0,0 +1,377 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include "simData/DataStore.h"
+#include "simData/EntityActivity.h"
+
+namespace simData {
+
+namespace {
+
+/** Returns the value in effect at the given time, i.e. the last value at or before the time, or defaultValue */
+template <typename ValueVector>
+typename ValueVector::value_type valueAsOf(const std::vector<double>& times, const ValueVector& values, double atTime, typename ValueVector::value_type defaultValue)
+{
+  const auto iter = std::upper_bound(times.begin(), times.end(), atTime);
+  if (iter == times.begin())
+    return defaultValue;
+  return values[(iter - times.begin()) - 1];
+}
+
+/** Appends the value to the change list if it differs from the last value */
+template <typename ValueVector>
+void addChange(std::vector<double>& times, ValueVector& values, double time, typename ValueVector::value_type value)
+{
+  if (!values.empty() && values.back() == value)
+    return;
+  times.push_back(time);
+  values.push_back(value);
+}
+
+/** Only beam commands have targets */
+template <typename CommandType>
+void addTargetChange(const CommandType& command, std::vector<double>& times, std::vector<ObjectId>& targetIds)
+{
+}
+
+void addTargetChange(const BeamCommand& command, std::vector<double>& times, std::vector<ObjectId>& targetIds)
+{
+  if (command.updateprefs().has_targetid())
+    addChange(times, targetIds, command.time(), command.updateprefs().targetid());
+}
+
+}
+
+EntityActivity::EntityActivity(const DataStore& dataStore)
+  : dataStore_(dataStore),
+    numIndexBuilds_(0)
+{
+}
+
+EntityActivity::~EntityActivity()
+{
+}
+
+bool EntityActivity::isActive(ObjectId id, double atTime)
+{
+  const bool rv = isActive_(id, atTime);
+  results_.clear();
+  platformResults_.clear();
+  return rv;
+}
+
+void EntityActivity::evaluate(const std::vector<ObjectId>& ids, double atTime, std::vector<bool>& active)
+{
+  active.resize(ids.size());
+  for (size_t k = 0; k < ids.size(); ++k)
+    active[k] = isActive_(ids[k], atTime);
+  results_.clear();
+  platformResults_.clear();
+}
+
+void EntityActivity::activeEntities(double atTime, std::vector<ObjectId>& activeIds, simData::ObjectType type)
+{
+  activeIds.clear();
+  DataStore::IdList ids;
+  dataStore_.idList(&ids, type);
+  for (const auto id : ids)
+  {
+    if (isActive_(id, atTime))
+      activeIds.push_back(id);
+  }
+  results_.clear();
+  platformResults_.clear();
+}
+
+void EntityActivity::clear()
+{
+  indices_.clear();
+}
+
+size_t EntityActivity::numIndexBuilds() const
+{
+  return numIndexBuilds_;
+}
+
+bool EntityActivity::isActive_(ObjectId id, double atTime)
+{
+  const simData::ObjectType type = dataStore_.objectType(id);
+  if (type == simData::PLATFORM)
+    return isPlatformActive_(id, atTime);
+
+  const auto iter = results_.find(id);
+  if (iter != results_.end())
+    return iter->second;
+
+  bool rv = false;
+  switch (type)
+  {
+  case simData::BEAM:
+    rv = isBeamActive_(id, atTime);
+    break;
+
+  case simData::GATE:
+    rv = isGateActive_(id, atTime);
+    break;
+
+  case simData::LASER:
+    rv = isLaserActive_(id, atTime);
+    break;
+
+  case simData::LOB_GROUP:
+    rv = isLobGroupActive_(id, atTime);
+    break;
+
+  case simData::PROJECTOR:
+    rv = true;
+    break;
+
+  case simData::CUSTOM_RENDERING:
+    rv = isCustomRenderingActive_(id, atTime);
+    break;
+
+  case simData::NONE:
+    // Entity does not exist; drop any index left behind
+    indices_.erase(id);
+    break;
+
+  default:
+    // The switch statement needs to be updated
+    assert(false);
+    break;
+  }
+
+  results_[id] = rv;
+  return rv;
+}
+
+bool EntityActivity::isPlatformActive_(ObjectId id, double atTime)
+{
+  const auto iter = platformResults_.find(id);
+  if (iter != platformResults_.end())
+    return iter->second;
+
+  bool rv = false;
+  if (dataStore_.dataLimiting())
+  {
+    simData::DataStore::Transaction txn;
+    const simData::CommonPrefs* prefs = dataStore_.commonPrefs(id, &txn);
+    rv = (prefs != nullptr) ? prefs->datadraw() : true;
+  }
+  else
+  {
+    const simData::PlatformUpdateSlice* slice = dataStore_.platformUpdateSlice(id);
+    if (slice != nullptr)
+    {
+      // static platforms are always active
+      rv = (slice->firstTime() == -1.0) || ((slice->firstTime() <= atTime) && (slice->lastTime() >= atTime));
+    }
+  }
+
+  platformResults_[id] = rv;
+  return rv;
+}
+
+bool EntityActivity::isBeamActive_(ObjectId id, double atTime)
+{
+  ObjectId hostId = 0;
+  bool isTarget = false;
+  {
+    simData::DataStore::Transaction propertyTrans;
+    const simData::BeamProperties* beamProperty = dataStore_.beamProperties(id, &propertyTrans);
+    if (beamProperty == nullptr)
+      return false;
+    hostId = beamProperty->hostid();
+    isTarget = (beamProperty->type() == simData::BeamProperties::TARGET);
+  }
+
+  // Host must be active
+  if (!isPlatformActive_(hostId, atTime))
+    return false;
+
+  const simData::BeamCommandSlice* slice = dataStore_.beamCommandSlice(id);
+  if (slice == nullptr || !dataDraw_(id, slice, atTime))
+    return false;
+
+  // Active depends on Beam Type
+  if (!isTarget)
+    return true;
+
+  // Verify that the target beam has a target and that the target is active
+  ObjectId targetId = 0;
+  if (!targetId_(id, slice, atTime, targetId))
+    return false;
+  return isPlatformActive_(targetId, atTime);
+}
+
+bool EntityActivity::isGateActive_(ObjectId id, double atTime)
+{
+  ObjectId hostId = 0;
+  {
+    simData::DataStore::Transaction propertyTrans;
+    const simData::GateProperties* gateProperty = dataStore_.gateProperties(id, &propertyTrans);
+    if (gateProperty == nullptr)
+      return false;
+    hostId = gateProperty->hostid();
+  }
+
+  // Host must be an active beam
+  if (dataStore_.objectType(hostId) != simData::BEAM || !isActive_(hostId, atTime))
+    return false;
+
+  const simData::GateCommandSlice* slice = dataStore_.gateCommandSlice(id);
+  return (slice != nullptr) && dataDraw_(id, slice, atTime);
+}
+
+bool EntityActivity::isLaserActive_(ObjectId id, double atTime)
+{
+  ObjectId hostId = 0;
+  {
+    simData::DataStore::Transaction propertyTrans;
+    const simData::LaserProperties* laserProperty = dataStore_.laserProperties(id, &propertyTrans);
+    if (laserProperty == nullptr)
+      return false;
+    hostId = laserProperty->hostid();
+  }
+
+  // Host must be active
+  if (!isPlatformActive_(hostId, atTime))
+    return false;
+
+  const simData::LaserCommandSlice* slice = dataStore_.laserCommandSlice(id);
+  return (slice != nullptr) && dataDraw_(id, slice, atTime);
+}
+
+bool EntityActivity::isLobGroupActive_(ObjectId id, double atTime)
+{
+  ObjectId hostId = 0;
+  {
+    simData::DataStore::Transaction propertyTrans;
+    const simData::LobGroupProperties* lobProperty = dataStore_.lobGroupProperties(id, &propertyTrans);
+    if (lobProperty == nullptr)
+      return false;
+    hostId = lobProperty->hostid();
+  }
+
+  // LOB do NOT have datadraw command; LOBs are always on when the host is active
+  return isPlatformActive_(hostId, atTime);
+}
+
+bool EntityActivity::isCustomRenderingActive_(ObjectId id, double atTime)
+{
+  ObjectId hostId = 0;
+  {
+    simData::DataStore::Transaction propertyTrans;
+    const simData::CustomRenderingProperties* property = dataStore_.customRenderingProperties(id, &propertyTrans);
+    if (property == nullptr)
+      return false;
+    hostId = property->hostid();
+  }
+
+  // Custom Renderings can be top-level entities, ignore host if host ID is 0
+  if (hostId != 0 && !isPlatformActive_(hostId, atTime))
+    return false;
+
+  const simData::CustomRenderingCommandSlice* slice = dataStore_.customRenderingCommandSlice(id);
+  return (slice != nullptr) && dataDraw_(id, slice, atTime);
+}
+
+template <typename CommandType>
+bool EntityActivity::dataDraw_(ObjectId id, const DataSlice<CommandType>* slice, double atTime)
+{
+  const CommandIndex* index = index_(id, slice);
+  if (index != nullptr)
+    return valueAsOf(index->drawTimes, index->drawValues, atTime, false);
+
+  // Slice does not track revisions; search back for the last draw command
+  auto iter = slice->upper_bound(atTime);
+  while (iter.hasPrevious())
+  {
+    const CommandType* command = iter.previous();
+    if (command->has_time() && command->updateprefs().commonprefs().has_datadraw())
+      return command->updateprefs().commonprefs().datadraw();
+  }
+  return false;
+}
+
+template <typename CommandType>
+bool EntityActivity::targetId_(ObjectId id, const DataSlice<CommandType>* slice, double atTime, ObjectId& targetId)
+{
+  const CommandIndex* index = index_(id, slice);
+  if (index != nullptr)
+  {
+    const auto iter = std::upper_bound(index->targetTimes.begin(), index->targetTimes.end(), atTime);
+    if (iter == index->targetTimes.begin())
+      return false;
+    targetId = index->targetIds[(iter - index->targetTimes.begin()) - 1];
+    return true;
+  }
+
+  // Slice does not track revisions; search back for the last target command
+  auto iter = slice->upper_bound(atTime);
+  while (iter.hasPrevious())
+  {
+    const CommandType* command = iter.previous();
+    if (command->has_time() && command->updateprefs().has_targetid())
+    {
+      targetId = command->updateprefs().targetid();
+      return true;
+    }
+  }
+  return false;
+}
+
+template <typename CommandType>
+const EntityActivity::CommandIndex* EntityActivity::index_(ObjectId id, const DataSlice<CommandType>* slice)
+{
+  const uint64_t revision = slice->revision();
+  if (revision == 0)
+    return nullptr;
+
+  CommandIndex& index = indices_[id];
+  if (index.slice == slice && index.revision == revision)
+    return &index;
+
+  // Rebuild from the start; appends are rare relative to evaluations
+  ++numIndexBuilds_;
+  index.slice = slice;
+  index.revision = revision;
+  index.drawTimes.clear();
+  index.drawValues.clear();
+  index.targetTimes.clear();
+  index.targetIds.clear();
+  typename DataSlice<CommandType>::Iterator iter(slice);
+  while (iter.hasNext())
+  {
+    const CommandType* command = iter.next();
+    if (!command->has_time())
+      continue;
+    if (command->updateprefs().commonprefs().has_datadraw())
+      addChange(index.drawTimes, index.drawValues, command->time(), command->updateprefs().commonprefs().datadraw());
+    addTargetChange(*command, index.targetTimes, index.targetIds);
+  }
+  return &index;
+}
+
+}
@@ -0,0 +1,119 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_ENTITYACTIVITY_H
+#define SIMDATA_ENTITYACTIVITY_H
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "simData/ObjectId.h"
+
+namespace simData {
+
+class DataStore;
+template<typename T> class DataSlice;
+
+/**
+ * Evaluates entity activity, giving the same answers as DataStoreHelpers::isEntityActive(), for many
+ * entities at a time.  Host and target platforms are evaluated once per call no matter how many entities
+ * depend on them, and the data draw and target id commands of each entity are kept in an as-of index
+ * that is looked up with a binary search.  The index is rebuilt from a command slice only after the
+ * slice's revision() changes; slices that do not track revisions are searched directly every time.
+ */
+class SDKDATA_EXPORT EntityActivity
+{
+public:
+  /** Constructs an evaluator on the given data store, which must outlive this instance */
+  explicit EntityActivity(const DataStore& dataStore);
+  virtual ~EntityActivity();
+
+  /** Returns true if the entity is active at the given time; same as DataStoreHelpers::isEntityActive() */
+  bool isActive(ObjectId id, double atTime);
+
+  /**
+   * Evaluates activity for all of the given entities at one time
+   * @param ids Entities to evaluate
+   * @param atTime Data store time to evaluate
+   * @param active Filled with the activity of each entry in ids, in the same order
+   */
+  void evaluate(const std::vector<ObjectId>& ids, double atTime, std::vector<bool>& active);
+
+  /**
+   * Retrieves all entities of the given type that are active at the given time
+   * @param atTime Data store time to evaluate
+   * @param activeIds Filled with the active entities, in data store order
+   * @param type Type of entities to evaluate; may be a combination of types
+   */
+  void activeEntities(double atTime, std::vector<ObjectId>& activeIds, simData::ObjectType type = simData::ALL);
+
+  /** Discards the command index; the entry of a removed entity is otherwise dropped the next time it is evaluated */
+  void clear();
+
+  /** Number of times the command index was built or rebuilt for a slice, for testing */
+  size_t numIndexBuilds() const;
+
+private:
+  /** Data draw and target id changes of a single command slice */
+  struct CommandIndex
+  {
+    const void* slice = nullptr;
+    uint64_t revision = 0;
+    std::vector<double> drawTimes;
+    std::vector<bool> drawValues;
+    std::vector<double> targetTimes;
+    std::vector<ObjectId> targetIds;
+  };
+
+  /** Returns the activity of an entity, using the results from earlier in this pass when available */
+  bool isActive_(ObjectId id, double atTime);
+  /** Evaluates the platform rules for the given ID, which is the check applied to hosts and targets */
+  bool isPlatformActive_(ObjectId id, double atTime);
+  bool isBeamActive_(ObjectId id, double atTime);
+  bool isGateActive_(ObjectId id, double atTime);
+  bool isLaserActive_(ObjectId id, double atTime);
+  bool isLobGroupActive_(ObjectId id, double atTime);
+  bool isCustomRenderingActive_(ObjectId id, double atTime);
+
+  /** Returns the data draw state of the slice at the given time, false if it has never been set */
+  template <typename CommandType>
+  bool dataDraw_(ObjectId id, const DataSlice<CommandType>* slice, double atTime);
+  /** Retrieves the target ID in effect at the given time; returns false if there is none */
+  template <typename CommandType>
+  bool targetId_(ObjectId id, const DataSlice<CommandType>* slice, double atTime, ObjectId& targetId);
+  /** Returns the up to date index for the slice, or nullptr if the slice does not track revisions */
+  template <typename CommandType>
+  const CommandIndex* index_(ObjectId id, const DataSlice<CommandType>* slice);
+
+  const DataStore& dataStore_;
+  std::map<ObjectId, CommandIndex> indices_;
+  /// Entity results of the current pass
+  std::unordered_map<ObjectId, bool> results_;
+  /// Platform check results of the current pass, for hosts and targets
+  std::unordered_map<ObjectId, bool> platformResults_;
+  size_t numIndexBuilds_;
+};
+
+}
+
+#endif /* SIMDATA_ENTITYACTIVITY_H */
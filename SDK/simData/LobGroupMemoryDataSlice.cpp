@@ -30,7 +30,9 @@ LobGroupMemoryDataSlice::LobGroupMemoryDataSlice()
   :MemoryDataSlice<LobGroupUpdate>(),
   maxDataPoints_(std::numeric_limits<int>::max()),
   maxDataSeconds_(std::numeric_limits<double>::max()),
-  currentTime_(0.0)
+  currentTime_(0.0),
+  rebuildWindow_(true),
+  numPointsCopied_(0)
 {}
 
 
@@ -49,6 +51,9 @@ void LobGroupMemoryDataSlice::update(double time)
   if (!dirty_ && currentTime_ == time)
     return;
 
+  // the window can only be advanced in place when moving forward in time
+  if (time < currentTime_)
+    rebuildWindow_ = true;
   currentTime_ = time;
   dirty_ = false;
 
@@ -77,32 +82,66 @@ void LobGroupMemoryDataSlice::update(double time)
   // we picked a start___Iter that is AFTER the current time, which shouldn't be feasible.
   assert(useIter <= curTimeIter);
 
-  // create the new update
-  LobGroupUpdate* currentUpdate = new LobGroupUpdate();
-  currentUpdate->set_time(time);
-  for (; useIter != curTimeIter; ++useIter)
+  const bool hadCurrent = (current_ != nullptr);
+  if (rebuildWindow_ || current_ == nullptr)
+    rebuildCurrent_(useIter, curTimeIter);
+  else
   {
-    // copy all points from each update record to the new current update
-    for (int pointIndex = 0; pointIndex < (*useIter)->datapoints().size(); pointIndex++)
+    // drop the points of updates that have aged out of the front of the window
+    const double windowStart = (useIter == curTimeIter) ? std::numeric_limits<double>::max() : (*useIter)->time();
+    int expiredPoints = 0;
+    while (!window_.empty() && window_.front().first < windowStart)
     {
-      LobGroupUpdatePoint* newPoint = currentUpdate->add_datapoints();
-      newPoint->CopyFrom((*useIter)->datapoints(pointIndex));
+      expiredPoints += window_.front().second;
+      window_.pop_front();
     }
+    if (expiredPoints > 0)
+      current_->mutable_datapoints()->DeleteSubrange(0, expiredPoints);
+
+    // append the points of updates that entered the window since the last update
+    std::deque<LobGroupUpdate*>::const_iterator newIter = useIter;
+    if (!window_.empty())
+      newIter = std::upper_bound(useIter, curTimeIter, window_.back().first, UpdateComp<LobGroupUpdate>());
+    for (; newIter != curTimeIter; ++newIter)
+      appendToCurrent_(**newIter);
   }
 
-  // remove the old current_ object here, since we are replacing it
-  delete current_;
-  // only pass in the currentUpdate if it has data points
-  if (currentUpdate->datapoints_size())
+  // only keep the current_ object if it has data points
+  if (current_->datapoints_size() == 0)
   {
+    delete current_;
     current_ = nullptr;
-    setCurrent(currentUpdate);
-  }
-  else // set current to nullptr, need to call setCurrent to trigger update flag
-  {
-    delete currentUpdate;
-    setCurrent(nullptr);
+    window_.clear();
   }
+  else
+    current_->set_time(time);
+
+  // current_ content changes with each time update; need to trigger update flag if there was or is a current_
+  if (hadCurrent || current_ != nullptr)
+    setChanged();
+}
+
+void LobGroupMemoryDataSlice::rebuildCurrent_(std::deque<LobGroupUpdate*>::const_iterator begin, std::deque<LobGroupUpdate*>::const_iterator end)
+{
+  rebuildWindow_ = false;
+  window_.clear();
+  delete current_;
+  current_ = new LobGroupUpdate();
+  for (; begin != end; ++begin)
+    appendToCurrent_(**begin);
+}
+
+void LobGroupMemoryDataSlice::appendToCurrent_(const LobGroupUpdate& update)
+{
+  // copy all points from the update record to the current update
+  current_->mutable_datapoints()->MergeFrom(update.datapoints());
+  window_.push_back(std::make_pair(update.time(), update.datapoints_size()));
+  numPointsCopied_ += update.datapoints_size();
+}
+
+size_t LobGroupMemoryDataSlice::numPointsCopied() const
+{
+  return numPointsCopied_;
 }
 
 void LobGroupMemoryDataSlice::flush(bool keepStatic)
@@ -112,6 +151,7 @@ void LobGroupMemoryDataSlice::flush(bool keepStatic)
     delete current_;
     current_ = nullptr;
   }
+  rebuildWindow_ = true;
   dirty_ = true;
 }
 
@@ -122,11 +162,13 @@ void LobGroupMemoryDataSlice::flush(double startTime, double endTime)
     delete current_;
     current_ = nullptr;
   }
+  rebuildWindow_ = true;
   dirty_ = true;
 }
 
 void LobGroupMemoryDataSlice::insert(LobGroupUpdate *data)
 {
+  const double time = data->time();
   // first, ensure that all data points have the time of the LobGroupUpdate they are associated with
   for (int pointIndex = 0; pointIndex < data->datapoints().size(); pointIndex++)
   {
@@ -152,6 +194,9 @@ void LobGroupMemoryDataSlice::insert(LobGroupUpdate *data)
     std::deque<LobGroupUpdate*>::iterator iter = std::upper_bound(updates_.begin(), updates_.end(), data, UpdateComp<LobGroupUpdate>());
     updates_.insert(iter, data);
   }
+  // data at or before the end of the window changes points already copied into current_
+  if (!window_.empty() && window_.back().first >= time)
+    rebuildWindow_ = true;
   dirty_ = true;
 }
 
@@ -161,6 +206,7 @@ void LobGroupMemoryDataSlice::setMaxDataPoints(size_t maxDataPoints)
   if (maxDataPoints_ != maxDataPoints)
   {
     maxDataPoints_ = maxDataPoints;
+    rebuildWindow_ = true;
     dirty_ = true;
   }
 }
@@ -170,6 +216,7 @@ void LobGroupMemoryDataSlice::setMaxDataSeconds(double maxDataSeconds)
   if (maxDataSeconds_ != maxDataSeconds)
   {
     maxDataSeconds_ = maxDataSeconds;
+    rebuildWindow_ = true;
     dirty_ = true;
   }
 }
@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <limits>
+#include "simData/CommandPrefsHistory.h"
 #include "simData/DataStore.h"
 #include "simData/MessageVisitor/Message.h"
 #include "simData/MessageVisitor/MessageVisitor.h"
@@ -529,7 +530,8 @@ template<class CommandType, class PrefType>
 MemoryCommandSlice<CommandType, PrefType>::MemoryCommandSlice()
 : lastUpdateTime_(-std::numeric_limits<double>::max()),
   hasChanged_(false),
-  earliestInsert_(std::numeric_limits<double>::max())
+  earliestInsert_(std::numeric_limits<double>::max()),
+  revision_(1)
 {
 }
 
@@ -574,6 +576,9 @@ void MemoryCommandSlice<CommandType, PrefType>::modify(typename DataSlice<Comman
     else
       ++index;
   }
+  ++revision_;
+  if (history_)
+    history_->invalidate();
   // force a recalculation of commandPrefsCache_; less than optional solution
   // when necessary a future solution should reset the individual field
   reset_();
@@ -584,6 +589,9 @@ void MemoryCommandSlice<CommandType, PrefType>::flush()
 {
   MemorySliceHelper::flush(updates_);
   earliestInsert_ = std::numeric_limits<double>::max();
+  ++revision_;
+  if (history_)
+    history_->clear();
 }
 
 template<class CommandType, class PrefType>
@@ -591,6 +599,9 @@ void MemoryCommandSlice<CommandType, PrefType>::flush(double startTime, double e
 {
   MemorySliceHelper::flush(updates_, startTime, endTime);
   earliestInsert_ = std::numeric_limits<double>::max();
+  ++revision_;
+  if (history_)
+    history_->invalidate();
 }
 
 template<class CommandType, class PrefType>
@@ -613,6 +624,19 @@ void MemoryCommandSlice<CommandType, PrefType>::insert(CommandType *data)
   typename std::deque<CommandType*>::iterator iter = std::lower_bound(updates_.begin(), updates_.end(), data, UpdateComp<CommandType>());
   if (data->time() < earliestInsert_)
     earliestInsert_ = data->time();
+  ++revision_;
+  if (history_)
+  {
+    // appending in time order (or merging into the last command) keeps the history in sync; anything else requires a rebuild
+    if (iter == updates_.end() || (iter + 1 == updates_.end() && (*iter)->time() == data->time()))
+    {
+      if (data->has_updateprefs())
+        history_->add(data->time(), data->isclearcommand(), data->updateprefs());
+    }
+    else
+      history_->invalidate();
+  }
+
   if ((iter == updates_.end()) || (*iter)->time() != data->time())
   {
     // the transaction owns the data item, transfers ownership to the deque here
@@ -694,7 +718,7 @@ void MemoryCommandSlice<CommandType, PrefType>::update(DataStore *ds, ObjectId i
   if ((!lastCommand || time >= lastCommand->time()) && (earliestInsert_ > lastUpdateTime_))
   {
     // time moved forward: execute all commands from lastUpdateTime_ to new current time
-    hasChanged_ = advance_(lastUpdateTime_, time);
+    hasChanged_ = advanceTo_(time);
 
     // Check for repeated scalars in the command, forcing complete replacement instead of add-value
     conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
@@ -709,8 +733,8 @@ void MemoryCommandSlice<CommandType, PrefType>::update(DataStore *ds, ObjectId i
     // reset lastUpdateTime_
     reset_();
 
-    // advance time forward, execute all commands from 0.0 (use -1.0 since we need a time before 0.0) to new current time
-    advance_(-1.0, time);
+    // rebuild the command state from the start to new current time
+    replay_(time);
     conditionalClearRepeatedFields_(prefs, &commandPrefsCache_);
 
     hasChanged_ = true;
@@ -726,14 +750,27 @@ void MemoryCommandSlice<CommandType, PrefType>::update(DataStore *ds, ObjectId i
 template<class CommandType, class PrefType>
 void MemoryCommandSlice<CommandType, PrefType>::limitByTime(double timeWindow)
 {
-  if (timeWindow >= 0)
-    MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow);
+  if (timeWindow < 0)
+    return;
+  const size_t oldSize = updates_.size();
+  MemorySliceHelper::limitByTime(updates_, lastTime() - timeWindow);
+  if (updates_.size() == oldSize)
+    return;
+  ++revision_;
+  if (history_)
+    history_->invalidate();
 }
 
 template<class CommandType, class PrefType>
 void MemoryCommandSlice<CommandType, PrefType>::limitByPoints(uint32_t limitPoints)
 {
+  const size_t oldSize = updates_.size();
   MemorySliceHelper::limitByPoints(updates_, limitPoints);
+  if (updates_.size() == oldSize)
+    return;
+  ++revision_;
+  if (history_)
+    history_->invalidate();
 }
 
 template<class CommandType, class PrefType>
@@ -791,6 +828,12 @@ double MemoryCommandSlice<CommandType, PrefType>::deltaTime(double time) const
   return -1;
 }
 
+template<class CommandType, class PrefType>
+uint64_t MemoryCommandSlice<CommandType, PrefType>::revision() const
+{
+  return revision_;
+}
+
 template<class CommandType, class PrefType>
 bool MemoryCommandSlice<CommandType, PrefType>::advance_(double startTime, double time)
 {
@@ -827,6 +870,72 @@ bool MemoryCommandSlice<CommandType, PrefType>::advance_(double startTime, doubl
   return prefsWereUpdated;
 }
 
+template<class CommandType, class PrefType>
+void MemoryCommandSlice<CommandType, PrefType>::setSeekHistory(bool enable)
+{
+  if (enable == hasSeekHistory())
+    return;
+  if (!enable)
+  {
+    history_.reset();
+    return;
+  }
+  history_.reset(new CommandPrefsHistory);
+  // built from the existing commands on the next seek
+  if (!updates_.empty())
+    history_->invalidate();
+}
+
+template<class CommandType, class PrefType>
+bool MemoryCommandSlice<CommandType, PrefType>::hasSeekHistory() const
+{
+  return history_ != nullptr;
+}
+
+template<class CommandType, class PrefType>
+bool MemoryCommandSlice<CommandType, PrefType>::advanceTo_(double time)
+{
+  // only use a history that is already in sync; rebuilding it costs as much as the replay
+  if (history_ && history_->isValid() && time >= lastUpdateTime_)
+  {
+    const size_t pending = history_->numCommands(lastUpdateTime_, time);
+    if (pending > history_->numFields())
+    {
+      commandPrefsCache_.Clear();
+      lastUpdateTime_ = -std::numeric_limits<double>::max();
+      history_->seek(time, commandPrefsCache_, lastUpdateTime_);
+      return true;
+    }
+  }
+  return advance_(lastUpdateTime_, time);
+}
+
+template<class CommandType, class PrefType>
+void MemoryCommandSlice<CommandType, PrefType>::replay_(double time)
+{
+  if (syncHistory_() && history_->seek(time, commandPrefsCache_, lastUpdateTime_))
+    return;
+  // execute all commands from the start to new current time, matching forward playback, which does not skip negative times
+  advance_(-std::numeric_limits<double>::max(), time);
+}
+
+template<class CommandType, class PrefType>
+bool MemoryCommandSlice<CommandType, PrefType>::syncHistory_()
+{
+  if (!history_)
+    return false;
+  if (history_->isValid())
+    return true;
+
+  history_->clear();
+  for (const CommandType* cmd : updates_)
+  {
+    if (cmd->has_updateprefs())
+      history_->add(cmd->time(), cmd->isclearcommand(), cmd->updateprefs());
+  }
+  return history_->isValid();
+}
+
 template<class CommandType, class PrefType>
 void MemoryCommandSlice<CommandType, PrefType>::reset_()
 {
@@ -24,6 +24,7 @@
 #define SIMDATA_MEMORYDATASLICE_H
 
 #include <deque>
+#include <memory>
 #include "simData/DataTypes.h"
 #include "simData/DataSlice.h"
 #include "simData/DataSliceUpdaters.h"
@@ -33,6 +34,7 @@
 
 namespace simData
 {
+class CommandPrefsHistory;
 class DataStore;
 
 namespace MemorySliceHelper
@@ -334,6 +336,17 @@ public:
   /// this feature is not implemented for MemoryCommandSlice
   virtual bool isDirty() const;
 
+  /**
+   * Enable or disable the per-field change history of the commands.  The history speeds up backward
+   * seeks and large forward jumps, which otherwise replay every command from the start, at the cost
+   * of extra memory on top of the commands (roughly a sixth of the protobuf size).  Off by default.
+   * @param enable True to keep a history, false to release it and always replay commands
+   */
+  void setSeekHistory(bool enable);
+
+  /// Returns true if the per-field change history of the commands is enabled
+  bool hasSeekHistory() const;
+
   //--- effectively required interface
   /**
    * Insert the specified data within the MemoryDataSlice in time-based sorted order
@@ -403,6 +416,9 @@ public:
   /// Not Implemented; always returns -1;
   virtual double deltaTime(double time) const;
 
+  /// @copydoc simData::DataSlice::revision
+  virtual uint64_t revision() const;
+
 protected: // methods
   /**
    * Move "current" to specified time.
@@ -414,6 +430,24 @@ protected: // methods
    */
   bool advance_(double startTime, double time);
 
+  /**
+   * Move "current" forward to the specified time from lastUpdateTime_.  Equivalent to advance_(lastUpdateTime_, time),
+   * but seeks through the field history instead when that skips more commands than there are fields in the history.
+   * @param time current time
+   * @return True if a prefs was updated
+   */
+  bool advanceTo_(double time);
+
+  /**
+   * Rebuild the command state from the start of the data up to the specified time.  Call reset_() first.
+   * Uses the field history when available, otherwise replays all the commands.
+   * @param time current time
+   */
+  void replay_(double time);
+
+  /// Brings the field history in sync with updates_, rebuilding it if needed; returns false if no history is usable
+  bool syncHistory_();
+
   /// Set values to default
   void reset_();
 
@@ -454,6 +488,10 @@ protected: // data
   bool hasChanged_;
   /// Keeps track of the earliest command time insert since the last update(), to efficiently process command updates
   double earliestInsert_;
+  /// Optional per-field change history of the commands for fast seeks; nullptr (default) to always replay commands
+  std::unique_ptr<CommandPrefsHistory> history_;
+  /// Incremented on every change to updates_, including merges into existing commands
+  uint64_t revision_;
 };
 
 /**
@@ -542,13 +580,32 @@ public:
   */
   void setMaxDataSeconds(double maxDataSeconds);
 
+  /**
+  * Number of LobGroupUpdatePoints copied into the current data slice since construction.  Time
+  * changes only copy points from updates that enter the window, so this grows with the data
+  * entering the window rather than with the size of the window.
+  * @return count of points copied into current()
+  */
+  size_t numPointsCopied() const;
+
 private:
+  /// rebuilds current_ from scratch, copying every point in the window [begin, end)
+  void rebuildCurrent_(std::deque<LobGroupUpdate*>::const_iterator begin, std::deque<LobGroupUpdate*>::const_iterator end);
+  /// appends the points of the given update to current_ and records it in window_
+  void appendToCurrent_(const LobGroupUpdate& update);
+
   /// defines the max number of data points in the data slice
   size_t maxDataPoints_;
   /// defines the max age for data points in the data slice
   double  maxDataSeconds_;
   /// cache last update time
   double currentTime_;
+  /// time and point count of each update whose points are currently copied into current_, in time order
+  std::deque<std::pair<double, int> > window_;
+  /// true when current_ and window_ can no longer be advanced incrementally and must be rebuilt
+  bool rebuildWindow_;
+  /// running count of points copied into current_
+  size_t numPointsCopied_;
 };
 
 } // End of namespace simData
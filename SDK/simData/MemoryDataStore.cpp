@@ -325,6 +325,7 @@ MemoryDataStore::MemoryDataStore()
   interpolator_(nullptr),
   newUpdatesListener_(new DefaultNewUpdatesListener),
   dataLimiting_(false),
+  commandSeekHistory_(false),
   categoryNameManager_(new CategoryNameManager),
   dataLimitsProvider_(nullptr),
   dataTableManager_(nullptr),
@@ -346,6 +347,7 @@ MemoryDataStore::MemoryDataStore(const ScenarioProperties &properties)
   interpolator_(nullptr),
   newUpdatesListener_(new DefaultNewUpdatesListener),
   dataLimiting_(false),
+  commandSeekHistory_(false),
   categoryNameManager_(new CategoryNameManager),
   dataLimitsProvider_(nullptr),
   dataTableManager_(nullptr),
@@ -1055,6 +1057,20 @@ bool MemoryDataStore::dataLimiting() const
   return dataLimiting_;
 }
 
+void MemoryDataStore::setCommandSeekHistory(bool enable)
+{
+  commandSeekHistory_ = enable;
+  for (Beams::const_iterator iter = beams_.begin(); iter != beams_.end(); ++iter)
+    iter->second->commands()->setSeekHistory(enable);
+  for (Gates::const_iterator iter = gates_.begin(); iter != gates_.end(); ++iter)
+    iter->second->commands()->setSeekHistory(enable);
+}
+
+bool MemoryDataStore::commandSeekHistory() const
+{
+  return commandSeekHistory_;
+}
+
 void MemoryDataStore::flush(ObjectId flushId, FlushType flushType)
 {
   if (flushId == 0)
@@ -2131,6 +2147,8 @@ BeamCommand *MemoryDataStore::addBeamCommand(ObjectId id, Transaction *transacti
 
   // Setup transaction
   MemoryCommandSlice<BeamCommand, BeamPrefs> *slice = entry->commands();
+  // entities added after setCommandSeekHistory() pick up the setting with their first command
+  slice->setSeekHistory(commandSeekHistory_);
   // Note that Command doesn't change the time bounds for this data store
   *transaction = Transaction(new NewUpdateTransactionImpl<BeamCommand, MemoryCommandSlice<BeamCommand, BeamPrefs> >(command, slice, this, id, false));
 
@@ -2172,6 +2190,8 @@ GateCommand *MemoryDataStore::addGateCommand(ObjectId id, Transaction *transacti
 
   // Setup transaction
   MemoryCommandSlice<GateCommand, GatePrefs> *slice = entry->commands();
+  // entities added after setCommandSeekHistory() pick up the setting with their first command
+  slice->setSeekHistory(commandSeekHistory_);
   // Note that Command doesn't change the time bounds for this data store
   *transaction = Transaction(new NewUpdateTransactionImpl<GateCommand, MemoryCommandSlice<GateCommand, GatePrefs> >(command, slice, this, id, false));
 
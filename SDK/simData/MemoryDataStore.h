@@ -84,6 +84,16 @@ public:
   /// returns flag indicating if data limiting is set
   virtual bool dataLimiting() const;
 
+  /**
+  * Enable or disable the per-field command history on beams and gates, applying to existing and new entities.
+  * The history trades memory for faster backward seeks; see MemoryCommandSlice::setSeekHistory().  Off by default.
+  * @param[in] enable True to keep a command history for seeks
+  */
+  void setCommandSeekHistory(bool enable);
+
+  /// returns flag indicating if beams and gates keep a command history for seeks
+  bool commandSeekHistory() const;
+
   /// flush all the updates, command, category data and generic data for the specified id,
   /// if 0 is passed in flushes the entire scenario, except for static entities
   virtual void flush(ObjectId flushId, FlushType type = NON_RECURSIVE);
@@ -716,6 +726,8 @@ private:
   NewUpdatesListenerPtr newUpdatesListener_;
   /// Flag indicating if data limiting is set
   bool dataLimiting_;
+  /// Flag indicating if beam and gate command slices keep a history for seeks
+  bool commandSeekHistory_;
   /// The CategoryNameManager coordinates string/int values
   CategoryNameManager* categoryNameManager_;
   /// Correlates data store preferences to limit values for the table manager
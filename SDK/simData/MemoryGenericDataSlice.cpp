@@ -69,9 +69,11 @@ public:
     struct TimeValuePair
     {
       double time;
+      double duration;
       std::string value;
-      TimeValuePair(double inTime, const std::string& inValue)
+      TimeValuePair(double inTime, double inDuration, const std::string& inValue)
         : time(inTime),
+          duration(inDuration),
           value(inValue)
       {}
     };
@@ -88,7 +90,7 @@ public:
       // verify that indexOffset_ is updated correctly; dev error if assert
       assert((index >= 0) && (index < static_cast<int>(values_.size())));
       const ValueIndex& cacheValue = values_[index];
-      remainingValues.push_back(TimeValuePair(timeIndex.time, cacheValue.value));
+      remainingValues.push_back(TimeValuePair(timeIndex.time, timeIndex.duration, cacheValue.value));
     }
 
     // clear
@@ -96,7 +98,7 @@ public:
 
     // and rebuild
     for (const auto& pair : remainingValues)
-      insert(pair.time, pair.value, false);
+      insert(pair.time, pair.duration, pair.value, false);
   }
 
   /// If a value is no longer referenced remove it.
@@ -193,7 +195,7 @@ public:
   }
 
   /// if ignoreDuplicates is true; successive duplicate values, with different times, will not be added to times_
-  void insert(double time, const std::string& value, bool ignoreDuplicates)
+  void insert(double time, double duration, const std::string& value, bool ignoreDuplicates)
   {
     // Find location
     TimeList::iterator start = times_.end();
@@ -252,7 +254,7 @@ public:
     }
 
     // Finally add to the times_ list
-    times_.insert(start, TimeIndex(time, valueIndex));
+    times_.insert(start, TimeIndex(time, valueIndex, duration));
 
     // lazy update requires this
     lastUpdateDirty_ = true;
@@ -297,8 +299,8 @@ public:
     return key_;
   }
 
-  /** Retrieve the time and value at the given index, returning true on success */
-  bool getItem(size_t index, double& time, std::string& value) const
+  /** Retrieve the time, duration and value at the given index, returning true on success */
+  bool getItem(size_t index, double& time, double& duration, std::string& value) const
   {
     // Asking for an index that does not exist
     assert(index < times_.size());
@@ -306,6 +308,7 @@ public:
       return false;
 
     time = times_[index].time;
+    duration = times_[index].duration;
     value = values_[times_[index].index - indexOffset_].value;
     return true;
   }
@@ -316,9 +319,11 @@ private:
   {
     double time;
     int index;
-    TimeIndex(double inTime = 0.0, int inIndex = 0)
+    double duration;  ///< Not applied by update(); kept so that visit() reproduces the inserted data
+    TimeIndex(double inTime = 0.0, int inIndex = 0, double inDuration = INFINITE_EXPIRATION_TIME)
       : time(inTime),
-        index(inIndex)
+        index(inIndex),
+        duration(inDuration)
     {}
   };
   typedef std::deque<TimeIndex> TimeList;
@@ -363,6 +368,7 @@ public:
     tag_ = key_.name();
     done_ = (key.numItems() == 0);
     index_ = 0;
+    duration_ = INFINITE_EXPIRATION_TIME;
     if (done_)
     {
       // List is empty, so initialize to empty
@@ -372,7 +378,7 @@ public:
     else
     {
       // Initialize the walk down with the first time/value pair
-      key_.getItem(index_, time_, value_);
+      key_.getItem(index_, time_, duration_, value_);
     }
   }
 
@@ -392,10 +398,16 @@ public:
     return time_;
   }
 
-  /// If the time matches the current time/value pair it is added to data and the time/value is advanced to the next pair
-  void add(double time, GenericData& data)
+  /// Returns the duration of the current time/value pair
+  double duration() const
   {
-    if (time == time_)
+    return duration_;
+  }
+
+  /// If the time and duration match the current time/value pair it is added to data and the time/value is advanced to the next pair
+  void add(double time, double duration, GenericData& data)
+  {
+    if ((time == time_) && (duration == duration_))
     {
       simData::GenericData_Entry* entry = data.add_entry();
       entry->set_key(tag_);
@@ -409,7 +421,7 @@ public:
       }
       else
       {
-        key_.getItem(index_, time_, value_);
+        key_.getItem(index_, time_, duration_, value_);
       }
     }
   }
@@ -420,6 +432,7 @@ private:
   bool done_;  ///< True means all time/value pairs have been processed
   size_t index_;  ///< The index into the time/value pair list
   double time_; ///< The time of the current time/value pair
+  double duration_; ///< The duration of the current time/value pair
   std::string value_; ///< The value of the current time/value pair
 };
 
@@ -483,6 +496,8 @@ void MemoryGenericDataSlice::insert(GenericData* data, bool ignoreDuplicates)
   if (data == nullptr)
     return;
 
+  // Duration is not applied, but is kept for visit()
+  const double duration = data->has_duration() ? data->duration() : INFINITE_EXPIRATION_TIME;
   for (int k = 0; k < data->entry_size(); ++k)
   {
     const std::string& key = data->entry(k).key();
@@ -492,11 +507,11 @@ void MemoryGenericDataSlice::insert(GenericData* data, bool ignoreDuplicates)
     if (it == genericData_.end())
     {
       Key* newKey = new Key(key);
-      newKey->insert(data->time(), value, ignoreDuplicates);
+      newKey->insert(data->time(), duration, value, ignoreDuplicates);
       genericData_[key] = newKey;
     }
     else
-      it->second->insert(data->time(), value, ignoreDuplicates);
+      it->second->insert(data->time(), duration, value, ignoreDuplicates);
   }
 
   delete data;
@@ -559,22 +574,26 @@ void MemoryGenericDataSlice::visit(Visitor *visitor) const
     if (done)
       break;
 
-    // Find earliest time
+    // Find earliest time, and the duration of the first key at that time
     double time = std::numeric_limits<double>::max();
+    double duration = INFINITE_EXPIRATION_TIME;
     for (std::deque<Collector>::const_iterator it = keys.begin(); it != keys.end(); ++it)
     {
       if (!it->isDone() && (it->time() < time))
+      {
         time = it->time();
+        duration = it->duration();
+      }
     }
 
-    // Make message
+    // Make message; keys at the same time with other durations go in later messages
     GenericData data;
     data.set_time(time);
-    data.set_duration(INFINITE_EXPIRATION_TIME);
+    data.set_duration(duration);
     for (std::deque<Collector>::iterator it = keys.begin(); it != keys.end(); ++it)
     {
       if (!it->isDone())
-        it->add(time, data);
+        it->add(time, duration, data);
     }
 
     // Do the visit
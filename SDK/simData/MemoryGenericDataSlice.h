@@ -33,7 +33,8 @@ namespace simData
 /**
  * Memory Data Store's Generic Data slice implementation.  For the sake of simplicity and performance,
  * non-infinite generic data is not respected in MemoryGenericDataSlice.  Instead, the non-infinite
- * expiration time is converted to an infinite expiration time.
+ * expiration time is converted to an infinite expiration time.  The duration is still kept, so that
+ * visit() reproduces the data as inserted, such as when copying to another data store.
  *
  * The algorithm attempts to balance two opposite use cases.  The first use case is Generic Data with
  * repeating values and the second use case is Generic Data with non-repeating values.  The algorithm
@@ -454,6 +454,57 @@ TableStatus SubTable::interpolate(TableColumnId columnId, double time, double& v
   return column->interpolate(value, time, interpolator);
 }
 
+void SubTable::resample(const std::vector<TableColumnId>& columnIds, const std::vector<double>& times,
+  DataTable::ResampleMethod method, const std::vector<double*>& outputs) const
+{
+  // Assertion failure means caller did not provide one output per column
+  assert(columnIds.size() == outputs.size());
+  if (times.empty() || timeContainer_->empty())
+    return;
+
+  std::vector<const DataColumn*> columns;
+  for (auto columnId : columnIds)
+    columns.push_back(findColumn_(columnId));
+
+  // Keep the iterator such that previous() is at or before the grid time and next() is after it
+  TimeContainer::Iterator iter = timeContainer_->upper_bound(times.front());
+  for (size_t t = 0; t < times.size(); ++t)
+  {
+    const double time = times[t];
+    while (iter.hasNext() && iter.peekNext().time() <= time)
+      iter.next();
+    // No extrapolation before the first sample
+    if (!iter.hasPrevious())
+      continue;
+
+    const TimeContainer::IteratorData before = iter.peekPrevious();
+    const bool holdValue = (method == DataTable::RESAMPLE_SAMPLE_AND_HOLD || before.time() == time || !iter.hasNext());
+    if (holdValue)
+    {
+      for (size_t c = 0; c < columns.size(); ++c)
+      {
+        double value = 0.0;
+        if (columns[c] != nullptr && columns[c]->getValue(before.isFreshBin(), before.index(), value).isSuccess())
+          outputs[c][t] = value;
+      }
+      continue;
+    }
+
+    const TimeContainer::IteratorData after = iter.peekNext();
+    for (size_t c = 0; c < columns.size(); ++c)
+    {
+      double lowValue = 0.0;
+      double highValue = 0.0;
+      if (columns[c] != nullptr &&
+        columns[c]->getValue(before.isFreshBin(), before.index(), lowValue).isSuccess() &&
+        columns[c]->getValue(after.isFreshBin(), after.index(), highValue).isSuccess())
+      {
+        outputs[c][t] = simCore::linearInterpolate(lowValue, highValue, before.time(), time, after.time());
+      }
+    }
+  }
+}
+
 SubTable::AddRowTransactionPtr SubTable::addRow(double timeStamp, SplitObserverPtr splitObserver)
 {
   return AddRowTransactionPtr(new AddRowTransactionImpl(*this, timeStamp, splitObserver));
@@ -137,6 +137,17 @@ public:
    */
   TableStatus interpolate(TableColumnId columnId, double time, double& value, const TableColumn::Interpolator* interpolator) const;
 
+  /**
+   * Resamples columns of this subtable onto a sorted time grid, with a single walk of the shared
+   * time container.  Only writes outputs where a column has a value; see DataTable::resample().
+   * @param columnIds Columns in this subtable to resample
+   * @param times Time grid, sorted in ascending order
+   * @param method Method used for times between samples
+   * @param outputs One output array per column ID, each with room for times.size() values
+   */
+  void resample(const std::vector<TableColumnId>& columnIds, const std::vector<double>& times,
+    DataTable::ResampleMethod method, const std::vector<double*>& outputs) const;
+
   /**
    * Removes all rows from the subtable.
    */
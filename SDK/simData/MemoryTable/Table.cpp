@@ -537,6 +537,34 @@ void Table::flush(double startTime, double endTime)
   }
 }
 
+TableStatus Table::resample(const std::vector<TableColumnId>& columnIds, const std::vector<double>& times,
+  ResampleMethod method, std::vector<double>& values, double noValue) const
+{
+  values.assign(columnIds.size() * times.size(), noValue);
+  if (!std::is_sorted(times.begin(), times.end()))
+    return TableStatus::Error("Resample times must be sorted.");
+
+  // Group columns by subtable, so each shared time container is walked only once
+  std::map<SubTable*, std::pair<std::vector<TableColumnId>, std::vector<double*> > > bySubTable;
+  TableStatus rv = TableStatus::Success();
+  for (size_t c = 0; c < columnIds.size(); ++c)
+  {
+    std::map<TableColumnId, TableToColumn>::const_iterator i = columns_.find(columnIds[c]);
+    if (i == columns_.end())
+    {
+      rv = TableStatus::Error("Invalid column index.");
+      continue;
+    }
+    auto& group = bySubTable[i->second.first];
+    group.first.push_back(columnIds[c]);
+    group.second.push_back(values.data() + c * times.size());
+  }
+
+  for (auto i = bySubTable.begin(); i != bySubTable.end(); ++i)
+    i->first->resample(i->second.first, times, method, i->second.second);
+  return rv;
+}
+
 void Table::addObserver(TableObserverPtr callback)
 {
   observers_.push_back(callback);
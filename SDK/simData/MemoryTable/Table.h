@@ -78,6 +78,9 @@ public:
   virtual DelayedFlushContainerPtr flush(TableColumnId id = -1);
   /** Remove rows in the given time range; up to but not including endTime */
   virtual void flush(double startTime, double endTime);
+  /** @copydoc simData::DataTable::resample() */
+  virtual TableStatus resample(const std::vector<TableColumnId>& columnIds, const std::vector<double>& times,
+    ResampleMethod method, std::vector<double>& values, double noValue = std::numeric_limits<double>::quiet_NaN()) const;
   /** Add an observer for notification when rows or columns are added or removed */
   virtual void addObserver(TableObserverPtr callback);
   /** Remove an observer */
@@ -0,0 +1,345 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include "simData/CategoryData/CategoryNameManager.h"
+#include "simData/PrefRulesManager.h"
+#include "simData/PrefRuleIndex.h"
+
+namespace simData
+{
+
+size_t PrefRuleIndex::PairHash::operator()(const std::pair<int, int>& key) const
+{
+  const uint64_t combined = (static_cast<uint64_t>(static_cast<uint32_t>(key.first)) << 32) | static_cast<uint32_t>(key.second);
+  return std::hash<uint64_t>()(combined);
+}
+
+PrefRuleIndex::PrefRuleIndex()
+  : nextSequence_(0)
+{
+}
+
+PrefRuleIndex::~PrefRuleIndex()
+{
+}
+
+void PrefRuleIndex::addRule(PrefRule* rule)
+{
+  if (rule == nullptr || rules_.find(rule) != rules_.end())
+    return;
+
+  RuleEntry& entry = rules_[rule];
+  entry.sequence = nextSequence_++;
+  ordered_[entry.sequence] = rule;
+  register_(rule, entry);
+}
+
+void PrefRuleIndex::removeRule(PrefRule* rule)
+{
+  auto iter = rules_.find(rule);
+  if (iter == rules_.end())
+    return;
+  unregister_(rule, iter->second);
+  ordered_.erase(iter->second.sequence);
+  rules_.erase(iter);
+}
+
+void PrefRuleIndex::updateRule(PrefRule* rule)
+{
+  auto iter = rules_.find(rule);
+  if (iter == rules_.end())
+  {
+    addRule(rule);
+    return;
+  }
+
+  // Sequence is retained so that application order is unchanged
+  unregister_(rule, iter->second);
+  iter->second.anyValueNames.clear();
+  iter->second.valueKeys.clear();
+  register_(rule, iter->second);
+}
+
+void PrefRuleIndex::clear()
+{
+  rules_.clear();
+  ordered_.clear();
+  anyValue_.clear();
+  byValue_.clear();
+  entityValues_.clear();
+  nextSequence_ = 0;
+}
+
+bool PrefRuleIndex::hasRule(const PrefRule* rule) const
+{
+  return rules_.find(const_cast<PrefRule*>(rule)) != rules_.end();
+}
+
+size_t PrefRuleIndex::numRules() const
+{
+  return rules_.size();
+}
+
+void PrefRuleIndex::affectedRules(int nameInt, int oldValueInt, int newValueInt, std::vector<PrefRule*>& rules) const
+{
+  rules.clear();
+  if (oldValueInt == newValueInt)
+    return;
+  RuleSet ruleSet;
+  collectRules_(nameInt, oldValueInt, newValueInt, ruleSet);
+  sortRules_(ruleSet, rules);
+}
+
+void PrefRuleIndex::affectedRules(const CategoryFilter::CurrentCategoryValues& oldValues, const CategoryFilter::CurrentCategoryValues& newValues,
+  std::vector<PrefRule*>& rules) const
+{
+  rules.clear();
+  RuleSet ruleSet;
+
+  // Merge the two sorted maps, collecting rules for every name whose value differs
+  auto oldIter = oldValues.begin();
+  auto newIter = newValues.begin();
+  while (oldIter != oldValues.end() || newIter != newValues.end())
+  {
+    if (newIter == newValues.end() || (oldIter != oldValues.end() && oldIter->first < newIter->first))
+    {
+      collectRules_(oldIter->first, oldIter->second, CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, ruleSet);
+      ++oldIter;
+    }
+    else if (oldIter == oldValues.end() || newIter->first < oldIter->first)
+    {
+      collectRules_(newIter->first, CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, newIter->second, ruleSet);
+      ++newIter;
+    }
+    else
+    {
+      if (oldIter->second != newIter->second)
+        collectRules_(oldIter->first, oldIter->second, newIter->second, ruleSet);
+      ++oldIter;
+      ++newIter;
+    }
+  }
+
+  sortRules_(ruleSet, rules);
+}
+
+int PrefRuleIndex::applyChangedRules(uint64_t entityId, simData::DataStore& ds)
+{
+  CategoryFilter::CurrentCategoryValues newValues;
+  CategoryFilter::getCurrentCategoryValues(ds, entityId, newValues);
+
+  CategoryFilter::CurrentCategoryValues& values = entityValues_[entityId];
+  std::vector<PrefRule*> rules;
+  affectedRules(values, newValues, rules);
+  values.swap(newValues);
+  if (rules.empty())
+    return 0;
+
+  // A later unaffected rule may set the same pref as an affected rule, so reapply every matching rule from the
+  // first affected rule on to keep the last rule winning
+  const RuleSet affected(rules.begin(), rules.end());
+  int rv = 0;
+  for (auto iter = ordered_.find(rules_.find(rules.front())->second.sequence); iter != ordered_.end(); ++iter)
+  {
+    PrefRule* rule = iter->second;
+    if (affected.find(rule) == affected.end())
+    {
+      const CategoryFilter* filter = rule->categoryFilter();
+      if (filter != nullptr && !filter->matchData(values))
+        continue;
+    }
+    if (rule->apply(entityId, ds) != 0)
+      rv = 1;
+  }
+  return rv;
+}
+
+void PrefRuleIndex::removeEntity(uint64_t entityId)
+{
+  entityValues_.erase(entityId);
+}
+
+void PrefRuleIndex::collectRules_(int nameInt, int oldValueInt, int newValueInt, RuleSet& rules) const
+{
+  auto anyIter = anyValue_.find(nameInt);
+  if (anyIter != anyValue_.end())
+    rules.insert(anyIter->second.begin(), anyIter->second.end());
+
+  auto oldIter = byValue_.find(std::make_pair(nameInt, oldValueInt));
+  if (oldIter != byValue_.end())
+    rules.insert(oldIter->second.begin(), oldIter->second.end());
+
+  auto newIter = byValue_.find(std::make_pair(nameInt, newValueInt));
+  if (newIter != byValue_.end())
+    rules.insert(newIter->second.begin(), newIter->second.end());
+}
+
+void PrefRuleIndex::sortRules_(const RuleSet& ruleSet, std::vector<PrefRule*>& rules) const
+{
+  rules.assign(ruleSet.begin(), ruleSet.end());
+  std::sort(rules.begin(), rules.end(), [this](PrefRule* lhs, PrefRule* rhs) {
+    return rules_.find(lhs)->second.sequence < rules_.find(rhs)->second.sequence;
+  });
+}
+
+void PrefRuleIndex::register_(PrefRule* rule, RuleEntry& entry)
+{
+  const CategoryFilter* filter = rule->categoryFilter();
+  if (filter == nullptr)
+    return;
+
+  std::vector<int> names;
+  filter->getNames(names);
+  for (int nameInt : names)
+  {
+    if (nameInt == CategoryNameManager::NO_CATEGORY_NAME)
+      continue;
+
+    // Regular expressions supersede the value checks and can match any value
+    const RegExpFilter* regExp = filter->getRegExp(nameInt);
+    if (regExp != nullptr && !regExp->pattern().empty())
+    {
+      entry.anyValueNames.push_back(nameInt);
+      continue;
+    }
+
+    // Unchecked names do not participate in matching
+    const CategoryFilter::CategoryCheck& checks = filter->getCategoryFilter();
+    auto checkIter = checks.find(nameInt);
+    if (checkIter == checks.end() || !checkIter->second.first)
+      continue;
+
+    // Any transition between unlisted values may change result through the "Unlisted Value" entry
+    const CategoryFilter::ValuesCheck& values = checkIter->second.second;
+    if (values.find(CategoryNameManager::UNLISTED_CATEGORY_VALUE) != values.end())
+    {
+      entry.anyValueNames.push_back(nameInt);
+      continue;
+    }
+
+    // Otherwise only a transition to or from a listed value can change the result
+    for (const auto& valueCheck : values)
+      entry.valueKeys.push_back(std::make_pair(nameInt, valueCheck.first));
+  }
+
+  for (int nameInt : entry.anyValueNames)
+    anyValue_[nameInt].insert(rule);
+  for (const auto& key : entry.valueKeys)
+    byValue_[key].insert(rule);
+}
+
+void PrefRuleIndex::unregister_(PrefRule* rule, const RuleEntry& entry)
+{
+  for (int nameInt : entry.anyValueNames)
+  {
+    auto iter = anyValue_.find(nameInt);
+    if (iter == anyValue_.end())
+      continue;
+    iter->second.erase(rule);
+    if (iter->second.empty())
+      anyValue_.erase(iter);
+  }
+  for (const auto& key : entry.valueKeys)
+  {
+    auto iter = byValue_.find(key);
+    if (iter == byValue_.end())
+      continue;
+    iter->second.erase(rule);
+    if (iter->second.empty())
+      byValue_.erase(iter);
+  }
+}
+
+//---------------------------------------------------------------------------------------------------------------------------
+
+size_t PrefEnforcementIndex::TagStackHash::operator()(const std::deque<int>& tagStack) const
+{
+  // FNV-1a over the tags; stacks are short, typically 1 to 3 entries
+  uint64_t hash = 14695981039346656037ULL;
+  for (int tag : tagStack)
+  {
+    hash ^= static_cast<uint32_t>(tag);
+    hash *= 1099511628211ULL;
+  }
+  return static_cast<size_t>(hash);
+}
+
+PrefEnforcementIndex::PrefEnforcementIndex()
+  : size_(0)
+{
+}
+
+PrefEnforcementIndex::~PrefEnforcementIndex()
+{
+}
+
+void PrefEnforcementIndex::enforcePrefValue(simData::ObjectId id, const std::deque<int>& tagStack, bool enforce)
+{
+  if (enforce)
+  {
+    if (enforced_[id].insert(tagStack).second)
+      ++size_;
+    return;
+  }
+
+  auto iter = enforced_.find(id);
+  if (iter == enforced_.end())
+    return;
+  if (iter->second.erase(tagStack) != 0)
+  {
+    assert(size_ > 0);
+    --size_;
+  }
+  if (iter->second.empty())
+    enforced_.erase(iter);
+}
+
+bool PrefEnforcementIndex::isPrefValueEnforced(simData::ObjectId id, const std::deque<int>& tagStack) const
+{
+  auto iter = enforced_.find(id);
+  return iter != enforced_.end() && iter->second.find(tagStack) != iter->second.end();
+}
+
+void PrefEnforcementIndex::removeEntity(simData::ObjectId id)
+{
+  auto iter = enforced_.find(id);
+  if (iter == enforced_.end())
+    return;
+  size_ -= iter->second.size();
+  enforced_.erase(iter);
+}
+
+void PrefEnforcementIndex::clear()
+{
+  enforced_.clear();
+  size_ = 0;
+}
+
+size_t PrefEnforcementIndex::size() const
+{
+  return size_;
+}
+
+}
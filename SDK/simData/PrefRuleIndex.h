@@ -0,0 +1,180 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDATA_PREFRULEINDEX_H
+#define SIMDATA_PREFRULEINDEX_H
+
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "simCore/Common/Common.h"
+#include "simData/CategoryData/CategoryFilter.h"
+#include "simData/ObjectId.h"
+
+namespace simData
+{
+class DataStore;
+class PrefRule;
+
+/**
+ * Indexes preference rules by the category name/value pairs referenced by their category filters.  When an
+ * entity's category data changes, only the rules whose filters can change result are returned for re-evaluation,
+ * instead of applying every rule to the entity.
+ *
+ * A rule is indexed under (name, value) for every value listed in its filter for that name.  Names with a regular
+ * expression or an "Unlisted Value" entry can change result on any value transition, so those rules are indexed
+ * under the name alone.  Rules with an empty filter match every entity and are never affected by category changes.
+ *
+ * The index reads the filter when the rule is added.  Call updateRule() if a rule's filter changes afterwards.
+ * Rules are not owned by the index.
+ */
+class SDKDATA_EXPORT PrefRuleIndex
+{
+public:
+  PrefRuleIndex();
+  virtual ~PrefRuleIndex();
+
+  /** Adds the rule to the index.  Rules are returned in the order in which they were added. */
+  void addRule(PrefRule* rule);
+  /** Removes the rule from the index */
+  void removeRule(PrefRule* rule);
+  /** Re-reads the category filter of a rule already in the index; adds the rule if not present */
+  void updateRule(PrefRule* rule);
+  /** Removes all rules and all cached entity category values */
+  void clear();
+
+  /** Returns true if the rule has been added to the index */
+  bool hasRule(const PrefRule* rule) const;
+  /** Returns the number of rules in the index */
+  size_t numRules() const;
+
+  /**
+   * Retrieves the rules whose category filter result may change when the value of a category changes.
+   * @param[in] nameInt  category name that changed
+   * @param[in] oldValueInt  previous value; use CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME when not set
+   * @param[in] newValueInt  new value; use CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME when not set
+   * @param[out] rules  affected rules, in the order added, without duplicates
+   */
+  void affectedRules(int nameInt, int oldValueInt, int newValueInt, std::vector<PrefRule*>& rules) const;
+
+  /**
+   * Retrieves the rules whose category filter result may change when an entity's category values change.
+   * @param[in] oldValues  previous category values of the entity
+   * @param[in] newValues  new category values of the entity
+   * @param[out] rules  affected rules, in the order added, without duplicates
+   */
+  void affectedRules(const CategoryFilter::CurrentCategoryValues& oldValues, const CategoryFilter::CurrentCategoryValues& newValues,
+    std::vector<PrefRule*>& rules) const;
+
+  /**
+   * Compares the entity's current category values against those cached from the previous call, and applies
+   * the rules affected by the difference.  Rules may set the same preference, with the last rule winning, so
+   * every rule added after the first affected rule that currently matches the entity is applied again as well,
+   * in the order added.  The result is the same as applying all rules.  An entity not seen before is compared
+   * against having no category data, which is its state when all rules are applied on creation.
+   * @param[in] entityId  entity whose category data changed
+   * @param[in] ds  data store holding the entity
+   * @return 0 on success, non-zero if any rule failed to apply
+   */
+  int applyChangedRules(uint64_t entityId, simData::DataStore& ds);
+
+  /** Removes the cached category values for the given entity; call when the entity is removed */
+  void removeEntity(uint64_t entityId);
+
+private:
+  /** Index keys registered for a single rule, used to unregister it */
+  struct RuleEntry
+  {
+    /** Order in which the rule was added, used to sort results */
+    uint64_t sequence = 0;
+    /** Names under which the rule is registered for any value */
+    std::vector<int> anyValueNames;
+    /** Name/value pairs under which the rule is registered */
+    std::vector<std::pair<int, int> > valueKeys;
+  };
+
+  /** Hash for (name, value) keys */
+  struct PairHash
+  {
+    size_t operator()(const std::pair<int, int>& key) const;
+  };
+
+  typedef std::unordered_set<PrefRule*> RuleSet;
+
+  /** Adds the rules registered under the changed name to the output set */
+  void collectRules_(int nameInt, int oldValueInt, int newValueInt, RuleSet& rules) const;
+  /** Sorts the rules into insertion order */
+  void sortRules_(const RuleSet& ruleSet, std::vector<PrefRule*>& rules) const;
+  /** Reads the rule's category filter and adds its index keys to the entry */
+  void register_(PrefRule* rule, RuleEntry& entry);
+  /** Removes the index keys of the given entry */
+  void unregister_(PrefRule* rule, const RuleEntry& entry);
+
+  std::unordered_map<PrefRule*, RuleEntry> rules_;
+  /// Rules keyed by sequence, for application order
+  std::map<uint64_t, PrefRule*> ordered_;
+  std::unordered_map<int, RuleSet> anyValue_;
+  std::unordered_map<std::pair<int, int>, RuleSet, PairHash> byValue_;
+  std::unordered_map<uint64_t, CategoryFilter::CurrentCategoryValues> entityValues_;
+  uint64_t nextSequence_;
+};
+
+/**
+ * Constant-time store for the enforcement state of preference values, keyed on entity ID and the protobuf tag
+ * stack that identifies the preference.  Suitable for backing PrefRulesManager::enforcePrefValue() and
+ * PrefRulesManager::isPrefValueEnforced().
+ */
+class SDKDATA_EXPORT PrefEnforcementIndex
+{
+public:
+  PrefEnforcementIndex();
+  virtual ~PrefEnforcementIndex();
+
+  /** Turns enforcement of the preference on or off for the entity */
+  void enforcePrefValue(simData::ObjectId id, const std::deque<int>& tagStack, bool enforce = true);
+  /** Returns true if the preference is enforced for the entity */
+  bool isPrefValueEnforced(simData::ObjectId id, const std::deque<int>& tagStack) const;
+  /** Removes all enforced preferences for the entity */
+  void removeEntity(simData::ObjectId id);
+  /** Removes all enforced preferences */
+  void clear();
+  /** Returns the number of enforced preferences across all entities */
+  size_t size() const;
+
+private:
+  /** Hash for tag stacks */
+  struct TagStackHash
+  {
+    size_t operator()(const std::deque<int>& tagStack) const;
+  };
+
+  typedef std::unordered_set<std::deque<int>, TagStackHash> TagStackSet;
+  std::unordered_map<simData::ObjectId, TagStackSet> enforced_;
+  size_t size_;
+};
+
+}
+
+#endif // SIMDATA_PREFRULEINDEX_H
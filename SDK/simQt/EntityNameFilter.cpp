@@ -39,8 +39,12 @@ EntityNameFilter::EntityNameFilter(AbstractEntityTreeModel* model)
   : EntityFilter(),
     model_(model),
     regExp_(new RegExpImpl("")),
-    widget_(nullptr)
+    widget_(nullptr),
+    patternRevision_(1),
+    acceptRevision_(1),
+    numNameEvaluations_(0)
 {
+  connectModel_();
 }
 
 EntityNameFilter::~EntityNameFilter()
@@ -94,7 +98,56 @@ void EntityNameFilter::bindToWidget(EntityFilterLineEdit* widget)
 
 void EntityNameFilter::setModel(AbstractEntityTreeModel* model)
 {
+  if (model_ == model)
+    return;
+  if (model_ != nullptr)
+    disconnect(model_, nullptr, this, nullptr);
   model_ = model;
+  clearCache_();
+  connectModel_();
+}
+
+unsigned int EntityNameFilter::numNameEvaluations() const
+{
+  return numNameEvaluations_;
+}
+
+void EntityNameFilter::connectModel_()
+{
+  if (model_ == nullptr)
+    return;
+  // Name changes in the data store arrive as dataChanged() from the entity tree model
+  connect(model_, SIGNAL(dataChanged(QModelIndex, QModelIndex)), this, SLOT(invalidateNames_(QModelIndex, QModelIndex)));
+  connect(model_, SIGNAL(rowsInserted(QModelIndex, int, int)), this, SLOT(invalidateResults_()));
+  connect(model_, SIGNAL(rowsRemoved(QModelIndex, int, int)), this, SLOT(invalidateResults_()));
+  connect(model_, SIGNAL(rowsMoved(QModelIndex, int, int, QModelIndex, int)), this, SLOT(invalidateResults_()));
+  connect(model_, SIGNAL(layoutChanged()), this, SLOT(invalidateResults_()));
+  connect(model_, SIGNAL(modelReset()), this, SLOT(clearCache_()));
+}
+
+void EntityNameFilter::invalidateNames_(const QModelIndex& topLeft, const QModelIndex& bottomRight)
+{
+  if (model_ == nullptr)
+    return;
+  for (int row = topLeft.row(); row <= bottomRight.row(); ++row)
+  {
+    const QModelIndex idx = model_->index(row, 0, topLeft.parent());
+    if (idx.isValid())
+      cache_.erase(model_->uniqueId(idx));
+  }
+  // Ancestors of the changed entities may no longer pass
+  invalidateResults_();
+}
+
+void EntityNameFilter::invalidateResults_()
+{
+  ++acceptRevision_;
+}
+
+void EntityNameFilter::clearCache_()
+{
+  cache_.clear();
+  invalidateResults_();
 }
 
 void EntityNameFilter::setRegExp(const QRegExp& regExp)
@@ -137,7 +190,11 @@ void EntityNameFilter::setRegExpAttributes_(QString filter, Qt::CaseSensitivity
     changed = true;
   }
   if (changed)
+  {
+    ++patternRevision_;
+    invalidateResults_();
     Q_EMIT filterUpdated();
+  }
 }
 
 bool EntityNameFilter::acceptIndex_(const QModelIndex& index) const
@@ -146,27 +203,46 @@ bool EntityNameFilter::acceptIndex_(const QModelIndex& index) const
   const QAbstractItemModel* model = index.model();
   assert(model != nullptr);
   // Make sure pointers are valid
-  if ((model == nullptr) || (regExp_ == nullptr))
+  if ((model == nullptr) || (regExp_ == nullptr) || (model_ == nullptr))
     return false;
 
-  // Check if this index passes the filter, return true if it does
-  const QString name = model->data(index).toString();
-  bool rv = regExp_->match(name.toStdString());
-  if (rv)
-    return rv;
+  // References into std::map remain valid while children are inserted during recursion
+  CacheEntry& entry = cache_[model_->uniqueId(index)];
+  if (entry.acceptRevision == acceptRevision_)
+    return entry.accepted;
+
+  // Check if this index passes the filter, matching against the cached name
+  if (entry.matchRevision != patternRevision_)
+  {
+    if (!entry.hasName)
+    {
+      entry.name = model->data(index).toString();
+      entry.hasName = true;
+    }
+    entry.nameMatches = regExp_->matchQString(entry.name);
+    entry.matchRevision = patternRevision_;
+    ++numNameEvaluations_;
+  }
 
   // Index didn't pass, check its children
+  entry.accepted = entry.nameMatches || acceptChildren_(index);
+  entry.acceptRevision = acceptRevision_;
+  return entry.accepted;
+}
+
+bool EntityNameFilter::acceptChildren_(const QModelIndex& index) const
+{
+  const QAbstractItemModel* model = index.model();
   int numChildren = model->rowCount(index);
   for (int i = 0; i < numChildren; ++i)
   {
     const QModelIndex& childIdx = model->index(i, 0, index);
     // Check if this child index (or any of its children)
     // passes the filter, return true if any of them pass
-    rv = acceptIndex_(childIdx);
-    if (rv)
-      break;
+    if (acceptIndex_(childIdx))
+      return true;
   }
-  return rv;
+  return false;
 }
 
 }
@@ -23,6 +23,8 @@
 #ifndef SIMQT_ENTITY_NAME_FILTER_H
 #define SIMQT_ENTITY_NAME_FILTER_H
 
+#include <map>
+#include <QString>
 #include "simQt/EntityFilter.h"
 
 namespace simQt {
@@ -77,6 +79,9 @@ public:
   /** Update the model ptr */
   void setModel(AbstractEntityTreeModel* model);
 
+  /** Returns the number of regular expression evaluations performed against entity names; for testing */
+  unsigned int numNameEvaluations() const;
+
 public Q_SLOTS:
   /// Set the filter's QRegExp
   void setRegExp(const QRegExp& regExp);
@@ -84,10 +89,37 @@ public Q_SLOTS:
 private Q_SLOTS:
   /// Set the attributes of the QRegExp filter
   void setRegExpAttributes_(QString filter, Qt::CaseSensitivity caseSensitive, QRegExp::PatternSyntax expression);
+  /// Drops the cached names and results of entities whose data changed
+  void invalidateNames_(const QModelIndex& topLeft, const QModelIndex& bottomRight);
+  /// Drops cached results that depend on the tree structure, keeping names and name matches
+  void invalidateResults_();
+  /// Drops all cached names and results
+  void clearCache_();
 
 private:
+  /// Cached name and filter results for a single entity
+  struct CacheEntry
+  {
+    /// Entity name as reported by the model
+    QString name;
+    /// True if name has been fetched from the model
+    bool hasName = false;
+    /// Pattern revision that nameMatches was computed against
+    unsigned int matchRevision = 0;
+    /// True if the entity's own name matches the pattern
+    bool nameMatches = false;
+    /// Result revision that accepted was computed against
+    unsigned int acceptRevision = 0;
+    /// True if the entity or any of its children match the pattern
+    bool accepted = false;
+  };
+
   /// Recursively determines if the specified index or any of its children pass the filter
   bool acceptIndex_(const QModelIndex& idx) const;
+  /// Returns true if any of the children of the specified index pass the filter
+  bool acceptChildren_(const QModelIndex& idx) const;
+  /// Connects model_ signals to the cache invalidation slots
+  void connectModel_();
 
   // reference to the entity tree model for looking up entity name
   AbstractEntityTreeModel* model_;
@@ -95,6 +127,15 @@ private:
   RegExpImpl* regExp_;
   /// widget that generates a reg exp filter
   EntityFilterLineEdit* widget_;
+
+  /// Cached names and results by entity ID, so that repeated filter passes skip model lookups and string conversions
+  mutable std::map<uint64_t, CacheEntry> cache_;
+  /// Incremented whenever the pattern changes, invalidating cached name matches
+  unsigned int patternRevision_;
+  /// Incremented whenever the pattern, names, or tree structure changes, invalidating cached results
+  unsigned int acceptRevision_;
+  /// Number of regular expression evaluations, for testing
+  mutable unsigned int numNameEvaluations_;
 };
 
 }
@@ -21,9 +21,10 @@
  *
  */
 
+#include <vector>
 #include <QComboBox>
 #include "simData/DataStore.h"
-#include "simData/DataStoreHelpers.h"
+#include "simData/EntityActivity.h"
 #include "simQt/EntityStateFilter.h"
 
 namespace simQt {
@@ -55,23 +56,74 @@ private:
   EntityStateFilter& parent_;
 };
 
+/** Data changes, even without a time change, may change entity activity */
+class EntityStateFilter::DataStoreListener : public simData::DataStore::DefaultListener
+{
+public:
+  /** Constructor */
+  explicit DataStoreListener(EntityStateFilter& parent)
+    : parent_(parent)
+  {
+  }
+
+  virtual void onAddEntity(simData::DataStore* source, simData::ObjectId newId, simData::ObjectType ot)
+  {
+    parent_.activeValid_ = false;
+  }
+
+  virtual void onRemoveEntity(simData::DataStore* source, simData::ObjectId removedId, simData::ObjectType ot)
+  {
+    parent_.activeValid_ = false;
+  }
+
+  virtual void onPrefsChange(simData::DataStore* source, simData::ObjectId id)
+  {
+    parent_.activeValid_ = false;
+  }
+
+  virtual void onPropertiesChange(simData::DataStore* source, simData::ObjectId id)
+  {
+    parent_.activeValid_ = false;
+  }
+
+  /** Called on data store updates with new data, such as commands, as well as on time changes */
+  virtual void onChange(simData::DataStore* source)
+  {
+    parent_.activeValid_ = false;
+  }
+
+  virtual void onFlush(simData::DataStore* source, simData::ObjectId id)
+  {
+    parent_.activeValid_ = false;
+  }
+
+private:
+  EntityStateFilter& parent_;
+};
+
 
 //----------------------------------------------------------------------------------------------------
 
 
-EntityStateFilter::EntityStateFilter(const simData::DataStore& dataStore, simCore::Clock& clock, bool showWidget)
+EntityStateFilter::EntityStateFilter(simData::DataStore& dataStore, simCore::Clock& clock, bool showWidget)
   : EntityFilter(),
   dataStore_(dataStore),
   clock_(clock),
   showWidget_(showWidget),
-  state_(BOTH)
+  state_(BOTH),
+  activity_(new simData::EntityActivity(dataStore)),
+  activeValid_(false),
+  activeTime_(0.0)
 {
   clockAdapter_.reset(new TimeObserver(*this));
   clock_.registerTimeCallback(clockAdapter_);
+  dataStoreListener_.reset(new DataStoreListener(*this));
+  dataStore_.addListener(dataStoreListener_);
 }
 
 EntityStateFilter::~EntityStateFilter()
 {
+  dataStore_.removeListener(dataStoreListener_);
   clock_.removeTimeCallback(clockAdapter_);
 }
 
@@ -81,13 +133,40 @@ bool EntityStateFilter::acceptEntity(simData::ObjectId id) const
     return true;
 
   const double time = clock_.currentTime().secondsSinceRefYear(dataStore_.referenceYear());
-  // Assertion failure means that isEntityActive may return invalid values
+  // Assertion failure means that isActive may return invalid values
   assert(clock_.isLiveMode() == dataStore_.dataLimiting());
-  const bool isActive = simData::DataStoreHelpers::isEntityActive(dataStore_, id, time);
+  const bool isActive = isActive_(id, time);
 
   return (state_ == ACTIVE) ? isActive : !isActive;
 }
 
+bool EntityStateFilter::isActive_(simData::ObjectId id, double time) const
+{
+  // A filter pass checks every entity at one time, so evaluate them together; hosts are then evaluated once per pass.
+  // The data store listener invalidates the results when data that affects activity changes.
+  if (!activeValid_ || time != activeTime_)
+  {
+    simData::DataStore::IdList ids;
+    dataStore_.idList(&ids);
+    std::vector<bool> active;
+    activity_->evaluate(ids, time, active);
+    active_.clear();
+    for (size_t k = 0; k < ids.size(); ++k)
+      active_[ids[k]] = active[k];
+    activeValid_ = true;
+    activeTime_ = time;
+  }
+
+  const auto iter = active_.find(id);
+  if (iter != active_.end())
+    return iter->second;
+
+  // Entity added since the evaluation
+  const bool rv = activity_->isActive(id, time);
+  active_[id] = rv;
+  return rv;
+}
+
 QWidget* EntityStateFilter::widget(QWidget* newWidgetParent) const
 {
   // only generate the widget if we are set to show a widget
@@ -152,6 +231,7 @@ void EntityStateFilter::entityStateChanged_(int state)
 
 void EntityStateFilter::newTime_()
 {
+  activeValid_ = false;
   if (state_ != BOTH)
     Q_EMIT filterUpdated();
 }
@@ -23,11 +23,12 @@
 #ifndef SIMQT_ENTITY_STATE_FILTER_H
 #define SIMQT_ENTITY_STATE_FILTER_H
 
+#include <unordered_map>
 #include "simData/ObjectId.h"
 #include "simCore/Time/Clock.h"
 #include "simQt/EntityFilter.h"
 
-namespace simData { class CategoryFilter; class DataStore; }
+namespace simData { class CategoryFilter; class DataStore; class EntityActivity; }
 
 namespace simQt {
 
@@ -48,7 +49,7 @@ namespace simQt {
     * @param clock reference to clock object
     * @param showWidget flag to indicate if a widget should be created
     */
-    EntityStateFilter(const simData::DataStore& dataStore, simCore::Clock& clock, bool showWidget = false);
+    EntityStateFilter(simData::DataStore& dataStore, simCore::Clock& clock, bool showWidget = false);
 
     /** Destructor */
     virtual ~EntityStateFilter();
@@ -92,15 +93,23 @@ namespace simQt {
 
   private:
     class TimeObserver;
+    class DataStoreListener;
 
     /// Updates the filtering when time changes
     void newTime_();
+    /// Returns the activity of the entity, evaluating all entities at once when the time or data store changes
+    bool isActive_(simData::ObjectId id, double time) const;
 
-    const simData::DataStore& dataStore_;  ///< reference to the data store
+    simData::DataStore& dataStore_;  ///< reference to the data store
     simCore::Clock& clock_; ///< reference to the clock
     bool showWidget_; ///< indicates whether this filter should produce a widget or not
     State state_;  ///< Type of entities to filter out
     std::shared_ptr<TimeObserver> clockAdapter_;  ///< Used to monitor for time changes
+    std::shared_ptr<DataStoreListener> dataStoreListener_;  ///< Used to monitor for data changes that affect activity
+    std::unique_ptr<simData::EntityActivity> activity_;  ///< Indexes draw commands across filter passes
+    mutable std::unordered_map<simData::ObjectId, bool> active_;  ///< Activity of all entities at activeTime_
+    mutable bool activeValid_;  ///< False if active_ needs to be evaluated again
+    mutable double activeTime_;  ///< Clock time of active_
   };
 }
 
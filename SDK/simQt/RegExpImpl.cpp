@@ -60,7 +60,13 @@ RegExpImpl::~RegExpImpl()
 //------------------------------------------------------------
 bool RegExpImpl::match(const std::string& test) const
 {
-  return matchQt_(test); // currently using Qt
+  return matchQt_(QString::fromStdString(test)); // currently using Qt
+}
+
+//------------------------------------------------------------
+bool RegExpImpl::matchQString(const QString& test) const
+{
+  return matchQt_(test);
 }
 
 //------------------------------------------------------------
@@ -263,7 +269,7 @@ void RegExpImpl::initializeQRegExp_()
 }
 
 //------------------------------------------------------------
-bool RegExpImpl::matchQt_(const std::string& test) const
+bool RegExpImpl::matchQt_(const QString& test) const
 {
   if (exp_.empty())
     return true;
@@ -274,21 +280,21 @@ bool RegExpImpl::matchQt_(const std::string& test) const
     if (exp_ == ".*")
       return true;
     if (fastRegex_ && fastRegex_->isValid())
-      return fastRegex_->match(QString::fromStdString(test)).hasMatch();
+      return fastRegex_->match(test).hasMatch();
     break;
 
   case FixedString:
     // Failure means problem in initializeQRegExp_()
     assert(qRegExp_);
     if (qRegExp_ && qRegExp_->isValid())
-      return qRegExp_->indexIn(QString::fromStdString(test)) >= 0;
+      return qRegExp_->indexIn(test) >= 0;
     break;
 
   case Wildcard:
     // Failure means problem in initializeQRegExp_()
     assert(qRegExp_);
     if (qRegExp_ && qRegExp_->isValid())
-      return qRegExp_->exactMatch(QString::fromStdString(test));
+      return qRegExp_->exactMatch(test);
     break;
   }
   return false;
@@ -85,6 +85,14 @@ public:
   */
   virtual bool match(const std::string& test) const;
 
+  /**
+  * Returns true if the test string matches anything in the regular expression.  Avoids the
+  * std::string round trip of match() for callers that already hold a QString.
+  * @param[in] test String to test
+  * @return true if test string matches
+  */
+  bool matchQString(const QString& test) const;
+
   /**
   * Returns the regex pattern string
   * @return the regex pattern
@@ -149,7 +157,7 @@ private:
   void initializeQRegExp_();
 
   /// private implementation of QRegExp
-  bool matchQt_(const std::string& test) const;
+  bool matchQt_(const QString& test) const;
 
   std::string exp_;
   CaseSensitivity caseSensitivity_;
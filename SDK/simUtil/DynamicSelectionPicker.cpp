@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include "simCore/Calc/Math.h"
 #include "simVis/Beam.h"
 #include "simVis/CustomRendering.h"
@@ -101,8 +102,12 @@ DynamicSelectionPicker::DynamicSelectionPicker(simVis::ViewManager* viewManager,
     scenario_(scenarioManager),
     maximumValidRange_(100.0), // pixels
     pickMask_(simVis::DISPLAY_MASK_PLATFORM|simVis::DISPLAY_MASK_PLATFORM_MODEL),
-    platformAdvantagePct_(0.7)
+    platformAdvantagePct_(0.7),
+    shapesDirty_(true),
+    shapesProjection_(0)
 {
+  // Buckets the size of the pick range mean a pick only examines the buckets adjacent to the mouse
+  screenCache_.setBucketSize(maximumValidRange_);
   // By default, only platforms are picked.  Gates are feasibly pickable though.
   guiEventHandler_ = new RepickEventHandler(*this);
   addHandlerToViews_ = new simVis::AddEventHandlerToViews(guiEventHandler_.get());
@@ -170,32 +175,56 @@ void DynamicSelectionPicker::pickThisFrame_()
   setPicked_(objectIndexTag, picked);
 }
 
-void DynamicSelectionPicker::pickToVector_(simVis::EntityVector& nodes, PickBehavior behavior, double& mouseRangeSquaredPx) const
+void DynamicSelectionPicker::pickToVector_(simVis::EntityVector& nodes, PickBehavior behavior, double& mouseRangeSquaredPx)
 {
-  // Create a calculator for screen coordinates
-  simUtil::ScreenCoordinateCalculator calc;
-  calc.updateMatrix(*lastMouseView_);
   nodes.clear();
+  if (!lastMouseView_.valid())
+    return;
 
-  // Request all entities from the scenario
+  // Request all entities from the scenario; projection is cached across picks within the same frame
   simVis::EntityVector allEntities;
   scenario_->getAllEntities(allEntities);
+  screenCache_.update(*lastMouseView_, allEntities);
+  if (shapesDirty_ || shapesProjection_ != screenCache_.numProjections())
+    projectShapes_();
 
   // We square the range to avoid sqrt() in a tight loop
   const double maximumValidRangeSquared = osg::square(maximumValidRange_);
   mouseRangeSquaredPx = maximumValidRangeSquared;
 
-  // Loop through all entities
-  for (const auto& entityRefPtr : allEntities)
+  // Candidates are the positions in buckets near the mouse, plus shapes whose bounds are in range
+  std::vector<size_t> candidates;
+  screenCache_.buckets().findNear(mouseXy_, maximumValidRange_, candidates);
+  candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [this](size_t index) { return isShape_[index]; }), candidates.end());
+  std::vector<const ShapeProjection*> candidateShapes(screenCache_.entities().size(), nullptr);
+  const size_t numPositions = candidates.size();
+  for (const auto& shape : shapes_)
   {
-    auto* entityPtr = entityRefPtr.get();
+    const double dx = simCore::sdkMax(0.0, simCore::sdkMax(shape.minXy.x() - mouseXy_.x(), mouseXy_.x() - shape.maxXy.x()));
+    const double dy = simCore::sdkMax(0.0, simCore::sdkMax(shape.minXy.y() - mouseXy_.y(), mouseXy_.y() - shape.maxXy.y()));
+    if (dx * dx + dy * dy > maximumValidRangeSquared)
+      continue;
+    candidates.push_back(shape.index);
+    candidateShapes[shape.index] = &shape;
+  }
+  // Visit candidates in scenario order, so that ties resolve the same as testing every entity
+  if (candidates.size() > numPositions)
+    std::inplace_merge(candidates.begin(), candidates.begin() + numPositions, candidates.end());
+
+  const simVis::EntityVector& entities = screenCache_.entities();
+  const std::vector<ScreenCoordinate>& coords = screenCache_.coordinates();
+  for (size_t index : candidates)
+  {
+    auto* entityPtr = entities[index].get();
     if (!isPickable_(entityPtr))
       continue;
 
-    // Ask the calculator for the range from the mouse position
+    // Calculate the range from the mouse position
     double rangeSquared;
-    if (calculateSquaredRange_(calc, *entityRefPtr, rangeSquared) != 0)
-      continue;
+    if (candidateShapes[index] != nullptr)
+      rangeSquared = shapeRangeSquared_(*candidateShapes[index]);
+    else
+      rangeSquared = (mouseXy_ - osg::Vec2d(coords[index].position())).length2();
 
     if (behavior == PickBehavior::AllInRange)
     {
@@ -229,113 +258,107 @@ bool DynamicSelectionPicker::isPickable_(const simVis::EntityNode* entityNode) c
   return entityNode->isActive() && entityNode->isVisible();
 }
 
-int DynamicSelectionPicker::calculateSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::EntityNode& entityNode, double& rangeSquared) const
-{
-  // Fall back to the LOB case if it's requesting a LOB, since it picks individual points on the lines shown
-  const simVis::LobGroupNode* lobNode = dynamic_cast<const simVis::LobGroupNode*>(&entityNode);
-  if (lobNode)
-    return calculateLobSquaredRange_(calc, *lobNode, rangeSquared);
-
-  // Fall back to the CustomRender case if it's requesting a CustomRender, since it picks different points depending on its type
-  const simVis::CustomRenderingNode* customNode = dynamic_cast<const simVis::CustomRenderingNode*>(&entityNode);
-  if (customNode)
-    return calculateCustomRenderRange_(calc, *customNode, rangeSquared);
-
-  // Fall back to the Laser case if it's requesting a Laser, since it picks a line segment
-  const simVis::LaserNode* laserNode = dynamic_cast<const simVis::LaserNode*>(&entityNode);
-  if (laserNode)
-    return calculateLaserRange_(calc, *laserNode, rangeSquared);
-
-  // Fall back to the Beam case if it's requesting a Beam, since it picks along the boresight
-  const simVis::BeamNode* beamNode = dynamic_cast<const simVis::BeamNode*>(&entityNode);
-  if (beamNode)
-    return calculateBeamRange_(calc, *beamNode, rangeSquared);
-
-  const simUtil::ScreenCoordinate& pos = calc.calculate(entityNode);
-  // Ignore objects that are off screen or behind the camera
-  if (pos.isBehindCamera() || pos.isOffScreen() || pos.isOverHorizon())
-    return 1;
-  rangeSquared = (mouseXy_ - pos.position()).length2();
-  return 0;
-}
-
-int DynamicSelectionPicker::calculateLobSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::LobGroupNode& lobNode, double& rangeSquared) const
-{
-  // Pull out the vector of all endpoints on the LOB that are visible
-  std::vector<osg::Vec3d> ecefVec;
-  lobNode.getVisibleEndPoints(ecefVec);
-
-  // Check the distance from the whole line segment, not just the end points
-  return calculateScreenRangeSegments_(calc, ecefVec, rangeSquared);
-}
-
-int DynamicSelectionPicker::calculateCustomRenderRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::CustomRenderingNode& customNode, double& rangeSquared) const
-{
-  // Pull out the vector of all pick points on the CustomRendering that are visible
-  std::vector<osg::Vec3d> ecefVec;
-  customNode.getPickingPoints(ecefVec);
-
-  // for lines, check the distance from the whole line segment
-  if (customNode.isLine())
-    return calculateScreenRangeSegments_(calc, ecefVec, rangeSquared);
-  // otherwise just check distance from the picking points
-  return calculateScreenRangePoints_(calc, ecefVec, rangeSquared);
-}
-
-int DynamicSelectionPicker::calculateLaserRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::LaserNode& laserNode, double& rangeSquared) const
+void DynamicSelectionPicker::projectShapes_()
 {
-  // Pull out the vector of all endpoints on the Laser that are visible
-  std::vector<osg::Vec3d> ecefVec;
-  laserNode.getVisibleEndPoints(ecefVec);
-
-  // Check the distance from the whole line segment, not just the end points
-  return calculateScreenRangeSegments_(calc, ecefVec, rangeSquared);
+  shapesDirty_ = false;
+  shapesProjection_ = screenCache_.numProjections();
+  shapes_.clear();
+  const simVis::EntityVector& entities = screenCache_.entities();
+  isShape_.assign(entities.size(), false);
+
+  ShapeProjection shape;
+  for (size_t k = 0; k < entities.size(); ++k)
+  {
+    // Unpickable entities are skipped by the pick anyway, so avoid projecting their shapes
+    const simVis::EntityNode* entityNode = entities[k].get();
+    if (entityNode == nullptr)
+      continue;
+    bool isShape = false;
+    const int rv = projectShape_(*entityNode, isShape, shape);
+    isShape_[k] = isShape;
+    if (rv != 0)
+      continue;
+    shape.index = k;
+    shapes_.push_back(shape);
+  }
 }
 
-int DynamicSelectionPicker::calculateBeamRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::BeamNode& beamNode, double& rangeSquared) const
+int DynamicSelectionPicker::projectShape_(const simVis::EntityNode& entityNode, bool& isShape, ShapeProjection& shape)
 {
-  // Pull out the vector of all endpoints on the Beam that are visible
   std::vector<osg::Vec3d> ecefVec;
-  beamNode.getVisibleEndPoints(ecefVec);
-
-  // Check the distance from the whole line segment, not just the end points
-  return calculateScreenRangeSegments_(calc, ecefVec, rangeSquared);
-}
-
-int DynamicSelectionPicker::calculateScreenRangePoints_(simUtil::ScreenCoordinateCalculator& calc, const std::vector<osg::Vec3d>& ecefVec, double& rangeSquared) const
-{
-  rangeSquared = std::numeric_limits<double>::max();
+  isShape = true;
+  if (const simVis::LobGroupNode* lobNode = dynamic_cast<const simVis::LobGroupNode*>(&entityNode))
+  {
+    // LOBs pick on the whole line segment, not just the end points
+    if (!isPickable_(&entityNode))
+      return 1;
+    lobNode->getVisibleEndPoints(ecefVec);
+    shape.segments = true;
+  }
+  else if (const simVis::CustomRenderingNode* customNode = dynamic_cast<const simVis::CustomRenderingNode*>(&entityNode))
+  {
+    // CustomRenderings that are lines pick on the line segments, otherwise on the picking points
+    if (!isPickable_(&entityNode))
+      return 1;
+    customNode->getPickingPoints(ecefVec);
+    shape.segments = customNode->isLine();
+  }
+  else if (const simVis::LaserNode* laserNode = dynamic_cast<const simVis::LaserNode*>(&entityNode))
+  {
+    // Lasers pick on the whole line segment
+    if (!isPickable_(&entityNode))
+      return 1;
+    laserNode->getVisibleEndPoints(ecefVec);
+    shape.segments = true;
+  }
+  else if (const simVis::BeamNode* beamNode = dynamic_cast<const simVis::BeamNode*>(&entityNode))
+  {
+    // Beams pick along the boresight
+    if (!isPickable_(&entityNode))
+      return 1;
+    beamNode->getVisibleEndPoints(ecefVec);
+    shape.segments = true;
+  }
+  else
+  {
+    isShape = false;
+    return 1;
+  }
 
-  for (auto i = ecefVec.begin(); i != ecefVec.end(); ++i)
+  std::vector<ScreenCoordinate> coords;
+  screenCache_.calculator().calculateEcef(ecefVec, coords);
+  shape.points.clear();
+  for (const auto& pos : coords)
   {
-    const simUtil::ScreenCoordinate& pos = calc.calculateEcef(simCore::Vec3(i->x(), i->y(), i->z()));
-    // Ignore objects that are off screen or behind the camera
-    if (pos.isBehindCamera() || pos.isOffScreen() || pos.isOverHorizon())
+    // Segments use every end point, but point sets ignore points that are off screen or behind the camera
+    if (!shape.segments && (pos.isBehindCamera() || pos.isOffScreen() || pos.isOverHorizon()))
       continue;
-    rangeSquared = simCore::sdkMin(rangeSquared, (mouseXy_ - pos.position()).length2());
+    shape.points.push_back(pos.position());
   }
+  if (shape.points.empty() || (shape.segments && shape.points.size() < 2))
+    return 1;
 
-  return (rangeSquared == std::numeric_limits<double>::max()) ? 1 : 0;
+  shape.minXy = shape.maxXy = shape.points.front();
+  for (const auto& point : shape.points)
+  {
+    shape.minXy.set(simCore::sdkMin(shape.minXy.x(), point.x()), simCore::sdkMin(shape.minXy.y(), point.y()));
+    shape.maxXy.set(simCore::sdkMax(shape.maxXy.x(), point.x()), simCore::sdkMax(shape.maxXy.y(), point.y()));
+  }
+  return 0;
 }
 
-int DynamicSelectionPicker::calculateScreenRangeSegments_(simUtil::ScreenCoordinateCalculator& calc, const std::vector<osg::Vec3d>& ecefVec, double& rangeSquared) const
+double DynamicSelectionPicker::shapeRangeSquared_(const ShapeProjection& shape) const
 {
-  const size_t numVerts = ecefVec.size();
-  if (numVerts < 2)
-    return 1;
-  rangeSquared = std::numeric_limits<double>::max();
-
-  osg::Vec3d ecefPoint = ecefVec.front();
-  simUtil::ScreenCoordinate point1 = calc.calculateEcef(simCore::Vec3(ecefPoint.x(), ecefPoint.y(), ecefPoint.z()));
-  for (unsigned int i = 1; i < numVerts; ++i)
+  double rangeSquared = std::numeric_limits<double>::max();
+  if (!shape.segments)
   {
-    osg::Vec3d ecefPoint = ecefVec[i];
-    simUtil::ScreenCoordinate point2 = calc.calculateEcef(simCore::Vec3(ecefPoint.x(), ecefPoint.y(), ecefPoint.z()));
-    rangeSquared = simCore::sdkMin(rangeSquared, lineSegmentDistanceSquared_(point1.position(), point2.position(), mouseXy_));
-    point1 = point2;
+    for (const auto& point : shape.points)
+      rangeSquared = simCore::sdkMin(rangeSquared, (mouseXy_ - point).length2());
+    return rangeSquared;
   }
-
-  return (rangeSquared == std::numeric_limits<double>::max()) ? 1 : 0;
+  for (size_t i = 1; i < shape.points.size(); ++i)
+    rangeSquared = simCore::sdkMin(rangeSquared, lineSegmentDistanceSquared_(shape.points[i - 1], shape.points[i], mouseXy_));
+  return rangeSquared;
 }
 
 double DynamicSelectionPicker::lineSegmentDistanceSquared_(const osg::Vec2d& a, const osg::Vec2d& b, const osg::Vec2d& p) const
@@ -371,11 +394,13 @@ double DynamicSelectionPicker::lineSegmentDistanceSquared_(const osg::Vec2d& a,
 void DynamicSelectionPicker::setRange(double pixelsFromCenter)
 {
   maximumValidRange_ = pixelsFromCenter;
+  screenCache_.setBucketSize(maximumValidRange_);
 }
 
 void DynamicSelectionPicker::setPickMask(osg::Node::NodeMask pickMask)
 {
   pickMask_ = pickMask;
+  shapesDirty_ = true;
 }
 
 osg::Node::NodeMask DynamicSelectionPicker::pickMask() const
@@ -383,4 +408,9 @@ osg::Node::NodeMask DynamicSelectionPicker::pickMask() const
   return pickMask_;
 }
 
+EntityScreenCache& DynamicSelectionPicker::screenCache()
+{
+  return screenCache_;
+}
+
 }
@@ -23,9 +23,11 @@
 #ifndef SIMUTIL_DYNAMICSELECTIONPICKER_H
 #define SIMUTIL_DYNAMICSELECTIONPICKER_H
 
+#include <vector>
 #include "simCore/Common/Export.h"
 #include "simVis/Picker.h"
 #include "simVis/Types.h"
+#include "simUtil/ScreenCoordinateCalculator.h"
 
 namespace simVis {
   class BeamNode;
@@ -37,8 +39,6 @@ namespace simVis {
 namespace simUtil
 {
 
-class ScreenCoordinateCalculator;
-
 /**
  * Implementation of the advanced selection algorithm, sometimes referred to as the advanced
  * hooking algorithm (AHA), identified in U.S. Patent 5,757,358.  This algorithm was developed
@@ -96,6 +96,12 @@ public:
    */
   void pickToVector(simVis::EntityVector& nodes, const osg::Vec2d& mouseXy, PickBehavior behavior);
 
+  /**
+   * Projected entity positions from the most recent pick, refreshed at most once per frame.  Other
+   * screen-space consumers in the same view may share this cache instead of projecting entities again.
+   */
+  EntityScreenCache& screenCache();
+
 protected:
   /** Derived from osg::Referenced, protect destructor */
   virtual ~DynamicSelectionPicker();
@@ -105,25 +111,35 @@ private:
   void pickThisFrame_();
 
   /** Picks into a vector. */
-  void pickToVector_(simVis::EntityVector& nodes, PickBehavior behavior, double& mouseRangeSquaredPx) const;
+  void pickToVector_(simVis::EntityVector& nodes, PickBehavior behavior, double& mouseRangeSquaredPx);
 
   /** Returns true if the entity type is pickable. */
   bool isPickable_(const simVis::EntityNode* entityNode) const;
-  /** Calculates the squared range from the mouse for the given entity, returning 0 on success */
-  int calculateSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::EntityNode& entityNode, double& rangeSquared) const;
-  /** Special case calculation for LOBs, called by calculateSquaredRange_() automatically, returning 0 on success */
-  int calculateLobSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::LobGroupNode& lobNode, double& rangeSquared) const;
-  /** Special case calculation for CustomRenderings, called by calculateSquaredRange_() automatically, returning 0 on success */
-  int calculateCustomRenderRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::CustomRenderingNode& customNode, double& rangeSquared) const;
-  /** Special case calculation for Lasers, called by calculateSquaredRange_() automatically, returning 0 on success */
-  int calculateLaserRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::LaserNode& laserNode, double& rangeSquared) const;
-  /** Special case calculation for Beams, called by calculateSquaredRange_() automatically, returning 0 on success */
-  int calculateBeamRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::BeamNode& beamNode, double& rangeSquared) const;
-
-  /** Convenience method to find the squared range from the cursor to the closest point within ecefVec, returning 0 on success */
-  int calculateScreenRangePoints_(simUtil::ScreenCoordinateCalculator& calc, const std::vector<osg::Vec3d>& ecefVec, double& rangeSquared) const;
-  /** Convenience method to find the squared range from the cursor to the line segments formed by treating ecefVec as successive end points, returning 0 on success */
-  int calculateScreenRangeSegments_(simUtil::ScreenCoordinateCalculator& calc, const std::vector<osg::Vec3d>& ecefVec, double& rangeSquared) const;
+
+  /** Screen-space geometry of an entity that picks on lines or points instead of its position, such as a LOB */
+  struct ShapeProjection
+  {
+    /// Index of the entity in the screen cache
+    size_t index;
+    /// True to pick on the segments between successive points, false to pick on the points
+    bool segments;
+    /// Projected points
+    std::vector<osg::Vec2d> points;
+    /// Bounds of the projected points
+    osg::Vec2d minXy;
+    osg::Vec2d maxXy;
+  };
+
+  /** Projects the shapes of pickable LOBs, custom renderings, lasers and beams in the screen cache */
+  void projectShapes_();
+  /**
+   * Projects a single entity's shape, returning 0 on success, or non-zero if there is no shape to pick.
+   * isShape is set true for entity types that pick on a shape, even if none of it is visible.
+   */
+  int projectShape_(const simVis::EntityNode& entityNode, bool& isShape, ShapeProjection& shape);
+  /** Calculates the squared range from the mouse to a projected shape */
+  double shapeRangeSquared_(const ShapeProjection& shape) const;
+
   /** Finds the squared distance between point p and the closest point on the line described by a and b */
   double lineSegmentDistanceSquared_(const osg::Vec2d& a, const osg::Vec2d& b, const osg::Vec2d& p) const;
 
@@ -150,6 +166,17 @@ private:
   osg::Node::NodeMask pickMask_;
   /** Percentage [0,1] of advantage given to platforms over other entity types. */
   double platformAdvantagePct_;
+
+  /** Entity screen positions, bucketed by the pick range */
+  EntityScreenCache screenCache_;
+  /** Projected shapes for entities in the screen cache, in entity order */
+  std::vector<ShapeProjection> shapes_;
+  /** Flags entities in the screen cache that pick on a shape (whether visible or not) rather than their position */
+  std::vector<bool> isShape_;
+  /** True when shapes_ needs to be rebuilt even if the screen cache is current */
+  bool shapesDirty_;
+  /** Screen cache projection count when shapes_ was built, since the cache may be updated by other consumers */
+  unsigned int shapesProjection_;
 };
 
 }
@@ -20,8 +20,13 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cmath>
+#include "osg/Camera"
+#include "osg/FrameStamp"
 #include "osgEarth/Horizon"
 #include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
 #include "simVis/Entity.h"
 #include "simVis/View.h"
 #include "simUtil/ScreenCoordinateCalculator.h"
@@ -98,6 +103,14 @@ void ScreenCoordinateCalculator::updateMatrix(const simVis::View& view)
 {
   dirtyMatrix_ = true;
   view_ = &view;
+  camera_ = nullptr;
+}
+
+void ScreenCoordinateCalculator::updateMatrix(const osg::Camera& camera)
+{
+  dirtyMatrix_ = true;
+  view_ = nullptr;
+  camera_ = &camera;
 }
 
 ScreenCoordinate ScreenCoordinateCalculator::calculate(const simVis::EntityNode& entity)
@@ -105,27 +118,7 @@ ScreenCoordinate ScreenCoordinateCalculator::calculate(const simVis::EntityNode&
   // Refresh the VPW if needed, returning invalid coordinate if needed
   if (recalculateVPW_() != 0)
     return INVALID_COORDINATE;
-
-  // Check entity active flag
-  if (!entity.isActive())
-    return INVALID_COORDINATE;
-
-  if (!view_.valid() || !view_->isOverheadEnabled())
-  {
-    simCore::Vec3 locatorNodeEcef;
-    if (0 != entity.getPosition(&locatorNodeEcef, simCore::COORD_SYS_ECEF))
-      return INVALID_COORDINATE;
-    return matrixCalculate_(osg::Vec3d(locatorNodeEcef.x(), locatorNodeEcef.y(), locatorNodeEcef.z()));
-  }
-
-  // Overhead mode: Get the LLA position, clamp to 0, then convert to ECEF
-  simCore::Vec3 lla;
-  if (0 != entity.getPosition(&lla, simCore::COORD_SYS_LLA))
-    return INVALID_COORDINATE;
-  lla.setAlt(0.0);
-  simCore::Vec3 ecefOut;
-  simCore::CoordinateConverter::convertGeodeticPosToEcef(lla, ecefOut);
-  return matrixCalculate_(osg::Vec3d(ecefOut.x(), ecefOut.y(), ecefOut.z()));
+  return entityCoordinate_(entity, isOverhead_());
 }
 
 ScreenCoordinate ScreenCoordinateCalculator::calculateLla(const simCore::Vec3& lla)
@@ -134,7 +127,7 @@ ScreenCoordinate ScreenCoordinateCalculator::calculateLla(const simCore::Vec3& l
   if (recalculateVPW_() != 0)
     return INVALID_COORDINATE;
   simCore::Vec3 ecefOut;
-  if (!view_.valid() || !view_->isOverheadEnabled())
+  if (!isOverhead_())
     simCore::CoordinateConverter::convertGeodeticPosToEcef(lla, ecefOut);
   else
     simCore::CoordinateConverter::convertGeodeticPosToEcef(simCore::Vec3(lla.lat(), lla.lon(), 0.0), ecefOut);
@@ -146,17 +139,35 @@ ScreenCoordinate ScreenCoordinateCalculator::calculateEcef(const simCore::Vec3&
   // Refresh the VPW if needed, returning invalid coordinate if needed
   if (recalculateVPW_() != 0)
     return INVALID_COORDINATE;
-  if (!view_.valid() || !view_->isOverheadEnabled())
-    return matrixCalculate_(osg::Vec3d(ecef.x(), ecef.y(), ecef.z()));
+  return ecefCoordinate_(osg::Vec3d(ecef.x(), ecef.y(), ecef.z()), isOverhead_());
+}
 
-  // Clamping is required in overhead mode, so we need to convert to LLA
-  simCore::Vec3 llaPos;
-  if (simCore::CoordinateConverter::convertEcefToGeodeticPos(ecef, llaPos) != 0)
-    return INVALID_COORDINATE;
-  llaPos.setAlt(0.0);
-  simCore::Vec3 clampedEcef;
-  simCore::CoordinateConverter::convertGeodeticPosToEcef(llaPos, clampedEcef);
-  return matrixCalculate_(osg::Vec3d(clampedEcef.x(), clampedEcef.y(), clampedEcef.z()));
+void ScreenCoordinateCalculator::calculate(const std::vector<osg::ref_ptr<simVis::EntityNode> >& entities, std::vector<ScreenCoordinate>& coords)
+{
+  coords.clear();
+  coords.reserve(entities.size());
+  if (recalculateVPW_() != 0)
+  {
+    coords.resize(entities.size(), INVALID_COORDINATE);
+    return;
+  }
+  const bool overhead = isOverhead_();
+  for (const auto& entity : entities)
+    coords.push_back(entity.valid() ? entityCoordinate_(*entity, overhead) : INVALID_COORDINATE);
+}
+
+void ScreenCoordinateCalculator::calculateEcef(const std::vector<osg::Vec3d>& ecef, std::vector<ScreenCoordinate>& coords)
+{
+  coords.clear();
+  coords.reserve(ecef.size());
+  if (recalculateVPW_() != 0)
+  {
+    coords.resize(ecef.size(), INVALID_COORDINATE);
+    return;
+  }
+  const bool overhead = isOverhead_();
+  for (const auto& point : ecef)
+    coords.push_back(ecefCoordinate_(point, overhead));
 }
 
 int ScreenCoordinateCalculator::recalculateVPW_()
@@ -164,34 +175,300 @@ int ScreenCoordinateCalculator::recalculateVPW_()
   // Break out if no changes
   if (!dirtyMatrix_)
     return 0;
-  // Break out early on invalid view
-  if (!view_.valid())
+  // Break out early on invalid view or camera
+  const osg::Camera* camera = currentCamera_();
+  if (!camera || !camera->getViewport())
     return 1;
 
   // Combine the matrices
-  const osg::Camera* camera = view_->getCamera();
   const osg::Viewport* viewport = camera->getViewport();
   horizon_->setEye(osg::Vec3d(0, 0, 0) * osg::Matrix::inverse(camera->getViewMatrix()));
   viewProjectionWindow_ = camera->getViewMatrix() * camera->getProjectionMatrix() * viewport->computeWindowMatrix();
+  viewportMin_.set(viewport->x(), viewport->y());
+  viewportMax_.set(viewport->x() + viewport->width(), viewport->y() + viewport->height());
   dirtyMatrix_ = false;
   return 0;
 }
 
-ScreenCoordinate ScreenCoordinateCalculator::matrixCalculate_(const osg::Vec3d& ecefCoordinate) const
+const osg::Camera* ScreenCoordinateCalculator::currentCamera_() const
 {
-  // Calculate the info for the coordinate
-  const osg::Vec3 coordinate = ecefCoordinate * viewProjectionWindow_;
-  bool isInside = false;
-  if (view_.valid() && view_->getCamera() && view_->getCamera()->getViewport())
+  if (view_.valid())
+    return view_->getCamera();
+  return camera_.get();
+}
+
+bool ScreenCoordinateCalculator::isOverhead_() const
+{
+  return view_.valid() && view_->isOverheadEnabled();
+}
+
+ScreenCoordinate ScreenCoordinateCalculator::entityCoordinate_(const simVis::EntityNode& entity, bool overhead) const
+{
+  // Check entity active flag
+  if (!entity.isActive())
+    return INVALID_COORDINATE;
+
+  if (!overhead)
   {
-    const osg::Viewport* vp = view_->getCamera()->getViewport();
-    isInside = (coordinate.x() >= vp->x() && coordinate.x() <= (vp->x() + vp->width())) &&
-      (coordinate.y() >= vp->y() && coordinate.y() <= (vp->y() + vp->height()));
+    simCore::Vec3 locatorNodeEcef;
+    if (0 != entity.getPosition(&locatorNodeEcef, simCore::COORD_SYS_ECEF))
+      return INVALID_COORDINATE;
+    return matrixCalculate_(osg::Vec3d(locatorNodeEcef.x(), locatorNodeEcef.y(), locatorNodeEcef.z()));
   }
 
+  // Overhead mode: Get the LLA position, clamp to 0, then convert to ECEF
+  simCore::Vec3 lla;
+  if (0 != entity.getPosition(&lla, simCore::COORD_SYS_LLA))
+    return INVALID_COORDINATE;
+  lla.setAlt(0.0);
+  simCore::Vec3 ecefOut;
+  simCore::CoordinateConverter::convertGeodeticPosToEcef(lla, ecefOut);
+  return matrixCalculate_(osg::Vec3d(ecefOut.x(), ecefOut.y(), ecefOut.z()));
+}
+
+ScreenCoordinate ScreenCoordinateCalculator::ecefCoordinate_(const osg::Vec3d& ecef, bool overhead) const
+{
+  if (!overhead)
+    return matrixCalculate_(ecef);
+
+  // Clamping is required in overhead mode, so we need to convert to LLA
+  simCore::Vec3 llaPos;
+  if (simCore::CoordinateConverter::convertEcefToGeodeticPos(simCore::Vec3(ecef.x(), ecef.y(), ecef.z()), llaPos) != 0)
+    return INVALID_COORDINATE;
+  llaPos.setAlt(0.0);
+  simCore::Vec3 clampedEcef;
+  simCore::CoordinateConverter::convertGeodeticPosToEcef(llaPos, clampedEcef);
+  return matrixCalculate_(osg::Vec3d(clampedEcef.x(), clampedEcef.y(), clampedEcef.z()));
+}
+
+ScreenCoordinate ScreenCoordinateCalculator::matrixCalculate_(const osg::Vec3d& ecefCoordinate) const
+{
+  // Calculate the info for the coordinate; viewport extents are from the last VPW calculation
+  const osg::Vec3 coordinate = ecefCoordinate * viewProjectionWindow_;
+  const bool isInside = (coordinate.x() >= viewportMin_.x() && coordinate.x() <= viewportMax_.x()) &&
+    (coordinate.y() >= viewportMin_.y() && coordinate.y() <= viewportMax_.y());
+
   // Check horizon culling
   const bool overHorizon = !horizon_->isVisible(ecefCoordinate);
   return ScreenCoordinate(coordinate, !isInside, overHorizon);
 }
 
+////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** Upper limit on the number of buckets, to bound memory for very small bucket sizes */
+static const int MAX_BUCKETS = 1 << 20;
+
+/** Returns true if the coordinate can be seen, and so is worth indexing */
+bool isVisible(const ScreenCoordinate& coord)
+{
+  return !coord.isBehindCamera() && !coord.isOffScreen() && !coord.isOverHorizon();
+}
+
+}
+
+ScreenCoordinateBuckets::ScreenCoordinateBuckets(double bucketSizePx)
+  : bucketSize_(1.0),
+    cellSize_(1.0),
+    numColumns_(0),
+    numRows_(0)
+{
+  setBucketSize(bucketSizePx);
+}
+
+ScreenCoordinateBuckets::~ScreenCoordinateBuckets()
+{
+}
+
+void ScreenCoordinateBuckets::setBucketSize(double bucketSizePx)
+{
+  // Avoid degenerate buckets; sub-pixel buckets provide no benefit
+  bucketSize_ = (bucketSizePx < 1.0) ? 1.0 : bucketSizePx;
+}
+
+double ScreenCoordinateBuckets::bucketSize() const
+{
+  return bucketSize_;
+}
+
+void ScreenCoordinateBuckets::clear()
+{
+  numColumns_ = 0;
+  numRows_ = 0;
+  bucketStart_.clear();
+  indices_.clear();
+}
+
+size_t ScreenCoordinateBuckets::size() const
+{
+  return indices_.size();
+}
+
+int ScreenCoordinateBuckets::cell_(double value, double origin, int numCells) const
+{
+  // Clamp before converting, to avoid overflow for positions far outside the grid
+  const double cell = std::floor((value - origin) / cellSize_);
+  return static_cast<int>(simCore::sdkMax(-1.0, simCore::sdkMin(cell, static_cast<double>(numCells))));
+}
+
+void ScreenCoordinateBuckets::build(const std::vector<ScreenCoordinate>& coords)
+{
+  clear();
+
+  // Find the extents of the visible coordinates
+  bool any = false;
+  osg::Vec2d minXy;
+  osg::Vec2d maxXy;
+  for (const auto& coord : coords)
+  {
+    if (!isVisible(coord))
+      continue;
+    const osg::Vec2d xy = coord.position();
+    if (!any)
+    {
+      minXy = maxXy = xy;
+      any = true;
+      continue;
+    }
+    minXy.set(simCore::sdkMin(minXy.x(), xy.x()), simCore::sdkMin(minXy.y(), xy.y()));
+    maxXy.set(simCore::sdkMax(maxXy.x(), xy.x()), simCore::sdkMax(maxXy.y(), xy.y()));
+  }
+  if (!any)
+    return;
+
+  // Grow the buckets if needed to limit the bucket count; coordinates are on screen so this is rare
+  origin_ = minXy;
+  cellSize_ = bucketSize_;
+  while (true)
+  {
+    const double columns = std::floor((maxXy.x() - minXy.x()) / cellSize_) + 1.0;
+    const double rows = std::floor((maxXy.y() - minXy.y()) / cellSize_) + 1.0;
+    if (columns * rows <= MAX_BUCKETS)
+    {
+      numColumns_ = static_cast<int>(columns);
+      numRows_ = static_cast<int>(rows);
+      break;
+    }
+    cellSize_ *= 2.0;
+  }
+
+  // Count the coordinates per bucket, then convert counts into start offsets
+  std::vector<int> bucketOf(coords.size(), -1);
+  bucketStart_.assign(static_cast<size_t>(numColumns_) * numRows_ + 1, 0);
+  for (size_t k = 0; k < coords.size(); ++k)
+  {
+    if (!isVisible(coords[k]))
+      continue;
+    const osg::Vec2d xy = coords[k].position();
+    const int column = simCore::sdkMin(cell_(xy.x(), origin_.x(), numColumns_), numColumns_ - 1);
+    const int row = simCore::sdkMin(cell_(xy.y(), origin_.y(), numRows_), numRows_ - 1);
+    bucketOf[k] = row * numColumns_ + column;
+    ++bucketStart_[bucketOf[k] + 1];
+  }
+  for (size_t k = 1; k < bucketStart_.size(); ++k)
+    bucketStart_[k] += bucketStart_[k - 1];
+
+  // Fill in index order, which keeps each bucket sorted
+  indices_.resize(bucketStart_.back());
+  std::vector<size_t> next(bucketStart_.begin(), bucketStart_.end() - 1);
+  for (size_t k = 0; k < coords.size(); ++k)
+  {
+    if (bucketOf[k] >= 0)
+      indices_[next[bucketOf[k]]++] = k;
+  }
+}
+
+void ScreenCoordinateBuckets::findNear(const osg::Vec2d& xy, double radiusPx, std::vector<size_t>& indices) const
+{
+  indices.clear();
+  if (indices_.empty())
+    return;
+
+  const int minColumn = simCore::sdkMax(cell_(xy.x() - radiusPx, origin_.x(), numColumns_), 0);
+  const int maxColumn = simCore::sdkMin(cell_(xy.x() + radiusPx, origin_.x(), numColumns_), numColumns_ - 1);
+  const int minRow = simCore::sdkMax(cell_(xy.y() - radiusPx, origin_.y(), numRows_), 0);
+  const int maxRow = simCore::sdkMin(cell_(xy.y() + radiusPx, origin_.y(), numRows_), numRows_ - 1);
+  if (minColumn > maxColumn || minRow > maxRow)
+    return;
+
+  for (int row = minRow; row <= maxRow; ++row)
+  {
+    const size_t first = static_cast<size_t>(row) * numColumns_;
+    indices.insert(indices.end(), indices_.begin() + bucketStart_[first + minColumn], indices_.begin() + bucketStart_[first + maxColumn + 1]);
+  }
+  // Contents of each row are in order within buckets, but not across them
+  if (maxColumn > minColumn || maxRow > minRow)
+    std::sort(indices.begin(), indices.end());
+}
+
+////////////////////////////////////////////////////////////////////////
+
+EntityScreenCache::EntityScreenCache()
+  : frameNumber_(0),
+    valid_(false),
+    numProjections_(0)
+{
+}
+
+EntityScreenCache::~EntityScreenCache()
+{
+}
+
+bool EntityScreenCache::update(const simVis::View& view, const std::vector<osg::ref_ptr<simVis::EntityNode> >& entities)
+{
+  // Positions only change between frames, so a matching view, frame and entity list can reuse the results
+  const osg::FrameStamp* frameStamp = view.getFrameStamp();
+  if (valid_ && frameStamp != nullptr && frameStamp->getFrameNumber() == frameNumber_ &&
+    view_.get() == &view && entities == entities_)
+    return false;
+
+  calculator_.updateMatrix(view);
+  entities_ = entities;
+  calculator_.calculate(entities_, coordinates_);
+  buckets_.build(coordinates_);
+
+  view_ = &view;
+  frameNumber_ = (frameStamp != nullptr) ? frameStamp->getFrameNumber() : 0;
+  valid_ = (frameStamp != nullptr);
+  ++numProjections_;
+  return true;
+}
+
+void EntityScreenCache::invalidate()
+{
+  valid_ = false;
+}
+
+void EntityScreenCache::setBucketSize(double bucketSizePx)
+{
+  buckets_.setBucketSize(bucketSizePx);
+  invalidate();
+}
+
+const std::vector<osg::ref_ptr<simVis::EntityNode> >& EntityScreenCache::entities() const
+{
+  return entities_;
+}
+
+const std::vector<ScreenCoordinate>& EntityScreenCache::coordinates() const
+{
+  return coordinates_;
+}
+
+const ScreenCoordinateBuckets& EntityScreenCache::buckets() const
+{
+  return buckets_;
+}
+
+ScreenCoordinateCalculator& EntityScreenCache::calculator()
+{
+  return calculator_;
+}
+
+unsigned int EntityScreenCache::numProjections() const
+{
+  return numProjections_;
+}
+
 }
@@ -23,14 +23,20 @@
 #ifndef SIMUTIL_SCREENCOORDINATECALCULATOR_H
 #define SIMUTIL_SCREENCOORDINATECALCULATOR_H
 
+#include <vector>
 #include "osg/observer_ptr"
 #include "osg/ref_ptr"
 #include "osg/Matrix"
 #include "osg/Vec2"
+#include "osg/Vec2d"
 #include "osg/Vec3"
+#include "osg/Vec3d"
 #include "simCore/Common/Common.h"
 
-namespace osg { class Viewport; }
+namespace osg {
+  class Camera;
+  class Viewport;
+}
 namespace osgEarth { class Horizon; }
 namespace simVis {
   class View;
@@ -105,6 +111,11 @@ public:
 
   /** Update the internal projection matrix based on the view.  Call whenever view, projection, or window matrix changes */
   void updateMatrix(const simVis::View& view);
+  /**
+   * Update the internal projection matrix based on a camera that is not associated with a simVis::View,
+   * such as an offscreen camera.  Overhead mode clamping does not apply.  The camera must have a viewport.
+   */
+  void updateMatrix(const osg::Camera& camera);
 
   /** Retrieves a coordinate for a given entity, using the matrix from the most recent call to updateMatrix() */
   ScreenCoordinate calculate(const simVis::EntityNode& entity);
@@ -113,9 +124,31 @@ public:
   /** Retrieves a screen coordinate for a given ECEF coordinate */
   ScreenCoordinate calculateEcef(const simCore::Vec3& ecef);
 
+  /**
+   * Retrieves coordinates for each entity, same as calling calculate() on each in turn, but checking the
+   * matrix and view state only once.  Null entities get an invalid (off screen) coordinate.
+   * @param entities Entities to project; a simVis::EntityVector
+   * @param coords Replaced with one coordinate per entity, in the same order
+   */
+  void calculate(const std::vector<osg::ref_ptr<simVis::EntityNode> >& entities, std::vector<ScreenCoordinate>& coords);
+  /**
+   * Retrieves screen coordinates for an array of ECEF coordinates, same as calling calculateEcef() on each.
+   * @param ecef ECEF coordinates to project
+   * @param coords Replaced with one coordinate per ECEF coordinate, in the same order
+   */
+  void calculateEcef(const std::vector<osg::Vec3d>& ecef, std::vector<ScreenCoordinate>& coords);
+
 private:
   /** recalculates the VPW matrix if needed (if dirty); returns 0 on success */
   int recalculateVPW_();
+  /** Camera from the view, or from updateMatrix(const osg::Camera&) */
+  const osg::Camera* currentCamera_() const;
+  /** Returns true if positions are clamped to the surface for overhead mode */
+  bool isOverhead_() const;
+  /** Entity coordinate, after recalculateVPW_() succeeds */
+  ScreenCoordinate entityCoordinate_(const simVis::EntityNode& entity, bool overhead) const;
+  /** ECEF coordinate, after recalculateVPW_() succeeds */
+  ScreenCoordinate ecefCoordinate_(const osg::Vec3d& ecef, bool overhead) const;
   /* Convert an ecef coordinate to a screen coordinate */
   ScreenCoordinate matrixCalculate_(const osg::Vec3d& ecefCoordinate) const;
 
@@ -125,10 +158,114 @@ private:
   bool dirtyMatrix_;
   /// Pointer to the viewport for the current view
   osg::observer_ptr<const simVis::View> view_;
+  /// Camera passed directly to updateMatrix(), when there is no view
+  osg::observer_ptr<const osg::Camera> camera_;
+  /// Viewport extents as of the last VPW calculation
+  osg::Vec2d viewportMin_;
+  osg::Vec2d viewportMax_;
   /// Horizon calculator
   osg::ref_ptr<osgEarth::Horizon> horizon_;
 };
 
+/**
+ * Coarse screen-space grid over a set of screen coordinates, for finding the coordinates near a
+ * pixel without testing every one.  Coordinates that are behind the camera, off screen or over the
+ * horizon are not indexed.  Coordinates are referred to by their index in the vector passed to build().
+ */
+class SDKUTIL_EXPORT ScreenCoordinateBuckets
+{
+public:
+  /** Constructs buckets with the given edge length in pixels */
+  explicit ScreenCoordinateBuckets(double bucketSizePx = 100.0);
+  virtual ~ScreenCoordinateBuckets();
+
+  /** Changes the bucket edge length in pixels; takes effect on the next build() */
+  void setBucketSize(double bucketSizePx);
+  /** Retrieves the bucket edge length in pixels */
+  double bucketSize() const;
+
+  /** Indexes the visible coordinates, replacing the previous contents */
+  void build(const std::vector<ScreenCoordinate>& coords);
+  /** Removes all coordinates */
+  void clear();
+  /** Number of coordinates indexed */
+  size_t size() const;
+
+  /**
+   * Retrieves indices of the coordinates in all buckets that overlap the square of the given radius around
+   * the pixel.  This is a superset of the coordinates within the radius; callers test the actual distance.
+   * @param xy Pixel position
+   * @param radiusPx Search radius in pixels
+   * @param indices Replaced with indices into the vector passed to build(), in ascending order
+   */
+  void findNear(const osg::Vec2d& xy, double radiusPx, std::vector<size_t>& indices) const;
+
+private:
+  /** Bucket column or row for a pixel position on one axis, clamped to [-1, numCells] */
+  int cell_(double value, double origin, int numCells) const;
+
+  /// Requested bucket edge length in pixels
+  double bucketSize_;
+  /// Bucket edge length of the current grid, larger than bucketSize_ if needed to limit the bucket count
+  double cellSize_;
+  /// Pixel position of the lower left corner of bucket (0,0)
+  osg::Vec2d origin_;
+  int numColumns_;
+  int numRows_;
+  /// Offset of each bucket's first entry in indices_, with a final entry for the end
+  std::vector<size_t> bucketStart_;
+  /// Coordinate indices, grouped by bucket and ascending within each bucket
+  std::vector<size_t> indices_;
+};
+
+/**
+ * Per-frame cache of projected entity positions for a view.  Screen-space consumers such as pickers
+ * and overlays can share one cache so entities are projected once per frame, regardless of how many
+ * times the positions are queried.
+ */
+class SDKUTIL_EXPORT EntityScreenCache
+{
+public:
+  EntityScreenCache();
+  virtual ~EntityScreenCache();
+
+  /**
+   * Projects the entities into the view, unless they were already projected for the same view, frame
+   * and entity list.  Views without a frame stamp are projected on every call.
+   * @param view View to project into
+   * @param entities Entities to project; a simVis::EntityVector
+   * @return True if the entities were projected, false if the cached results are still current
+   */
+  bool update(const simVis::View& view, const std::vector<osg::ref_ptr<simVis::EntityNode> >& entities);
+  /** Forces the next update() to project the entities */
+  void invalidate();
+
+  /** Changes the bucket size in pixels, which invalidates the cache */
+  void setBucketSize(double bucketSizePx);
+
+  /** Entities from the most recent projection */
+  const std::vector<osg::ref_ptr<simVis::EntityNode> >& entities() const;
+  /** Screen coordinates of entities(), in the same order */
+  const std::vector<ScreenCoordinate>& coordinates() const;
+  /** Bucketed coordinates, for finding entities near a pixel */
+  const ScreenCoordinateBuckets& buckets() const;
+  /** Calculator set up for the view of the most recent update(), for projecting other positions */
+  ScreenCoordinateCalculator& calculator();
+
+  /** Number of times the entities were projected, for testing and diagnostics */
+  unsigned int numProjections() const;
+
+private:
+  ScreenCoordinateCalculator calculator_;
+  ScreenCoordinateBuckets buckets_;
+  std::vector<osg::ref_ptr<simVis::EntityNode> > entities_;
+  std::vector<ScreenCoordinate> coordinates_;
+  osg::observer_ptr<const simVis::View> view_;
+  unsigned int frameNumber_;
+  bool valid_;
+  unsigned int numProjections_;
+};
+
 }
 
 #endif /* SIMUTIL_SCREENCOORDINATECALCULATOR_H */
@@ -37,6 +37,7 @@
 #include "simVis/OverheadMode.h"
 #include "simVis/Types.h"
 #include "simVis/Utils.h"
+#include "simVis/ViewManager.h"
 #include "simVis/AnimatedLine.h"
 
 #define LC "[AnimatedLine] "
@@ -356,6 +357,9 @@ void AnimatedLineNode::traverse(osg::NodeVisitor& nv)
   {
     update_(nv.getFrameStamp()->getReferenceTime());
   }
+  // shifting stipple needs continuous frames when rendering on demand, but only while drawn
+  else if (nv.getVisitorType() == nv.CULL_VISITOR && shiftsPerSecond_ != 0.)
+    ViewManager::requestAnimationFrame(nv);
 
   osg::MatrixTransform::traverse(nv);
 }
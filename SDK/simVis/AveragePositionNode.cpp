@@ -23,17 +23,34 @@
 #include <algorithm>
 #include "osg/BoundingSphere"
 #include "simVis/Entity.h"
+#include "simVis/Locator.h"
 #include "simVis/AveragePositionNode.h"
 
 namespace simVis
 {
 
+AveragePositionNode::TrackedNode::TrackedNode(EntityNode* inNode)
+  : node(inNode),
+    locator(nullptr),
+    visible(false),
+    hasPosition(false)
+{
+}
+
 AveragePositionNode::AveragePositionNode()
+  : recomputeNeeded_(false),
+    recomputeInterval_(0),
+    updatesSinceRecompute_(0),
+    numRecomputes_(0)
 {
   callback_ = new RecalcUpdateCallback(*this);
 }
 
 AveragePositionNode::AveragePositionNode(const std::vector<EntityNode*>& nodes)
+  : recomputeNeeded_(false),
+    recomputeInterval_(0),
+    updatesSinceRecompute_(0),
+    numRecomputes_(0)
 {
   callback_ = new RecalcUpdateCallback(*this);
   for (auto it = nodes.begin(); it != nodes.end(); ++it)
@@ -44,6 +61,16 @@ AveragePositionNode::~AveragePositionNode()
 {
 }
 
+std::vector<AveragePositionNode::TrackedNode>::iterator AveragePositionNode::findNode_(const EntityNode* node)
+{
+  return std::find_if(nodes_.begin(), nodes_.end(), [node](const TrackedNode& tracked) { return tracked.node.get() == node; });
+}
+
+std::vector<AveragePositionNode::TrackedNode>::const_iterator AveragePositionNode::findNode_(const EntityNode* node) const
+{
+  return std::find_if(nodes_.begin(), nodes_.end(), [node](const TrackedNode& tracked) { return tracked.node.get() == node; });
+}
+
 void AveragePositionNode::addTrackedNode(EntityNode* node)
 {
   if (!node)
@@ -53,8 +80,11 @@ void AveragePositionNode::addTrackedNode(EntityNode* node)
   if (nodes_.empty())
     addUpdateCallback(callback_);
 
-  if (std::find(nodes_.begin(), nodes_.end(), node) == nodes_.end())
-    nodes_.push_back(node);
+  if (findNode_(node) == nodes_.end())
+  {
+    nodes_.push_back(TrackedNode(node));
+    recomputeNeeded_ = true;
+  }
 }
 
 void AveragePositionNode::removeTrackedNode(EntityNode* node)
@@ -62,9 +92,12 @@ void AveragePositionNode::removeTrackedNode(EntityNode* node)
   if (!node)
     return;
 
-  auto found = std::find(nodes_.begin(), nodes_.end(), node);
+  auto found = findNode_(node);
   if (found != nodes_.end())
+  {
     nodes_.erase(found);
+    recomputeNeeded_ = true;
+  }
 
   // Remove the update callback if we're not tracking any nodes
   if (nodes_.empty())
@@ -75,7 +108,7 @@ bool AveragePositionNode::isTrackingNode(EntityNode* node) const
 {
   if (!node)
     return false;
-  return (std::find(nodes_.begin(), nodes_.end(), node) != nodes_.end());
+  return (findNode_(node) != nodes_.end());
 }
 
 int AveragePositionNode::getNumTrackedNodes() const
@@ -86,7 +119,10 @@ int AveragePositionNode::getNumTrackedNodes() const
 void AveragePositionNode::getTrackedIds(std::vector<uint64_t>& ids) const
 {
   for (auto it = nodes_.begin(); it != nodes_.end(); ++it)
-    ids.push_back((*it)->getId());
+  {
+    if (it->node.valid())
+      ids.push_back(it->node->getId());
+  }
 }
 
 double AveragePositionNode::boundingSphereRadius() const
@@ -96,33 +132,83 @@ double AveragePositionNode::boundingSphereRadius() const
   return boundingSphere_.radius();
 }
 
-void AveragePositionNode::updateAveragePosition_()
+void AveragePositionNode::setRadiusRecomputeInterval(unsigned int numUpdates)
 {
-  bool isExpanded = false;
+  recomputeInterval_ = numUpdates;
+}
 
+unsigned int AveragePositionNode::radiusRecomputeInterval() const
+{
+  return recomputeInterval_;
+}
+
+unsigned int AveragePositionNode::numRecomputes() const
+{
+  return numRecomputes_;
+}
+
+void AveragePositionNode::updateAveragePosition_()
+{
   if (nodes_.empty())
     return;
-
-  // Reset bounding sphere
-  boundingSphere_.init();
+  // Saturate so that idle groups do not wrap the counter
+  if (updatesSinceRecompute_ <= recomputeInterval_)
+    ++updatesSinceRecompute_;
 
   // Remove invalid nodes
-  nodes_.erase(std::remove(nodes_.begin(), nodes_.end(), osg::observer_ptr<EntityNode>()), nodes_.end());
+  const size_t oldSize = nodes_.size();
+  nodes_.erase(std::remove_if(nodes_.begin(), nodes_.end(), [](const TrackedNode& tracked) { return !tracked.node.valid(); }), nodes_.end());
+  if (nodes_.size() != oldSize)
+    recomputeNeeded_ = true;
 
-  // Expand bounding sphere by each tracked node's position
+  // Refresh cached positions only for nodes whose locator or visibility changed
+  osg::BoundingSphere grown = boundingSphere_;
   for (auto it = nodes_.begin(); it != nodes_.end(); ++it)
   {
-    if (!it->valid() || !(*it)->isVisible())
+    const EntityNode* node = it->node.get();
+    const Locator* locator = node->getLocator();
+    const bool visible = node->isVisible();
+    if (visible == it->visible && locator == it->locator && (locator == nullptr || !locator->outOfSyncWith(it->locatorRevision)))
       continue;
+
+    it->visible = visible;
+    it->locator = locator;
+    if (locator)
+      locator->sync(it->locatorRevision);
+
     simCore::Vec3 pos;
-    if ((*it)->getPosition(&pos) == 0)
+    it->hasPosition = visible && (node->getPosition(&pos) == 0);
+    if (it->hasPosition)
     {
-      boundingSphere_.expandBy(osg::Vec3d(pos.x(), pos.y(), pos.z()));
-      isExpanded = true;
+      it->position.set(pos.x(), pos.y(), pos.z());
+      grown.expandBy(it->position);
     }
+    recomputeNeeded_ = true;
+  }
+
+  if (!recomputeNeeded_)
+    return;
+
+  if (updatesSinceRecompute_ > recomputeInterval_ || !boundingSphere_.valid())
+  {
+    // Expanding is order dependent; rebuild from the cached positions in tracking order to match a full computation
+    boundingSphere_.init();
+    for (auto it = nodes_.begin(); it != nodes_.end(); ++it)
+    {
+      if (it->hasPosition)
+        boundingSphere_.expandBy(it->position);
+    }
+    recomputeNeeded_ = false;
+    updatesSinceRecompute_ = 0;
+    ++numRecomputes_;
+  }
+  else
+  {
+    // Too soon for a full recalculation; grow to contain changed nodes, deferring any shrink
+    boundingSphere_ = grown;
   }
 
-  if (isExpanded)
+  if (boundingSphere_.valid())
   {
     // Translate the matrix to the center of the bounding sphere
     setMatrix(osg::Matrix::translate(boundingSphere_.center()));
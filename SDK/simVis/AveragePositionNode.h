@@ -26,15 +26,21 @@
 #include "osg/observer_ptr"
 #include "osg/BoundingSphere"
 #include "osg/MatrixTransform"
+#include "osgEarth/Revisioning"
 #include "simCore/Common/Common.h"
 
 namespace simVis {
 
 class EntityNode;
+class Locator;
 
 /**
 * Node that is placed at the center of the bounding sphere
 * created by the positions of the tracked simVis::EntityNodes.
+*
+* Positions are cached per tracked node and only re-read when the node's locator
+* revision or visibility changes.  The bounding sphere is only rebuilt when a
+* tracked node changed, so a group that is not moving costs a revision check per node.
 */
 class SDKVIS_EXPORT AveragePositionNode : public osg::MatrixTransform
 {
@@ -79,6 +85,20 @@ public:
   */
   double boundingSphereRadius() const;
 
+  /**
+  * Sets the minimum number of updates between full recalculations of the bounding sphere.  Between
+  * full recalculations, changed nodes only expand the sphere, so it still contains every tracked
+  * node but may be larger than necessary until the next full recalculation.  The default of 0
+  * recalculates on every update in which a tracked node changed, which matches a full computation.
+  * @param numUpdates Minimum number of updates between full recalculations
+  */
+  void setRadiusRecomputeInterval(unsigned int numUpdates);
+  /** Retrieves the minimum number of updates between full recalculations of the bounding sphere */
+  unsigned int radiusRecomputeInterval() const;
+
+  /** Retrieves the number of full recalculations of the bounding sphere performed; for testing */
+  unsigned int numRecomputes() const;
+
   /** Return the proper library name */
   virtual const char* libraryName() const { return "simVis"; }
 
@@ -109,6 +129,30 @@ private:
     AveragePositionNode& avgNode_;
   };
 
+  /** Cached state of a tracked EntityNode */
+  struct TrackedNode
+  {
+    explicit TrackedNode(EntityNode* inNode);
+
+    /** Node being tracked */
+    osg::observer_ptr<EntityNode> node;
+    /** Locator whose revision was recorded; used only for identity comparison */
+    const Locator* locator;
+    /** Revision of the locator when position was read */
+    osgEarth::Util::Revision locatorRevision;
+    /** Visibility of the node when position was read */
+    bool visible;
+    /** True if position holds a valid position for a visible node */
+    bool hasPosition;
+    /** ECEF position of the node */
+    osg::Vec3d position;
+  };
+
+  /** Returns an iterator to the tracked entry for the given node, or nodes_.end() */
+  std::vector<TrackedNode>::iterator findNode_(const EntityNode* node);
+  /** Returns an iterator to the tracked entry for the given node, or nodes_.end() */
+  std::vector<TrackedNode>::const_iterator findNode_(const EntityNode* node) const;
+
   /** Recalculate the bounding sphere and translate to the sphere's center. */
   void updateAveragePosition_();
 
@@ -116,7 +160,15 @@ private:
   /** Bounding sphere created by the positions of the tracked EntityNodes. */
   osg::BoundingSphere boundingSphere_;
   /** Vector of EntityNodes being tracked. */
-  std::vector<osg::observer_ptr<EntityNode> > nodes_;
+  std::vector<TrackedNode> nodes_;
+  /** True when the bounding sphere must be recalculated from all cached positions */
+  bool recomputeNeeded_;
+  /** Minimum number of updates between full recalculations */
+  unsigned int recomputeInterval_;
+  /** Number of updates since the last full recalculation */
+  unsigned int updatesSinceRecompute_;
+  /** Number of full recalculations performed */
+  unsigned int numRecomputes_;
 };
 
 }
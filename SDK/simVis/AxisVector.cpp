@@ -34,8 +34,10 @@ namespace simVis
 // --------------------------------------------------------------------------
 namespace
 {
-/// Number of points in the subdivided line strip
-const unsigned int AXIS_NUM_POINTS_PER_LINE_STRIP = 4;
+/// Number of segments in each subdivided axis line
+const unsigned int AXIS_NUM_SEGMENTS_PER_LINE = 3;
+/// Number of GL_LINES vertices used by each axis
+const unsigned int AXIS_NUM_VERTS_PER_LINE = 2 * AXIS_NUM_SEGMENTS_PER_LINE;
 }
 
 // --------------------------------------------------------------------------
@@ -44,6 +46,9 @@ AxisVector::AxisVector()
     lineWidth_(2.f),
     axisLengths_(1.f, 1.f, 1.f)
 {
+  colors_[0] = simVis::Color::Yellow;
+  colors_[1] = simVis::Color::Fuchsia;
+  colors_[2] = simVis::Color::Aqua;
   setName("AxisVector");
   init_();
 }
@@ -53,6 +58,8 @@ AxisVector::AxisVector(const AxisVector &rhs, const osg::CopyOp& copyOp)
     lineWidth_(rhs.lineWidth_),
     axisLengths_(rhs.axisLengths_)
 {
+  for (unsigned int k = 0; k < 3; ++k)
+    colors_[k] = rhs.colors_[k];
   init_();
 }
 
@@ -89,9 +96,7 @@ osg::Vec3f AxisVector::axisLengths() const
 void AxisVector::setLineWidth(float lineWidth)
 {
   lineWidth_ = lineWidth;
-  lineGroup_->getLineDrawable(0)->setLineWidth(lineWidth);
-  lineGroup_->getLineDrawable(1)->setLineWidth(lineWidth);
-  lineGroup_->getLineDrawable(2)->setLineWidth(lineWidth);
+  line_->setLineWidth(lineWidth);
 }
 
 float AxisVector::lineWidth() const
@@ -105,24 +110,32 @@ void AxisVector::setColors(const simVis::Color& x, const simVis::Color& y, const
   if (x == xColor() && y == yColor() && z == zColor())
     return;
 
-  lineGroup_->getLineDrawable(0)->setColor(x);
-  lineGroup_->getLineDrawable(1)->setColor(y);
-  lineGroup_->getLineDrawable(2)->setColor(z);
+  setAxisColor_(0, x);
+  setAxisColor_(1, y);
+  setAxisColor_(2, z);
 }
 
 simVis::Color AxisVector::xColor() const
 {
-  return lineGroup_->getLineDrawable(0)->getColor();
+  return colors_[0];
 }
 
 simVis::Color AxisVector::yColor() const
 {
-  return lineGroup_->getLineDrawable(1)->getColor();
+  return colors_[1];
 }
 
 simVis::Color AxisVector::zColor() const
 {
-  return lineGroup_->getLineDrawable(2)->getColor();
+  return colors_[2];
+}
+
+void AxisVector::setAxisColor_(unsigned int axis, const simVis::Color& color)
+{
+  colors_[axis] = color;
+  const unsigned int first = axis * AXIS_NUM_VERTS_PER_LINE;
+  for (unsigned int k = 0; k < AXIS_NUM_VERTS_PER_LINE; ++k)
+    line_->setColor(first + k, color);
 }
 
 void AxisVector::setPositionOrientation(const osg::Vec3f& pos, const osg::Vec3f& vec)
@@ -138,34 +151,25 @@ void AxisVector::setPositionOrientation(const osg::Vec3f& pos, const osg::Vec3f&
   setMatrix(rot);
 }
 
-void AxisVector::createAxisVectors_() const
-{
-  // draw x axis vector
-  osgEarth::LineDrawable* line = new osgEarth::LineDrawable(GL_LINE_STRIP);
-  line->setName("simVis::AxisVector");
-  line->allocate(AXIS_NUM_POINTS_PER_LINE_STRIP);
-  VectorScaling::generatePoints(*line, osg::Vec3(), osg::X_AXIS);
-  line->setColor(simVis::Color::Yellow);
-  line->setLineWidth(lineWidth_);
-  lineGroup_->addChild(line);
-
-  // draw y axis vector
-  line = new osgEarth::LineDrawable(GL_LINE_STRIP);
-  line->setName("simVis::AxisVector");
-  line->allocate(AXIS_NUM_POINTS_PER_LINE_STRIP);
-  VectorScaling::generatePoints(*line, osg::Vec3(), osg::Y_AXIS);
-  line->setColor(simVis::Color::Fuchsia);
-  line->setLineWidth(lineWidth_);
-  lineGroup_->addChild(line);
-
-  // draw z axis vector
-  line = new osgEarth::LineDrawable(GL_LINE_STRIP);
-  line->setName("simVis::AxisVector");
-  line->allocate(AXIS_NUM_POINTS_PER_LINE_STRIP);
-  VectorScaling::generatePoints(*line, osg::Vec3(), osg::Z_AXIS);
-  line->setColor(simVis::Color::Aqua);
-  line->setLineWidth(lineWidth_);
-  lineGroup_->addChild(line);
+void AxisVector::createAxisVectors_()
+{
+  // One drawable for all three axes; each axis is a run of subdivided segments with its own color
+  line_ = new osgEarth::LineDrawable(GL_LINES);
+  line_->setName("simVis::AxisVector");
+  line_->allocate(3 * AXIS_NUM_VERTS_PER_LINE);
+  const osg::Vec3f axes[3] = { osg::X_AXIS, osg::Y_AXIS, osg::Z_AXIS };
+  for (unsigned int axis = 0; axis < 3; ++axis)
+  {
+    const unsigned int first = axis * AXIS_NUM_VERTS_PER_LINE;
+    for (unsigned int seg = 0; seg < AXIS_NUM_SEGMENTS_PER_LINE; ++seg)
+    {
+      line_->setVertex(first + 2 * seg, axes[axis] * (static_cast<float>(seg) / AXIS_NUM_SEGMENTS_PER_LINE));
+      line_->setVertex(first + 2 * seg + 1, axes[axis] * (static_cast<float>(seg + 1) / AXIS_NUM_SEGMENTS_PER_LINE));
+    }
+    setAxisColor_(axis, colors_[axis]);
+  }
+  line_->setLineWidth(lineWidth_);
+  lineGroup_->addChild(line_.get());
 }
 
 }
@@ -30,7 +30,10 @@
 #include "simVis/Types.h"
 
 namespace osg { class Geometry; }
-namespace osgEarth { class LineGroup; }
+namespace osgEarth {
+  class LineDrawable;
+  class LineGroup;
+}
 
 namespace simVis
 {
@@ -86,14 +89,21 @@ private:
   void init_();
 
   /// create the axis vector lines
-  void createAxisVectors_() const;
+  void createAxisVectors_();
+
+  /// applies a color to the vertices of one axis
+  void setAxisColor_(unsigned int axis, const simVis::Color& color);
 
   /// width of axis vector lines
   float lineWidth_;
   /// most recent value for axis size
   osg::Vec3f axisLengths_;
-  /// holds the 3 axis vectors
+  /// holds the axis vector line
   osg::ref_ptr<osgEarth::LineGroup> lineGroup_;
+  /// all 3 axes in one GL_LINES drawable, colored per vertex
+  osg::ref_ptr<osgEarth::LineDrawable> line_;
+  /// axis colors, indexed by axis
+  simVis::Color colors_[3];
 };
 
 } // namespace simVis
@@ -36,6 +36,7 @@
 #include "simVis/LocatorNode.h"
 #include "simVis/OverheadMode.h"
 #include "simVis/Types.h"
+#include "simVis/ViewManager.h"
 
 #include "simVis/Utils.h"
 #include "simVis/Registry.h"
@@ -73,12 +74,7 @@ namespace
     return (PB_FIELD_CHANGED(a, b, verticalwidth) ||
       PB_FIELD_CHANGED(a, b, horizontalwidth));
 #else
-    if (b->rendercone() && PB_FIELD_CHANGED(a, b, horizontalwidth))
-    {
-      // manage automatic change to/from cone/pyramid when horizontalwidth crosses PI threshold
-      return ((a->horizontalwidth() <= M_PI && b->horizontalwidth() > M_PI) ||
-        (a->horizontalwidth() > M_PI && b->horizontalwidth() <= M_PI));
-    }
+    // width changes, including the cone/pyramid crossover, select the shared geometry for the new shape in place
     return false;
 #endif
   }
@@ -94,6 +90,31 @@ namespace
     return PB_FIELD_CHANGED(a, b, range);
 #endif
   }
+
+  /// Requests frames for the pulse animation while the beam is culled with its pulse on
+  class PulseCullCallback : public osg::NodeCallback
+  {
+  public:
+    explicit PulseCullCallback(simVis::BeamPulse* pulse)
+      : pulse_(pulse)
+    {
+    }
+
+    virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+    {
+      // pulse is animated in the shader, and needs continuous frames when rendering on demand
+      osg::ref_ptr<simVis::BeamPulse> pulse;
+      if (pulse_.lock(pulse) && pulse->isEnabled())
+        simVis::ViewManager::requestAnimationFrame(*nv);
+      traverse(node, nv);
+    }
+
+  protected:
+    virtual ~PulseCullCallback() {}
+
+  private:
+    osg::observer_ptr<simVis::BeamPulse> pulse_;
+  };
 }
 
 // --------------------------------------------------------------------------
@@ -101,18 +122,24 @@ namespace
 namespace simVis
 {
 BeamVolume::BeamVolume(const simData::BeamPrefs& prefs, const simData::BeamUpdate& update)
+  : beamScale_(prefs.beamscale()),
+    range_(update.has_range() ? update.range() : simVis::SVData().farRange_)
 {
   createBeamSV_(prefs, update);
   setName("Beam Volume");
-  setBeamScale_(prefs.beamscale());
+  applyScale_();
+  setRenderBins_(prefs.blended());
+}
 
+void BeamVolume::setRenderBins_(bool blended)
+{
   // if blended, use BIN_BEAM & TPA, otherwise use BIN_OPAQUE_BEAM & BIN_GLOBAL_SIMSDK
   osg::Geometry* solidGeometry = simVis::SVFactory::solidGeometry(this);
   if (solidGeometry != nullptr)
   {
     solidGeometry->getOrCreateStateSet()->setRenderBinDetails(
-      (prefs.blended() ? BIN_BEAM : BIN_OPAQUE_BEAM),
-      (prefs.blended() ? BIN_TWO_PASS_ALPHA : BIN_GLOBAL_SIMSDK));
+      (blended ? BIN_BEAM : BIN_OPAQUE_BEAM),
+      (blended ? BIN_TWO_PASS_ALPHA : BIN_GLOBAL_SIMSDK));
   }
 
   // if there is a wireframe/2nd group, it should be renderbin'd to BIN_OPAQUE_BEAM
@@ -133,10 +160,8 @@ void BeamVolume::createBeamSV_(const simData::BeamPrefs& prefs, const simData::B
   sv.color_.set(1, 1, 0, 0.5);
   sv.shape_ = simVis::SVData::SHAPE_CONE;
 
-  if (update.has_range())
-  {
-    sv.farRange_ = update.range();
-  }
+  // beam has no near face, so its vertices are proportional to range; range is applied by applyScale_()
+  sv.farRange_ = 1.0f;
 
   if (prefs.has_horizontalwidth())
     sv.hfov_deg_ = osg::RadiansToDegrees(prefs.horizontalwidth());
@@ -168,19 +193,21 @@ void BeamVolume::createBeamSV_(const simData::BeamPrefs& prefs, const simData::B
   sv.drawCone_ = prefs.drawtype() != simData::BeamPrefs_DrawType_COVERAGE;
 
   // use a "Y-forward" direction vector because the Beam is drawn in ENU LTP space.
-  simVis::SVFactory::createNode(*this, sv, osg::Y_AXIS);
+  simVis::SVFactory::createPooledNode(*this, sv, osg::Y_AXIS);
 }
 
-void BeamVolume::setBeamScale_(double beamScale)
+void BeamVolume::applyScale_()
 {
-  osg::Matrix m = getMatrix();
-  const osg::Vec3d& currentScale = m.getScale();
-  if (currentScale.x() > 0.0)
-  {
-    const double s = beamScale / currentScale.x();   // undo the old, apply the new.
-    m.preMultScale(osg::Vec3d(s, s, s));
-    setMatrix(m);
-  }
+  // a zero range collapses the volume to its origin, as unscaled geometry built at zero range would
+  const double s = beamScale_ * range_;
+  setMatrix(osg::Matrix::scale(s, s, s));
+  // pulse length and rate are in meters of range, independent of beam scale
+  BeamPulse::setRangeScale(getOrCreateStateSet(), static_cast<float>(range_));
+#ifdef OSG_GL_FIXED_FUNCTION_AVAILABLE
+  // scale is uniform, so rescaling normals is sufficient for lighting; GL_RESCALE_NORMAL is deprecated in GL CORE builds
+  if (s != 1.0)
+    getOrCreateStateSet()->setMode(GL_RESCALE_NORMAL, osg::StateAttribute::ON);
+#endif
 }
 
 /// update prefs that can be updated without rebuilding the whole beam.
@@ -220,17 +247,19 @@ void BeamVolume::performInPlacePrefChanges(const simData::BeamPrefs* a, const si
     SVFactory::updateBlending(this, b->blended());
   }
 #ifdef BEAM_IN_PLACE_UPDATES
-  if (PB_FIELD_CHANGED(a, b, verticalwidth))
-    SVFactory::updateVertAngle(this, b->verticalwidth());
-  if (PB_FIELD_CHANGED(a, b, horizontalwidth))
+  // geometry is shared between beams of the same shape; swap in the shared geometry for the new shape, keeping this node
+  if (PB_FIELD_CHANGED(a, b, verticalwidth) || PB_FIELD_CHANGED(a, b, horizontalwidth))
   {
-    int status = SVFactory::updateHorizAngle(this, b->horizontalwidth());
-    // dev error; must check changeRequiresRebuild before attempting in-place update
-    assert(status == 0);
+    removeChildren(0, getNumChildren());
+    createBeamSV_(*b, simData::BeamUpdate());
+    setRenderBins_(b->blended());
   }
 #endif
   if (PB_FIELD_CHANGED(a, b, beamscale))
-    setBeamScale_(b->beamscale());
+  {
+    beamScale_ = b->beamscale();
+    applyScale_();
+  }
 }
 
 void BeamVolume::performInPlaceUpdates(const simData::BeamUpdate* a, const simData::BeamUpdate* b)
@@ -239,10 +268,11 @@ void BeamVolume::performInPlaceUpdates(const simData::BeamUpdate* a, const simDa
     return;
 
 #ifdef BEAM_IN_PLACE_UPDATES
-  // the update method calls dirtyBound on all beam volume geometries, so no need for that here
+  // range is a scale on the shared unit-range geometry; setMatrix dirties the bound
   if (PB_FIELD_CHANGED(a, b, range))
   {
-    SVFactory::updateFarRange(this, b->range());
+    range_ = b->range();
+    applyScale_();
   }
 #endif
 }
@@ -253,6 +283,8 @@ BeamNode::BeamNode(const simData::BeamProperties& props, Locator* hostLocator, c
   : EntityNode(simData::BEAM),
     hasLastUpdate_(false),
     hasLastPrefs_(false),
+    prefsRevision_(0),
+    labelPrefsRevision_(0),
     host_(host),
     hostMissileOffset_(0.0),
     objectIndexTag_(0)
@@ -324,13 +356,19 @@ void BeamNode::updateLabel_(const simData::BeamPrefs& prefs)
 {
   if (hasLastUpdate_)
   {
+    // setPrefs() passes in the data store prefs; otherwise these are the applied prefs, which change with prefsRevision_
+    const bool prefsChanged = (&prefs != &lastPrefsApplied_) || (labelPrefsRevision_ != prefsRevision_);
+    labelPrefsRevision_ = prefsRevision_;
+    if (prefsChanged)
+      labelContent_.invalidate();
+
     std::string label = getEntityName_(prefs.commonprefs(), EntityNode::DISPLAY_NAME, false);
     if (prefs.commonprefs().labelprefs().namelength() > 0)
       label = label.substr(0, prefs.commonprefs().labelprefs().namelength());
 
     std::string text;
     if (prefs.commonprefs().labelprefs().draw())
-      text = labelContentCallback().createString(prefs, lastUpdateFromDS_, prefs.commonprefs().labelprefs().displayfields());
+      text = labelContent_.createString(labelContentCallback(), prefs, lastUpdateFromDS_, prefs.commonprefs().labelprefs().displayfields());
 
     if (!text.empty())
     {
@@ -339,7 +377,7 @@ void BeamNode::updateLabel_(const simData::BeamPrefs& prefs)
     }
 
     const float zOffset = 0.0f;
-    label_->update(prefs.commonprefs(), label, zOffset);
+    label_->update(prefs.commonprefs(), label, zOffset, prefsChanged);
   }
 }
 
@@ -357,7 +395,7 @@ std::string BeamNode::popupText() const
         prefix = getEntityName(EntityNode::ALIAS_NAME);
       prefix += "\n";
     }
-    return prefix + labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hoverdisplayfields());
+    return prefix + hoverContent_.createString(labelContentCallback(), lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hoverdisplayfields());
   }
 
   return "";
@@ -366,14 +404,14 @@ std::string BeamNode::popupText() const
 std::string BeamNode::hookText() const
 {
   if (hasLastPrefs_ && hasLastUpdate_)
-    return labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hookdisplayfields());
+    return hookContent_.createString(labelContentCallback(), lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hookdisplayfields());
   return "";
 }
 
 std::string BeamNode::legendText() const
 {
   if (hasLastPrefs_ && hasLastUpdate_)
-    return labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().legenddisplayfields());
+    return legendContent_.createString(labelContentCallback(), lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().legenddisplayfields());
 
   return "";
 }
@@ -394,10 +432,14 @@ void BeamNode::setPrefs(const simData::BeamPrefs& prefs)
   applyPrefs_(prefs);
   updateLabel_(prefs);
   lastPrefsFromDS_ = prefs;
+  hoverContent_.invalidate();
+  hookContent_.invalidate();
+  legendContent_.invalidate();
 }
 
 void BeamNode::applyPrefs_(const simData::BeamPrefs& prefs, bool force)
 {
+  ++prefsRevision_;
   if (prefsOverrides_.size() == 0)
   {
     apply_(nullptr, &prefs, force);
@@ -421,7 +463,11 @@ void BeamNode::applyPrefs_(const simData::BeamPrefs& prefs, bool force)
   if (prefs.animate())
   {
     if (beamPulse_ == nullptr)
+    {
       beamPulse_ = new simVis::BeamPulse(getOrCreateStateSet());
+      // added after the horizon cull callback, so beams culled by the horizon do not request frames
+      addCullCallback(new PulseCullCallback(beamPulse_.get()));
+    }
 
     beamPulse_->setEnabled(true);
     beamPulse_->setLength(static_cast<float>(prefs.pulselength()));
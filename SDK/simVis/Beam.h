@@ -28,6 +28,7 @@
 #include "simData/DataTypes.h"
 #include "simVis/Constants.h"
 #include "simVis/Entity.h"
+#include "simVis/LabelContentCache.h"
 #include "simVis/SphericalVolume.h"
 
 namespace osg { class MatrixTransform; }
@@ -67,11 +68,19 @@ namespace simVis
     virtual ~BeamVolume() {}
 
   private:
-    /// build the spherical volume
+    /// build the spherical volume, at unit range, sharing geometry with other beams of the same shape
     void createBeamSV_(const simData::BeamPrefs& prefs, const simData::BeamUpdate& update);
 
-    /// apply the beam scale pref to the specified node
-    void setBeamScale_(double beamScale);
+    /// apply the beam scale pref and the beam range to the volume's transform
+    void applyScale_();
+
+    /// assign render bins to the solid geometry and opaque group, based on the blended pref
+    void setRenderBins_(bool blended);
+
+    /// beam scale pref
+    double beamScale_;
+    /// beam range in meters; the volume geometry has unit range, so range is applied as a scale
+    double range_;
   };
 
 
@@ -340,6 +349,15 @@ namespace simVis
     simData::BeamUpdate     lastUpdateApplied_;
     bool                    hasLastUpdate_;
     bool                    hasLastPrefs_;
+    /// incremented each time prefs are applied
+    unsigned int            prefsRevision_;
+    /// prefsRevision_ as of the last label update
+    unsigned int            labelPrefsRevision_;
+    /// label content for the label, hover, hook and legend display fields
+    LabelContentCache       labelContent_;
+    mutable LabelContentCache hoverContent_;
+    mutable LabelContentCache hookContent_;
+    mutable LabelContentCache legendContent_;
 
     osg::ref_ptr<BeamVolume>  beamVolume_;
     osg::ref_ptr<LocalGridNode> localGrid_;
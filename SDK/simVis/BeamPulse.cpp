@@ -34,10 +34,12 @@ namespace
   const std::string LENGTH_UNIFORM = "simvis_beampulse_length";
   const std::string RATE_UNIFORM = "simvis_beampulse_rate";
   const std::string STIPPLE_PATTERN_UNIFORM = "simvis_beampulse_stipplepattern";
+  const std::string RANGE_SCALE_UNIFORM = "simvis_beampulse_rangescale";
 
   const float DEFAULT_LENGTH = 100.0f; // meters
   const float DEFAULT_RATE= 1.0f; // hz
   const unsigned int DEFAULT_STIPPLE = 0x0f0fu; // bitmask
+  const float DEFAULT_RANGE_SCALE = 1.0f; // meters per model unit
 }
 
 BeamPulse::BeamPulse(osg::StateSet* stateset)
@@ -82,6 +84,12 @@ void BeamPulse::setEnabled(bool active)
     enabled_->set(active);
 }
 
+bool BeamPulse::isEnabled() const
+{
+  bool active = false;
+  return enabled_.valid() && enabled_->get(active) && active;
+}
+
 void BeamPulse::setLength(float length)
 {
   if (length_.valid())
@@ -100,6 +108,12 @@ void BeamPulse::setStipplePattern(uint16_t pattern)
     stipplePattern_->set(static_cast<unsigned int>(pattern));
 }
 
+void BeamPulse::setRangeScale(osg::StateSet* stateSet, float scale)
+{
+  if (stateSet)
+    stateSet->getOrCreateUniform(RANGE_SCALE_UNIFORM, osg::Uniform::FLOAT)->set(scale);
+}
+
 void BeamPulse::setDefaultValues_(osg::StateSet* stateSet)
 {
   stateSet
@@ -114,6 +128,9 @@ void BeamPulse::setDefaultValues_(osg::StateSet* stateSet)
   stateSet
     ->getOrCreateUniform(STIPPLE_PATTERN_UNIFORM, osg::Uniform::UNSIGNED_INT)
     ->set(DEFAULT_STIPPLE);
+  stateSet
+    ->getOrCreateUniform(RANGE_SCALE_UNIFORM, osg::Uniform::FLOAT)
+    ->set(DEFAULT_RANGE_SCALE);
 }
 
 }
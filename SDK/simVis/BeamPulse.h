@@ -51,6 +51,8 @@ public:
 
   /** Turns the pulse effect on or off */
   void setEnabled(bool active);
+  /** Returns true if the pulse effect is on */
+  bool isEnabled() const;
   /**
    * Sets the range between start and stop of a pulse in meters from the origin.  The pattern
    * repeats every (length) meters.  The animation loops (rate) times per real second.
@@ -61,6 +63,12 @@ public:
   /** Changes the stipple pattern (16 bit mask of beam parts to have on) */
   void setStipplePattern(uint16_t pattern);
 
+  /**
+   * Sets the number of meters per model unit along the pulse axis for geometry under the state set,
+   * for volumes built at unit range and scaled to range by a transform.  Defaults to 1.
+   */
+  static void setRangeScale(osg::StateSet* stateSet, float scale);
+
   /**
    * Before using this class a call to installShaderProgram is required.  This
    * method installs the shader program and default uniform variables for
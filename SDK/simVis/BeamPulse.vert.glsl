@@ -4,10 +4,12 @@
 #pragma vp_location vertex_model
 #pragma vp_order 3.0
 
+uniform float simvis_beampulse_rangescale; // meters per model unit
+
 out float simvis_beampulse_y;
 
-// Get the y distance of the vertex shader from origin
+// Get the y distance of the vertex shader from origin, in meters
 void simvis_beampulse_vert(inout vec4 vertex)
 {
-  simvis_beampulse_y = vertex.y / vertex.w;
+  simvis_beampulse_y = simvis_beampulse_rangescale * vertex.y / vertex.w;
 }
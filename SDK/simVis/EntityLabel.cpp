@@ -60,8 +60,15 @@ EntityLabelNode::~EntityLabelNode()
 }
 
 /// Update the label with the given preferences and text
-void EntityLabelNode::update(const simData::CommonPrefs& commonPrefs, const std::string& text, float zOffset)
+void EntityLabelNode::update(const simData::CommonPrefs& commonPrefs, const std::string& text, float zOffset, bool prefsChanged)
 {
+  // Prefs were applied last time, which also means the label exists; only the text and offset can differ
+  if (!prefsChanged && hasLastPrefs_)
+  {
+    applyTextAndOffset_(text, zOffset);
+    return;
+  }
+
   const simData::LabelPrefs& labelPrefs = commonPrefs.labelprefs();
 
   // whether to draw the label at all:
@@ -188,22 +195,30 @@ void EntityLabelNode::update(const simData::CommonPrefs& commonPrefs, const std:
       label_->setStyle(style);
     }
 
-    // apply the local altitude offset passed in
-    const osg::Vec3d labelOffset(0.0, 0.0, zOffset);
-    if (label_->getLocalOffset() != labelOffset)
-      label_->setLocalOffset(labelOffset);
-
-    // check for an update:
-    if (text != lastText_)
-    {
-      label_->setText(text);
-      lastText_ = text;
-    }
+    applyTextAndOffset_(text, zOffset);
   }
 
   lastCommonPrefs_ = commonPrefs;
   hasLastPrefs_ = true;
 }
 
+void EntityLabelNode::applyTextAndOffset_(const std::string& text, float zOffset)
+{
+  if (!label_.valid())
+    return;
+
+  // apply the local altitude offset passed in
+  const osg::Vec3d labelOffset(0.0, 0.0, zOffset);
+  if (label_->getLocalOffset() != labelOffset)
+    label_->setLocalOffset(labelOffset);
+
+  // check for an update:
+  if (text != lastText_)
+  {
+    label_->setText(text);
+    lastText_ = text;
+  }
+}
+
 }
 
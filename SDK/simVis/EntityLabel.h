@@ -45,8 +45,15 @@ public:
   /// constructor for (custom rendering) entity that does not provide a transform-derived parent to position the label
   explicit EntityLabelNode(simVis::Locator* locator);
 
-  /// Update the label with the given preferences and text
-  void update(const simData::CommonPrefs& commonPrefs, const std::string& text, float zOffset=0.f);
+  /**
+   * Update the label with the given preferences and text
+   * @param commonPrefs Preferences for the entity
+   * @param text Label text
+   * @param zOffset Local altitude offset for the label
+   * @param prefsChanged Callers may pass false if commonPrefs are the same as in the previous call, in which
+   *   case only the text and offset are checked, and nothing is done if they are unchanged
+   */
+  void update(const simData::CommonPrefs& commonPrefs, const std::string& text, float zOffset=0.f, bool prefsChanged=true);
 
   /** Return the proper library name */
   virtual const char* libraryName() const { return "simVis"; }
@@ -61,6 +68,9 @@ private:
   /** Copy constructor, not implemented or available. */
   EntityLabelNode(const EntityLabelNode&);
 
+  /** Applies changes to the text and local offset to the existing label */
+  void applyTextAndOffset_(const std::string& text, float zOffset);
+
   osg::ref_ptr<LocatorNode> locatorNode_; // optional locator node to position the label
   osg::ref_ptr<osgEarth::LabelNode> label_;  ///< The actual label
   simData::CommonPrefs lastCommonPrefs_;  ///< The last preferences to check for changes
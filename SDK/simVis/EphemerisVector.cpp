@@ -82,11 +82,92 @@ private:
   int maxDelta_;
 };
 
+// --------------------------------------------------------------------------
+EphemerisCache::EphemerisCache(osgEarth::Ephemeris* ephemeris, size_t maxEntries)
+  : ephemeris_(ephemeris),
+    maxEntries_(simCore::sdkMax(static_cast<size_t>(1), maxEntries))
+{
+  if (!ephemeris_.valid())
+    ephemeris_ = new osgEarth::Ephemeris;
+}
+
+EphemerisCache::~EphemerisCache()
+{
+}
+
+const osg::Vec3d& EphemerisCache::sunPosition(const simCore::TimeStamp& timeStamp)
+{
+  Entry& entry = entry_(timeStamp);
+  if (!entry.hasSun)
+  {
+    const osgEarth::DateTime dateTime(timeStamp.secondsSinceRefYear(1970).getSeconds());
+    entry.sun = ephemeris_->getSunPosition(dateTime).geocentric;
+    entry.hasSun = true;
+  }
+  return entry.sun;
+}
+
+const osg::Vec3d& EphemerisCache::moonPosition(const simCore::TimeStamp& timeStamp)
+{
+  Entry& entry = entry_(timeStamp);
+  if (!entry.hasMoon)
+  {
+    const osgEarth::DateTime dateTime(timeStamp.secondsSinceRefYear(1970).getSeconds());
+    entry.moon = ephemeris_->getMoonPosition(dateTime).geocentric;
+    entry.hasMoon = true;
+  }
+  return entry.moon;
+}
+
+void EphemerisCache::setMaxEntries(size_t maxEntries)
+{
+  maxEntries_ = simCore::sdkMax(static_cast<size_t>(1), maxEntries);
+  while (insertionOrder_.size() > maxEntries_)
+  {
+    entries_.erase(insertionOrder_.front());
+    insertionOrder_.pop_front();
+  }
+}
+
+size_t EphemerisCache::maxEntries() const
+{
+  return maxEntries_;
+}
+
+size_t EphemerisCache::size() const
+{
+  return entries_.size();
+}
+
+void EphemerisCache::clear()
+{
+  entries_.clear();
+  insertionOrder_.clear();
+}
+
+EphemerisCache::Entry& EphemerisCache::entry_(const simCore::TimeStamp& timeStamp)
+{
+  auto iter = entries_.find(timeStamp);
+  if (iter != entries_.end())
+    return iter->second;
+
+  // Make room for the new time by discarding the oldest
+  while (insertionOrder_.size() >= maxEntries_)
+  {
+    entries_.erase(insertionOrder_.front());
+    insertionOrder_.pop_front();
+  }
+  insertionOrder_.push_back(timeStamp);
+  Entry& entry = entries_[timeStamp];
+  entry.hasSun = false;
+  entry.hasMoon = false;
+  return entry;
+}
+
 // --------------------------------------------------------------------------
 EphemerisVector::EphemerisVector(const simVis::Color& moonColor, const simVis::Color& sunColor, float lineWidth)
   : Group(),
     coordConvert_(new simCore::CoordinateConverter),
-    ephemeris_(new osgEarth::Ephemeris),
     lastUpdateTime_(simCore::INFINITE_TIME_STAMP),
     hasLastPrefs_(false)
 {
@@ -147,10 +228,10 @@ void EphemerisVector::rebuild_(const simData::PlatformPrefs& prefs)
     return;
   }
 
-  // Pull out the DateTime that we can then send to the Ephemeris calculations
+  // Ephemeris positions are shared by all platforms at the same time
   const simCore::TimeStamp& timeStamp = clock->currentTime();
   lastUpdateTime_ = timeStamp;
-  const osgEarth::DateTime dateTime(timeStamp.secondsSinceRefYear(1970).getSeconds());
+  EphemerisCache* ephemerisCache = simVis::Registry::instance()->ephemerisCache();
 
   // Reset the coordinate conversion center point
   const simCore::Coordinate asEcef(simCore::COORD_SYS_ECEF, simCore::Vec3(lastUpdate_.x(), lastUpdate_.y(), lastUpdate_.z()));
@@ -165,8 +246,7 @@ void EphemerisVector::rebuild_(const simData::PlatformPrefs& prefs)
   osgEarth::LineDrawable* moonGeom = geomGroup_->getLineDrawable(VECTOR_MOON);
   if (prefs.drawmoonvec())
   {
-    const osgEarth::CelestialBody& moon = ephemeris_->getMoonPosition(dateTime);
-    rebuildLine_(moonGeom, moon.geocentric, lineLength);
+    rebuildLine_(moonGeom, ephemerisCache->moonPosition(timeStamp), lineLength);
     moonGeom->setNodeMask(DISPLAY_MASK_EPHEMERIS);
   }
   else
@@ -176,8 +256,7 @@ void EphemerisVector::rebuild_(const simData::PlatformPrefs& prefs)
   osgEarth::LineDrawable* sunGeom = geomGroup_->getLineDrawable(VECTOR_SUN);
   if (prefs.drawsunvec())
   {
-    const osgEarth::CelestialBody& sun = ephemeris_->getSunPosition(dateTime);
-    rebuildLine_(sunGeom, sun.geocentric, lineLength);
+    rebuildLine_(sunGeom, ephemerisCache->sunPosition(timeStamp), lineLength);
     sunGeom->setNodeMask(DISPLAY_MASK_EPHEMERIS);
   }
   else
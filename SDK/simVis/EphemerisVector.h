@@ -23,6 +23,8 @@
 #ifndef SIMVIS_EPHEMERISVECTOR_H
 #define SIMVIS_EPHEMERISVECTOR_H
 
+#include <deque>
+#include <map>
 #include "osgEarth/Ephemeris"
 #include "simCore/Common/Common.h"
 #include "simCore/Time/TimeClass.h"
@@ -40,6 +42,60 @@ namespace simVis
 
 class PlatformModelNode;
 
+/**
+ * Caches geocentric sun and moon positions by scenario time.  The ephemeris result for a given
+ * time is identical for every platform, so all consumers at the same time share one evaluation.
+ * The cache holds a bounded number of times, discarding the oldest entry first.  Not thread safe;
+ * intended for use from the update traversal.  A shared instance is available from the Registry.
+ */
+class SDKVIS_EXPORT EphemerisCache : public osg::Referenced
+{
+public:
+  /**
+   * Construct a new ephemeris cache.
+   * @param ephemeris Ephemeris model used to evaluate positions; if nullptr, a default osgEarth::Ephemeris is used
+   * @param maxEntries Maximum number of distinct times to retain; minimum of 1
+   */
+  explicit EphemerisCache(osgEarth::Ephemeris* ephemeris = nullptr, size_t maxEntries = 16);
+
+  /** Retrieves the geocentric (ECEF) position of the sun at the given time, evaluating only if not cached */
+  const osg::Vec3d& sunPosition(const simCore::TimeStamp& timeStamp);
+  /** Retrieves the geocentric (ECEF) position of the moon at the given time, evaluating only if not cached */
+  const osg::Vec3d& moonPosition(const simCore::TimeStamp& timeStamp);
+
+  /** Changes the maximum number of distinct times to retain, discarding oldest entries as needed */
+  void setMaxEntries(size_t maxEntries);
+  /** Retrieves the maximum number of distinct times retained */
+  size_t maxEntries() const;
+  /** Number of distinct times currently cached */
+  size_t size() const;
+  /** Removes all cached positions */
+  void clear();
+
+protected:
+  /// osg::Referenced-derived
+  virtual ~EphemerisCache();
+
+private:
+  /// Positions for a single time; each body is evaluated lazily on first request
+  struct Entry
+  {
+    bool hasSun;
+    bool hasMoon;
+    osg::Vec3d sun;
+    osg::Vec3d moon;
+  };
+
+  /// Returns the entry for the given time, creating it (and discarding the oldest entry) if needed
+  Entry& entry_(const simCore::TimeStamp& timeStamp);
+
+  osg::ref_ptr<osgEarth::Ephemeris> ephemeris_;
+  size_t maxEntries_;
+  std::map<simCore::TimeStamp, Entry> entries_;
+  /// Insertion order of the times in entries_, oldest first
+  std::deque<simCore::TimeStamp> insertionOrder_;
+};
+
 /// Attachment node for a platform's ephemeris vector graphics.
 class SDKVIS_EXPORT EphemerisVector : public osg::Group
 {
@@ -94,7 +150,6 @@ private:
 
   osg::ref_ptr<osgEarth::LineGroup> geomGroup_;
   osg::observer_ptr<const PlatformModelNode> modelNode_;
-  osg::ref_ptr<osgEarth::Ephemeris> ephemeris_;
 
   /// Last clock time when we rebuilt the line; detect time drift to rebuild line for entites that don't move
   simCore::TimeStamp lastUpdateTime_;
@@ -0,0 +1,224 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "osgEarth/GLUtils"
+#include "osgEarth/LineDrawable"
+#include "osgEarth/PointDrawable"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/GOG/GogShape.h"
+#include "simCore/String/Format.h"
+#include "simVis/Types.h"
+#include "simVis/Utils.h"
+#include "simVis/GOG/BulkGeometry.h"
+
+namespace simVis { namespace GOG {
+
+/** Shapes with fewer points than this go through the osgEarth feature pipeline */
+unsigned int BulkGeometry::minimumBulkSize_ = 10000;
+
+BulkGeometry::BulkGeometry(Mode mode)
+  : mode_(mode),
+    numVertices_(0),
+    color_(simVis::Color::White)
+{
+  setName("simVis::GOG::BulkGeometry");
+  if (mode_ == BULK_POINTS)
+  {
+    points_ = new osgEarth::PointDrawable();
+    points_->setName("GOG Bulk Points");
+    addChild(points_.get());
+  }
+  else
+  {
+    lineGroup_ = new osgEarth::LineGroup();
+    lines_ = new osgEarth::LineDrawable(GL_LINES);
+    lines_->setName("GOG Bulk LineSegs");
+    lineGroup_->addChild(lines_.get());
+    addChild(lineGroup_.get());
+  }
+  simVis::setLighting(getOrCreateStateSet(), osg::StateAttribute::OFF);
+}
+
+BulkGeometry::~BulkGeometry()
+{
+}
+
+BulkGeometry::Mode BulkGeometry::mode() const
+{
+  return mode_;
+}
+
+void BulkGeometry::setPositions(const std::vector<simCore::Vec3>& lla, double altOffset)
+{
+  // Convert everything to ECEF once, pairing up segments for lines
+  std::vector<simCore::Vec3> ecef;
+  ecef.reserve(lla.size());
+  simCore::Vec3 first;
+  simCore::Vec3 second;
+  if (mode_ == BULK_POINTS)
+  {
+    for (const simCore::Vec3& pos : lla)
+    {
+      simCore::CoordinateConverter::convertGeodeticPosToEcef(simCore::Vec3(pos.lat(), pos.lon(), pos.alt() + altOffset), first);
+      ecef.push_back(first);
+    }
+  }
+  else
+  {
+    for (size_t k = 0; k + 1 < lla.size(); k += 2)
+    {
+      // Avoid adding the same point twice
+      if (lla[k] == lla[k + 1])
+        continue;
+      simCore::CoordinateConverter::convertGeodeticPosToEcef(simCore::Vec3(lla[k].lat(), lla[k].lon(), lla[k].alt() + altOffset), first);
+      simCore::CoordinateConverter::convertGeodeticPosToEcef(simCore::Vec3(lla[k + 1].lat(), lla[k + 1].lon(), lla[k + 1].alt() + altOffset), second);
+      ecef.push_back(first);
+      ecef.push_back(second);
+    }
+  }
+
+  ecefBounds_.init();
+  for (const simCore::Vec3& pos : ecef)
+    ecefBounds_.expandBy(osg::Vec3d(pos.x(), pos.y(), pos.z()));
+  const osg::Vec3d anchor = ecefBounds_.valid() ? ecefBounds_.center() : osg::Vec3d();
+  setMatrix(osg::Matrixd::translate(anchor));
+
+  const bool resized = (ecef.size() != numVertices_);
+  numVertices_ = static_cast<unsigned int>(ecef.size());
+  if (mode_ == BULK_POINTS)
+  {
+    if (resized)
+    {
+      points_->clear();
+      points_->allocate(numVertices_);
+    }
+    for (unsigned int k = 0; k < numVertices_; ++k)
+      points_->setVertex(k, osg::Vec3d(ecef[k].x(), ecef[k].y(), ecef[k].z()) - anchor);
+    if (resized)
+    {
+      points_->setColor(color_);
+      points_->finish();
+    }
+    points_->dirtyBound();
+  }
+  else
+  {
+    if (resized)
+    {
+      lines_->clear();
+      lines_->allocate(numVertices_);
+    }
+    for (unsigned int k = 0; k < numVertices_; ++k)
+      lines_->setVertex(k, osg::Vec3d(ecef[k].x(), ecef[k].y(), ecef[k].z()) - anchor);
+    if (resized)
+    {
+      lines_->setColor(color_);
+      lines_->finish();
+    }
+    lines_->dirtyBound();
+  }
+  dirtyBound();
+}
+
+unsigned int BulkGeometry::numVertices() const
+{
+  return numVertices_;
+}
+
+unsigned int BulkGeometry::numPrimitives() const
+{
+  return (mode_ == BULK_POINTS) ? numVertices_ : numVertices_ / 2;
+}
+
+const osg::BoundingBoxd& BulkGeometry::ecefBounds() const
+{
+  return ecefBounds_;
+}
+
+void BulkGeometry::setColor(const osg::Vec4f& color)
+{
+  if (color == color_)
+    return;
+  color_ = color;
+  if (points_.valid())
+    points_->setColor(color_);
+  if (lines_.valid())
+    lines_->setColor(color_);
+}
+
+const osg::Vec4f& BulkGeometry::color() const
+{
+  return color_;
+}
+
+void BulkGeometry::setPointSize(float pointSize)
+{
+  if (points_.valid())
+    osgEarth::GLUtils::setPointSize(points_->getOrCreateStateSet(), pointSize, osg::StateAttribute::ON);
+}
+
+void BulkGeometry::setLineWidth(float lineWidth)
+{
+  if (lines_.valid())
+    lines_->setLineWidth(lineWidth);
+}
+
+void BulkGeometry::setStipple(unsigned short pattern)
+{
+  if (lines_.valid())
+    lines_->setStipplePattern(pattern);
+}
+
+unsigned int BulkGeometry::minimumBulkSize()
+{
+  return minimumBulkSize_;
+}
+
+void BulkGeometry::setMinimumBulkSize(unsigned int numPoints)
+{
+  minimumBulkSize_ = numPoints;
+}
+
+bool BulkGeometry::supportsShape(const simCore::GOG::GogShape& shape, size_t numPoints, bool attached)
+{
+  if (minimumBulkSize_ == 0 || numPoints < minimumBulkSize_ || attached || shape.isRelative())
+    return false;
+
+  simCore::GOG::AltitudeMode altMode = simCore::GOG::AltitudeMode::NONE;
+  shape.getAltitudeMode(altMode);
+  if (altMode != simCore::GOG::AltitudeMode::NONE)
+    return false;
+
+  // Geoid-relative (EGM) altitudes are converted by the osgEarth SRS, which this node does not use
+  std::string vdatum;
+  shape.getVerticalDatum(vdatum);
+  if (simCore::caseCompare(vdatum.substr(0, 3), "egm") == 0)
+    return false;
+
+  const simCore::GOG::PointBasedShape* pointBased = dynamic_cast<const simCore::GOG::PointBasedShape*>(&shape);
+  simCore::GOG::TessellationStyle tessellation = simCore::GOG::TessellationStyle::NONE;
+  if (pointBased)
+    pointBased->getTessellation(tessellation);
+  return tessellation == simCore::GOG::TessellationStyle::NONE;
+}
+
+} }
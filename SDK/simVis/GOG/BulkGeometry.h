@@ -0,0 +1,122 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMVIS_GOG_BULKGEOMETRY_H
+#define SIMVIS_GOG_BULKGEOMETRY_H
+
+#include <vector>
+#include "osg/BoundingBox"
+#include "osg/MatrixTransform"
+#include "osg/ref_ptr"
+#include "simCore/Common/Common.h"
+#include "simCore/Calc/Vec3.h"
+
+namespace simCore { namespace GOG { class GogShape; } }
+namespace osgEarth {
+  class LineDrawable;
+  class LineGroup;
+  class PointDrawable;
+}
+
+namespace simVis { namespace GOG {
+
+/**
+ * Direct vertex-array rendering for large GOG point and line segment shapes.  Absolute positions are converted
+ * once to ECEF and packed into a single osgEarth PointDrawable or GL_LINES LineDrawable, bypassing the
+ * osgEarth feature pipeline that would otherwise build geometry per point.  Vertices are stored relative to the
+ * center of their ECEF bounds, which this transform's matrix restores, to limit single precision error.
+ *
+ * The node draws at the absolute altitudes given; it does not clamp to terrain or tessellate segments.
+ */
+class SDKVIS_EXPORT BulkGeometry : public osg::MatrixTransform
+{
+public:
+  /** Primitive type drawn */
+  enum Mode
+  {
+    BULK_POINTS = 0,
+    BULK_LINES
+  };
+
+  /** Creates an empty node drawing the given primitive type */
+  explicit BulkGeometry(Mode mode);
+
+  /** Primitive type drawn */
+  Mode mode() const;
+
+  /**
+   * Replaces the vertices.  In BULK_LINES mode consecutive pairs form segments; a trailing unpaired point and
+   * zero-length segments are dropped, matching simVis::GOG::LineSegs.
+   * @param lla Positions as latitude and longitude in radians, altitude in meters (WGS-84)
+   * @param altOffset Offset in meters added to every altitude
+   */
+  void setPositions(const std::vector<simCore::Vec3>& lla, double altOffset = 0.0);
+
+  /** Number of vertices in the drawable */
+  unsigned int numVertices() const;
+  /** Number of points or segments drawn */
+  unsigned int numPrimitives() const;
+  /** Bounds of the vertices in ECEF meters */
+  const osg::BoundingBoxd& ecefBounds() const;
+
+  /** Color of every vertex */
+  void setColor(const osg::Vec4f& color);
+  /** Color of every vertex */
+  const osg::Vec4f& color() const;
+  /** Point size in pixels; BULK_POINTS only */
+  void setPointSize(float pointSize);
+  /** Line width in pixels; BULK_LINES only */
+  void setLineWidth(float lineWidth);
+  /** Line stipple pattern; BULK_LINES only */
+  void setStipple(unsigned short pattern);
+
+  /** Minimum number of points at which GOG Points and LineSegs use this node; 0 disables the bulk path */
+  static unsigned int minimumBulkSize();
+  /** Changes the minimum number of points at which GOG Points and LineSegs use this node */
+  static void setMinimumBulkSize(unsigned int numPoints);
+
+  /**
+   * Returns true if the shape can be drawn by this node without losing any of its attributes: an unattached
+   * absolute shape at or above minimumBulkSize() points, drawn at WGS-84 altitudes with no terrain clamping,
+   * extrusion or tessellation.
+   */
+  static bool supportsShape(const simCore::GOG::GogShape& shape, size_t numPoints, bool attached);
+
+protected:
+  /** osg::Referenced-derived */
+  virtual ~BulkGeometry();
+
+private:
+  Mode mode_;
+  osg::ref_ptr<osgEarth::PointDrawable> points_;
+  osg::ref_ptr<osgEarth::LineGroup> lineGroup_;
+  osg::ref_ptr<osgEarth::LineDrawable> lines_;
+  unsigned int numVertices_;
+  osg::BoundingBoxd ecefBounds_;
+  osg::Vec4f color_;
+
+  static unsigned int minimumBulkSize_;
+};
+
+} } // namespace simVis::GOG
+
+#endif // SIMVIS_GOG_BULKGEOMETRY_H
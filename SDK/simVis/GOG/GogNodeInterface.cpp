@@ -35,6 +35,7 @@
 #include "osgEarth/LocalGeometryNode"
 #include "osgEarth/ObjectIndex"
 #include "osgEarth/PlaceNode"
+#include "osgEarth/PointSymbol"
 #include "osgEarth/PolygonSymbol"
 #include "osgEarth/Registry"
 #include "osgEarth/RenderSymbol"
@@ -55,6 +56,7 @@
 #include "simVis/Registry.h"
 #include "simVis/Types.h"
 #include "simVis/Utils.h"
+#include "simVis/GOG/BulkGeometry.h"
 #include "simVis/GOG/GOGNode.h"
 #include "simVis/GOG/LoaderUtils.h"
 #include "simVis/GOG/ParsedShape.h"
@@ -977,7 +979,7 @@ int GogNodeInterface::getOpacity(float& opacity) const
   return 0;
 }
 
-void GogNodeInterface::setAltitudeMode(AltitudeMode altMode)
+int GogNodeInterface::setAltitudeMode(AltitudeMode altMode)
 {
   // not all shapes support extrude
   if (altMode == ALTITUDE_EXTRUDE)
@@ -986,18 +988,19 @@ void GogNodeInterface::setAltitudeMode(AltitudeMode altMode)
     {
     case simVis::GOG::GOG_POINTS:
     case simVis::GOG::GOG_CYLINDER:
-      return;
+      return 1;
     default:
       break;
     }
   }
   metaData_.setExplicitly(GOG_ALTITUDE_MODE_SET);
   if (altMode_ == altMode)
-    return;
+    return 0;
   altMode_ = altMode;
   adjustAltitude_();
   if (shape_)
     shape_->setAltitudeMode(LoaderUtils::convertToCoreAltitudeMode(altMode));
+  return 0;
 }
 
 void GogNodeInterface::setAltOffset(double altOffsetMeters)
@@ -1084,7 +1087,7 @@ int GogNodeInterface::setDrawState(bool draw)
   return 0;
 }
 
-void GogNodeInterface::setExtrude(bool extrude)
+int GogNodeInterface::setExtrude(bool extrude)
 {
   metaData_.setExplicitly(GOG_EXTRUDE_SET);
   float height = static_cast<float>(extrudedHeight_);
@@ -1095,7 +1098,7 @@ void GogNodeInterface::setExtrude(bool extrude)
   case simVis::GOG::GOG_HEMISPHERE:
   case simVis::GOG::GOG_SPHERE:
   case simVis::GOG::GOG_CONE:
-    return;
+    return 1;
     // need to specify height for circular shapes
   case simVis::GOG::GOG_ARC:
   case simVis::GOG::GOG_CIRCLE:
@@ -1166,6 +1169,7 @@ void GogNodeInterface::setExtrude(bool extrude)
     assert(style_.getSymbol<osgEarth::PolygonSymbol>()->fill()->color()[3] == 0.);
   if (extruded_ && shape_)
     shape_->setAltitudeMode(simCore::GOG::AltitudeMode::EXTRUDE);
+  return 0;
 }
 
 void GogNodeInterface::setExtrudedHeight(double extrudeHeightM)
@@ -1810,7 +1814,7 @@ void FeatureNodeInterface::setAltOffset(double altOffsetMeters)
     shape_->setAltitudeOffset(altOffsetMeters);
 }
 
-void FeatureNodeInterface::setExtrude(bool extrude)
+int FeatureNodeInterface::setExtrude(bool extrude)
 {
   if (extrude)
   {
@@ -1824,7 +1828,7 @@ void FeatureNodeInterface::setExtrude(bool extrude)
     if (alt)
       alt->clamping() = osgEarth::AltitudeSymbol::CLAMP_NONE;
   }
-  GogNodeInterface::setExtrude(extrude);
+  return GogNodeInterface::setExtrude(extrude);
 }
 
 void FeatureNodeInterface::setTessellation(TessellationStyle style)
@@ -1912,11 +1916,11 @@ void FeatureNodeInterface::setTessellation(TessellationStyle style)
     pointBased->setTesssellation(LoaderUtils::convertToCoreTessellation(style));
 }
 
-void FeatureNodeInterface::setAltitudeMode(AltitudeMode altMode)
+int FeatureNodeInterface::setAltitudeMode(AltitudeMode altMode)
 {
   metaData_.setExplicitly(GOG_ALTITUDE_MODE_SET);
   if (altMode_ == altMode)
-    return;
+    return 0;
   altMode_ = altMode;
   // The altitude mode combinations applied here should match those in the hasValidAltitudeMode() method. Update both methods with changes.
   setExtrude(altMode == ALTITUDE_EXTRUDE);
@@ -1925,7 +1929,7 @@ void FeatureNodeInterface::setAltitudeMode(AltitudeMode altMode)
   {
     // Assertion failure means failure in setExtrude()
     assert(altMode == ALTITUDE_EXTRUDE);
-    return;
+    return 0;
   }
 
   switch (altMode)
@@ -1952,6 +1956,7 @@ void FeatureNodeInterface::setAltitudeMode(AltitudeMode altMode)
 
   if (shape_)
     shape_->setAltitudeMode(LoaderUtils::convertToCoreAltitudeMode(altMode));
+  return 0;
 }
 
 void FeatureNodeInterface::adjustAltitude_()
@@ -2300,13 +2305,13 @@ int CylinderNodeInterface::getPosition(osg::Vec3d& position, osgEarth::GeoPoint*
   return findLocalGeometryPosition(sideNode_.get(), referencePosition, position, true);
 }
 
-void CylinderNodeInterface::setAltitudeMode(AltitudeMode altMode)
+int CylinderNodeInterface::setAltitudeMode(AltitudeMode altMode)
 {
   // cylinder doesn't support extrusion
   if (altMode == ALTITUDE_EXTRUDE)
-    return;
+    return 1;
 
-  GogNodeInterface::setAltitudeMode(altMode);
+  return GogNodeInterface::setAltitudeMode(altMode);
 }
 
 void CylinderNodeInterface::adjustAltitude_()
@@ -2793,4 +2798,147 @@ void LatLonAltBoxInterface::applyAltOffsets_(osgEarth::FeatureNode& node, const
   node.dirty();
 }
 
+///////////////////////////////////////////////////////////////////
+
+BulkGeometryNodeInterface::BulkGeometryNodeInterface(BulkGeometry* node, const std::vector<simCore::Vec3>& lla, const osgEarth::Style& style, const simVis::GOG::GogMetaData& metaData)
+  : GogNodeInterface(node, metaData),
+    bulkNode_(node),
+    lla_(lla)
+{
+  hasMapNode_ = true; // positions are absolute, same as a feature node
+  setStyle_(style);
+  initializeFillColor_();
+  initializeLineColor_();
+}
+
+int BulkGeometryNodeInterface::getPosition(osg::Vec3d& position, osgEarth::GeoPoint* referencePosition) const
+{
+  if (lla_.empty())
+    return 1;
+
+  // bounding box of lon/lat in degrees, same as FeatureNodeInterface
+  double minX = std::numeric_limits<double>::max();
+  double maxX = -std::numeric_limits<double>::max();
+  double minY = std::numeric_limits<double>::max();
+  double maxY = -std::numeric_limits<double>::max();
+  for (const simCore::Vec3& lla : lla_)
+  {
+    minX = simCore::sdkMin(minX, lla.lon() * simCore::RAD2DEG);
+    maxX = simCore::sdkMax(maxX, lla.lon() * simCore::RAD2DEG);
+    minY = simCore::sdkMin(minY, lla.lat() * simCore::RAD2DEG);
+    maxY = simCore::sdkMax(maxY, lla.lat() * simCore::RAD2DEG);
+  }
+
+  position.x() = minX + (maxX - minX) / 2;
+  position.y() = minY + (maxY - minY) / 2;
+  position.z() = 0.0;
+
+  /* Account for crossing the date line.  Assume a gog does not span more than half the earth */
+  if ((maxX - minX) > 180.0)
+  {
+    double offset = (- minX - maxX)/2;
+    if (offset > 0.0)
+      position.x() = 180.0 - offset; // Mid point is on positive side of date line
+    else
+      position.x() = -180.0 - offset; // Mid point is on negative side of date line
+  }
+
+  return 0;
+}
+
+int BulkGeometryNodeInterface::setAltitudeMode(AltitudeMode altMode)
+{
+  // Clamped, relative and extruded altitudes need the feature pipeline; the vertices are only ever absolute
+  if (altMode != ALTITUDE_NONE)
+    return 1;
+  return GogNodeInterface::setAltitudeMode(altMode);
+}
+
+int BulkGeometryNodeInterface::setExtrude(bool extrude)
+{
+  // Extrusion needs the feature pipeline
+  if (extrude)
+    return 1;
+  return GogNodeInterface::setExtrude(extrude);
+}
+
+void BulkGeometryNodeInterface::adjustAltitude_()
+{
+  // Only the altitude offset is supported; clamping to terrain requires the feature pipeline
+  if (bulkNode_.valid())
+    bulkNode_->setPositions(lla_, altOffset_);
+}
+
+void BulkGeometryNodeInterface::serializeGeometry_(bool relativeShape, std::ostream& gogOutputStream) const
+{
+  // serialize the original positions, without the altitude offset
+  osgEarth::PointSet geometry;
+  for (const simCore::Vec3& lla : lla_)
+    geometry.push_back(osg::Vec3d(lla.lon() * simCore::RAD2DEG, lla.lat() * simCore::RAD2DEG, lla.alt()));
+  Utils::serializeShapeGeometry(&geometry, relativeShape, gogOutputStream);
+}
+
+void BulkGeometryNodeInterface::setStyle_(const osgEarth::Style& style)
+{
+  if (&style != &style_)
+    style_ = style;
+  if (deferringStyleUpdates_() || !bulkNode_.valid())
+    return;
+
+  if (bulkNode_->mode() == BulkGeometry::BULK_POINTS)
+  {
+    const osgEarth::PointSymbol* point = style_.get<osgEarth::PointSymbol>();
+    if (point)
+    {
+      if (point->fill().isSet())
+        bulkNode_->setColor(point->fill()->color());
+      if (point->size().isSet())
+        bulkNode_->setPointSize(point->size().get());
+    }
+  }
+  else
+  {
+    const osgEarth::LineSymbol* line = style_.get<osgEarth::LineSymbol>();
+    if (line && line->stroke().isSet())
+    {
+      const osgEarth::Stroke& stroke = line->stroke().get();
+      bulkNode_->setColor(stroke.color());
+      if (stroke.width().isSet())
+        bulkNode_->setLineWidth(stroke.width().get());
+      bulkNode_->setStipple(stroke.stipple().isSet() ? stroke.stipple().get() : 0xffff);
+    }
+  }
+
+  const osgEarth::RenderSymbol* render = style_.get<osgEarth::RenderSymbol>();
+  if (!render)
+    return;
+
+  // Same subset of osgEarth applyRenderSymbology() as SphericalNodeInterface
+  osg::StateSet* ss = bulkNode_->getOrCreateStateSet();
+  if (render->depthTest().isSet())
+  {
+    ss->setMode(GL_DEPTH_TEST,
+      (render->depthTest().get() ? osg::StateAttribute::ON : osg::StateAttribute::OFF) | osg::StateAttribute::OVERRIDE);
+  }
+
+#if !( defined(OSG_GLES2_AVAILABLE) || defined(OSG_GLES3_AVAILABLE) )
+  if (render->clipPlane().isSet())
+    ss->setMode(GL_CLIP_DISTANCE0 + render->clipPlane().value(), 1);
+#endif
+
+  if (render->order().isSet() || render->renderBin().isSet())
+  {
+    int binNumber = render->order().isSet() ? (int)render->order()->eval() : ss->getBinNumber();
+    std::string binName =
+      render->renderBin().isSet() ? render->renderBin().get() :
+        ss->useRenderBinDetails() ? ss->getBinName() : "DepthSortedBin";
+    ss->setRenderBinDetails(binNumber, binName);
+  }
+}
+
+void BulkGeometryNodeInterface::applyOrientationOffsets_()
+{
+  // no-op, this class does not implement relative shapes
+}
+
 } }
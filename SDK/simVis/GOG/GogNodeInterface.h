@@ -48,6 +48,8 @@ namespace osgEarth{
 //----------------------------------------------------------------------------
 namespace simVis { namespace GOG {
 
+class BulkGeometry;
+
 // enum describing the depth buffer override state
 enum DepthBufferOverride
 {
@@ -267,8 +269,12 @@ public:
    */
   virtual void serializeToStream(std::ostream& gogOutputStream);
 
-  /** Update the altitude mode of the Overlay */
-  virtual void setAltitudeMode(AltitudeMode altMode);
+  /**
+  * Update the altitude mode of the Overlay
+  * @param altMode New altitude mode
+  * @return 0 if successful, non-zero if the Overlay does not support the altitude mode
+  */
+  virtual int setAltitudeMode(AltitudeMode altMode);
 
   /**
   * Update altitude offset of Overlay, in meters, to prevent Z-buffer fighting
@@ -296,8 +302,12 @@ public:
   */
   virtual int setDrawState(bool draw);
 
-  /** update whether to extend the object towards the Earth's surface */
-  virtual void setExtrude(bool extrude);
+  /**
+  * Update whether to extend the object towards the Earth's surface
+  * @param extrude true to extrude the Overlay
+  * @return 0 if successful, non-zero if the Overlay does not support the extrusion state
+  */
+  virtual int setExtrude(bool extrude);
 
   /**
   * Update the extrude height of the Overlay
@@ -587,9 +597,9 @@ public:
   virtual ~FeatureNodeInterface() {}
   virtual int getPosition(osg::Vec3d& position, osgEarth::GeoPoint* referencePosition = nullptr) const;
   virtual int getTessellation(TessellationStyle& style) const;
-  virtual void setAltitudeMode(AltitudeMode altMode);
+  virtual int setAltitudeMode(AltitudeMode altMode);
   virtual void setAltOffset(double altOffsetMeters);
-  virtual void setExtrude(bool extrude);
+  virtual int setExtrude(bool extrude);
   virtual void setTessellation(TessellationStyle style);
 
 protected:
@@ -676,7 +686,7 @@ public:
   CylinderNodeInterface(osg::Group* groupNode, osgEarth::LocalGeometryNode* sideNode, osgEarth::LocalGeometryNode* topCapNode, osgEarth::LocalGeometryNode* bottomCapNode, const simVis::GOG::GogMetaData& metaData);
   virtual ~CylinderNodeInterface();
   virtual int getPosition(osg::Vec3d& position, osgEarth::GeoPoint* referencePosition = nullptr) const;
-  virtual void setAltitudeMode(AltitudeMode altMode);
+  virtual int setAltitudeMode(AltitudeMode altMode);
   virtual void applyOrientationOffsets_();
 
 protected:
@@ -808,6 +818,44 @@ private:
 };
 
 
+/**
+ * Implementation of GogNodeInterface for large absolute Points and LineSegs drawn through BulkGeometry.  Supports
+ * color, point size, line width, line style, depth and altitude offset changes; the ECEF vertex arrays are rebuilt
+ * from the original positions when the altitude offset changes.  Clamping, extrusion and tessellation are not
+ * applied, so the loader only selects this interface for shapes that use none of them, and setAltitudeMode() and
+ * setExtrude() reject any later change to them.
+ */
+class SDKVIS_EXPORT BulkGeometryNodeInterface : public GogNodeInterface
+{
+public:
+  /**
+   * Constructor
+   * @param node Bulk geometry node, which has already been given its positions
+   * @param lla Original positions as lat/lon in radians and altitude in meters, used to apply altitude offsets
+   * @param style Initial style, applied to the node
+   * @param metaData Meta data for the shape
+   */
+  BulkGeometryNodeInterface(BulkGeometry* node, const std::vector<simCore::Vec3>& lla, const osgEarth::Style& style, const simVis::GOG::GogMetaData& metaData);
+  virtual ~BulkGeometryNodeInterface() {}
+  virtual int getPosition(osg::Vec3d& position, osgEarth::GeoPoint* referencePosition = nullptr) const;
+  /** Only ALTITUDE_NONE is supported; returns non-zero for any other mode */
+  virtual int setAltitudeMode(AltitudeMode altMode);
+  /** Extrusion is not supported; returns non-zero when enabling it */
+  virtual int setExtrude(bool extrude);
+
+protected:
+  virtual void adjustAltitude_();
+  virtual void serializeGeometry_(bool relativeShape, std::ostream& gogOutputStream) const;
+  virtual void setStyle_(const osgEarth::Style& style);
+  virtual void applyOrientationOffsets_();
+
+private:
+  osg::observer_ptr<BulkGeometry> bulkNode_;
+  /// original positions, lat/lon in radians and altitude in meters
+  std::vector<simCore::Vec3> lla_;
+};
+
+
 }}
 
 #endif /* SIMVIS_GOG_GOGNODEINTERFACE_H */
@@ -27,6 +27,7 @@
 #include "simCore/Calc/Angle.h"
 #include "simCore/GOG/GogShape.h"
 #include "simVis/GOG/LineSegs.h"
+#include "simVis/GOG/BulkGeometry.h"
 #include "simVis/GOG/GogNodeInterface.h"
 #include "simVis/GOG/HostedLocalGeometryNode.h"
 #include "simVis/GOG/LoaderUtils.h"
@@ -101,6 +102,20 @@ GogNodeInterface* LineSegs::deserialize(const ParsedShape& parsedShape,
 
 GogNodeInterface* LineSegs::createLineSegs(const simCore::GOG::LineSegs& lineSegs, bool attached, const simCore::Vec3& refPoint, osgEarth::MapNode* mapNode)
 {
+  // Large absolute segment sets skip the feature pipeline and go straight to a vertex array
+  if (BulkGeometry::supportsShape(lineSegs, lineSegs.points().size(), attached))
+  {
+    osgEarth::Style style;
+    // Try to prevent terrain z-fighting.
+    if (LoaderUtils::geometryRequiresClipping(lineSegs))
+      Utils::configureStyleForClipping(style);
+
+    BulkGeometry* bulk = new BulkGeometry(BulkGeometry::BULK_LINES);
+    bulk->setPositions(lineSegs.points());
+    bulk->setName("GOG LineSegs");
+    return new BulkGeometryNodeInterface(bulk, lineSegs.points(), style, GogMetaData());
+  }
+
   MultiGeometry* multiGeom = new MultiGeometry();
   const std::vector<simCore::Vec3>& points = lineSegs.points();
   // add the line seg points in pairs
@@ -27,6 +27,7 @@
 #include "osgEarth/LocalGeometryNode"
 #include "simCore/GOG/GogShape.h"
 #include "simVis/GOG/Points.h"
+#include "simVis/GOG/BulkGeometry.h"
 #include "simVis/GOG/GogNodeInterface.h"
 #include "simVis/GOG/HostedLocalGeometryNode.h"
 #include "simVis/GOG/LoaderUtils.h"
@@ -69,6 +70,20 @@ GogNodeInterface* Points::deserialize(const ParsedShape& parsedShape,
 
 GogNodeInterface* Points::createPoints(const simCore::GOG::Points& points, bool attached, const simCore::Vec3& refPoint, osgEarth::MapNode* mapNode)
 {
+  // Large absolute point clouds skip the feature pipeline and go straight to a vertex array
+  if (BulkGeometry::supportsShape(points, points.points().size(), attached))
+  {
+    osgEarth::Style style;
+    // Try to prevent terrain z-fighting.
+    if (LoaderUtils::geometryRequiresClipping(points))
+      Utils::configureStyleForClipping(style);
+
+    BulkGeometry* bulk = new BulkGeometry(BulkGeometry::BULK_POINTS);
+    bulk->setPositions(points.points());
+    bulk->setName("GOG Points");
+    return new BulkGeometryNodeInterface(bulk, points.points(), style, GogMetaData());
+  }
+
   osgEarth::Geometry* geom = new osgEarth::PointSet();
   LoaderUtils::setPoints(points.points(), points.isRelative(), *geom);
 
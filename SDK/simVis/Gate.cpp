@@ -50,11 +50,11 @@
 namespace simVis
 {
 
-GateVolume::GateVolume(simVis::Locator* locator, const simData::GatePrefs* prefs, const simData::GateUpdate* update)
+GateVolume::GateVolume(simVis::Locator* locator, const simData::GatePrefs* prefs, const simData::GateUpdate* update, bool pooled)
   : LocatorNode(locator)
 {
   setName("Gate Volume Locator");
-  gateSV_ = createNode_(prefs, update);
+  gateSV_ = createNode_(prefs, update, pooled);
   setNodeMask(DISPLAY_MASK_GATE);
   addChild(gateSV_);
 
@@ -86,6 +86,11 @@ GateVolume::~GateVolume()
 {
 }
 
+bool GateVolume::isShared() const
+{
+  return SVFactory::isShared(gateSV_.get());
+}
+
 /// prefs that can be applied without rebuilding the whole gate
 void GateVolume::performInPlacePrefChanges(const simData::GatePrefs* a, const simData::GatePrefs* b)
 {
@@ -142,7 +147,7 @@ void GateVolume::performInPlaceUpdates(const simData::GateUpdate* a, const simDa
 #endif
 }
 
-SphericalVolume* GateVolume::createNode_(const simData::GatePrefs* prefs, const simData::GateUpdate* update)
+SphericalVolume* GateVolume::createNode_(const simData::GatePrefs* prefs, const simData::GateUpdate* update, bool pooled)
 {
   simVis::SVData sv;
 
@@ -217,7 +222,13 @@ SphericalVolume* GateVolume::createNode_(const simData::GatePrefs* prefs, const
   sv.drawAsSphereSegment_ = prefs->gatedrawmode() == simData::GatePrefs_DrawMode_COVERAGE;
 
   // use a Y-forward directional vector to correspond with the gate's locator.
-  SphericalVolume* node = simVis::SVFactory::createNode(sv, osg::Y_AXIS);
+  // gates of the same shape share geometry; in-place updates give a shared gate its own copy
+  SphericalVolume* node = new SphericalVolume();
+  node->setName("SVFactory Node Transform");
+  if (pooled)
+    simVis::SVFactory::createPooledNode(*node, sv, osg::Y_AXIS);
+  else
+    simVis::SVFactory::createNode(*node, sv, osg::Y_AXIS);
   return node;
 }
 
@@ -281,6 +292,7 @@ GateNode::GateNode(const simData::GateProperties& props, Locator* hostLocator, c
   : EntityNode(simData::GATE),
     hasLastUpdate_(false),
     hasLastPrefs_(false),
+    dynamicShape_(false),
     host_(host),
     objectIndexTag_(0)
 {
@@ -702,8 +714,15 @@ void GateNode::apply_(const simData::GateUpdate* newUpdate, const simData::GateP
   force = force || !hasLastUpdate_ || !hasLastPrefs_ ||
     (newPrefs && PB_SUBFIELD_CHANGED(&lastPrefsApplied_, newPrefs, commonprefs, datadraw));
 
+  // Gates that change shape stop sharing pooled geometry.  Rebuilding a shared volume on its first shape change
+  // avoids copying the shared geometry before updating it in place; later changes update the private copy in place.
+  const bool shapeChange = !force && changesShape_(newUpdate);
+  if (shapeChange)
+    dynamicShape_ = true;
+
   // do we need to redraw gate volume visual?
-  const bool refreshRequiresNewNode = force || changeRequiresRebuild_(newUpdate, newPrefs);
+  const bool refreshRequiresNewNode = force || changeRequiresRebuild_(newUpdate, newPrefs) ||
+    (shapeChange && gateVolume_.valid() && gateVolume_->isShared());
   if (refreshRequiresNewNode)
   {
     if (gateVolume_)
@@ -714,7 +733,7 @@ void GateNode::apply_(const simData::GateUpdate* newUpdate, const simData::GateP
 
     if (activePrefs->fillpattern() != simData::GatePrefs_FillPattern_CENTROID)
     {
-      gateVolume_ = new GateVolume(gateVolumeLocator_.get(), activePrefs, activeUpdate);
+      gateVolume_ = new GateVolume(gateVolumeLocator_.get(), activePrefs, activeUpdate, !dynamicShape_);
       addChild(gateVolume_);
     }
     // explicit dirtyBound call probably only necessary in the case that the volume is removed and only the centroid is left
@@ -840,6 +859,17 @@ void GateNode::updateLocator_(const simData::GateUpdate* newUpdate, const simDat
   dirtyBound();
 }
 
+bool GateNode::changesShape_(const simData::GateUpdate* newUpdate) const
+{
+  // this can only be called when an update is already set; if assert fails, check callers
+  assert(hasLastUpdate_);
+  return newUpdate != nullptr &&
+    (PB_FIELD_CHANGED(&lastUpdateApplied_, newUpdate, minrange) ||
+    PB_FIELD_CHANGED(&lastUpdateApplied_, newUpdate, maxrange) ||
+    PB_FIELD_CHANGED(&lastUpdateApplied_, newUpdate, width) ||
+    PB_FIELD_CHANGED(&lastUpdateApplied_, newUpdate, height));
+}
+
 /// determine if new update/new prefs can be handled with in-place-update (without complete rebuild)
 bool GateNode::changeRequiresRebuild_(const simData::GateUpdate* newUpdate, const simData::GatePrefs* newPrefs) const
 {
@@ -41,8 +41,17 @@ namespace simVis
   class SDKVIS_EXPORT GateVolume : public simVis::LocatorNode
   {
   public:
-    /** Constructor */
-    GateVolume(simVis::Locator* locator, const simData::GatePrefs* prefs, const simData::GateUpdate* update);
+    /**
+    * Constructor
+    * @param locator Locator of the gate volume
+    * @param prefs Gate prefs
+    * @param update Gate update
+    * @param pooled If true, shares geometry with gates of the same shape; use for gates whose shape does not change
+    */
+    GateVolume(simVis::Locator* locator, const simData::GatePrefs* prefs, const simData::GateUpdate* update, bool pooled = true);
+
+    /** Returns true if the volume shares geometry with other gates of the same shape */
+    bool isShared() const;
 
     /** Perform an in-place update to an existing volume */
     void performInPlaceUpdates(const simData::GateUpdate* a,
@@ -65,7 +74,7 @@ namespace simVis
     // Not implemented
     GateVolume(const GateVolume&);
 
-    SphericalVolume* createNode_(const simData::GatePrefs* prefs, const simData::GateUpdate* update);
+    SphericalVolume* createNode_(const simData::GatePrefs* prefs, const simData::GateUpdate* update, bool pooled);
 
     osg::ref_ptr<SphericalVolume> gateSV_;
   };
@@ -277,6 +286,9 @@ namespace simVis
     // Not implemented
     GateNode(const GateNode&);
 
+    /// returns true if the new update changes the shape of the gate volume
+    bool changesShape_(const simData::GateUpdate* newUpdate) const;
+
     /// determine if new update/new prefs can be handled with in-place-update (without complete rebuild)
     bool changeRequiresRebuild_(
       const simData::GateUpdate* newUpdate,
@@ -331,6 +343,8 @@ namespace simVis
 
     bool                    hasLastUpdate_;
     bool                    hasLastPrefs_;
+    /// true once the gate changes shape; such gates stop sharing pooled volume geometry
+    bool                    dynamicShape_;
 
     /**
      * Locator that represents the "origin" of the gate, typically a position on the host platform, stripped of orientation
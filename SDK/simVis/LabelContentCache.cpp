@@ -0,0 +1,139 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "simVis/LabelContentCache.h"
+
+namespace simVis
+{
+
+LabelContentCache::LabelContentCache()
+  : valid_(false),
+    dependencies_(LABEL_INPUT_ALL),
+    numFormats_(0)
+{
+  inputs_.time = 0.0;
+}
+
+LabelContentCache::~LabelContentCache()
+{
+}
+
+void LabelContentCache::invalidate()
+{
+  valid_ = false;
+}
+
+const std::string& LabelContentCache::createString(LabelContentCallback& callback, const simData::PlatformPrefs& prefs, const simData::PlatformUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+{
+  Inputs inputs;
+  inputs.time = lastUpdate.time();
+  inputs.position.set(lastUpdate.x(), lastUpdate.y(), lastUpdate.z());
+  inputs.orientation.set(lastUpdate.psi(), lastUpdate.theta(), lastUpdate.phi());
+  inputs.velocity.set(lastUpdate.vx(), lastUpdate.vy(), lastUpdate.vz());
+  if (!isCurrent_(callback, simData::PLATFORM, prefs.commonprefs().labelprefs(), fields, inputs))
+  {
+    text_ = callback.createString(prefs, lastUpdate, fields);
+    ++numFormats_;
+  }
+  return text_;
+}
+
+const std::string& LabelContentCache::createString(LabelContentCallback& callback, const simData::BeamPrefs& prefs, const simData::BeamUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+{
+  Inputs inputs;
+  inputs.time = lastUpdate.time();
+  inputs.position.set(lastUpdate.range(), 0.0, 0.0);
+  inputs.orientation.set(lastUpdate.azimuth(), lastUpdate.elevation(), 0.0);
+  inputs.velocity.zero();
+  if (!isCurrent_(callback, simData::BEAM, prefs.commonprefs().labelprefs(), fields, inputs))
+  {
+    text_ = callback.createString(prefs, lastUpdate, fields);
+    ++numFormats_;
+  }
+  return text_;
+}
+
+bool LabelContentCache::isCurrent_(LabelContentCallback& callback, simData::ObjectType type, const simData::LabelPrefs& labelPrefs,
+  const simData::LabelPrefs_DisplayFields& fields, const Inputs& inputs)
+{
+  // Dependencies only change with the prefs or the callback, so they are looked up once per change
+  if (!valid_ || callback_.get() != &callback)
+  {
+    callback_ = &callback;
+    dependencies_ = callback.labelInputs(type, labelPrefs, fields);
+    inputs_ = inputs;
+    valid_ = true;
+    return false;
+  }
+
+  bool changed = (dependencies_ & LABEL_INPUT_EXTERNAL) != 0;
+  if ((dependencies_ & LABEL_INPUT_TIME) && inputs.time != inputs_.time)
+    changed = true;
+  if ((dependencies_ & LABEL_INPUT_POSITION) && inputs.position != inputs_.position)
+    changed = true;
+  if ((dependencies_ & LABEL_INPUT_ORIENTATION) && inputs.orientation != inputs_.orientation)
+    changed = true;
+  if ((dependencies_ & LABEL_INPUT_VELOCITY) && inputs.velocity != inputs_.velocity)
+    changed = true;
+  inputs_ = inputs;
+  return !changed;
+}
+
+unsigned int LabelContentCache::numFormats() const
+{
+  return numFormats_;
+}
+
+unsigned int LabelContentCache::defaultInputs(const simData::LabelPrefs& labelPrefs, const simData::LabelPrefs_DisplayFields& fields)
+{
+  // Content from outside the update must always be regenerated
+  if (fields.genericdata() || fields.categorydata() || fields.late() || fields.uselabelcode())
+    return LABEL_INPUT_EXTERNAL;
+
+  unsigned int inputs = LABEL_INPUT_NONE;
+  if (fields.xlat() || fields.ylon() || fields.zalt())
+  {
+    inputs |= LABEL_INPUT_POSITION;
+    // terrain heights arrive asynchronously as tiles load
+    if (fields.zalt() && labelPrefs.applyheightaboveterrain())
+      inputs |= LABEL_INPUT_EXTERNAL;
+  }
+  // angles and velocities are displayed in a frame local to the position
+  if (fields.yaw() || fields.pitch() || fields.roll())
+    inputs |= LABEL_INPUT_ORIENTATION | LABEL_INPUT_POSITION;
+  if (fields.course() || fields.flightpathelevation() || fields.displayvx() || fields.displayvy() || fields.displayvz() ||
+    fields.speed() || fields.mach())
+    inputs |= LABEL_INPUT_VELOCITY | LABEL_INPUT_POSITION;
+  if (fields.angleofattack() || fields.sideslip() || fields.totalangleofattack())
+    inputs |= LABEL_INPUT_ORIENTATION | LABEL_INPUT_VELOCITY | LABEL_INPUT_POSITION;
+  if (fields.solarazimuth() || fields.solarelevation() || fields.solarilluminance() ||
+    fields.lunarazimuth() || fields.lunarelevation() || fields.lunarilluminance())
+    inputs |= LABEL_INPUT_TIME | LABEL_INPUT_POSITION;
+
+  // ECI coordinates and magnetic variance also vary with time
+  if (inputs != LABEL_INPUT_NONE &&
+    (labelPrefs.coordinatesystem() == simData::ECI || labelPrefs.magneticvariance() != simData::MV_TRUE))
+    inputs |= LABEL_INPUT_TIME;
+  return inputs;
+}
+
+}
@@ -0,0 +1,97 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMVIS_LABEL_CONTENT_CACHE_H
+#define SIMVIS_LABEL_CONTENT_CACHE_H
+
+#include <string>
+#include "osg/observer_ptr"
+#include "simCore/Common/Common.h"
+#include "simData/DataTypes.h"
+#include "simVis/LabelContentManager.h"
+
+namespace simVis
+{
+
+/**
+ * Caches the label content from a LabelContentCallback for one set of display fields, such as the label,
+ * hover, hook or legend fields of an entity.  The inputs the content depends on are taken from
+ * LabelContentCallback::labelInputs() once per prefs change, and the callback is called again only when one of
+ * those inputs changes in the update.  Owners call invalidate() whenever the prefs change.
+ */
+class SDKVIS_EXPORT LabelContentCache
+{
+public:
+  LabelContentCache();
+  virtual ~LabelContentCache();
+
+  /** Discards the cached content, so that the next request calls the callback; call when the prefs change */
+  void invalidate();
+
+  /** Returns platform label content, calling the callback only if needed; arguments match LabelContentCallback::createString() */
+  const std::string& createString(LabelContentCallback& callback, const simData::PlatformPrefs& prefs, const simData::PlatformUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields);
+  /** Returns beam label content, calling the callback only if needed; arguments match LabelContentCallback::createString() */
+  const std::string& createString(LabelContentCallback& callback, const simData::BeamPrefs& prefs, const simData::BeamUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields);
+
+  /** Number of times the callback was asked for content, for testing and diagnostics */
+  unsigned int numFormats() const;
+
+  /**
+   * Typical inputs for the platform display fields, suitable for returning from LabelContentCallback::labelInputs().
+   * Fields that depend on data outside the update, such as category data, generic data, label code and late time,
+   * and altitudes above terrain, map to LABEL_INPUT_EXTERNAL.
+   * @param labelPrefs Label prefs for the coordinate system and related settings
+   * @param fields Display fields of the content
+   * @return Bitwise OR of LabelInput values
+   */
+  static unsigned int defaultInputs(const simData::LabelPrefs& labelPrefs, const simData::LabelPrefs_DisplayFields& fields);
+
+private:
+  /** Update values that label content may depend on, grouped by LabelInput */
+  struct Inputs
+  {
+    double time;
+    simCore::Vec3 position;
+    simCore::Vec3 orientation;
+    simCore::Vec3 velocity;
+  };
+
+  /** Returns true if the cached content can be reused for the given callback and update inputs */
+  bool isCurrent_(LabelContentCallback& callback, simData::ObjectType type, const simData::LabelPrefs& labelPrefs,
+    const simData::LabelPrefs_DisplayFields& fields, const Inputs& inputs);
+
+  /// Callback that generated the cached content
+  osg::observer_ptr<LabelContentCallback> callback_;
+  /// True when text_ holds content for the current prefs
+  bool valid_;
+  /// Inputs the content depends on, from the callback, for the current prefs
+  unsigned int dependencies_;
+  /// Inputs of the cached content
+  Inputs inputs_;
+  /// Cached content
+  std::string text_;
+  unsigned int numFormats_;
+};
+
+}
+
+#endif
@@ -31,6 +31,23 @@
 
 namespace simVis
 {
+  /**
+  * Inputs from an entity's update that label content can depend on, combined as bit flags.  For platforms the
+  * position, orientation and velocity are the matching update components.  For beams, the position is the range
+  * and the orientation is the azimuth and elevation.
+  */
+  enum LabelInput
+  {
+    LABEL_INPUT_NONE = 0x00,
+    LABEL_INPUT_TIME = 0x01,
+    LABEL_INPUT_POSITION = 0x02,
+    LABEL_INPUT_ORIENTATION = 0x04,
+    LABEL_INPUT_VELOCITY = 0x08,
+    /// Content depends on data outside the update, such as category data or the current time; always regenerated
+    LABEL_INPUT_EXTERNAL = 0x10,
+    LABEL_INPUT_ALL = 0xff
+  };
+
   /** Callback for the user to create custom label content for a platform.  */
   class LabelContentCallback : public osg::Referenced
   {
@@ -98,6 +115,20 @@ namespace simVis
     */
     virtual std::string createString(simData::ObjectId id, const simData::CustomRenderingPrefs& prefs, const simData::LabelPrefs_DisplayFields& fields) = 0;
 
+    /**
+    * Returns the update inputs that createString() depends on for the given fields, as LabelInput bit flags.
+    * Platforms and beams reuse the previous content until one of these inputs, the prefs, or the callback changes.
+    * The default regenerates content on every update.  See LabelContentCache::defaultInputs() for a typical mapping.
+    * @param type Entity type of the content
+    * @param labelPrefs Label prefs, for the coordinate system and other settings that affect the inputs
+    * @param fields Display fields that will be passed to createString()
+    * @return Bitwise OR of LabelInput values
+    */
+    virtual unsigned int labelInputs(simData::ObjectType type, const simData::LabelPrefs& labelPrefs, const simData::LabelPrefs_DisplayFields& fields) const
+    {
+      return LABEL_INPUT_ALL;
+    }
+
   protected:
     virtual ~LabelContentCallback() {}
   };
@@ -155,6 +186,11 @@ namespace simVis
       return "";
     }
 
+    virtual unsigned int labelInputs(simData::ObjectType type, const simData::LabelPrefs& labelPrefs, const simData::LabelPrefs_DisplayFields& fields) const
+    {
+      return LABEL_INPUT_NONE;
+    }
+
   protected:
     virtual ~NullEntityCallback() {}
   };
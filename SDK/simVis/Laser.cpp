@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <vector>
 #include "osg/Geometry"
 #include "osgEarth/Horizon"
 #include "osgEarth/LineDrawable"
@@ -44,6 +45,7 @@ LaserNode::LaserNode(const simData::LaserProperties& props, Locator* hostLocator
     host_(host),
     localGrid_(nullptr),
     hasLastPrefs_(false),
+    lineBatchSlot_(LineBatch::INVALID_SLOT),
     label_(nullptr),
     objectIndexTag_(0)
 {
@@ -101,9 +103,34 @@ LaserNode::LaserNode(const simData::LaserProperties& props, Locator* hostLocator
 
 LaserNode::~LaserNode()
 {
+  releaseLineBatchSlot_();
   osgEarth::Registry::objectIndex()->remove(objectIndexTag_);
 }
 
+void LaserNode::setLineBatchGroup(LineBatchGroup* lineBatches)
+{
+  if (lineBatches_.get() == lineBatches)
+    return;
+  lineBatches_ = lineBatches;
+  if (!node_.valid())
+    return;
+
+  // Drop the current geometry; refresh_() rebuilds it through the new batches
+  releaseLineBatchSlot_();
+  locatorNode_->removeChild(node_);
+  node_ = nullptr;
+  refresh_(nullptr, nullptr);
+}
+
+void LaserNode::releaseLineBatchSlot_()
+{
+  osg::ref_ptr<LineBatch> lineBatch;
+  if (lineBatch_.lock(lineBatch))
+    lineBatch->release(lineBatchSlot_);
+  lineBatch_ = nullptr;
+  lineBatchSlot_ = LineBatch::INVALID_SLOT;
+}
+
 void LaserNode::updateLabel_(const simData::LaserPrefs& prefs)
 {
   if (!hasLastUpdate_)
@@ -407,6 +434,30 @@ osg::Group* LaserNode::createGeometry_(const simData::LaserPrefs &prefs)
   const double segmentLength = simCore::sdkMin(prefs.maxrange(), MAX_SEGMENT_LENGTH);
   const unsigned int numSegs = simCore::sdkMax(MIN_NUM_SEGMENTS, simCore::sdkMin(MAX_NUM_SEGMENTS, static_cast<unsigned int>(length / segmentLength)));
 
+  osg::ref_ptr<LineBatchGroup> lineBatches;
+  if (lineBatches_.lock(lineBatches))
+  {
+    // Batch holds one slot per laser; the width selects the batch
+    releaseLineBatchSlot_();
+    osg::ref_ptr<LineBatch> lineBatch = lineBatches->getOrCreate(prefs.laserwidth(), DISPLAY_MASK_LASER);
+    lineBatch_ = lineBatch.get();
+    lineBatchSlot_ = lineBatch->allocate(numSegs, locatorNode_.get(), this);
+
+    std::vector<osg::Vec3f> points;
+    points.reserve(2 * numSegs);
+    for (unsigned int k = 0; k < numSegs; ++k)
+    {
+      points.push_back(osg::Vec3f(0.f, length * k / numSegs, 0.f));
+      points.push_back(osg::Vec3f(0.f, length * (k + 1) / numSegs, 0.f));
+    }
+    lineBatch->setSegments(lineBatchSlot_, points);
+    lineBatch->setColor(lineBatchSlot_, simVis::ColorUtils::RgbaToVec4(
+      prefs.commonprefs().useoverridecolor() ? prefs.commonprefs().overridecolor() : prefs.commonprefs().color()));
+
+    // Empty placeholder keeps the node bookkeeping in refresh_() unchanged
+    return new osg::Group();
+  }
+
   osgEarth::LineDrawable* g = new osgEarth::LineDrawable(GL_LINE_STRIP);
   g->setDataVariance(osg::Object::DYNAMIC);
   g->setName("simVis::LaserNode");
@@ -426,6 +477,26 @@ osg::Group* LaserNode::createGeometry_(const simData::LaserPrefs &prefs)
 
 void LaserNode::updateLaser_(const simData::LaserPrefs &prefs)
 {
+  osg::ref_ptr<LineBatch> lineBatch;
+  if (lineBatch_.lock(lineBatch))
+  {
+    if (lineBatch->lineWidth() == prefs.laserwidth())
+    {
+      lineBatch->setColor(lineBatchSlot_, simVis::ColorUtils::RgbaToVec4(
+        prefs.commonprefs().useoverridecolor() ? prefs.commonprefs().overridecolor() : prefs.commonprefs().color()));
+    }
+    else if (node_.valid())
+    {
+      // Width belongs to the batch, so move the laser to the batch for the new width
+      osg::ref_ptr<osg::Node> oldNode = node_;
+      node_ = createGeometry_(prefs);
+      node_->setCullingActive(false);
+      node_->setNodeMask(DISPLAY_MASK_LASER);
+      locatorNode_->replaceChild(oldNode, node_);
+    }
+    return;
+  }
+
   if (node_ == nullptr || node_->getNumChildren() == 0)
     return;
   osgEarth::LineDrawable* geom = dynamic_cast<osgEarth::LineDrawable*>(node_->getChild(0));
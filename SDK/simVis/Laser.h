@@ -28,6 +28,7 @@
 #include "simData/DataTypes.h"
 #include "simVis/Constants.h"
 #include "simVis/Entity.h"
+#include "simVis/LineBatch.h"
 
 namespace osg { class Group; }
 
@@ -74,6 +75,14 @@ public:
   */
   void setPrefs(const simData::LaserPrefs& prefs);
 
+  /**
+  * Sets the shared line batches used to draw the laser line.  Batched lasers are drawn in one
+  * shared geometry per laser width; they are not horizon culled or flattened in Overhead Mode.
+  * Pass nullptr to draw the laser with its own geometry.
+  * @param lineBatches Scenario line batches, or nullptr
+  */
+  void setLineBatchGroup(LineBatchGroup* lineBatches);
+
   /** Retrieves the currently visible end points (empty if not visible) */
   void getVisibleEndPoints(std::vector<osg::Vec3d>& ecefVec) const;
 
@@ -201,6 +210,9 @@ private: // methods
   /** Responsible for generating a new osgEarth::LineDrawable for the laser geometry */
   osg::Group* createGeometry_(const simData::LaserPrefs& prefs);
 
+  /** Returns the laser's segments to the line batch, if batched */
+  void releaseLineBatchSlot_();
+
 private: // data
   simData::LaserProperties  lastProps_;      ///< laser properties
   simData::LaserPrefs       lastPrefs_;      ///< latest copy of prefs received
@@ -212,6 +224,9 @@ private: // data
   osg::observer_ptr<const EntityNode> host_; ///< the platform that hosts this laser
   osg::ref_ptr<LocalGridNode> localGrid_;    ///< the localgrid node for this laser
   bool hasLastPrefs_;                        ///< Whether lastPrefs_ has been set by prefs we received
+  osg::observer_ptr<LineBatchGroup> lineBatches_; ///< shared batches, if the laser line is batched
+  osg::observer_ptr<LineBatch> lineBatch_;   ///< batch currently drawing the laser line
+  LineBatch::SlotId lineBatchSlot_;          ///< slot in lineBatch_
 
   osg::ref_ptr<EntityLabelNode> label_;
 
@@ -0,0 +1,436 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include "osg/NodeCallback"
+#include "osgEarth/LineDrawable"
+#include "simVis/Types.h"
+#include "simVis/Utils.h"
+#include "simVis/LineBatch.h"
+
+namespace simVis
+{
+
+namespace
+{
+
+/// Color used for hidden and unused vertices
+const osg::Vec4f TRANSPARENT_COLOR(0.f, 0.f, 0.f, 0.f);
+/// Smallest number of vertices reserved in the drawable
+const unsigned int MIN_DRAWABLE_CAPACITY = 64;
+
+/// Returns true if the node and all of its first-parent ancestors have a non-zero node mask
+bool isEffectivelyVisible(const osg::Node* node)
+{
+  while (node != nullptr)
+  {
+    if (node->getNodeMask() == 0)
+      return false;
+    node = (node->getNumParents() > 0) ? node->getParent(0) : nullptr;
+  }
+  return true;
+}
+
+/// Runs LineBatch::update() from the update traversal
+class UpdateBatchCallback : public osg::NodeCallback
+{
+public:
+  virtual void operator()(osg::Node* node, osg::NodeVisitor* nv)
+  {
+    static_cast<LineBatch*>(node)->update();
+    traverse(node, nv);
+  }
+};
+
+}
+
+const LineBatch::SlotId LineBatch::INVALID_SLOT = std::numeric_limits<LineBatch::SlotId>::max();
+// Single precision spacing is under a centimeter at this distance
+const double LineBatch::MAX_ANCHOR_DISTANCE = 100000.0;
+
+LineBatch::LineBatch(float lineWidth)
+  : lineWidth_(lineWidth),
+    numSlots_(0),
+    numVertexWrites_(0)
+{
+  setName("simVis::LineBatch");
+  simVis::setLighting(getOrCreateStateSet(), osg::StateAttribute::OFF);
+
+  // Batched entities can be anywhere; never cull the batch as a whole
+  setCullingActive(false);
+  addUpdateCallback(new UpdateBatchCallback);
+}
+
+LineBatch::~LineBatch()
+{
+}
+
+float LineBatch::lineWidth() const
+{
+  return lineWidth_;
+}
+
+LineBatch::SlotId LineBatch::allocate(unsigned int numSegments, const osg::MatrixTransform* frame, const osg::Node* owner)
+{
+  if (numSegments == 0 || frame == nullptr)
+    return INVALID_SLOT;
+
+  Slot slot;
+  slot.group = groupFor_(frame->getMatrix().getTrans());
+  slot.first = allocateRange_(slot.group, numSegments);
+  slot.numSegments = numSegments;
+  slot.frame = frame;
+  slot.owner = owner;
+  slot.localPoints.resize(2 * numSegments);
+  slot.color = simVis::Color::White;
+  slot.visible = true;
+  slot.inUse = true;
+  slot.dirty = true;
+  slot.drawn = false;
+
+  SlotId id;
+  if (!freeSlotIds_.empty())
+  {
+    id = freeSlotIds_.back();
+    freeSlotIds_.pop_back();
+    slots_[id] = slot;
+  }
+  else
+  {
+    id = static_cast<SlotId>(slots_.size());
+    slots_.push_back(slot);
+  }
+  ++numSlots_;
+  return id;
+}
+
+void LineBatch::release(SlotId slotId)
+{
+  if (slotId >= slots_.size() || !slots_[slotId].inUse)
+    return;
+  Slot& slot = slots_[slotId];
+  releaseRange_(slot);
+  slot.inUse = false;
+  slot.frame = nullptr;
+  slot.owner = nullptr;
+  slot.localPoints.clear();
+  freeSlotIds_.push_back(slotId);
+  --numSlots_;
+}
+
+int LineBatch::setSegments(SlotId slotId, const std::vector<osg::Vec3f>& points)
+{
+  if (slotId >= slots_.size() || !slots_[slotId].inUse)
+    return 1;
+  Slot& slot = slots_[slotId];
+  if (points.size() != 2 * slot.numSegments)
+    return 1;
+  if (points != slot.localPoints)
+  {
+    slot.localPoints = points;
+    slot.dirty = true;
+  }
+  return 0;
+}
+
+void LineBatch::setColor(SlotId slotId, const osg::Vec4f& color)
+{
+  if (slotId >= slots_.size() || !slots_[slotId].inUse || slots_[slotId].color == color)
+    return;
+  slots_[slotId].color = color;
+  slots_[slotId].dirty = true;
+}
+
+void LineBatch::setVisible(SlotId slotId, bool visible)
+{
+  if (slotId >= slots_.size() || !slots_[slotId].inUse)
+    return;
+  slots_[slotId].visible = visible;
+}
+
+void LineBatch::update()
+{
+  for (auto it = slots_.begin(); it != slots_.end(); ++it)
+  {
+    Slot& slot = *it;
+    if (!slot.inUse)
+      continue;
+
+    osg::ref_ptr<const osg::MatrixTransform> frame;
+    const bool hasFrame = slot.frame.lock(frame);
+    osg::ref_ptr<const osg::Node> owner;
+    const bool ownerVisible = !slot.owner.lock(owner) || isEffectivelyVisible(owner.get());
+    const bool visible = slot.visible && hasFrame && ownerVisible;
+
+    if (!visible)
+    {
+      if (slot.drawn || slot.dirty)
+        writeSlot_(slot, false, osg::Matrixd::identity());
+      continue;
+    }
+    const osg::Matrixd& matrix = frame->getMatrix();
+    if (slot.dirty || !slot.drawn || matrix != slot.drawnMatrix)
+      writeSlot_(slot, true, matrix);
+  }
+  for (auto it = groups_.begin(); it != groups_.end(); ++it)
+    flush_(*it);
+}
+
+unsigned int LineBatch::numSlots() const
+{
+  return numSlots_;
+}
+
+unsigned int LineBatch::numAnchorGroups() const
+{
+  return static_cast<unsigned int>(groups_.size());
+}
+
+unsigned int LineBatch::anchorGroup(SlotId slotId) const
+{
+  assert(slotId < slots_.size());
+  return slots_[slotId].group;
+}
+
+unsigned int LineBatch::numVertices(unsigned int group) const
+{
+  return (group < groups_.size()) ? static_cast<unsigned int>(groups_[group].vertices.size()) : 0;
+}
+
+unsigned int LineBatch::firstVertex(SlotId slotId) const
+{
+  assert(slotId < slots_.size());
+  return slots_[slotId].first;
+}
+
+const osg::Vec3f& LineBatch::vertex(unsigned int index, unsigned int group) const
+{
+  return groups_[group].vertices[index];
+}
+
+const osg::Vec4f& LineBatch::vertexColor(unsigned int index, unsigned int group) const
+{
+  return groups_[group].colors[index];
+}
+
+const osg::Vec3d& LineBatch::anchor(unsigned int group) const
+{
+  return groups_[group].anchor;
+}
+
+unsigned int LineBatch::numVertexWrites() const
+{
+  return numVertexWrites_;
+}
+
+unsigned int LineBatch::groupFor_(const osg::Vec3d& position)
+{
+  // Prefer the nearest anchor in range, then a group still waiting for its anchor
+  unsigned int nearest = static_cast<unsigned int>(groups_.size());
+  double nearestDistance2 = MAX_ANCHOR_DISTANCE * MAX_ANCHOR_DISTANCE;
+  unsigned int unanchored = nearest;
+  unsigned int empty = nearest;
+  for (unsigned int k = 0; k < groups_.size(); ++k)
+  {
+    const AnchorGroup& group = groups_[k];
+    if (!group.hasAnchor)
+    {
+      unanchored = k;
+      continue;
+    }
+    const double distance2 = (group.anchor - position).length2();
+    if (distance2 <= nearestDistance2)
+    {
+      nearest = k;
+      nearestDistance2 = distance2;
+    }
+    else if (group.numSlots == 0)
+      empty = k;
+  }
+  if (nearest < groups_.size())
+    return nearest;
+  if (unanchored < groups_.size())
+    return unanchored;
+  if (empty < groups_.size())
+  {
+    // Its released ranges are already cleared, so it can be re-anchored in place
+    groups_[empty].hasAnchor = false;
+    return empty;
+  }
+
+  AnchorGroup group;
+  group.hasAnchor = false;
+  group.numSlots = 0;
+  group.dirtyFirst = 0;
+  group.dirtyEnd = 0;
+  group.drawableCapacity = 0;
+  group.line = new osgEarth::LineDrawable(GL_LINES);
+  group.line->setName("simVis::LineBatch");
+  group.line->setDataVariance(osg::Object::DYNAMIC);
+  group.line->setLineWidth(lineWidth_);
+  osg::ref_ptr<osgEarth::LineGroup> lineGroup = new osgEarth::LineGroup();
+  lineGroup->addChild(group.line.get());
+  group.xform = new osg::MatrixTransform;
+  group.xform->addChild(lineGroup.get());
+  addChild(group.xform.get());
+  groups_.push_back(group);
+  return static_cast<unsigned int>(groups_.size() - 1);
+}
+
+unsigned int LineBatch::allocateRange_(unsigned int groupIndex, unsigned int numSegments)
+{
+  AnchorGroup& group = groups_[groupIndex];
+  ++group.numSlots;
+
+  // Prefer an exact-size range left behind by a released slot
+  const auto freeRange = group.freeRanges.find(numSegments);
+  if (freeRange != group.freeRanges.end())
+  {
+    const unsigned int first = freeRange->second;
+    group.freeRanges.erase(freeRange);
+    return first;
+  }
+  const unsigned int first = static_cast<unsigned int>(group.vertices.size());
+  group.vertices.resize(group.vertices.size() + 2 * numSegments);
+  group.colors.resize(group.vertices.size(), TRANSPARENT_COLOR);
+  clearRange_(group, first, 2 * numSegments);
+  return first;
+}
+
+void LineBatch::releaseRange_(const Slot& slot)
+{
+  AnchorGroup& group = groups_[slot.group];
+  clearRange_(group, slot.first, 2 * slot.numSegments);
+  group.freeRanges.insert(std::make_pair(slot.numSegments, slot.first));
+  --group.numSlots;
+}
+
+void LineBatch::writeSlot_(Slot& slot, bool visible, const osg::Matrixd& matrix)
+{
+  slot.dirty = false;
+  slot.drawn = visible;
+  const unsigned int count = 2 * slot.numSegments;
+  if (!visible)
+  {
+    clearRange_(groups_[slot.group], slot.first, count);
+    return;
+  }
+
+  slot.drawnMatrix = matrix;
+  const osg::Vec3d origin = matrix.getTrans();
+  if (groups_[slot.group].hasAnchor && (groups_[slot.group].anchor - origin).length2() > MAX_ANCHOR_DISTANCE * MAX_ANCHOR_DISTANCE)
+  {
+    // Too far from the anchor for single precision; move to a nearer group
+    releaseRange_(slot);
+    slot.group = groupFor_(origin);
+    slot.first = allocateRange_(slot.group, slot.numSegments);
+  }
+
+  AnchorGroup& group = groups_[slot.group];
+  if (!group.hasAnchor)
+  {
+    group.anchor = origin;
+    group.hasAnchor = true;
+    group.xform->setMatrix(osg::Matrixd::translate(group.anchor));
+  }
+  for (unsigned int k = 0; k < count; ++k)
+  {
+    group.vertices[slot.first + k] = osg::Vec3d(slot.localPoints[k]) * matrix - group.anchor;
+    group.colors[slot.first + k] = slot.color;
+  }
+  markDirty_(group, slot.first, count);
+}
+
+void LineBatch::clearRange_(AnchorGroup& group, unsigned int first, unsigned int count)
+{
+  std::fill(group.vertices.begin() + first, group.vertices.begin() + first + count, osg::Vec3f());
+  std::fill(group.colors.begin() + first, group.colors.begin() + first + count, TRANSPARENT_COLOR);
+  markDirty_(group, first, count);
+}
+
+void LineBatch::markDirty_(AnchorGroup& group, unsigned int first, unsigned int count)
+{
+  if (group.dirtyFirst == group.dirtyEnd)
+  {
+    group.dirtyFirst = first;
+    group.dirtyEnd = first + count;
+    return;
+  }
+  group.dirtyFirst = std::min(group.dirtyFirst, first);
+  group.dirtyEnd = std::max(group.dirtyEnd, first + count);
+}
+
+void LineBatch::flush_(AnchorGroup& group)
+{
+  const unsigned int numVerts = static_cast<unsigned int>(group.vertices.size());
+  if (numVerts > group.drawableCapacity)
+  {
+    // Grow geometrically; reallocating discards the drawable's contents, so rewrite everything
+    group.drawableCapacity = std::max(MIN_DRAWABLE_CAPACITY, std::max(numVerts, 2 * group.drawableCapacity));
+    group.line->allocate(group.drawableCapacity);
+    group.line->setColor(TRANSPARENT_COLOR);
+    group.dirtyFirst = 0;
+    group.dirtyEnd = numVerts;
+  }
+  if (group.dirtyFirst == group.dirtyEnd)
+    return;
+
+  for (unsigned int k = group.dirtyFirst; k < group.dirtyEnd; ++k)
+  {
+    group.line->setVertex(k, group.vertices[k]);
+    group.line->setColor(k, group.colors[k]);
+  }
+  numVertexWrites_ += group.dirtyEnd - group.dirtyFirst;
+  group.dirtyFirst = group.dirtyEnd = 0;
+  group.line->setFirst(0);
+  group.line->setCount(numVerts);
+  group.line->dirtyBound();
+}
+
+// --------------------------------------------------------------------------
+
+LineBatchGroup::LineBatchGroup()
+{
+  setName("simVis::LineBatchGroup");
+}
+
+LineBatchGroup::~LineBatchGroup()
+{
+}
+
+LineBatch* LineBatchGroup::getOrCreate(float lineWidth, unsigned int nodeMask)
+{
+  const std::pair<float, unsigned int> key(lineWidth, nodeMask);
+  auto it = batches_.find(key);
+  if (it != batches_.end())
+    return it->second.get();
+
+  osg::ref_ptr<LineBatch> batch = new LineBatch(lineWidth);
+  batch->setNodeMask(nodeMask);
+  batches_[key] = batch;
+  addChild(batch.get());
+  return batch.get();
+}
+
+}
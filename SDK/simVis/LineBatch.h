@@ -0,0 +1,229 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMVIS_LINE_BATCH_H
+#define SIMVIS_LINE_BATCH_H
+
+#include <map>
+#include <utility>
+#include <vector>
+#include "osg/Group"
+#include "osg/MatrixTransform"
+#include "osg/observer_ptr"
+#include "osg/ref_ptr"
+#include "simCore/Common/Common.h"
+
+namespace osgEarth {
+  class LineDrawable;
+}
+
+namespace simVis
+{
+
+/**
+ * Shared GL_LINES geometry for many small per-entity line primitives, such as velocity vectors
+ * and lasers.  Each client allocates a slot, a contiguous range of segments in the shared
+ * vertex array, and supplies its segments in the local coordinates of a frame transform whose
+ * matrix places them in the world.  Once per update traversal the batch re-evaluates each slot's
+ * frame matrix and visibility, rewrites only the slots that changed, and pushes the dirty vertex
+ * range to a single drawable, so thousands of lines cost one draw instead of one node each.
+ *
+ * A slot is drawn when it is marked visible and its owner node and every ancestor of the owner
+ * have a non-zero node mask.  To limit single precision error, slots are kept in anchor groups:
+ * vertices are stored relative to the group's anchor, the first frame origin written to it, and a
+ * slot whose frame moves more than MAX_ANCHOR_DISTANCE from its anchor moves to a nearer group.
+ * Each group is one draw, so widely spread entities cost a draw per region.  Because the batch
+ * reads the frame's matrix directly, slots do not follow per-view adjustments such as Overhead
+ * Mode flattening.
+ */
+class SDKVIS_EXPORT LineBatch : public osg::Group
+{
+public:
+  /// Handle to a range of segments in the batch
+  typedef unsigned int SlotId;
+  /// Returned by allocate() on failure
+  static const SlotId INVALID_SLOT;
+  /// Largest distance, in meters, from a slot's frame origin to its group's anchor
+  static const double MAX_ANCHOR_DISTANCE;
+
+  /** Creates an empty batch drawn with the given line width, in pixels */
+  explicit LineBatch(float lineWidth = 1.f);
+
+  /** Line width, in pixels, of every segment in this batch */
+  float lineWidth() const;
+
+  /**
+   * Reserves a range of segments.  The slot is visible, white, and collapsed until segments are set.
+   * @param numSegments Number of line segments (two vertices each) in the slot
+   * @param frame Transform whose matrix maps the slot's local points into the world
+   * @param owner Node whose effective visibility gates the slot; may be nullptr
+   * @return Slot handle, or INVALID_SLOT if numSegments is 0 or frame is nullptr
+   */
+  SlotId allocate(unsigned int numSegments, const osg::MatrixTransform* frame, const osg::Node* owner);
+
+  /** Returns a slot's range to the batch for reuse by a later allocation of the same size */
+  void release(SlotId slot);
+
+  /**
+   * Replaces a slot's segments.
+   * @param slot Slot to change
+   * @param points Vertex pairs, one pair per segment, in the frame's local coordinates
+   * @return 0 on success, non-zero if the slot is invalid or the point count does not match its size
+   */
+  int setSegments(SlotId slot, const std::vector<osg::Vec3f>& points);
+
+  /** Changes the color of every segment in a slot */
+  void setColor(SlotId slot, const osg::Vec4f& color);
+
+  /** Shows or hides a slot independently of its owner's node mask */
+  void setVisible(SlotId slot, bool visible);
+
+  /**
+   * Refreshes slots whose frame, owner visibility, segments or color changed, then pushes the
+   * changed vertex range to the drawable.  Called automatically from the update traversal.
+   */
+  void update();
+
+  /** Number of slots currently allocated */
+  unsigned int numSlots() const;
+  /** Number of anchor groups, each drawn separately */
+  unsigned int numAnchorGroups() const;
+  /** Anchor group that holds a slot's vertices */
+  unsigned int anchorGroup(SlotId slot) const;
+  /** Number of vertices in a group's array, including released ranges awaiting reuse */
+  unsigned int numVertices(unsigned int group = 0) const;
+  /** Index of a slot's first vertex in its group's array */
+  unsigned int firstVertex(SlotId slot) const;
+  /** Anchor-relative position of a vertex in a group's array */
+  const osg::Vec3f& vertex(unsigned int index, unsigned int group = 0) const;
+  /** Color of a vertex in a group's array; hidden and released vertices are fully transparent */
+  const osg::Vec4f& vertexColor(unsigned int index, unsigned int group = 0) const;
+  /** World position that all vertices in a group are stored relative to */
+  const osg::Vec3d& anchor(unsigned int group = 0) const;
+  /** Number of vertices copied to the drawables since construction, for testing partial updates */
+  unsigned int numVertexWrites() const;
+
+  /** Return the proper library name */
+  virtual const char* libraryName() const { return "simVis"; }
+
+  /** Return the class name */
+  virtual const char* className() const { return "LineBatch"; }
+
+protected:
+  /// osg::Referenced-derived
+  virtual ~LineBatch();
+
+private:
+  /// Range of segments owned by one client
+  struct Slot
+  {
+    unsigned int group;
+    unsigned int first;
+    unsigned int numSegments;
+    osg::observer_ptr<const osg::MatrixTransform> frame;
+    osg::observer_ptr<const osg::Node> owner;
+    std::vector<osg::Vec3f> localPoints;
+    osg::Vec4f color;
+    bool visible;
+    bool inUse;
+    /// True when the slot must be rewritten on the next update()
+    bool dirty;
+    /// Visibility and frame matrix as of the last write
+    bool drawn;
+    osg::Matrixd drawnMatrix;
+  };
+
+  /// Slots near one anchor point, sharing a vertex array and a drawable
+  struct AnchorGroup
+  {
+    osg::Vec3d anchor;
+    /// False until the first slot is written, which sets the anchor
+    bool hasAnchor;
+    unsigned int numSlots;
+    /// Released vertex ranges by segment count, for reuse
+    std::multimap<unsigned int, unsigned int> freeRanges;
+    std::vector<osg::Vec3f> vertices;
+    std::vector<osg::Vec4f> colors;
+    unsigned int dirtyFirst;
+    unsigned int dirtyEnd;
+    unsigned int drawableCapacity;
+    osg::ref_ptr<osg::MatrixTransform> xform;
+    osg::ref_ptr<osgEarth::LineDrawable> line;
+  };
+
+  /// Returns the group for a slot whose frame origin is at the given world position, creating one if needed
+  unsigned int groupFor_(const osg::Vec3d& position);
+  /// Reserves a vertex range for the given number of segments in a group, returning its first vertex
+  unsigned int allocateRange_(unsigned int group, unsigned int numSegments);
+  /// Returns a slot's vertex range to its group
+  void releaseRange_(const Slot& slot);
+  /// Writes a slot's vertices and colors into its group's arrays, moving it to a nearer group if needed
+  void writeSlot_(Slot& slot, bool visible, const osg::Matrixd& matrix);
+  /// Collapses a vertex range to the anchor and makes it transparent
+  void clearRange_(AnchorGroup& group, unsigned int first, unsigned int count);
+  /// Extends the range pushed to the group's drawable on the next update()
+  void markDirty_(AnchorGroup& group, unsigned int first, unsigned int count);
+  /// Copies the group's dirty range into its drawable, growing it if needed
+  void flush_(AnchorGroup& group);
+
+  float lineWidth_;
+  std::vector<Slot> slots_;
+  std::vector<SlotId> freeSlotIds_;
+  std::vector<AnchorGroup> groups_;
+  unsigned int numSlots_;
+  unsigned int numVertexWrites_;
+};
+
+/**
+ * Holds the shared line batches for a scenario, one per combination of line width and node
+ * mask, so that batched lines keep the display mask of the entity type that draws them.
+ */
+class SDKVIS_EXPORT LineBatchGroup : public osg::Group
+{
+public:
+  LineBatchGroup();
+
+  /**
+   * Retrieves the batch for the given line width and node mask, creating it on first use.
+   * @param lineWidth Line width in pixels
+   * @param nodeMask Node mask applied to the batch, such as DISPLAY_MASK_LASER
+   * @return Batch shared by all clients with the same width and mask
+   */
+  LineBatch* getOrCreate(float lineWidth, unsigned int nodeMask);
+
+  /** Return the proper library name */
+  virtual const char* libraryName() const { return "simVis"; }
+
+  /** Return the class name */
+  virtual const char* className() const { return "LineBatchGroup"; }
+
+protected:
+  /// osg::Referenced-derived
+  virtual ~LineBatchGroup();
+
+private:
+  std::map<std::pair<float, unsigned int>, osg::ref_ptr<LineBatch> > batches_;
+};
+
+} // namespace simVis
+
+#endif // SIMVIS_LINE_BATCH_H
@@ -20,11 +20,15 @@
  * disclose, or release this software.
  *
  */
+#include <cmath>
 #include <iomanip>
+#include <map>
+#include <tuple>
 
 #include "osg/Notify"
 #include "osg/Geode"
 #include "osg/Geometry"
+#include "osg/MatrixTransform"
 #include "osgText/Text"
 
 #include "osgEarth/Color"
@@ -67,6 +71,50 @@ const unsigned int MIN_NUM_LINE_SEGMENTS = 50;
 // Number of points in the subdivided line strip for horizontal and cross-hair grids
 const unsigned int NUM_POINTS_PER_LINE_STRIP = 10;
 
+/// Prefs values that determine the content of grid geometry; labels are built per grid and are not included
+struct GeometryKey
+{
+  int gridType;
+  uint32_t color;
+  double sizeM; ///< radius for fixed size grids; 0 for speed grids, which are scaled by transform
+  unsigned int numDivisions;
+  unsigned int numSubDivisions;
+  double sectorAngle;
+  int speedRingLevel;
+
+  bool operator<(const GeometryKey& rhs) const
+  {
+    return std::tie(gridType, color, sizeM, numDivisions, numSubDivisions, sectorAngle, speedRingLevel) <
+      std::tie(rhs.gridType, rhs.color, rhs.sizeM, rhs.numDivisions, rhs.numSubDivisions, rhs.sectorAngle, rhs.speedRingLevel);
+  }
+};
+
+/// Immutable grid geometry, shared by all local grids with the same key; entries expire with the last grid using them
+typedef std::map<GeometryKey, osg::observer_ptr<osg::Node> > GeometryCache;
+
+GeometryCache& geometryCache()
+{
+  static GeometryCache cache;
+  return cache;
+}
+
+/**
+ * Speed ring geometry is built at unit radius and scaled to size.  Ring segment counts depend on the
+ * actual size though, so sizes are bucketed by power of two; geometry is only replaced when the bucket changes.
+ */
+int speedRingLevel(double sizeM)
+{
+  if (sizeM <= 1.0)
+    return 0;
+  return static_cast<int>(std::ceil(std::log2(sizeM)));
+}
+
+/// Outer radius in meters used to determine ring segment counts for the given speed ring level
+double speedRingSegmentSize(int level)
+{
+  return simCore::sdkMin(MAX_RING_SIZE_M, std::ldexp(1.0, level));
+}
+
 /// Base Class for local grid label types.
 class LocalGridLabel : public osgText::Text
 {
@@ -383,7 +431,13 @@ public:
     (*colorArray)[0] = color;
   }
 
-  void update(const simData::LocalGridPrefs& prefs, double sizeM)
+  /**
+   * Recalculates the ring vertices
+   * @param prefs Grid prefs providing the number of rings
+   * @param sizeM Radius of the outermost ring
+   * @param segmentSizeM Radius of the outermost ring for determining the number of segments; if 0, sizeM is used
+   */
+  void update(const simData::LocalGridPrefs& prefs, double sizeM, double segmentSizeM = 0.0)
   {
     osg::ref_ptr<osg::Vec3Array> vertexArray = dynamic_cast<osg::Vec3Array*>(getVertexArray());
     if (!vertexArray)
@@ -402,7 +456,8 @@ public:
     const unsigned int numRings = osg::maximum(1u, (numDivisions + 1) * (numSubDivisions + 1));
     const float spacingM = sizeM / numRings;
     const float radiusM = spacingM * (ring_ + 1);
-    const double circum = 2.0 * M_PI * radiusM;
+    const double segmentRadiusM = (segmentSizeM > 0.0) ? (segmentSizeM / numRings * (ring_ + 1)) : radiusM;
+    const double circum = 2.0 * M_PI * segmentRadiusM;
     const unsigned int segs = simCore::sdkMax(MIN_NUM_LINE_SEGMENTS, static_cast<unsigned int>(::ceil(circum / CIRCLE_QUANT_LEN)));
     const float inc = M_TWOPI / segs;
 
@@ -429,6 +484,9 @@ private:
 // --------------------------------------------------------------------------
 LocalGridNode::LocalGridNode(Locator* hostLocator, const EntityNode* host, int referenceYear)
   : LocatorNode(new Locator(hostLocator, Locator::COMP_POSITION | Locator::COMP_HEADING)),
+    speedRingLevel_(-1),
+    numGeometryBuilds_(0),
+    numGeometryCacheHits_(0),
     forceRebuild_(true),
     hostSpeedMS_(0.0),
     hostTimeS_(0.0),
@@ -443,6 +501,73 @@ LocalGridNode::LocalGridNode(Locator* hostLocator, const EntityNode* host, int r
 
 LocalGridNode::~LocalGridNode() {}
 
+unsigned int LocalGridNode::numGeometryBuilds() const
+{
+  return numGeometryBuilds_;
+}
+
+unsigned int LocalGridNode::numGeometryCacheHits() const
+{
+  return numGeometryCacheHits_;
+}
+
+osg::ref_ptr<osg::Node> LocalGridNode::getOrCreateGeometry_(const simData::LocalGridPrefs& prefs, int speedRingLevel)
+{
+  const simData::LocalGridPrefs_Type gridType = prefs.gridtype();
+  const bool isSpeedGrid = (gridType == simData::LocalGridPrefs_Type_SPEED_RINGS || gridType == simData::LocalGridPrefs_Type_SPEED_LINE);
+
+  GeometryKey key;
+  key.gridType = gridType;
+  key.color = prefs.gridcolor();
+  // Note that size is halved; it's provided in diameter, and we need it as radius
+  key.sizeM = isSpeedGrid ? 0.0 : simVis::convertUnitsToOsgEarth(prefs.sizeunits()).convertTo(osgEarth::Units::METERS, prefs.size()) * 0.5;
+  key.numDivisions = prefs.gridsettings().numdivisions();
+  key.numSubDivisions = prefs.gridsettings().numsubdivisions();
+  key.sectorAngle = (gridType == simData::LocalGridPrefs_Type_POLAR || gridType == simData::LocalGridPrefs_Type_SPEED_RINGS) ? prefs.gridsettings().sectorangle() : 0.0;
+  // speed line has no rings, so its geometry does not depend on size
+  key.speedRingLevel = (gridType == simData::LocalGridPrefs_Type_SPEED_RINGS) ? speedRingLevel : 0;
+
+  GeometryCache& cache = geometryCache();
+  GeometryCache::iterator i = cache.find(key);
+  osg::ref_ptr<osg::Node> geometry;
+  if (i != cache.end() && i->second.lock(geometry))
+  {
+    ++numGeometryCacheHits_;
+    return geometry;
+  }
+
+  // drop geometry that is no longer used by any grid
+  for (i = cache.begin(); i != cache.end();)
+  {
+    if (i->second.valid())
+      ++i;
+    else
+      i = cache.erase(i);
+  }
+
+  osg::ref_ptr<osg::Group> group = new osg::Group();
+  group->setName("simVis::LocalGridNode::Geometry");
+  switch (gridType)
+  {
+  case simData::LocalGridPrefs_Type_CARTESIAN:
+    createCartesian_(prefs, group.get(), nullptr);
+    break;
+  case simData::LocalGridPrefs_Type_POLAR:
+    createRangeRings_(prefs, group.get(), nullptr, true);
+    break;
+  case simData::LocalGridPrefs_Type_RANGE_RINGS:
+    createRangeRings_(prefs, group.get(), nullptr, false);
+    break;
+  case simData::LocalGridPrefs_Type_SPEED_RINGS:
+  case simData::LocalGridPrefs_Type_SPEED_LINE:
+    createSpeedRings_(prefs, group.get(), nullptr, (gridType == simData::LocalGridPrefs_Type_SPEED_LINE), speedRingSegmentSize(key.speedRingLevel));
+    break;
+  }
+  ++numGeometryBuilds_;
+  cache[key] = group.get();
+  return group;
+}
+
 void LocalGridNode::rebuild_(const simData::LocalGridPrefs& prefs)
 {
   // set up the default state set and render bins:
@@ -467,20 +592,25 @@ void LocalGridNode::rebuild_(const simData::LocalGridPrefs& prefs)
   assert(getNumChildren() == 2);
   graphicsGroup_->removeChildren(0, graphicsGroup_->getNumChildren());
   labelGroup_->removeChildren(0, labelGroup_->getNumChildren());
+  speedRingXform_ = nullptr;
+  speedRingLevel_ = -1;
 
-  // build for the appropriate grid type:
+  // build for the appropriate grid type; geometry is shared, labels belong to this grid
   switch (prefs.gridtype())
   {
   case simData::LocalGridPrefs_Type_CARTESIAN:
-    createCartesian_(prefs, graphicsGroup_.get(), labelGroup_.get());
+    graphicsGroup_->addChild(getOrCreateGeometry_(prefs, 0));
+    createCartesian_(prefs, nullptr, labelGroup_.get());
     break;
 
   case simData::LocalGridPrefs_Type_POLAR:
-    createRangeRings_(prefs, graphicsGroup_.get(), labelGroup_.get(), true);
+    graphicsGroup_->addChild(getOrCreateGeometry_(prefs, 0));
+    createRangeRings_(prefs, nullptr, labelGroup_.get(), true);
     break;
 
   case simData::LocalGridPrefs_Type_RANGE_RINGS:
-    createRangeRings_(prefs, graphicsGroup_.get(), labelGroup_.get(), false);
+    graphicsGroup_->addChild(getOrCreateGeometry_(prefs, 0));
+    createRangeRings_(prefs, nullptr, labelGroup_.get(), false);
     break;
 
   case simData::LocalGridPrefs_Type_SPEED_RINGS:
@@ -492,7 +622,11 @@ void LocalGridNode::rebuild_(const simData::LocalGridPrefs& prefs)
     const int status = processSpeedParams_(prefs, sizeM, timeRadiusSeconds);
     if (status >= 0)
     {
-      createSpeedRings_(prefs, graphicsGroup_.get(), labelGroup_.get(), (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_LINE));
+      speedRingXform_ = new osg::MatrixTransform();
+      speedRingXform_->setName("simVis::LocalGridNode::SpeedRingTransform");
+      speedRingXform_->setDataVariance(osg::Object::DYNAMIC);
+      graphicsGroup_->addChild(speedRingXform_.get());
+      createSpeedRings_(prefs, nullptr, labelGroup_.get(), (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_LINE), 0.0);
       updateSpeedRings_(prefs, sizeM, timeRadiusSeconds);
     }
     break;
@@ -565,19 +699,33 @@ void LocalGridNode::setPrefs(const simData::LocalGridPrefs& prefs, bool force)
       PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, gridsettings, numdivisions)    ||
       PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, gridsettings, numsubdivisions) ||
       PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, gridsettings, sectorangle)     ||
-      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, usefixedtime)       ||
-      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, fixedtime)          ||  // note that fixed time validation occurs above, but this will cause a rebuild
       PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, timeformat)         ||
+      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, displaytime);
+
+    // these only change the size of the speed ring/line, which is applied by rescaling the existing display
+    const bool speedSizeChanged =
+      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, usefixedtime)       ||
+      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, fixedtime)          ||  // note that fixed time validation occurs above
       PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, radius)             ||
       PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, useplatformspeed)   ||
       PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, speedtouse)         ||
-      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, speedunits)         ||
-      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, displaytime);
+      PB_SUBFIELD_CHANGED(&lastPrefs_, &prefs, speedring, speedunits);
+    const bool isSpeedGrid = (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_RINGS) ||
+      (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_LINE);
 
-    if (rebuildRequired)
+    if (rebuildRequired || (isSpeedGrid && speedSizeChanged && !speedRingXform_.valid()))
     {
       rebuild_(prefs);
     }
+    else if (isSpeedGrid && speedSizeChanged)
+    {
+      double sizeM;
+      double timeRadiusSeconds;
+      if (processSpeedParams_(prefs, sizeM, timeRadiusSeconds) >= 0)
+        updateSpeedRings_(prefs, sizeM, timeRadiusSeconds);
+      else
+        updateSpeedRings_(prefs, 0.0, 0.0);
+    }
 
     const bool locatorChangeRequired =
       forceRebuild_ ||
@@ -683,7 +831,7 @@ void LocalGridNode::createCartesian_(const simData::LocalGridPrefs& prefs, osg::
   const osg::Vec4f& subColor = simVis::Color(color * 0.5f, 1.0f);
 
   // first draw the subdivision lines
-  for (int s = 0; s < numSubLines; ++s)
+  for (int s = 0; geomGroup && s < numSubLines; ++s)
   {
     // skip sub lines that are coincident with main division lines
     if (s % (numSubDivisions+1) == 0)
@@ -711,6 +859,7 @@ void LocalGridNode::createCartesian_(const simData::LocalGridPrefs& prefs, osg::
   for (int p=0; p < numDivLines; ++p)
   {
     const float x = x0 + divSpacing * p;
+    if (geomGroup)
     {
       LineStrip* div1 = new LineStrip();
       div1->update(osg::Vec3(x, y0, 0.f), osg::Vec3(x, y0 + span, 0.f));
@@ -719,7 +868,7 @@ void LocalGridNode::createCartesian_(const simData::LocalGridPrefs& prefs, osg::
       geomGroup->addChild(div1);
     }
     // x-label:
-    if (x < 0 && prefs.gridlabeldraw())
+    if (x < 0 && labelGroup && prefs.gridlabeldraw())
     {
       CartesianGridLabel* label = new CartesianGridLabel(prefs, -x);
       label->setPosition(osg::Vec3(-x, 0.f, 0.f));
@@ -727,6 +876,7 @@ void LocalGridNode::createCartesian_(const simData::LocalGridPrefs& prefs, osg::
     }
 
     const float y = y0 + divSpacing * p;
+    if (geomGroup)
     {
       LineStrip* div2 = new LineStrip();
       div2->update(osg::Vec3(x0, y, 0.f), osg::Vec3(x0 + span, y, 0.f));
@@ -735,7 +885,7 @@ void LocalGridNode::createCartesian_(const simData::LocalGridPrefs& prefs, osg::
       geomGroup->addChild(div2);
     }
     // y-label
-    if (y > 0 && prefs.gridlabeldraw())
+    if (y > 0 && labelGroup && prefs.gridlabeldraw())
     {
       CartesianGridLabel* label = new CartesianGridLabel(prefs, y);
       label->setPosition(osg::Vec3(0.f, y, 0.f));
@@ -773,13 +923,16 @@ void LocalGridNode::createRangeRings_(const simData::LocalGridPrefs& prefs, osg:
   {
     const bool isMajorRing = ((i + 1) % (numSubDivisions + 1)) == 0;
 
-    RangeRing* rangeRing = new RangeRing(i);
-    rangeRing->setColor(isMajorRing ? color : subColor);
-    geomGroup->addChild(rangeRing);
-    rangeRing->update(prefs, sizeM);
+    if (geomGroup)
+    {
+      RangeRing* rangeRing = new RangeRing(i);
+      rangeRing->setColor(isMajorRing ? color : subColor);
+      geomGroup->addChild(rangeRing);
+      rangeRing->update(prefs, sizeM);
+    }
 
     // label:
-    if (isMajorRing && prefs.gridlabeldraw())
+    if (isMajorRing && labelGroup && prefs.gridlabeldraw())
     {
       RingLabel* label = new RingLabel(prefs, i, true);
       labelGroup->addChild(label);
@@ -793,7 +946,7 @@ void LocalGridNode::createRangeRings_(const simData::LocalGridPrefs& prefs, osg:
   }
 
   // Cross-hair lines don't get drawn for Range Rings, but do for Polar
-  if (includePolarRadials)
+  if (includePolarRadials && geomGroup)
   {
     Axis* majorAxis = new Axis(true);
     majorAxis->setColor(color);
@@ -816,7 +969,7 @@ void LocalGridNode::createRangeRings_(const simData::LocalGridPrefs& prefs, osg:
 }
 
 // creates a speed-rings local grid with optional polar radials.
-void LocalGridNode::createSpeedRings_(const simData::LocalGridPrefs& prefs, osg::Group* graphicsGroup, osg::Group* labelGroup, bool drawSpeedLine) const
+void LocalGridNode::createSpeedRings_(const simData::LocalGridPrefs& prefs, osg::Group* graphicsGroup, osg::Group* labelGroup, bool drawSpeedLine, double segmentSizeM) const
 {
   const osg::Vec4f& color = simVis::Color(prefs.gridcolor(), simVis::Color::RGBA);
   const osg::Vec4f& subColor = simVis::Color(color * 0.5f, 1.0f);
@@ -824,49 +977,53 @@ void LocalGridNode::createSpeedRings_(const simData::LocalGridPrefs& prefs, osg:
   const unsigned int numSubDivisions = prefs.gridsettings().numsubdivisions();
   const unsigned int numRings = (numDivisions + 1) * (numSubDivisions + 1);
 
-  if (drawSpeedLine)
+  // geometry is built at unit radius; the speed ring transform scales it to the current size
+  if (graphicsGroup)
   {
-    SpeedLine* speedLine = new SpeedLine();
-    speedLine->setDataVariance(osg::Object::DYNAMIC);
-    speedLine->setColor(color);
-    graphicsGroup->addChild(speedLine);
-
-    if (!prefs.gridlabeldraw())
-      return;
-  }
-  else
-  {
-    Axis* majorAxis = new Axis(true);
-    majorAxis->setDataVariance(osg::Object::DYNAMIC);
-    majorAxis->setColor(color);
-    graphicsGroup->addChild(majorAxis);
-    Axis* minorAxis = new Axis(false);
-    minorAxis->setDataVariance(osg::Object::DYNAMIC);
-    minorAxis->setColor(color);
-    graphicsGroup->addChild(minorAxis);
-
-    const float sectorAngle = prefs.gridsettings().sectorangle();
-    // draw polar radials for speed rings
-    if (sectorAngle > 0.0f)
+    if (drawSpeedLine)
     {
-      RadialPoints* points = new RadialPoints(subColor, sectorAngle, numRings);
-      points->setDataVariance(osg::Object::DYNAMIC);
-      graphicsGroup->addChild(points);
+      SpeedLine* speedLine = new SpeedLine();
+      speedLine->setColor(color);
+      graphicsGroup->addChild(speedLine);
+      speedLine->update(1.0);
+    }
+    else
+    {
+      Axis* majorAxis = new Axis(true);
+      majorAxis->setColor(color);
+      graphicsGroup->addChild(majorAxis);
+      majorAxis->update(1.0);
+      Axis* minorAxis = new Axis(false);
+      minorAxis->setColor(color);
+      graphicsGroup->addChild(minorAxis);
+      minorAxis->update(1.0);
+
+      const float sectorAngle = prefs.gridsettings().sectorangle();
+      // draw polar radials for speed rings
+      if (sectorAngle > 0.0f)
+      {
+        RadialPoints* points = new RadialPoints(subColor, sectorAngle, numRings);
+        graphicsGroup->addChild(points);
+        points->update(1.0);
+      }
     }
   }
 
+  if (drawSpeedLine && (!labelGroup || !prefs.gridlabeldraw()))
+    return;
+
   for (unsigned int i = 0; i < numRings; ++i)
   {
     const bool isMajorRing = ((i + 1) % (numSubDivisions + 1)) == 0;
-    if (!drawSpeedLine)
+    if (!drawSpeedLine && graphicsGroup)
     {
       RangeRing* speedRing = new RangeRing(i);
-      speedRing->setDataVariance(osg::Object::DYNAMIC);
       speedRing->setColor(isMajorRing ? color : subColor);
       graphicsGroup->addChild(speedRing);
+      speedRing->update(prefs, 1.0, segmentSizeM);
     }
     // labels are only added to major rings
-    if (isMajorRing && prefs.gridlabeldraw())
+    if (isMajorRing && labelGroup && prefs.gridlabeldraw())
     {
       RingLabel* label = new RingLabel(prefs, i, true);
       label->setDataVariance(osg::Object::DYNAMIC); // Need Dynamic so text display updates
@@ -897,35 +1054,25 @@ void LocalGridNode::updateSpeedRings_(const simData::LocalGridPrefs& prefs, doub
     if (label)
       label->update(prefs, sizeM, timeRadiusSeconds);
   }
-  const unsigned int numGraphics = graphicsGroup_->getNumChildren();
-  for (unsigned int i = 0; i < numGraphics; i++)
+  // no transform if the speed ring display could not be created at the last rebuild
+  if (!speedRingXform_.valid())
+    return;
+  if (sizeM <= 0.0)
   {
-    osg::Node* child = graphicsGroup_->getChild(i);
-    RangeRing* ring = dynamic_cast<RangeRing*>(child);
-    if (ring)
-    {
-      ring->update(prefs, sizeM);
-      continue;
-    }
-    SpeedLine* line = dynamic_cast<SpeedLine*>(child);
-    if (line)
-    {
-      line->update(sizeM);
-      continue;
-    }
-    Axis* axis = dynamic_cast<Axis*>(child);
-    if (axis)
-    {
-      axis->update(sizeM);
-      continue;
-    }
-    RadialPoints* pts = dynamic_cast<RadialPoints*>(child);
-    if (pts)
-    {
-      pts->update(sizeM);
-      continue;
-    }
+    speedRingXform_->setNodeMask(DISPLAY_MASK_NONE);
+    return;
+  }
+
+  // shared geometry only needs replacing when the size moves to a different segment count bucket
+  const int level = (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_LINE) ? 0 : speedRingLevel(sizeM);
+  if (level != speedRingLevel_)
+  {
+    speedRingXform_->removeChildren(0, speedRingXform_->getNumChildren());
+    speedRingXform_->addChild(getOrCreateGeometry_(prefs, level));
+    speedRingLevel_ = level;
   }
+  speedRingXform_->setMatrix(osg::Matrix::scale(sizeM, sizeM, 1.0));
+  speedRingXform_->setNodeMask(~0u);
 }
 
 int LocalGridNode::processSpeedParams_(const simData::LocalGridPrefs& prefs, double& sizeM, double& timeRadiusSeconds)
@@ -29,7 +29,11 @@
 #include "simData/DataTypes.h"
 #include "simVis/LocatorNode.h"
 
-namespace osg { class Group; }
+namespace osg {
+  class Group;
+  class MatrixTransform;
+  class Node;
+}
 namespace osgText { class Text; }
 
 namespace simVis
@@ -74,6 +78,16 @@ namespace simVis
     /** Return the class name */
     virtual const char* className() const { return "LocalGridNode"; }
 
+    /**
+     * Number of times this grid had to generate new grid geometry because no equivalent geometry was
+     * shared by another grid.  Grid geometry is immutable and shared between all local grids whose
+     * geometry-affecting prefs match; exposed for testing.
+     */
+    unsigned int numGeometryBuilds() const;
+
+    /** Number of times this grid reused grid geometry already built for an equivalent grid; exposed for testing. */
+    unsigned int numGeometryCacheHits() const;
+
   public: // LocatorNode interface
     virtual void syncWithLocator(); //override
 
@@ -89,14 +103,21 @@ namespace simVis
     /// update the locator settings
     void configureLocator_(const simData::LocalGridPrefs& prefs);
 
-    /// create Cartesian grid display
+    /// create Cartesian grid display; either group may be nullptr to skip geometry or labels
     void createCartesian_(const simData::LocalGridPrefs& prefs, osg::Group* geomGroup, osg::Group* labelGroup) const;
 
-    /// create polar ring or range ring display
+    /// create polar ring or range ring display; either group may be nullptr to skip geometry or labels
     void createRangeRings_(const simData::LocalGridPrefs& prefs, osg::Group* geomGroup, osg::Group* labelGroup, bool includePolarRadials) const;
 
-    /// create speed ring or speed line display
-    void createSpeedRings_(const simData::LocalGridPrefs& prefs, osg::Group* geomGroup, osg::Group* labelGroup, bool drawSpeedLine) const;
+    /**
+    * Create speed ring or speed line display; either group may be nullptr to skip geometry or labels.
+    * Geometry is created at unit radius, to be scaled to the ring size by speedRingXform_.
+    * @param[in ] segmentSizeM Outer radius in meters used to determine the number of segments in each ring
+    */
+    void createSpeedRings_(const simData::LocalGridPrefs& prefs, osg::Group* geomGroup, osg::Group* labelGroup, bool drawSpeedLine, double segmentSizeM) const;
+
+    /// returns shared geometry for the given prefs, building it only when no equivalent grid geometry exists
+    osg::ref_ptr<osg::Node> getOrCreateGeometry_(const simData::LocalGridPrefs& prefs, int speedRingLevel);
 
     /// update the speed ring/line display for current data
     void updateSpeedRings_(const simData::LocalGridPrefs& prefs, double sizeM, double timeRadiusSeconds);
@@ -113,6 +134,12 @@ namespace simVis
   private: // data
     osg::ref_ptr<osg::Group> graphicsGroup_;
     osg::ref_ptr<osg::Group> labelGroup_;
+    /// scales the unit-radius speed ring/line geometry to the current ring size
+    osg::ref_ptr<osg::MatrixTransform> speedRingXform_;
+    /// size bucket that determines the segment count of the current speed ring geometry; -1 when none
+    int speedRingLevel_;
+    unsigned int numGeometryBuilds_;
+    unsigned int numGeometryCacheHits_;
 
     simData::LocalGridPrefs lastPrefs_;
     bool                    forceRebuild_;
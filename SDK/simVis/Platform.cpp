@@ -182,8 +182,12 @@ PlatformNode::PlatformNode(const simData::PlatformProperties& props,
   frontOffset_(0.0),
   valid_(false),
   lastPrefsValid_(false),
+  prefsRevision_(0),
+  labelPrefsRevision_(0),
   forceUpdateFromDataStore_(false),
-  queuedInvalidate_(false)
+  queuedInvalidate_(false),
+  hasBatchFilterResult_(false),
+  batchFilterResponse_(PlatformTspiFilterManager::POINT_UNCHANGED)
 {
   // PlatformModelNode can simply re-use the Platform locator: it does not add any offsets
   model_ = new PlatformModelNode(getLocator());
@@ -407,6 +411,10 @@ void PlatformNode::setPrefs(const simData::PlatformPrefs& prefs)
 
   lastPrefs_ = prefs;
   lastPrefsValid_ = true;
+  ++prefsRevision_;
+  hoverContent_.invalidate();
+  hookContent_.invalidate();
+  legendContent_.invalidate();
 }
 
 const osg::BoundingBox& PlatformNode::getActualSize() const
@@ -469,7 +477,9 @@ TrackHistoryNode* PlatformNode::getTrackHistory()
 simCore::Vec3 PlatformNode::pointNorth_(const simCore::Vec3& ecef) const
 {
   simCore::Vec3 lla;
-  simCore::CoordinateConverter::convertEcefToGeodeticPos(ecef, lla);
+  // Share the conversion made while filtering the current point, if any
+  if (!platformTspiFilterManager_.lastGeodetic(getId(), ecef, lla))
+    simCore::CoordinateConverter::convertEcefToGeodeticPos(ecef, lla);
   simCore::Vec3 orientation;
   simCore::CoordinateConverter::convertGeodeticOriToEcef(lla, simCore::Vec3(0.0, 0.0, 0.0), orientation);
   return orientation;
@@ -507,8 +517,36 @@ simData::ObjectId PlatformNode::getId() const
   return lastProps_.id();
 }
 
+bool PlatformNode::prepareBatchFilter(const simData::DataSliceBase* updateSliceBase, bool force, PlatformTspiFilterManager::BatchEntry& entry) const
+{
+  if (!lastPrefsValid_ || updateSliceBase == nullptr)
+    return false;
+
+  const simData::PlatformUpdateSlice* updateSlice = static_cast<const simData::PlatformUpdateSlice*>(updateSliceBase);
+  // Only stage points that updateFromDataStore() will filter; it filters points in any other cases itself
+  if (!updateSlice->current() || (!updateSlice->hasChanged() && !force && !forceUpdateFromDataStore_))
+    return false;
+
+  entry.update = *updateSlice->current();
+  entry.prefs = &lastPrefs_;
+  entry.props = &lastProps_;
+  entry.prefsRevision = prefsRevision_;
+  return true;
+}
+
+void PlatformNode::setBatchFilterResult(const PlatformTspiFilterManager::BatchEntry& entry)
+{
+  batchFilterUpdate_ = entry.update;
+  batchFilterResponse_ = entry.response;
+  hasBatchFilterResult_ = true;
+}
+
 bool PlatformNode::updateFromDataStore(const simData::DataSliceBase* updateSliceBase, bool force)
 {
+  // A batch filter result only applies to the update immediately following it
+  const bool batchFiltered = hasBatchFilterResult_;
+  hasBatchFilterResult_ = false;
+
   // Do not assert on lastPrefsValid_; this routine can get called during platform creation.
   if (!lastPrefsValid_)
     return false;
@@ -595,7 +633,15 @@ bool PlatformNode::updateFromDataStore(const simData::DataSliceBase* updateSlice
   {
     simData::PlatformUpdate current = *updateSlice->current();
     lastUnfilteredUpdate_ = current;
-    PlatformTspiFilterManager::FilterResponse modified = platformTspiFilterManager_.filter(current, lastPrefs_, lastProps_);
+    PlatformTspiFilterManager::FilterResponse modified = PlatformTspiFilterManager::POINT_UNCHANGED;
+    if (batchFiltered && batchFilterUpdate_.time() == current.time())
+    {
+      // The scenario already filtered this point with the other platforms
+      modified = batchFilterResponse_;
+      current = batchFilterUpdate_;
+    }
+    else
+      modified = platformTspiFilterManager_.filter(current, lastPrefs_, lastProps_, prefsRevision_);
     if (modified == PlatformTspiFilterManager::POINT_DROPPED)
     {
       setInvalid_();
@@ -820,13 +866,19 @@ void PlatformNode::updateLabel_(const simData::PlatformPrefs& prefs)
   if (!valid_)
     return;
 
+  // prefs from setPrefs() are new; otherwise they are lastPrefs_, which may have changed since the last label update
+  const bool prefsChanged = (&prefs != &lastPrefs_) || (labelPrefsRevision_ != prefsRevision_);
+  labelPrefsRevision_ = prefsRevision_;
+  if (prefsChanged)
+    labelContent_.invalidate();
+
   std::string label = getEntityName_(prefs.commonprefs(), EntityNode::DISPLAY_NAME, true);
   if (prefs.commonprefs().labelprefs().namelength() > 0)
     label = label.substr(0, prefs.commonprefs().labelprefs().namelength());
 
   std::string text;
   if (prefs.commonprefs().labelprefs().draw())
-    text = labelContentCallback().createString(prefs, *labelUpdate_(prefs), prefs.commonprefs().labelprefs().displayfields());
+    text = labelContent_.createString(labelContentCallback(), prefs, *labelUpdate_(prefs), prefs.commonprefs().labelprefs().displayfields());
 
   if (!text.empty())
   {
@@ -836,7 +888,7 @@ void PlatformNode::updateLabel_(const simData::PlatformPrefs& prefs)
   }
 
   float zOffset = 0.0f;
-  model_->label()->update(prefs.commonprefs(), label, zOffset);
+  model_->label()->update(prefs.commonprefs(), label, zOffset, prefsChanged);
 }
 
 std::string PlatformNode::popupText() const
@@ -855,7 +907,7 @@ std::string PlatformNode::popupText() const
         prefix = getEntityName(EntityNode::ALIAS_NAME);
       prefix += "\n";
     }
-    return prefix + labelContentCallback().createString(lastPrefs_, *labelUpdate_(lastPrefs_), lastPrefs_.commonprefs().labelprefs().hoverdisplayfields());
+    return prefix + hoverContent_.createString(labelContentCallback(), lastPrefs_, *labelUpdate_(lastPrefs_), lastPrefs_.commonprefs().labelprefs().hoverdisplayfields());
   }
 
   return "";
@@ -867,7 +919,7 @@ std::string PlatformNode::hookText() const
   {
     // a valid_ platform should never have an update that does not have a time
     assert(lastUpdate_.has_time());
-    return labelContentCallback().createString(lastPrefs_, *labelUpdate_(lastPrefs_), lastPrefs_.commonprefs().labelprefs().hookdisplayfields());
+    return hookContent_.createString(labelContentCallback(), lastPrefs_, *labelUpdate_(lastPrefs_), lastPrefs_.commonprefs().labelprefs().hookdisplayfields());
   }
 
   return "";
@@ -879,7 +931,7 @@ std::string PlatformNode::legendText() const
   {
     // a valid_ platform should never have an update that does not have a time
     assert(lastUpdate_.has_time());
-    return labelContentCallback().createString(lastPrefs_, *labelUpdate_(lastPrefs_), lastPrefs_.commonprefs().labelprefs().legenddisplayfields());
+    return legendContent_.createString(labelContentCallback(), lastPrefs_, *labelUpdate_(lastPrefs_), lastPrefs_.commonprefs().labelprefs().legenddisplayfields());
   }
 
   return "";
@@ -941,6 +993,22 @@ void PlatformNode::updateOrRemoveInertialAxis_(bool prefsDraw, const simData::Pl
   }
 }
 
+void PlatformNode::setLineBatchGroup(LineBatchGroup* lineBatches)
+{
+  if (lineBatches_.get() == lineBatches)
+    return;
+  lineBatches_ = lineBatches;
+
+  // Recreate the velocity vector so it draws through the new batches
+  if (velocityAxisVector_.valid())
+  {
+    removeChild(velocityAxisVector_);
+    velocityAxisVector_ = nullptr;
+    if (lastPrefsValid_)
+      updateOrRemoveVelocityVector_(lastPrefs_.commonprefs().datadraw() && lastPrefs_.commonprefs().draw(), lastPrefs_);
+  }
+}
+
 void PlatformNode::updateOrRemoveVelocityVector_(bool prefsDraw, const simData::PlatformPrefs& prefs)
 {
   // Update or remove velocity axis vectors
@@ -950,7 +1018,7 @@ void PlatformNode::updateOrRemoveVelocityVector_(bool prefsDraw, const simData::
       velocityAxisVector_->setPrefs(prefs.drawvelocityvec(), prefs, PB_FIELD_CHANGED(&lastPrefs_, &prefs, drawvelocityvec));
     else
     {
-      velocityAxisVector_ = new VelocityVector(getLocator());
+      velocityAxisVector_ = new VelocityVector(getLocator(), 2.f, lineBatches_.get());
       addChild(velocityAxisVector_);
       // force rebuild
       velocityAxisVector_->update(lastUpdate_);
@@ -23,12 +23,15 @@
 #ifndef SIMVIS_PLATFORM_NODE_H
 #define SIMVIS_PLATFORM_NODE_H
 
+#include "osg/observer_ptr"
 #include "osg/ref_ptr"
 #include "simCore/Calc/CoordinateSystem.h"
 #include "simCore/EM/RadarCrossSection.h"
 #include "simData/DataTypes.h"
 #include "simVis/Constants.h"
 #include "simVis/Entity.h"
+#include "simVis/LabelContentCache.h"
+#include "simVis/PlatformFilter.h"
 
 namespace simData { class DataStore; }
 
@@ -38,10 +41,10 @@ namespace simVis
 class AxisVector;
 class CompositeHighlightNode;
 class EphemerisVector;
+class LineBatchGroup;
 class LocalGridNode;
 class PlatformInertialTransform;
 class PlatformModelNode;
-class PlatformTspiFilterManager;
 class ProjectorNode;
 class RadialLOSNode;
 class TimeTicks;
@@ -137,6 +140,12 @@ public:
   /// Set the creator for the LOS nodes
   void setLosCreator(LosCreator* losCreator);
 
+  /**
+  * Sets the shared line batches used for simple line graphics such as the velocity vector.
+  * Pass nullptr to draw them with per-platform geometry instead.
+  */
+  void setLineBatchGroup(LineBatchGroup* lineBatches);
+
 public: // EntityNode interface
 
   /**
@@ -178,6 +187,23 @@ public: // EntityNode interface
   */
   virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force = false);
 
+  /**
+  * Stages the platform's current point for filtering together with other platforms in
+  * PlatformTspiFilterManager::filterBatch().  Pass the filtered entry to setBatchFilterResult()
+  * before calling updateFromDataStore() with the same arguments.
+  * @param updateSlice  Data store update slice
+  * @param force  Same value that will be passed to updateFromDataStore()
+  * @param entry  Receives the point to filter
+  * @return true if the entry was filled in, false if the next update will not filter a point
+  */
+  bool prepareBatchFilter(const simData::DataSliceBase* updateSlice, bool force, PlatformTspiFilterManager::BatchEntry& entry) const;
+
+  /**
+  * Supplies the result of batch filtering the point from prepareBatchFilter().  The next
+  * updateFromDataStore() applies it instead of filtering the point again.
+  */
+  void setBatchFilterResult(const PlatformTspiFilterManager::BatchEntry& entry);
+
   /**
   * Notifies the platform of a clock mode update.
   * override from EntityNode.
@@ -334,6 +360,8 @@ private:
   osg::ref_ptr<PlatformInertialTransform> scaledInertialTransform_;
   osg::ref_ptr<PlatformInertialTransform> fixedScaledInertialTransform_;
   osg::ref_ptr<VelocityVector>    velocityAxisVector_;
+  /// shared line batches for the velocity vector, if batching is enabled
+  osg::observer_ptr<LineBatchGroup> lineBatches_;
   osg::ref_ptr<EphemerisVector>   ephemerisVector_;
   osg::ref_ptr<PlatformModelNode> model_;
   LosCreator*                     losCreator_; // Not owned
@@ -344,10 +372,25 @@ private:
   bool                            valid_;
   /// flag indicating that the lastPrefs_ field is valid
   bool                            lastPrefsValid_;
+  /// incremented each time lastPrefs_ changes; lets the TSPI filter manager cache prefs-based results
+  unsigned int                    prefsRevision_;
+  /// prefsRevision_ as of the last label update
+  unsigned int                    labelPrefsRevision_;
+  /// label content for the label, hover, hook and legend display fields
+  LabelContentCache               labelContent_;
+  mutable LabelContentCache       hoverContent_;
+  mutable LabelContentCache       hookContent_;
+  mutable LabelContentCache       legendContent_;
   /// force next update from data store to be processed, even if !slice->hasChanged()
   bool                            forceUpdateFromDataStore_;
   /// queue up the invalidate to apply on the next data store update
   bool                            queuedInvalidate_;
+  /// true if batchFilterUpdate_ holds a batch filter result for the next data store update
+  bool                            hasBatchFilterResult_;
+  /// current point as filtered by the scenario's batch filter
+  simData::PlatformUpdate         batchFilterUpdate_;
+  /// response of the batch filter for batchFilterUpdate_
+  PlatformTspiFilterManager::FilterResponse batchFilterResponse_;
 };
 
 } // namespace simVis
@@ -123,7 +123,38 @@ public:
 
 //-----------------------------------------------------------------------------------------------------------------------------
 
+namespace {
+
+/// Returns true if the two ECEF coordinates, as created by toCoordinate_(), hold the same state
+bool sameEcefState(const simCore::Coordinate& a, const simCore::Coordinate& b)
+{
+  return (a.position() == b.position()) &&
+    (a.hasOrientation() == b.hasOrientation()) && (!a.hasOrientation() || a.orientation() == b.orientation()) &&
+    (a.hasVelocity() == b.hasVelocity()) && (!a.hasVelocity() || a.velocity() == b.velocity());
+}
+
+}
+
+PlatformTspiFilterManager::BatchEntry::BatchEntry()
+  : prefs(nullptr),
+    props(nullptr),
+    prefsRevision(0),
+    response(PlatformTspiFilterManager::POINT_UNCHANGED)
+{
+}
+
+PlatformTspiFilterManager::PlatformCache::PlatformCache()
+  : hasApplicability(false),
+    prefsRevision(0),
+    filtersRevision(0),
+    applicable(false),
+    hasConversion(false)
+{
+}
+
 PlatformTspiFilterManager::PlatformTspiFilterManager()
+  : filtersRevision_(0),
+    numConversions_(0)
 {
   // Order matters; the last filter to modify wins
   platformFilters_.push_back(new AltitudeMinMaxClamping());
@@ -144,7 +175,10 @@ void PlatformTspiFilterManager::addFilter(PlatformTspiFilter* filter)
   assert(it == platformFilters_.end());
 
   if (it == platformFilters_.end())
+  {
     platformFilters_.push_back(filter);
+    invalidateApplicability();
+  }
 }
 
 void PlatformTspiFilterManager::removeFilter(PlatformTspiFilter* filter)
@@ -155,28 +189,104 @@ void PlatformTspiFilterManager::removeFilter(PlatformTspiFilter* filter)
   assert(it != platformFilters_.end());
 
   if (it != platformFilters_.end())
+  {
     platformFilters_.erase(it);
+    invalidateApplicability();
+  }
 }
 
 PlatformTspiFilterManager::FilterResponse PlatformTspiFilterManager::filter(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props)
 {
   // See if a filter possibly applies before converting from ECEF to LLA
-  std::vector<PlatformTspiFilter*> possibleFilters;
-  for (std::vector<PlatformTspiFilter*>::const_iterator it = platformFilters_.begin(); it != platformFilters_.end(); ++it)
+  if (!isApplicable_(prefs))
+    return PlatformTspiFilterManager::POINT_UNCHANGED;
+  // Historical points must not replace the conversion of the platform's current point
+  std::map<simData::ObjectId, PlatformCache>::iterator it = cache_.find(props.id());
+  return filter_(update, prefs, props, (it == cache_.end() ? nullptr : &it->second), false);
+}
+
+PlatformTspiFilterManager::FilterResponse PlatformTspiFilterManager::filter(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, unsigned int prefsRevision)
+{
+  PlatformCache& cache = cache_[props.id()];
+  if (!cache.hasApplicability || cache.prefsRevision != prefsRevision || cache.filtersRevision != filtersRevision_)
   {
-    if ((*it)->isApplicable(prefs))
-      possibleFilters.push_back(*it);
+    cache.applicable = isApplicable_(prefs);
+    cache.prefsRevision = prefsRevision;
+    cache.filtersRevision = filtersRevision_;
+    cache.hasApplicability = true;
   }
 
   // No filter wants to look at the data
-  if (possibleFilters.empty())
-  {
+  if (!cache.applicable)
     return PlatformTspiFilterManager::POINT_UNCHANGED;
+  return filter_(update, prefs, props, &cache, true);
+}
+
+void PlatformTspiFilterManager::filterBatch(std::vector<BatchEntry>& entries)
+{
+  for (std::vector<BatchEntry>::iterator it = entries.begin(); it != entries.end(); ++it)
+    it->response = filter(it->update, *it->prefs, *it->props, it->prefsRevision);
+}
+
+bool PlatformTspiFilterManager::lastGeodetic(simData::ObjectId id, const simCore::Vec3& ecefPos, simCore::Vec3& llaPos) const
+{
+  std::map<simData::ObjectId, PlatformCache>::const_iterator it = cache_.find(id);
+  if (it == cache_.end() || !it->second.hasConversion)
+    return false;
+  if (ecefPos == it->second.filteredEcefPos)
+    llaPos = it->second.filteredLlaPos;
+  else if (ecefPos == it->second.ecefCoord.position())
+    llaPos = it->second.llaCoord.position();
+  else
+    return false;
+  return true;
+}
+
+void PlatformTspiFilterManager::invalidateApplicability()
+{
+  ++filtersRevision_;
+}
+
+void PlatformTspiFilterManager::removeEntity(simData::ObjectId id)
+{
+  cache_.erase(id);
+}
+
+unsigned int PlatformTspiFilterManager::numConversions() const
+{
+  return numConversions_;
+}
+
+bool PlatformTspiFilterManager::isApplicable_(const simData::PlatformPrefs& prefs) const
+{
+  for (std::vector<PlatformTspiFilter*>::const_iterator it = platformFilters_.begin(); it != platformFilters_.end(); ++it)
+  {
+    if ((*it)->isApplicable(prefs))
+      return true;
   }
+  return false;
+}
 
+PlatformTspiFilterManager::FilterResponse PlatformTspiFilterManager::filter_(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformCache* cache, bool storeConversion)
+{
   simCore::Coordinate ecefCoord(toCoordinate_(update));
   simCore::Coordinate llaCoord;
-  simCore::CoordinateConverter::convertEcefToGeodetic(ecefCoord, llaCoord);
+  // Reuse the previous conversion if the state has not changed, e.g. the track filtering the platform's current point
+  if (cache != nullptr && cache->hasConversion && sameEcefState(cache->ecefCoord, ecefCoord))
+    llaCoord = cache->llaCoord;
+  else
+  {
+    simCore::CoordinateConverter::convertEcefToGeodetic(ecefCoord, llaCoord);
+    ++numConversions_;
+    if (cache != nullptr && storeConversion)
+    {
+      cache->ecefCoord = ecefCoord;
+      cache->llaCoord = llaCoord;
+      cache->filteredEcefPos = ecefCoord.position();
+      cache->filteredLlaPos = llaCoord.position();
+      cache->hasConversion = true;
+    }
+  }
 
   PlatformTspiFilterManager::FilterResponse modified = PlatformTspiFilterManager::POINT_UNCHANGED;
   for (std::vector<PlatformTspiFilter*>::const_iterator it = platformFilters_.begin(); it != platformFilters_.end(); ++it)
@@ -193,6 +303,12 @@ PlatformTspiFilterManager::FilterResponse PlatformTspiFilterManager::filter(simD
   {
     simCore::CoordinateConverter::convertGeodeticToEcef(llaCoord, ecefCoord);
     toPlatformUpdate_(ecefCoord, update);
+    // Consumers of the filtered point can share the conversion as well
+    if (cache != nullptr && storeConversion)
+    {
+      cache->filteredEcefPos = ecefCoord.position();
+      cache->filteredLlaPos = llaCoord.position();
+    }
   }
 
   return modified;
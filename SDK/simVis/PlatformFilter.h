@@ -24,6 +24,10 @@
 #ifndef SIMVIS_MEMORYDATASTORE_PLATFORMFILTER_H
 #define SIMVIS_MEMORYDATASTORE_PLATFORMFILTER_H
 
+#include <map>
+#include <vector>
+#include "simCore/Calc/Coordinate.h"
+#include "simCore/Common/Export.h"
 #include "simData/DataTypes.h"
 #include "simData/ObjectId.h"
 
@@ -40,7 +44,7 @@ class PlatformTspiFilter;
  *
  * Filters are used to implement features like Altitude Clamping.  See AltitudeMinMaxClamping as an example.
  */
-class PlatformTspiFilterManager
+class SDKVIS_EXPORT PlatformTspiFilterManager
 {
 public:
   /** Defines various responses to the filter() virtual method */
@@ -61,10 +65,94 @@ public:
   /// Removes a filter; the caller takes ownership of the memory
   void removeFilter(PlatformTspiFilter* filter);
 
-  /// Filters the given platform state
+  /**
+   * Filters the given platform state, such as a historical point for track history.  Reuses the conversion
+   * cached for the platform's current point if the state matches, but does not replace it.
+   */
   virtual FilterResponse filter(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props);
 
+  /**
+   * Filters the platform's current state, caching whether any filter applies to the platform until
+   * prefsRevision changes, and caching the ECEF to LLA conversion for other consumers of the same point.
+   * Callers must change prefsRevision whenever the prefs change.
+   */
+  FilterResponse filter(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, unsigned int prefsRevision);
+
+  /// One platform's current state to filter in filterBatch()
+  struct BatchEntry
+  {
+    BatchEntry();
+
+    simData::PlatformUpdate update;  ///< State to filter; modified in place
+    const simData::PlatformPrefs* prefs;  ///< Prefs of the platform
+    const simData::PlatformProperties* props;  ///< Properties of the platform
+    unsigned int prefsRevision;  ///< Changes whenever prefs change; used to cache applicability
+    FilterResponse response;  ///< Result of filtering, set by filterBatch()
+  };
+
+  /**
+   * Filters the current states of all the given platforms in one pass, setting each entry's response, as the
+   * prefs revision overload of filter() does for one platform.  The entries are owned by the caller and can be
+   * reused across frames; no allocation is performed beyond the first filter of a platform.
+   */
+  void filterBatch(std::vector<BatchEntry>& entries);
+
+  /**
+   * Retrieves the LLA position converted during the most recent filter of the platform's current state, allowing
+   * other consumers of the same point to share the ECEF to LLA conversion.  Matches the position either before or
+   * after filtering, and only holds a conversion if a filter applies to the platform.
+   * @param id Platform ID
+   * @param ecefPos ECEF position to find a conversion for
+   * @param llaPos Receives the LLA position on success
+   * @return true if a matching conversion was found
+   */
+  bool lastGeodetic(simData::ObjectId id, const simCore::Vec3& ecefPos, simCore::Vec3& llaPos) const;
+
+  /// Invalidates cached applicability; call when a filter's applicability changes for reasons other than prefs (e.g. new map)
+  void invalidateApplicability();
+
+  /// Removes cached data for the given platform
+  void removeEntity(simData::ObjectId id);
+
+  /// Number of ECEF to LLA conversions performed, not counting ones shared through the cache; for testing
+  unsigned int numConversions() const;
+
 private:
+  /// Cached per-platform state that avoids repeating work across calls
+  struct PlatformCache
+  {
+    PlatformCache();
+
+    /// True if applicable is valid for the given revisions
+    bool hasApplicability;
+    /// Prefs revision for which applicable was computed
+    unsigned int prefsRevision;
+    /// Manager revision for which applicable was computed
+    unsigned int filtersRevision;
+    /// True if any filter is applicable to the platform
+    bool applicable;
+
+    /// True if ecefCoord and llaCoord hold a conversion
+    bool hasConversion;
+    /// ECEF input of the most recent conversion
+    simCore::Coordinate ecefCoord;
+    /// LLA output of the most recent conversion
+    simCore::Coordinate llaCoord;
+    /// ECEF position after filtering the most recent conversion; same as ecefCoord if no filter changed it
+    simCore::Vec3 filteredEcefPos;
+    /// LLA position after filtering the most recent conversion
+    simCore::Vec3 filteredLlaPos;
+  };
+
+  /// Returns true if any filter might modify the TSPI data of a platform with the given prefs
+  bool isApplicable_(const simData::PlatformPrefs& prefs) const;
+
+  /**
+   * Implementation of filtering; reuses the conversion in cache if the state matches, and stores a new
+   * conversion in it if storeConversion is true.  If cache is nullptr, no cached state is used.
+   */
+  FilterResponse filter_(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformCache* cache, bool storeConversion);
+
   /// Returns simCore::Coordinate based off of update
   simCore::Coordinate toCoordinate_(const simData::PlatformUpdate& update) const;
 
@@ -73,6 +161,12 @@ private:
 
   /// Filters that are allowed to modified the platform state
   std::vector<PlatformTspiFilter*> platformFilters_;
+  /// Cached state per platform
+  std::map<simData::ObjectId, PlatformCache> cache_;
+  /// Incremented whenever applicability of the filters changes independently of prefs
+  unsigned int filtersRevision_;
+  /// Number of ECEF to LLA conversions performed
+  unsigned int numConversions_;
 };
 
 
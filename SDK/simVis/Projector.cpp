@@ -310,6 +310,12 @@ ProjectorNode::ProjectorNode(const simData::ProjectorProperties& props, simVis::
   hostLocator_(hostLocator),
   hasLastUpdate_(false),
   hasLastPrefs_(false),
+  projectionRevision_(1),
+  syncedProjectionRevision_(0),
+  syncedImageS_(0),
+  syncedImageT_(0),
+  syncedImageOrigin_(0),
+  numProjectionUpdates_(0),
   projectorTextureImpl_(new ProjectorTextureImpl()),
   graphics_(nullptr),
   stateDirty_(false)
@@ -612,11 +618,13 @@ void ProjectorNode::setPrefs(const simData::ProjectorPrefs& prefs)
 
   updateOverrideColor_(prefs);
 
-  // If override FOV changes, update the FOV with a sync-with-locator call
+  // If override FOV or far plane changes, update the projection with a sync-with-locator call
   bool syncAfterPrefsUpdate = false;
   if (!hasLastPrefs_ || PB_FIELD_CHANGED(&lastPrefs_, &prefs, overridefov) ||
-    PB_FIELD_CHANGED(&lastPrefs_, &prefs, overridefovangle))
+    PB_FIELD_CHANGED(&lastPrefs_, &prefs, overridefovangle) ||
+    PB_FIELD_CHANGED(&lastPrefs_, &prefs, maxdrawrange))
   {
+    dirtyProjection_();
     syncAfterPrefsUpdate = true;
   }
 
@@ -737,6 +745,7 @@ void ProjectorNode::setImage(osg::Image* image)
   imageProvider_ = nullptr;
   texture_->setImage(image);
   simVis::fixTextureForGlCoreProfile(texture_.get());
+  dirtyProjection_();
 }
 
 const osg::Matrixd& ProjectorNode::getTexGenMatrix() const
@@ -792,6 +801,21 @@ void ProjectorNode::getMatrices_(osg::Matrixd& projection, osg::Matrixd& locator
   modelView.invert(locatorMat);
 }
 
+unsigned int ProjectorNode::numProjectionUpdates() const
+{
+  return numProjectionUpdates_;
+}
+
+const osg::BoundingSphere& ProjectorNode::getProjectionBound() const
+{
+  return projectionBound_;
+}
+
+void ProjectorNode::dirtyProjection_()
+{
+  ++projectionRevision_;
+}
+
 void ProjectorNode::syncWithLocator()
 {
   if (!isActive())
@@ -799,6 +823,29 @@ void ProjectorNode::syncWithLocator()
   if (!hostLocator_.valid())
     assert(0);
 
+  // skip the recompute if nothing feeding the projection has changed; the host locator notifies
+  // for every move, and data store updates arrive every time step even when the FOV is constant
+  const osg::Image* image = texture_->getImage();
+  if (hostLocator_->inSyncWith(hostLocatorRevision_) &&
+    syncedProjectionRevision_ == projectionRevision_ &&
+    image->s() == syncedImageS_ && image->t() == syncedImageT_ &&
+    static_cast<int>(image->getOrigin()) == syncedImageOrigin_)
+  {
+    return;
+  }
+  recomputeProjection_();
+}
+
+void ProjectorNode::recomputeProjection_()
+{
+  ++numProjectionUpdates_;
+  hostLocator_->sync(hostLocatorRevision_);
+  syncedProjectionRevision_ = projectionRevision_;
+  const osg::Image* image = texture_->getImage();
+  syncedImageS_ = image->s();
+  syncedImageT_ = image->t();
+  syncedImageOrigin_ = static_cast<int>(image->getOrigin());
+
   // establish the view matrix:
   osg::Matrixd locatorMat;
   hostLocator_->getLocatorMatrix(locatorMat);
@@ -817,6 +864,14 @@ void ProjectorNode::syncWithLocator()
   // we create a view matrix that rotates the view to point along the +Y axis.
   const osg::Matrix& rotateUp90Mat = osg::Matrix::rotate(-osg::PI_2, osg::Vec3d(1.0, 0.0, 0.0));
   viewMat_ = viewMat_temp * rotateUp90Mat;
+  inverseViewMat_.invert(viewMat_);
+
+  // bound the frustum in world space by its far corners and apex, for culling against views
+  const osg::Matrixd clipToWorld = osg::Matrixd::inverse(viewMat_ * projectionMat);
+  projectionBound_.init();
+  projectionBound_.expandBy(inverseViewMat_.getTrans());
+  for (int corner = 0; corner < 4; ++corner)
+    projectionBound_.expandBy(osg::Vec3d((corner & 1) ? 1.0 : -1.0, (corner & 2) ? 1.0 : -1.0, 1.0) * clipToWorld);
 
   // flip the image if it's upside down
   const double flip = texture_->getImage()->getOrigin() == osg::Image::TOP_LEFT ? -1.0 : 1.0;
@@ -938,6 +993,10 @@ bool ProjectorNode::updateFromDataStore(const simData::DataSliceBase* updateSlic
     // do not apply update if host is not active
     if (current && (force || host_->isActive()))
     {
+      // the FOV is the only update value that feeds the projection
+      if (!hasLastUpdate_ || current->has_fov() != lastUpdate_.has_fov() || current->fov() != lastUpdate_.fov())
+        dirtyProjection_();
+
       // Make sure to set projector to active if draw preferences are on.
       if (lastPrefs_.commonprefs().datadraw() && lastPrefs_.commonprefs().draw())
       {
@@ -976,6 +1035,7 @@ void ProjectorNode::flush()
   projectorActive_->set(false);
   setNodeMask(DISPLAY_MASK_NONE);
   hasLastUpdate_ = false;
+  dirtyProjection_();
 }
 
 double ProjectorNode::range() const
@@ -1011,7 +1071,7 @@ void ProjectorNode::traverse(osg::NodeVisitor& nv)
     if (cv)
     {
       shadowToPrimaryMatrix_->set(
-        osg::Matrixd::inverse(viewMat_) *
+        inverseViewMat_ *
         *cv->getModelViewMatrix());
     }
   }
@@ -1044,6 +1104,7 @@ unsigned int ProjectorNode::objectIndexTag() const
 void ProjectorNode::setCalculator(std::shared_ptr<osgEarth::Util::EllipsoidIntersector> calculator)
 {
   calculator_ = calculator;
+  dirtyProjection_();
 }
 
 int ProjectorNode::addProjectionToNode(osg::Node* entity, osg::Node* attachmentPoint)
@@ -28,6 +28,7 @@
 #include "simVis/Entity.h"
 
 #include "osgEarth/MapNodeObserver"
+#include "osgEarth/Revisioning"
 
 namespace osg { class Texture2D; }
 
@@ -165,10 +166,20 @@ public:
 
   /**
   * Updates the projection uniforms. This called automatically when the locator moves; you
-  * do not need to call it directly.
+  * do not need to call it directly.  Does nothing if neither the host locator nor any input to
+  * the projection (prefs, FOV, image) changed since the last update.
   */
   void syncWithLocator();
 
+  /** Number of times the projection matrices have been recomputed; for testing */
+  unsigned int numProjectionUpdates() const;
+
+  /**
+  * World-space bounding sphere of the projection frustum, from the projector out to the far plane.
+  * Invalid until the projection has been computed.
+  */
+  const osg::BoundingSphere& getProjectionBound() const;
+
   /** Traverse the node during visitor pattern */
   virtual void traverse(osg::NodeVisitor& nv) override;
 
@@ -264,6 +275,11 @@ private:
 
   void init_();
 
+  /// Recomputes the projection matrices, uniforms and frustum from the current host position and inputs
+  void recomputeProjection_();
+  /// Marks the inputs to the projection as changed so that the next syncWithLocator() recomputes
+  void dirtyProjection_();
+
   /// Read video file
   bool readVideoFile_(const std::string& filename);
   /// Read raster file
@@ -295,6 +311,21 @@ private:
   osg::ref_ptr<osg::Camera> shadowCam_;
   osg::ref_ptr<osg::Uniform> shadowToPrimaryMatrix_;
   osg::Matrixd viewMat_;
+  osg::Matrixd inverseViewMat_;
+  osg::BoundingSphere projectionBound_;
+
+  /// Host locator revision at the last recompute
+  osgEarth::Util::Revision hostLocatorRevision_;
+  /// Incremented when a non-locator input to the projection changes
+  unsigned int projectionRevision_;
+  /// Value of projectionRevision_ at the last recompute
+  unsigned int syncedProjectionRevision_;
+  /// Image dimensions and origin at the last recompute, since video frames can change them
+  int syncedImageS_;
+  int syncedImageT_;
+  int syncedImageOrigin_;
+  /// Number of recomputes performed
+  unsigned int numProjectionUpdates_;
 
   // Projector video interface for transferring video image.
   osg::ref_ptr<ProjectorTextureImpl> projectorTextureImpl_;
@@ -22,6 +22,7 @@
  */
 #include "osg/Depth"
 #include "osg/BlendFunc"
+#include "osg/Polytope"
 #include "osgUtil/CullVisitor"
 #include "osgEarth/StringUtils"
 #include "osgEarth/TerrainEngineNode"
@@ -70,7 +71,9 @@ simData::ObjectId ProjectorManager::ProjectorLayer::id() const
 class UpdateProjMatrix : public osgEarth::Layer::TraversalCallback
 {
 public:
-  explicit UpdateProjMatrix(ProjectorNode* node) : proj_(node)
+  UpdateProjMatrix(ProjectorNode* node, std::shared_ptr<std::atomic<unsigned int> > culledCount)
+    : proj_(node),
+      culledCount_(culledCount)
   {
     //nop
   }
@@ -81,8 +84,17 @@ public:
     if (!proj_.lock(proj) || !proj.valid())
       return;
     osgUtil::CullVisitor* cv = dynamic_cast<osgUtil::CullVisitor*>(nv);
+    const osg::Camera* camera = cv->getCurrentCamera();
+
+    // skip the projection layer entirely if the projector is off or its frustum is outside this view
+    if (!proj->isVisible() || isOutsideView_(*camera, proj->getProjectionBound()))
+    {
+      ++(*culledCount_);
+      return;
+    }
+
     osg::ref_ptr<osg::StateSet> ss = new osg::StateSet();
-    const osg::Matrixd view_to_world = cv->getCurrentCamera()->getInverseViewMatrix();
+    const osg::Matrixd view_to_world = camera->getInverseViewMatrix();
     const osg::Matrixf texgen = view_to_world * proj->getTexGenMatrix();
     ss->addUniform(new osg::Uniform("simProjTexGenMat", texgen));
     const osg::Matrixf shadow = view_to_world * proj->getShadowMapMatrix();
@@ -93,7 +105,20 @@ public:
   }
 
 private:
+  /** Returns true if the world-space bound is entirely outside the side planes of the camera's frustum */
+  static bool isOutsideView_(const osg::Camera& camera, const osg::BoundingSphere& bound)
+  {
+    if (!bound.valid())
+      return false;
+    // near and far are ignored, since the projection matrix may not have computed near/far yet
+    osg::Polytope frustum;
+    frustum.setToUnitFrustum(false, false);
+    frustum.transformProvidingInverse(camera.getViewMatrix() * camera.getProjectionMatrix());
+    return !frustum.contains(bound);
+  }
+
   osg::observer_ptr<ProjectorNode> proj_;
+  std::shared_ptr<std::atomic<unsigned int> > culledCount_;
 };
 
 //-------------------------------------------------------------------------
@@ -120,7 +145,10 @@ private:
 //-------------------------------------------------------------------------
 
 ProjectorManager::ProjectorManager()
-  : needReorderProjectorLayers_(false)
+  : needReorderProjectorLayers_(false),
+    numProjectionUpdatesLastFrame_(0),
+    culledCount_(std::make_shared<std::atomic<unsigned int> >(0)),
+    numCulledLastFrame_(0)
 {
   setCullingActive(false);
   mapListener_ = new MapListener(*this);
@@ -214,7 +242,7 @@ void ProjectorManager::registerProjector(ProjectorNode* proj)
 
   ProjectorLayer* layer = new ProjectorLayer(proj->getId());
   layer->setName("SIMSDK Projector");
-  layer->setCullCallback(new UpdateProjMatrix(proj));
+  layer->setCullCallback(new UpdateProjMatrix(proj, culledCount_));
   projectorLayers_[proj->getId()] = layer;
   mapNode_->getMap()->addLayer(layer);
 
@@ -270,6 +298,7 @@ void ProjectorManager::unregisterProjector(const ProjectorNode* proj)
 
   // Remove projector node form the local collection as well
   projectors_.erase(std::remove(projectors_.begin(), projectors_.end(), proj), projectors_.end());
+  projectionUpdateCounts_.erase(proj);
 }
 
 void ProjectorManager::clear()
@@ -286,6 +315,7 @@ void ProjectorManager::clear()
   projectorLayers_.clear();
 
   projectors_.clear();
+  projectionUpdateCounts_.clear();
 }
 
 void ProjectorManager::traverse(osg::NodeVisitor& nv)
@@ -295,6 +325,16 @@ void ProjectorManager::traverse(osg::NodeVisitor& nv)
     if (needReorderProjectorLayers_)
       reorderProjectorLayers_();
 
+    // collect the per-frame statistics
+    numCulledLastFrame_ = culledCount_->exchange(0);
+    numProjectionUpdatesLastFrame_ = 0;
+    for (const auto& projector : projectors_)
+    {
+      unsigned int& lastCount = projectionUpdateCounts_[projector.get()];
+      numProjectionUpdatesLastFrame_ += projector->numProjectionUpdates() - lastCount;
+      lastCount = projector->numProjectionUpdates();
+    }
+
     for (auto& projector : projectors_)
     {
       if (projector->isStateDirty_())
@@ -312,6 +352,16 @@ void ProjectorManager::traverse(osg::NodeVisitor& nv)
   osg::Group::traverse(nv);
 }
 
+unsigned int ProjectorManager::numProjectionUpdatesLastFrame() const
+{
+  return numProjectionUpdatesLastFrame_;
+}
+
+unsigned int ProjectorManager::numCulledLastFrame() const
+{
+  return numCulledLastFrame_;
+}
+
 void ProjectorManager::reorderProjectorLayers_()
 {
   needReorderProjectorLayers_ = false;
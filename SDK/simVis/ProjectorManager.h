@@ -23,6 +23,8 @@
 #ifndef SIMVIS_PROJECTOR_MANAGER_H
 #define SIMVIS_PROJECTOR_MANAGER_H
 
+#include <atomic>
+#include <memory>
 #include "osgEarth/MapNode"
 #include "osgEarth/MapNodeObserver"
 #include "simVis/Projector.h"
@@ -69,6 +71,12 @@ public:
   /// Set the base (starting) texture image unit for projector textures.
   static void setBaseTextureImageUnit(int unit);
 
+  /** Number of projection matrix recomputes across all projectors between the last two update traversals; for testing */
+  unsigned int numProjectionUpdatesLastFrame() const;
+
+  /** Number of projector layer traversals skipped by culling between the last two update traversals; for testing */
+  unsigned int numCulledLastFrame() const;
+
 public: // MapNodeObserver
 
   /** Gets the map node */
@@ -133,6 +141,15 @@ private:
   /// A flag to mark when projector layers need to be moved to ensure visibility
   bool needReorderProjectorLayers_;
 
+  /// Number of projection updates per projector, as of the last update traversal
+  std::map<const ProjectorNode*, unsigned int> projectionUpdateCounts_;
+  /// Projection updates seen in the last update traversal
+  unsigned int numProjectionUpdatesLastFrame_;
+  /// Culled layer traversals, shared with the layer cull callbacks which may run on cull threads
+  std::shared_ptr<std::atomic<unsigned int> > culledCount_;
+  /// Culled layer traversals counted in the last update traversal
+  unsigned int numCulledLastFrame_;
+
   /// Base (starting) texture image unit for projector textures
   static int baseTextureImageUnit_;
 };
@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <limits>
 #include "simNotify/Notify.h"
 #include "simVis/RFProp/CompositeProfileProvider.h"
@@ -179,6 +180,14 @@ double CompositeProfileProvider::getValueByIndex(unsigned int heightIndex, unsig
   return getActiveProvider() ? getActiveProvider()->getValueByIndex(heightIndex, rangeIndex) : 0;
 }
 
+void CompositeProfileProvider::getValuesByIndex(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const
+{
+  if (getActiveProvider())
+    getActiveProvider()->getValuesByIndex(rangeIndex, firstHeightIndex, count, values);
+  else
+    std::fill(values, values + count, 0.0);
+}
+
 double CompositeProfileProvider::interpolateValue(double height, double range) const
 {
   return getActiveProvider() ? getActiveProvider()->interpolateValue(height, range) : 0;
@@ -100,6 +100,7 @@ public:
   virtual double getMaxHeight() const;
   virtual double getHeightStep() const;
   virtual double getValueByIndex(unsigned int heightIndex, unsigned int rangeIndex) const;
+  virtual void getValuesByIndex(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const;
   ///@}
 
   /**
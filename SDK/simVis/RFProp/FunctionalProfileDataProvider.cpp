@@ -81,6 +81,11 @@ double FunctionalProfileDataProvider::templateGetValueByIndex_(unsigned int heig
   return templateProvider_->getValueByIndex(heightIndex, rangeIndex);
 }
 
+void FunctionalProfileDataProvider::templateGetValuesByIndex_(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const
+{
+  templateProvider_->getValuesByIndex(rangeIndex, firstHeightIndex, count, values);
+}
+
 double FunctionalProfileDataProvider::templateInterpolateValue_(double height, double range) const
 {
   return templateProvider_->interpolateValue(height, range);
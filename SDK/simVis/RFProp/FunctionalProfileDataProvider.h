@@ -83,6 +83,15 @@ protected:
   */
   double templateGetValueByIndex_(unsigned int heightIndex, unsigned int rangeIndex) const;
 
+  /**
+  * Gets a column of values on this profile from the templateProvider_
+  * @param rangeIndex The range index of the desired samples
+  * @param firstHeightIndex The height index of the first sample
+  * @param count Number of samples
+  * @param values Output array of count values
+  */
+  void templateGetValuesByIndex_(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const;
+
   /**
   * Gets the value on this profile from the templateProvider_
   * @param height The height of the desired sample, in meters
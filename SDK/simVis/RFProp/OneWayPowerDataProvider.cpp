@@ -20,7 +20,9 @@
  * disclose, or release this software.
  *
  */
+#include <vector>
 #include "simCore/EM/Decibel.h"
+#include "simCore/EM/Propagation.h"
 #include "simVis/RFProp/OneWayPowerDataProvider.h"
 
 namespace simRF
@@ -39,6 +41,24 @@ double OneWayPowerDataProvider::getValueByIndex(unsigned int heightIndex, unsign
     simCore::SMALL_DB_VAL : OneWayPowerDataProvider::getOneWayPower(*radarParameters_, ppfdB, FunctionalProfileDataProvider::getRange_(rangeIndex), radarParameters_->antennaGaindBi, radarParameters_->antennaGaindBi);
 }
 
+void OneWayPowerDataProvider::getValuesByIndex(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const
+{
+  if (count == 0)
+    return;
+  std::vector<double> ppfdB(count);
+  FunctionalProfileDataProvider::templateGetValuesByIndex_(rangeIndex, firstHeightIndex, count, ppfdB.data());
+  const std::vector<double> ranges(count, FunctionalProfileDataProvider::getRange_(rangeIndex));
+  // The same antenna gain applies on transmit and receive at every point; fold it into the system loss
+  const simCore::RadarParameters& radar = *radarParameters_;
+  simCore::getRcvdPowerBlake(count, ranges.data(), ppfdB.data(), nullptr, nullptr, radar.freqMHz, radar.xmtPowerW, 0.0,
+    radar.systemLossdB - 2 * radar.antennaGaindBi, true, values);
+  for (unsigned int k = 0; k < count; ++k)
+  {
+    if (ppfdB[k] <= simCore::SMALL_DB_VAL)
+      values[k] = simCore::SMALL_DB_VAL;
+  }
+}
+
 double OneWayPowerDataProvider::interpolateValue(double height, double range) const
 {
   double ppfdB = FunctionalProfileDataProvider::templateInterpolateValue_(height, range);
@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <vector>
 #include "simCore/Calc/Math.h"
 #include "simCore/EM/Decibel.h"
 #include "simCore/EM/Propagation.h"
@@ -40,6 +41,24 @@ double PPFDataProvider::getValueByIndex(unsigned int heightIndex, unsigned int r
   return getPPF_(lossdB, FunctionalProfileDataProvider::getHeight_(heightIndex), FunctionalProfileDataProvider::getRange_(rangeIndex));
 }
 
+void PPFDataProvider::getValuesByIndex(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const
+{
+  if (count == 0)
+    return;
+  std::vector<double> lossdB(count);
+  FunctionalProfileDataProvider::templateGetValuesByIndex_(rangeIndex, firstHeightIndex, count, lossdB.data());
+  const double range = FunctionalProfileDataProvider::getRange_(rangeIndex);
+  std::vector<double> slantRangeM(count);
+  for (unsigned int k = 0; k < count; ++k)
+    slantRangeM[k] = sqrt(simCore::square(range) + simCore::square(FunctionalProfileDataProvider::getHeight_(firstHeightIndex + k)));
+  simCore::lossToPpf(count, slantRangeM.data(), lossdB.data(), radarParameters_->freqMHz, values);
+  for (unsigned int k = 0; k < count; ++k)
+  {
+    if (values[k] == simCore::SMALL_DB_VAL)
+      values[k] = simRF::INVALID_VALUE;
+  }
+}
+
 double PPFDataProvider::interpolateValue(double height, double range) const
 {
   const double lossdB = FunctionalProfileDataProvider::templateInterpolateValue_(height, range);
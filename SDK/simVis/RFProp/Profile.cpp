@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <vector>
 #include "osg/MatrixTransform"
 #include "osg/Texture2D"
 #include "osgEarth/GLUtils"
@@ -375,16 +376,18 @@ void Profile::init2DVert_()
   verts_->reserve(numVerts + startIndex);
   values_->reserve(numVerts + startIndex);
 
+  std::vector<double> column(numHeights);
   for (unsigned int r = 0; r < numRanges; r++)
   {
     const double range = minRange + rangeStep * r;
+    data_->getValuesByIndex(r, 0, numHeights, column.data());
 
     for (unsigned int h = 0; h < numHeights; h++)
     {
       const double height = adjustHeight_(0., range, minHeight + heightStep * h);
       const osg::Vec3 v(0., range, height);
       verts_->push_back(v);
-      const float value = data_->getValueByIndex(h, r);
+      const float value = column[h];
       values_->push_back(value);
     }
   }
@@ -464,6 +467,7 @@ void Profile::init3D_()
   values_->reserve(numVerts);
 
   const unsigned int startIndex = verts_->size();
+  std::vector<double> column(heightIndexCount);
   for (unsigned int r = 0; r < numRanges; r++)
   {
     const double range = minRange + rangeStep * r;
@@ -471,6 +475,7 @@ void Profile::init3D_()
     const double y0 = range * sinTheta0_;
     const double x1 = range * cosTheta1_;
     const double y1 = range * sinTheta1_;
+    data_->getValuesByIndex(r, minHeightIndex, heightIndexCount, column.data());
 
     for (unsigned int h = minHeightIndex; h <= maxHeightIndex; h++)
     {
@@ -482,7 +487,7 @@ void Profile::init3D_()
       const osg::Vec3 v1(x1, y1, height);
       verts_->push_back(v0);
       verts_->push_back(v1);
-      const double value = data_->getValueByIndex(h, r);
+      const double value = column[h - minHeightIndex];
       values_->push_back(value);
       values_->push_back(value);
     }
@@ -849,13 +854,16 @@ void Profile::init3DPoints_()
   points->setDataVariance(osg::Object::DYNAMIC);
   points->reserve(numVerts);
 
+  const unsigned int heightIndexCount = maxHeightIndex - minHeightIndex + 1;
+  std::vector<double> column(heightIndexCount);
   for (unsigned int r = 0; r < numRanges; r++)
   {
     const double range = minRange + rangeStep * r;
+    data_->getValuesByIndex(r, minHeightIndex, heightIndexCount, column.data());
 
     for (unsigned int h = minHeightIndex; h <= maxHeightIndex; h++)
     {
-      const double value = data_->getValueByIndex(h, r);
+      const double value = column[h - minHeightIndex];
       // values <= GROUND_VALUE are sentinel values, not actual values.
       if (value <= GROUND_VALUE)
         continue;
@@ -888,13 +896,12 @@ osg::Image* Profile::createImage_()
   image->allocateImage(numRanges, numHeights, 1, GL_LUMINANCE, GL_FLOAT);
   image->setInternalTextureFormat(GL_LUMINANCE32F_ARB);
 
+  std::vector<double> column(numHeights);
   for (unsigned int r = 0; r < numRanges; r++)
   {
+    data_->getValuesByIndex(r, 0, numHeights, column.data());
     for (unsigned int h = 0; h < numHeights; h++)
-    {
-      const double value = data_->getValueByIndex(h, r);
-      *(float*)image->data(r, h) = (float)value;
-    }
+      *(float*)image->data(r, h) = (float)column[h];
   }
   return image;
 }
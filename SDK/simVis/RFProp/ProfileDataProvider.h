@@ -94,6 +94,20 @@ public:
    */
   virtual double getValueByIndex(unsigned int heightIndex, unsigned int rangeIndex) const = 0;
 
+  /**
+   * Gets the values on this Profile at consecutive height indices for one range index.  Equivalent to calling
+   * getValueByIndex() for each height; providers override it to compute a whole column at once.
+   * @param rangeIndex The range index of the desired samples
+   * @param firstHeightIndex The height index of the first sample
+   * @param count Number of samples
+   * @param values Output array of count values
+   */
+  virtual void getValuesByIndex(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const
+  {
+    for (unsigned int k = 0; k < count; ++k)
+      values[k] = getValueByIndex(firstHeightIndex + k, rangeIndex);
+  }
+
   /**
    * Interpolates the value on this Profile at the given height and range.
    * @param hgtMeters The height index of the desired sample, in meters
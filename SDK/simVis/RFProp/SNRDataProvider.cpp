@@ -22,6 +22,7 @@
  */
 #include <cassert>
 #include "simCore/EM/Decibel.h"
+#include "simCore/EM/Propagation.h"
 #include "simVis/RFProp/SNRDataProvider.h"
 
 namespace simRF
@@ -46,6 +47,12 @@ double SNRDataProvider::getValueByIndex(unsigned int heightIndex, unsigned int r
   return (rcvPowerdB <= simCore::SMALL_DB_VAL) ? simCore::SMALL_DB_VAL : (rcvPowerdB - radarParameters_->noisePowerdB);
 }
 
+void SNRDataProvider::getValuesByIndex(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const
+{
+  FunctionalProfileDataProvider::templateGetValuesByIndex_(rangeIndex, firstHeightIndex, count, values);
+  simCore::getSignalToNoise(count, values, radarParameters_->noisePowerdB, values);
+}
+
 double SNRDataProvider::interpolateValue(double height, double range) const
 {
   double rcvPowerdB = FunctionalProfileDataProvider::templateInterpolateValue_(height, range);
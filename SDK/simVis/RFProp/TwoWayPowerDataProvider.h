@@ -56,6 +56,9 @@ public:
   /** @copydoc simRF::ProfileDataProvider::getValueByIndex() */
   virtual double getValueByIndex(unsigned int heightIndex, unsigned int rangeIndex) const;
 
+  /** @copydoc simRF::ProfileDataProvider::getValuesByIndex() */
+  virtual void getValuesByIndex(unsigned int rangeIndex, unsigned int firstHeightIndex, unsigned int count, double* values) const;
+
   /** @copydoc simRF::ProfileDataProvider::interpolateValue() */
   virtual double interpolateValue(double hgtMeters, double gndRngMeters) const;
 
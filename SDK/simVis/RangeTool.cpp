@@ -458,24 +458,15 @@ void RangeTool::Association::refresh_(EntityNode* obj0, EntityNode* obj1, const
     return;
   }
 
-  // reset the coord_ cache
-  state_->resetCoordCache();
-
   // ignore the invalid timestamp sent by RangeTool::RefreshGroup::traverse, reuse whatever timestamp was last used
   if (timeStamp != simCore::INFINITE_TIME_STAMP)
     state_->timeStamp_ = timeStamp;
 
-  // initialize coordinate system and converter to optimize repeated conversions and support other values (flat projections)
-  state_->coordConv_.setReferenceOrigin(state_->beginEntity_->lla_);
-
   // ensure that xform is synced with its locator
   xform_->syncWithLocator();
 
-  // localizes all geometry to the reference point of obj0, preventing precision jitter
-  state_->local2world_ = xform_->getMatrix();
-
-  // invert to support ECEF->ENU conversions
-  state_->world2local_.invert(state_->local2world_);
+  // reset the coord_ cache and localize all geometry to the reference point of obj0
+  state_->setLocalFrame(xform_->getMatrix());
 
   state_->mapNode_ = scenario.mapNode();
 
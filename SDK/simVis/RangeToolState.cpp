@@ -316,6 +316,37 @@ void RangeToolState::resetCoordCache()
     coord_[i].clear();
 }
 
+void RangeToolState::setLocalFrame(const osg::Matrixd& local2world)
+{
+  resetCoordCache();
+
+  // initialize coordinate system and converter to optimize repeated conversions and support other values (flat projections)
+  coordConv_.setReferenceOrigin(beginEntity_->lla_);
+
+  // localizes all geometry to the reference point, preventing precision jitter
+  local2world_ = local2world;
+
+  // invert to support ECEF->ENU conversions
+  world2local_.invert(local2world_);
+}
+
+osg::Matrixd RangeToolState::tangentPlaneFrame(const simCore::Vec3& lla)
+{
+  simCore::Vec3 ecefPos;
+  simCore::CoordinateConverter::convertGeodeticPosToEcef(lla, ecefPos);
+  osg::Matrixd local2world;
+  local2world.makeTranslate(ecefPos.x(), ecefPos.y(), ecefPos.z());
+
+  double rotationMatrixENU[3][3];
+  simCore::CoordinateConverter::setLocalToEarthMatrix(lla.lat(), lla.lon(), simCore::LOCAL_LEVEL_FRAME_ENU, rotationMatrixENU);
+  for (int row = 0; row < 3; ++row)
+  {
+    for (int col = 0; col < 3; ++col)
+      local2world(row, col) = rotationMatrixENU[row][col];
+  }
+  return local2world;
+}
+
 simCore::Vec3 RangeToolState::osg2simCore(const osg::Vec3d& point) const
 {
   return simCore::Vec3(point.x(), point.y(), point.z());
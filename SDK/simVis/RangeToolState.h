@@ -161,6 +161,21 @@ struct SDKVIS_EXPORT RangeToolState
   */
   void resetCoordCache();
 
+  /**
+  * Prepares for calculations after beginEntity_ and endEntity_ are populated.  Resets the coord cache,
+  * centers the coordinate converter on the begin entity and localizes to the given frame.
+  * @param local2world Local to world (ECEF) matrix; typically the tangent plane at the begin entity
+  */
+  void setLocalFrame(const osg::Matrixd& local2world);
+
+  /**
+  * Returns the local to world matrix for the ENU tangent plane at the given position, matching the
+  * frame of a position-only Locator.  Used for calculations without a scene graph.
+  * @param lla Position in lat, lon, alt (rad, rad, m)
+  * @return Local to world (ECEF) matrix
+  */
+  static osg::Matrixd tangentPlaneFrame(const simCore::Vec3& lla);
+
   /**@name internal state (TODO: make private)
   *@{
   */
@@ -0,0 +1,217 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Time/TimeClass.h"
+#include "simData/DataStore.h"
+#include "simVis/PlatformFilter.h"
+#include "simVis/RangeToolState.h"
+#include "simVis/RangeToolTimeSeries.h"
+
+namespace simVis
+{
+
+RangeToolTimeSeries::RangeToolTimeSeries(const simData::DataStore& dataStore)
+  : dataStore_(dataStore),
+    numThreads_(0),
+    earthModel_(simCore::WGS_84),
+    filters_(nullptr)
+{
+}
+
+RangeToolTimeSeries::~RangeToolTimeSeries()
+{
+}
+
+void RangeToolTimeSeries::setNumThreads(unsigned int numThreads)
+{
+  numThreads_ = numThreads;
+}
+
+unsigned int RangeToolTimeSeries::numThreads() const
+{
+  return numThreads_;
+}
+
+void RangeToolTimeSeries::setEarthModel(simCore::EarthModelCalculations earthModel)
+{
+  earthModel_ = earthModel;
+}
+
+simCore::EarthModelCalculations RangeToolTimeSeries::earthModel() const
+{
+  return earthModel_;
+}
+
+void RangeToolTimeSeries::setTspiFilterManager(PlatformTspiFilterManager* filters)
+{
+  filters_ = filters;
+}
+
+std::vector<double> RangeToolTimeSeries::sampleTimes(double beginTime, double endTime, double step)
+{
+  std::vector<double> times;
+  if (step <= 0.0 || endTime < beginTime)
+    return times;
+
+  // Compute each time from the index to avoid accumulating round off error
+  const size_t numSteps = static_cast<size_t>(std::floor((endTime - beginTime) / step + 1e-9));
+  times.reserve(numSteps + 1);
+  for (size_t k = 0; k <= numSteps; ++k)
+    times.push_back(std::min(endTime, beginTime + k * step));
+  return times;
+}
+
+void RangeToolTimeSeries::populateEntityState(simData::ObjectId id, const simData::PlatformUpdate& update, EntityState& state)
+{
+  state.id_ = id;
+  state.hostId_ = id;
+  state.type_ = simData::PLATFORM;
+
+  // Mirrors PlatformNode::updateLocator_() followed by Locator::getLocatorPositionOrientation(); platforms without orientation point north
+  simCore::Coordinate ecef(simCore::COORD_SYS_ECEF, simCore::Vec3(update.x(), update.y(), update.z()));
+  if (update.has_orientation())
+    ecef.setOrientation(simCore::Vec3(update.psi(), update.theta(), update.phi()));
+  if (update.has_velocity())
+    ecef.setVelocity(simCore::Vec3(update.vx(), update.vy(), update.vz()));
+
+  simCore::Coordinate lla;
+  simCore::CoordinateConverter::convertEcefToGeodetic(ecef, lla);
+  state.lla_ = lla.position();
+  state.ypr_ = update.has_orientation() ? lla.orientation() : simCore::Vec3();
+  state.vel_ = update.has_velocity() ? lla.velocity() : simCore::Vec3();
+}
+
+int RangeToolTimeSeries::collectUpdates_(simData::ObjectId id, const std::vector<double>& times, std::vector<simData::PlatformUpdate>& updates, std::vector<bool>& valid) const
+{
+  if (dataStore_.objectType(id) != simData::PLATFORM)
+    return 1;
+  const simData::PlatformUpdateSlice* slice = dataStore_.platformUpdateSlice(id);
+  if (slice == nullptr)
+    return 1;
+
+  updates.assign(times.size(), simData::PlatformUpdate());
+  valid.assign(times.size(), false);
+
+  simData::PlatformPrefs prefs;
+  simData::PlatformProperties props;
+  if (filters_ != nullptr)
+  {
+    simData::DataStore::Transaction txn;
+    const simData::PlatformPrefs* prefsPtr = dataStore_.platformPrefs(id, &txn);
+    if (prefsPtr != nullptr)
+      prefs = *prefsPtr;
+    txn.complete(&prefsPtr);
+    const simData::PlatformProperties* propsPtr = dataStore_.platformProperties(id, &txn);
+    if (propsPtr != nullptr)
+      props = *propsPtr;
+    txn.complete(&propsPtr);
+  }
+
+  // Walk the slice with the same bounding logic that MemoryDataSlice::update() uses for the current value
+  simData::Interpolator* interpolator = dataStore_.isInterpolationEnabled() ? dataStore_.interpolator() : nullptr;
+  for (size_t k = 0; k < times.size(); ++k)
+  {
+    const double time = times[k];
+    const simData::PlatformUpdateSlice::Iterator iter = slice->upper_bound(time);
+    const simData::PlatformUpdate* prev = iter.peekPrevious();
+    // Before the first point the platform has no position
+    if (prev == nullptr)
+      continue;
+
+    const simData::PlatformUpdate* next = iter.peekNext();
+    if ((interpolator != nullptr) && (next != nullptr) && !simCore::areEqual(time, prev->time()))
+      interpolator->interpolate(time, *prev, *next, &updates[k]);
+    else
+      updates[k] = *prev;
+
+    if ((filters_ != nullptr) && (filters_->filter(updates[k], prefs, props) == PlatformTspiFilterManager::POINT_DROPPED))
+      continue;
+    valid[k] = true;
+  }
+  return 0;
+}
+
+int RangeToolTimeSeries::evaluate(simData::ObjectId beginId, simData::ObjectId endId, const std::vector<double>& times,
+  const MeasurementVector& measurements, std::vector<std::vector<double> >& values) const
+{
+  values.assign(measurements.size(), std::vector<double>(times.size(), std::numeric_limits<double>::quiet_NaN()));
+
+  std::vector<simData::PlatformUpdate> beginUpdates;
+  std::vector<simData::PlatformUpdate> endUpdates;
+  std::vector<bool> beginValid;
+  std::vector<bool> endValid;
+  if (collectUpdates_(beginId, times, beginUpdates, beginValid) != 0 ||
+    collectUpdates_(endId, times, endUpdates, endValid) != 0)
+    return 1;
+
+  const int refYear = dataStore_.referenceYear();
+  const simCore::EarthModelCalculations earthModel = earthModel_;
+
+  // Each worker owns its state and writes a disjoint range of samples, so no locking is needed
+  auto evaluateRange = [&](size_t first, size_t last)
+  {
+    RangeToolState state(new EntityState, new EntityState);
+    state.earthModel_ = earthModel;
+    for (size_t k = first; k < last; ++k)
+    {
+      if (!beginValid[k] || !endValid[k])
+        continue;
+
+      populateEntityState(beginId, beginUpdates[k], *state.beginEntity_);
+      populateEntityState(endId, endUpdates[k], *state.endEntity_);
+      state.timeStamp_ = simCore::TimeStamp(refYear, times[k]);
+      state.setLocalFrame(RangeToolState::tangentPlaneFrame(state.beginEntity_->lla_));
+
+      for (size_t m = 0; m < measurements.size(); ++m)
+      {
+        const Measurement* measurement = measurements[m].get();
+        if ((measurement != nullptr) && measurement->willAccept(state))
+          values[m][k] = measurement->value(state);
+      }
+    }
+  };
+
+  size_t numThreads = (numThreads_ == 0) ? std::thread::hardware_concurrency() : numThreads_;
+  numThreads = std::max<size_t>(1, std::min(numThreads, times.size()));
+  if (numThreads <= 1)
+  {
+    evaluateRange(0, times.size());
+    return 0;
+  }
+
+  const size_t chunkSize = (times.size() + numThreads - 1) / numThreads;
+  std::vector<std::thread> workers;
+  workers.reserve(numThreads);
+  for (size_t first = 0; first < times.size(); first += chunkSize)
+    workers.push_back(std::thread(evaluateRange, first, std::min(times.size(), first + chunkSize)));
+  for (auto& worker : workers)
+    worker.join();
+  return 0;
+}
+
+}
@@ -0,0 +1,129 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMVIS_RANGETOOLTIMESERIES_H
+#define SIMVIS_RANGETOOLTIMESERIES_H
+
+#include <vector>
+#include "simCore/Calc/Calculations.h"
+#include "simCore/Common/Common.h"
+#include "simData/DataTypes.h"
+#include "simData/ObjectId.h"
+#include "simVis/Measurement.h"
+
+namespace simData { class DataStore; }
+
+namespace simVis
+{
+
+class PlatformTspiFilterManager;
+struct EntityState;
+
+/**
+* Evaluates Range Tool measurements for a pair of platforms over a series of times, pulling
+* positions directly from the data store instead of the scene.  Intended for plots and reports
+* that would otherwise require scrubbing the clock.  Each sample is computed with the same
+* EntityState population and Measurement math as the interactive Range Tool, so values match
+* what the Range Tool displays at that time.
+*
+* Samples are split across worker threads.  Data store access and TSPI filtering happen on the
+* calling thread; only the coordinate conversions and measurement calculations run in parallel,
+* so Measurement::value() must be safe to call concurrently on different states.
+*
+* Validity of a platform is based solely on data availability; draw state is ignored.
+* Measurements that need scene information (beams, RF propagation) are not supported and
+* return NaN, as does any measurement that does not accept the platform pair.
+*/
+class SDKVIS_EXPORT RangeToolTimeSeries
+{
+public:
+  /**
+  * Constructor
+  * @param dataStore Data store holding the platforms; must outlive this instance
+  */
+  explicit RangeToolTimeSeries(const simData::DataStore& dataStore);
+  virtual ~RangeToolTimeSeries();
+
+  /// Sets the number of threads used by evaluate(); 0 uses the hardware concurrency
+  void setNumThreads(unsigned int numThreads);
+  /// Returns the number of threads requested for evaluate(); 0 means hardware concurrency
+  unsigned int numThreads() const;
+
+  /// Sets the earth model used for the calculations; defaults to WGS-84 like the Range Tool
+  void setEarthModel(simCore::EarthModelCalculations earthModel);
+  /// Returns the earth model used for the calculations
+  simCore::EarthModelCalculations earthModel() const;
+
+  /**
+  * Sets a filter manager to apply to the platform updates, such as the one supplying altitude
+  * clamping to the scenario.  Filtering occurs on the calling thread.
+  * @param filters Filter manager to apply; may be nullptr (the default) for no filtering.  Not owned.
+  */
+  void setTspiFilterManager(PlatformTspiFilterManager* filters);
+
+  /**
+  * Evaluates the measurements for the given platform pair at each time
+  * @param beginId Platform at the start of the association
+  * @param endId Platform at the end of the association
+  * @param times Data store times to evaluate, in seconds since the reference year
+  * @param measurements Measurements to evaluate
+  * @param values Receives one vector per measurement, each with one value per time in the units of
+  *   Measurement::units(); NaN where either platform has no position or the measurement does not apply
+  * @return 0 on success, non-zero if either entity is not a platform in the data store
+  */
+  int evaluate(simData::ObjectId beginId, simData::ObjectId endId, const std::vector<double>& times,
+    const MeasurementVector& measurements, std::vector<std::vector<double> >& values) const;
+
+  /**
+  * Returns evenly spaced times from beginTime up to and including endTime
+  * @param beginTime First time, in seconds
+  * @param endTime Last time, in seconds
+  * @param step Time between samples in seconds; must be positive
+  * @return Sample times; empty if step is not positive or endTime < beginTime
+  */
+  static std::vector<double> sampleTimes(double beginTime, double endTime, double step);
+
+  /**
+  * Fills in an entity state for a platform from a data store update, in the same manner as
+  * SimdisRangeToolState::populateEntityState() does from a platform node
+  * @param id Platform ID
+  * @param update ECEF platform update, after any TSPI filtering
+  * @param state Entity state to fill in
+  */
+  static void populateEntityState(simData::ObjectId id, const simData::PlatformUpdate& update, EntityState& state);
+
+private:
+  /**
+  * Retrieves the (optionally interpolated and filtered) update for the platform at each time
+  * @return 0 on success, non-zero if the ID is not a platform
+  */
+  int collectUpdates_(simData::ObjectId id, const std::vector<double>& times, std::vector<simData::PlatformUpdate>& updates, std::vector<bool>& valid) const;
+
+  const simData::DataStore& dataStore_;
+  unsigned int numThreads_;
+  simCore::EarthModelCalculations earthModel_;
+  PlatformTspiFilterManager* filters_;
+};
+
+}
+
+#endif
@@ -0,0 +1,122 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "simVis/RedrawScheduler.h"
+
+namespace simVis
+{
+
+RedrawScheduler::RedrawScheduler()
+  : maxIdleInterval_(1.0),
+    pendingSources_(SOURCE_NONE),
+    nextFrameSources_(SOURCE_NONE),
+    hasSimulationTime_(false),
+    simulationTime_(0.0),
+    hasDrawn_(false),
+    settleFrame_(false),
+    lastFrameTime_(0.0),
+    numFramesDrawn_(0),
+    numFramesSkipped_(0)
+{
+}
+
+RedrawScheduler::~RedrawScheduler()
+{
+}
+
+void RedrawScheduler::setMaxIdleInterval(double seconds)
+{
+  maxIdleInterval_ = seconds;
+}
+
+double RedrawScheduler::maxIdleInterval() const
+{
+  return maxIdleInterval_;
+}
+
+void RedrawScheduler::requestRedraw(unsigned int sources)
+{
+  pendingSources_ |= sources;
+}
+
+void RedrawScheduler::requestNextFrame(unsigned int sources)
+{
+  nextFrameSources_.fetch_or(sources);
+}
+
+void RedrawScheduler::setSimulationTime(double simulationTime)
+{
+  if (hasSimulationTime_ && simulationTime == simulationTime_)
+    return;
+  hasSimulationTime_ = true;
+  simulationTime_ = simulationTime;
+  pendingSources_ |= SOURCE_CLOCK;
+}
+
+bool RedrawScheduler::needsFrame(double wallTime) const
+{
+  // Always draw the first frame
+  if (!hasDrawn_ || settleFrame_ || pendingSources() != SOURCE_NONE)
+    return true;
+  return maxIdleInterval_ > 0.0 && timeUntilIdleFrame(wallTime) <= 0.0;
+}
+
+unsigned int RedrawScheduler::pendingSources() const
+{
+  return pendingSources_;
+}
+
+double RedrawScheduler::timeUntilIdleFrame(double wallTime) const
+{
+  if (maxIdleInterval_ <= 0.0)
+    return -1.0;
+  if (!hasDrawn_)
+    return 0.0;
+  const double remaining = lastFrameTime_ + maxIdleInterval_ - wallTime;
+  return (remaining > 0.0) ? remaining : 0.0;
+}
+
+void RedrawScheduler::frameDrawn(double wallTime)
+{
+  settleFrame_ = (pendingSources_ != SOURCE_NONE);
+  pendingSources_ = nextFrameSources_.exchange(SOURCE_NONE);
+  hasDrawn_ = true;
+  lastFrameTime_ = wallTime;
+  ++numFramesDrawn_;
+}
+
+void RedrawScheduler::frameSkipped()
+{
+  ++numFramesSkipped_;
+}
+
+uint64_t RedrawScheduler::numFramesDrawn() const
+{
+  return numFramesDrawn_;
+}
+
+uint64_t RedrawScheduler::numFramesSkipped() const
+{
+  return numFramesSkipped_;
+}
+
+}
@@ -0,0 +1,121 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMVIS_REDRAW_SCHEDULER_H
+#define SIMVIS_REDRAW_SCHEDULER_H
+
+#include <atomic>
+#include <cstdint>
+#include "simCore/Common/Common.h"
+
+namespace simVis
+{
+
+/**
+ * Tracks whether the scene needs to be drawn, for rendering on demand.  Sources of change mark the scene
+ * dirty with requestRedraw(), and the frame loop asks needsFrame() before drawing.  A frame is also drawn
+ * whenever the maximum idle interval passes without one.  Animated nodes request the following frame with
+ * requestNextFrame() each time they are culled, so only animations actually drawn keep the scene drawing.
+ * One more frame is drawn after the last change, so that state lagging a frame behind, such as a tethered
+ * camera following its entity, settles before the display goes idle.
+ * Times are wall clock seconds supplied by the caller; nothing here depends on the graphics state.
+ */
+class SDKVIS_EXPORT RedrawScheduler
+{
+public:
+  /** Sources of scene changes; may be combined */
+  enum Source
+  {
+    SOURCE_NONE = 0,
+    /** Data store updates, flushes, and entity, prefs and properties changes */
+    SOURCE_DATA_STORE = 0x01,
+    /** Change in the simulation time */
+    SOURCE_CLOCK = 0x02,
+    /** Camera moved, or a camera manipulator changed its view */
+    SOURCE_CAMERA = 0x04,
+    /** Pending input events, or redraw and continuous update requests made through the viewer */
+    SOURCE_INPUT = 0x08,
+    /** Animated nodes, such as animated lines and pulsing beams */
+    SOURCE_ANIMATION = 0x10,
+    /** Pending paging work that needs frames to complete */
+    SOURCE_PAGING = 0x20,
+    /** Any other change made by the application */
+    SOURCE_APPLICATION = 0x40
+  };
+
+  RedrawScheduler();
+  virtual ~RedrawScheduler();
+
+  /**
+   * Sets the longest time without drawing a frame, in seconds; a frame is drawn once this passes even if nothing
+   * was marked dirty.  Values of 0 or less disable the idle frame.  Default is 1 second.
+   */
+  void setMaxIdleInterval(double seconds);
+  /** Retrieves the longest time without drawing a frame, in seconds */
+  double maxIdleInterval() const;
+
+  /** Marks the scene dirty from the given sources, a combination of Source values */
+  void requestRedraw(unsigned int sources = SOURCE_APPLICATION);
+  /**
+   * Marks the frame after the one being drawn dirty from the given sources.  Use while drawing, such as from
+   * a cull traversal, where a requestRedraw() would be cleared by frameDrawn().  Safe to call from any thread.
+   */
+  void requestNextFrame(unsigned int sources = SOURCE_ANIMATION);
+  /** Marks the clock source dirty if the simulation time differs from the last time set */
+  void setSimulationTime(double simulationTime);
+
+  /** Returns true if a frame should be drawn at the given wall clock time */
+  bool needsFrame(double wallTime) const;
+  /** Returns the sources marked dirty since the last frame was drawn */
+  unsigned int pendingSources() const;
+  /** Seconds from the given wall clock time until the max idle interval forces a frame; negative if disabled */
+  double timeUntilIdleFrame(double wallTime) const;
+
+  /**
+   * Call after drawing a frame; replaces the dirty sources with those requested for the next frame, leaving
+   * one settle frame if any were dirty
+   */
+  void frameDrawn(double wallTime);
+  /** Call after skipping a frame that was not needed */
+  void frameSkipped();
+
+  /** Number of frames drawn */
+  uint64_t numFramesDrawn() const;
+  /** Number of frames skipped */
+  uint64_t numFramesSkipped() const;
+
+private:
+  double maxIdleInterval_;
+  unsigned int pendingSources_;
+  std::atomic<unsigned int> nextFrameSources_;
+  bool hasSimulationTime_;
+  double simulationTime_;
+  bool hasDrawn_;
+  bool settleFrame_;
+  double lastFrameTime_;
+  uint64_t numFramesDrawn_;
+  uint64_t numFramesSkipped_;
+};
+
+}
+
+#endif /* SIMVIS_REDRAW_SCHEDULER_H */
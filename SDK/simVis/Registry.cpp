@@ -37,6 +37,7 @@
 #include "simVis/Utils.h"
 #include "simVis/ClockOptions.h"
 #include "simVis/Constants.h"
+#include "simVis/EphemerisVector.h"
 #include "simVis/ModelCache.h"
 #include "simVis/Registry.h"
 
@@ -169,6 +170,7 @@ simVis::Registry* simVis::Registry::instance_ = nullptr;
 
 simVis::Registry::Registry()
   : modelCache_(new ModelCache),
+    ephemerisCache_(new EphemerisCache),
     fileSearch_(new simCore::NoSearchFileSearch()),
     sequenceTimeUpdater_(new simVis::SequenceTimeUpdater(nullptr))
 {
@@ -421,6 +423,11 @@ simVis::ModelCache* simVis::Registry::modelCache() const
   return modelCache_;
 }
 
+simVis::EphemerisCache* simVis::Registry::ephemerisCache() const
+{
+  return ephemerisCache_.get();
+}
+
 osgText::Font* simVis::Registry::getOrCreateFont(const std::string& name) const
 {
   FontCache::const_iterator it = fontCache_.find(name);
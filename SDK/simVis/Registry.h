@@ -52,6 +52,8 @@ typedef osgDB::FilePathList FilePathList;
 typedef std::list<std::string> FileExtensionList;
 /** Model cache for loading models */
 class ModelCache;
+/** Cache of sun and moon positions by time */
+class EphemerisCache;
 
 // Handles time updates on osg::Sequence
 class SequenceTimeUpdater;
@@ -136,6 +138,9 @@ public:
   /** Retrieve a pointer to the model cache. */
   ModelCache* modelCache() const;
 
+  /** Retrieve a pointer to the ephemeris cache shared by all sun and moon position consumers. */
+  EphemerisCache* ephemerisCache() const;
+
   /**
   * Searches for the named font, using the data search path list and the extensions list.
   * This method is thread safe
@@ -235,6 +240,7 @@ private:
   FileExtensionList modelExtensions_;
   std::set<std::string> pseudoLoaderExtensions_;
   ModelCache* modelCache_;
+  osg::ref_ptr<EphemerisCache> ephemerisCache_;
 
   // A mapping between the supplied file name and the actual file name
   typedef std::map<std::string, std::string> FilenameCache;
@@ -44,6 +44,7 @@
 #include "simVis/CustomRendering.h"
 #include "simVis/LabelContentManager.h"
 #include "simVis/Laser.h"
+#include "simVis/LineBatch.h"
 #include "simVis/LobGroup.h"
 #include "simVis/Locator.h"
 #include "simVis/OverheadMode.h"
@@ -104,6 +105,22 @@ struct SetHorizonCullCallback : public osg::NodeCallback
   }
 };
 
+/** Update callback that creates a frame's worth of deferred entity nodes; see ScenarioDataStoreAdapter::setCreationBudget() */
+struct ProcessPendingEntitiesCallback : public osg::NodeCallback
+{
+  void operator()(osg::Node* node, osg::NodeVisitor* nv)
+  {
+    simVis::ScenarioManager* scenario = static_cast<simVis::ScenarioManager*>(node);
+    if (scenario->getDataStoreAdapter().numPendingEntities() > 0)
+    {
+      SAFETRYBEGIN;
+      scenario->getDataStoreAdapter().processPendingEntities();
+      SAFETRYEND("creating deferred entities");
+    }
+    traverse(node, nv);
+  }
+};
+
 /** Calls ScenarioManager::notifyBeamsOfNewHostSize() when model node gets a bounds update. */
 class BeamNoseFixer : public simVis::PlatformModelNode::Callback
 {
@@ -139,6 +156,7 @@ namespace simVis
 
 ScenarioManager::EntityRecord::EntityRecord(EntityNode* node, const simData::DataSliceBase* updateSlice, simData::DataStore* dataStore)
   : node_(node),
+    platform_(dynamic_cast<PlatformNode*>(node)),
     updateSlice_(updateSlice),
     dataStore_(dataStore)
 {
@@ -179,6 +197,17 @@ bool ScenarioManager::EntityRecord::updateFromDataStore(bool force) const
   return (node_.valid() && node_->updateFromDataStore(updateSlice_, force));
 }
 
+bool ScenarioManager::EntityRecord::prepareBatchFilter(bool force, PlatformTspiFilterManager::BatchEntry& entry) const
+{
+  return (platform_ != nullptr && platform_->prepareBatchFilter(updateSlice_, force, entry));
+}
+
+void ScenarioManager::EntityRecord::setBatchFilterResult(const PlatformTspiFilterManager::BatchEntry& entry) const
+{
+  if (platform_ != nullptr)
+    platform_->setBatchFilterResult(entry);
+}
+
 // -----------------------------------------------------------------------
 
 /** Entity group that stores all nodes in a flat osg::Group */
@@ -464,10 +493,13 @@ ScenarioManager::ScenarioManager(ProjectorManager* projMan)
   projectorManager_(projMan),
   labelContentManager_(new NullLabelContentManager()),
   rfManager_(new simRF::NullRFPropagationManager()),
-  losCreator_(new ScenarioLosCreator())
+  losCreator_(new ScenarioLosCreator()),
+  lineBatches_(new LineBatchGroup),
+  lineBatching_(false)
 {
   root_->setName("root");
   root_->addChild(entityGraph_->node());
+  root_->addChild(lineBatches_.get());
   addChild(root_.get());
 
   // Install a callback that will convey the Horizon info
@@ -488,6 +520,9 @@ ScenarioManager::ScenarioManager(ProjectorManager* projMan)
   refYearCallback_ = new SetRefYearCullCallback();
   addCullCallback(refYearCallback_);
 
+  // Drains entities queued by the data store adapter when a creation budget is set
+  addUpdateCallback(new ProcessPendingEntitiesCallback);
+
   // Clamping requires a Group for MapNode changes
   surfaceClamping_ = new SurfaceClamping();
   aboveSurfaceClamping_ = new AboveSurfaceClamping();
@@ -570,6 +605,32 @@ void ScenarioManager::setRFPropagationManager(simRF::RFPropagationManagerPtr man
     rfManager_ = manager;
 }
 
+void ScenarioManager::setLineBatching(bool enabled)
+{
+  if (lineBatching_ == enabled)
+    return;
+  lineBatching_ = enabled;
+  LineBatchGroup* lineBatches = (lineBatching_ ? lineBatches_.get() : nullptr);
+  for (auto i = entities_.begin(); i != entities_.end(); ++i)
+  {
+    EntityNode* node = i->second->getEntityNode();
+    PlatformNode* platform = dynamic_cast<PlatformNode*>(node);
+    if (platform)
+      platform->setLineBatchGroup(lineBatches);
+    else
+    {
+      LaserNode* laser = dynamic_cast<LaserNode*>(node);
+      if (laser)
+        laser->setLineBatchGroup(lineBatches);
+    }
+  }
+}
+
+bool ScenarioManager::lineBatching() const
+{
+  return lineBatching_;
+}
+
 simRF::RFPropagationManagerPtr ScenarioManager::rfPropagationManager() const
 {
   return rfManager_;
@@ -658,6 +719,7 @@ void ScenarioManager::removeEntity(simData::ObjectId id)
 
     // Remove it from the surface clamping algorithm
     surfaceClamping_->removeEntity(id);
+    platformTspiFilterManager_->removeEntity(id);
 
     // If this is a projector node, delete this from the projector manager
     if (entity->type() == simData::PROJECTOR)
@@ -693,6 +755,8 @@ void ScenarioManager::setMapNode(osgEarth::MapNode* map)
   surfaceClamping_->setMapNode(mapNode_.get());
   aboveSurfaceClamping_->setMapNode(mapNode_.get());
   lobSurfaceClamping_->setMapNode(mapNode_.get());
+  // Clamping filters only apply with a valid map
+  platformTspiFilterManager_->invalidateApplicability();
   SAFETRYEND("setting map in scenario");
 }
 
@@ -715,6 +779,8 @@ PlatformNode* ScenarioManager::addPlatform(const simData::PlatformProperties& pr
     &dataStore);
 
   node->setLosCreator(losCreator_);
+  if (lineBatching_)
+    node->setLineBatchGroup(lineBatches_.get());
 
   notifyToolsOfAdd_(node);
 
@@ -811,6 +877,8 @@ LaserNode* ScenarioManager::addLaser(const simData::LaserProperties& props, simD
   Locator* locator = host ? host->getLocator() : new Locator();
 
   LaserNode* node = new LaserNode(props, locator, host, dataStore.referenceYear());
+  if (lineBatching_)
+    node->setLineBatchGroup(lineBatches_.get());
 
   entities_[node->getId()] = new EntityRecord(
     node,
@@ -1266,6 +1334,24 @@ void ScenarioManager::update(simData::DataStore* ds, bool force)
 
   EntityVector updates;
 
+  // Filter the current points of all changed platforms in one pass; the platforms apply the results below
+  SAFETRYBEGIN;
+  platformBatch_.clear();
+  platformBatchRecords_.clear();
+  PlatformTspiFilterManager::BatchEntry entry;
+  for (EntityRepo::const_iterator i = entities_.begin(); i != entities_.end(); ++i)
+  {
+    if (i->second->prepareBatchFilter(force, entry))
+    {
+      platformBatch_.push_back(entry);
+      platformBatchRecords_.push_back(i->second.get());
+    }
+  }
+  platformTspiFilterManager_->filterBatch(platformBatch_);
+  for (size_t k = 0; k < platformBatch_.size(); ++k)
+    platformBatchRecords_[k]->setBatchFilterResult(platformBatch_[k]);
+  SAFETRYEND("filtering platform updates");
+
   SAFETRYBEGIN;
   for (EntityRepo::const_iterator i = entities_.begin(); i != entities_.end(); ++i)
   {
@@ -1327,6 +1413,43 @@ void ScenarioManager::update(simData::DataStore* ds, bool force)
   }
 }
 
+void ScenarioManager::updateEntities(simData::DataStore* ds, const std::vector<simData::ObjectId>& ids)
+{
+  EntityVector updates;
+
+  SAFETRYBEGIN;
+  for (std::vector<simData::ObjectId>::const_iterator i = ids.begin(); i != ids.end(); ++i)
+  {
+    EntityRepo::const_iterator entity = entities_.find(*i);
+    if (entity == entities_.end())
+      continue;
+    EntityRecord* record = entity->second.get();
+    if (record->updateFromDataStore(true))
+    {
+      updates.push_back(record->getEntityNode());
+      entityGraph_->addOrUpdate(record);
+    }
+  }
+  SAFETRYEND("updating new scenario entities");
+
+  if (updates.empty())
+    return;
+
+  // tools only hear about the updated entities; other changes are picked up by the next update()
+  const simCore::TimeStamp updateTimeStamp(ds->referenceYear(), ds->updateTime());
+  for (ScenarioToolVector::const_iterator i = scenarioTools_.begin(); i != scenarioTools_.end(); ++i)
+  {
+    SAFETRYBEGIN;
+    (*i)->onUpdate(*this, updateTimeStamp, updates);
+    SAFETRYEND("updating scenario tools");
+  }
+
+  SAFETRYBEGIN;
+  osgEarth::ViewVisitor<osgEarth::RequestRedraw> visitor;
+  this->accept(visitor);
+  SAFETRYEND("requesting redraw on scenario");
+}
+
 void ScenarioManager::removeAllTools_()
 {
   std::vector< osg::ref_ptr<ScenarioTool> > scenarioTools;
@@ -27,11 +27,13 @@
 #include <string>
 #include <map>
 #include <set>
+#include <vector>
 #include "osg/Group"
 #include "osg/ref_ptr"
 #include "osg/View"
 #include "osgEarth/CullingUtils"
 #include "osgEarth/Revisioning"
+#include "simVis/PlatformFilter.h"
 #include "simVis/ScenarioDataStoreAdapter.h"
 #include "simVis/Types.h"
 #include "simVis/RFProp/RFPropagationManager.h"
@@ -49,10 +51,10 @@ class GateNode;
 class CustomRenderingNode;
 class LabelContentManager;
 class LaserNode;
+class LineBatchGroup;
 class LobGroupNode;
 class Locator;
 class PlatformNode;
-class PlatformTspiFilterManager;
 class ProjectorManager;
 class ProjectorNode;
 class ScenarioTool;
@@ -96,6 +98,18 @@ public:
   /** Returns the RFPropagationManager */
   simRF::RFPropagationManagerPtr rfPropagationManager() const;
 
+  /**
+  * Turns on or off shared line batching for simple per-entity lines, currently laser lines and
+  * platform velocity vectors.  Batched lines are drawn with one draw per line width instead of
+  * one node each.  They keep per-entity colors and visibility, but are not horizon culled or
+  * flattened in Overhead Mode.  Off by default; applies to existing and future entities.
+  * @param[in ] enabled True to draw simple lines through shared batches
+  */
+  void setLineBatching(bool enabled);
+
+  /** Returns true if simple per-entity lines are drawn through shared batches */
+  bool lineBatching() const;
+
   /**
   * Add a new platform to the scenario and bind it to the data store.
   * @param props     Platform initialization properties
@@ -317,6 +331,8 @@ public:
   * Accesses the DataStore adapter bound to this scenario.
   */
   const ScenarioDataStoreAdapter& getDataStoreAdapter() const { return dataStoreAdapter_; }
+  /** Accesses the DataStore adapter bound to this scenario, e.g. to configure deferred entity creation. */
+  ScenarioDataStoreAdapter& getDataStoreAdapter() { return dataStoreAdapter_; }
 
   /**
   * Finds a list of object IDs that point to the input object ID
@@ -363,6 +379,15 @@ public: // package protected
   */
   void update(simData::DataStore* ds, bool force = false);
 
+  /**
+  * Forces an update of only the given entities from the data store, even if their update slices
+  * have not changed.  Used for nodes created after their data was already loaded, without the cost
+  * of checking every other entity in the scenario.
+  * @param[in ] ds  DataStore driving the update
+  * @param[in ] ids Entities to update
+  */
+  void updateEntities(simData::DataStore* ds, const std::vector<simData::ObjectId>& ids);
+
   /**
   * Notify all entities of a change in a Clock Mode.
   * @param[in ] clock Clock to propagate to scenario objects.
@@ -420,6 +445,14 @@ protected:
   simRF::RFPropagationManagerPtr rfManager_;
   /** Responsible for creation of LOS nodes as needed by platforms */
   ScenarioLosCreator* losCreator_;
+  /** Shared line batches, used when lineBatching() is on */
+  osg::ref_ptr<LineBatchGroup> lineBatches_;
+  /** Whether simple lines are drawn through lineBatches_ */
+  bool lineBatching_;
+  /** Current points of the changed platforms, filtered together on each update(); reused across updates */
+  std::vector<PlatformTspiFilterManager::BatchEntry> platformBatch_;
+  /** Records of the platforms in platformBatch_, in the same order */
+  std::vector<EntityRecord*> platformBatchRecords_;
 
   /** Association between the EntityNode, the data store, and the entity's update slice */
   class EntityRecord : public osg::Group
@@ -440,10 +473,16 @@ protected:
     bool dataStoreMatches(const simData::DataStore* dataStore) const;
     /** Updates the entity from the data store.  Returns true if update was applied, false otherwise */
     bool updateFromDataStore(bool force) const;
+    /** Stages a platform's current point for batch filtering.  Returns false for other entities, or if the update will not filter a point */
+    bool prepareBatchFilter(bool force, PlatformTspiFilterManager::BatchEntry& entry) const;
+    /** Passes the result of batch filtering to the platform for its next update */
+    void setBatchFilterResult(const PlatformTspiFilterManager::BatchEntry& entry) const;
 
   private:
     /** Node in scene graph representing entity */
     osg::ref_ptr<EntityNode> node_;
+    /** Same as node_ if the entity is a platform, saving a cast on each update; nullptr otherwise */
+    PlatformNode* platform_;
 
     /** Const pointer to the entity's data update slice */
     const simData::DataSliceBase* updateSlice_;
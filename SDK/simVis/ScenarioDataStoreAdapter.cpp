@@ -20,10 +20,17 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <vector>
+#include "osgDB/FileNameUtils"
 #include "simNotify/Notify.h"
 #include "simCore/Time/Clock.h"
 #include "simVis/ScenarioDataStoreAdapter.h"
 #include "simVis/LobGroup.h"
+#include "simVis/ModelCache.h"
+#include "simVis/Registry.h"
 #include "simVis/Scenario.h"
 
 #undef LC
@@ -39,31 +46,81 @@ class MyListener : public simData::DataStore::Listener
 {
 public:
   explicit MyListener(simVis::ScenarioManager *parent)
-    : scenarioManager_(parent)
+    : scenarioManager_(parent),
+      deferCreation_(false)
   {
   }
 
+  /// When true, new entities are queued and created later by createPending()
+  void setDeferCreation(bool defer)
+  {
+    deferCreation_ = defer;
+  }
+
+  /// Number of entities waiting for node creation
+  size_t numPending() const
+  {
+    return pending_.size();
+  }
+
+  /**
+   * Creates up to maxCount queued entities in the order they were added to the data store,
+   * then forces an update of only the new nodes so they pick up data that arrived before them.
+   * Returns the number of entities created.
+   */
+  size_t createPending(simData::DataStore& ds, size_t maxCount)
+  {
+    if (pending_.empty() || maxCount == 0)
+      return 0;
+    std::vector<simData::ObjectId> created;
+    while (!pending_.empty() && created.size() < maxCount)
+    {
+      const PendingEntity entity = pending_.front();
+      pending_.pop_front();
+      pendingIds_.erase(entity.id);
+      if (!scenarioManager_.valid())
+        continue;
+      addEntity_(ds, entity.id, entity.type);
+      // Prefs changes were ignored while queued; apply the current prefs now
+      onPrefsChange(&ds, entity.id);
+      created.push_back(entity.id);
+    }
+    if (scenarioManager_.valid() && !created.empty())
+      scenarioManager_->updateEntities(&ds, created);
+    // Icon prefetches are only needed while entities are waiting
+    if (pending_.empty())
+      prefetchedIcons_.clear();
+    return created.size();
+  }
+
   /// new entity has been added, with the given id and type
   virtual void onAddEntity(simData::DataStore *source, simData::ObjectId newId, simData::ObjectType ot)
   {
-    switch (ot)
+    if (!deferCreation_)
     {
-    case simData::PLATFORM: addPlatform_(*source, newId); break;
-    case simData::BEAM: addBeam_(*source, newId); break;
-    case simData::GATE: addGate_(*source, newId); break;
-    case simData::PROJECTOR: addProjector_(*source, newId); break;
-    case simData::LASER: addLaser_(*source, newId); break;
-    case simData::LOB_GROUP: addLobGroup_(*source, newId); break;
-    case simData::CUSTOM_RENDERING: addCustomRendering_(*source, newId); break;
-    case simData::ALL: // shouldn't see these
-    case simData::NONE:
-      assert(false);
+      addEntity_(*source, newId, ot);
+      return;
     }
+
+    PendingEntity entity;
+    entity.id = newId;
+    entity.type = ot;
+    pending_.push_back(entity);
+    pendingIds_.insert(newId);
+    if (ot == simData::PLATFORM)
+      prefetchIcon_(*source, newId);
   }
 
   /// entity with the given id and type will be removed after all notifications are processed
   virtual void onRemoveEntity(simData::DataStore *source, simData::ObjectId removedId, simData::ObjectType ot)
   {
+    // Entities that never left the queue have no node to remove
+    if (pendingIds_.erase(removedId) != 0)
+    {
+      pending_.erase(std::find_if(pending_.begin(), pending_.end(),
+        [removedId](const PendingEntity& entity) { return entity.id == removedId; }));
+      return;
+    }
     if (scenarioManager_.valid())
       scenarioManager_->removeEntity(removedId);
   }
@@ -77,6 +134,9 @@ public:
   /// prefs for the given entity have been changed
   virtual void onPrefsChange(simData::DataStore *source, simData::ObjectId id)
   {
+    // Queued entities pick up their current prefs when created
+    if (pendingIds_.find(id) != pendingIds_.end())
+      return;
     switch (source->objectType(id))
     {
     case simData::PLATFORM: changePlatformPrefs_(*source, id); break;
@@ -126,10 +186,54 @@ public:
   /// The scenario is about to be deleted
   virtual void onScenarioDelete(simData::DataStore* source)
   {
-    // no-op
+    pending_.clear();
+    pendingIds_.clear();
+    prefetchedIcons_.clear();
   }
 
 private: // methods
+  void addEntity_(simData::DataStore &ds, simData::ObjectId newId, simData::ObjectType ot) const
+  {
+    switch (ot)
+    {
+    case simData::PLATFORM: addPlatform_(ds, newId); break;
+    case simData::BEAM: addBeam_(ds, newId); break;
+    case simData::GATE: addGate_(ds, newId); break;
+    case simData::PROJECTOR: addProjector_(ds, newId); break;
+    case simData::LASER: addLaser_(ds, newId); break;
+    case simData::LOB_GROUP: addLobGroup_(ds, newId); break;
+    case simData::CUSTOM_RENDERING: addCustomRendering_(ds, newId); break;
+    case simData::ALL: // shouldn't see these
+    case simData::NONE:
+      assert(false);
+    }
+  }
+
+  /**
+   * Starts a background load of a queued platform's icon so that the model is already cached
+   * when the node is created.  Only the model cache's loader thread is involved; the live scene
+   * graph is untouched.
+   */
+  void prefetchIcon_(simData::DataStore &ds, simData::ObjectId id)
+  {
+    std::string icon;
+    simData::DataStore::Transaction xaction;
+    const simData::PlatformPrefs* livePrefs = ds.platformPrefs(id, &xaction);
+    if (livePrefs)
+      icon = livePrefs->icon();
+    xaction.release(&livePrefs);
+
+    const simVis::Registry* registry = simVis::Registry::instance();
+    if (icon.empty() || registry->isMemoryCheck() || !prefetchedIcons_.insert(icon).second)
+      return;
+    const std::string uri = registry->findModelFile(icon);
+    // LST and TMD loads fall back to synchronous loading, which would defeat the deferral
+    const std::string ext = osgDB::getLowerCaseFileExtension(uri);
+    if (uri.empty() || ext == "lst" || ext == "tmd")
+      return;
+    registry->modelCache()->asyncLoad(uri, nullptr);
+  }
+
   void addPlatform_(simData::DataStore &ds, simData::ObjectId newId) const
   {
     if (!scenarioManager_.valid())
@@ -321,7 +425,21 @@ private: // methods
   }
 
 private: // data
+  /// Entity waiting for node creation
+  struct PendingEntity
+  {
+    simData::ObjectId id;
+    simData::ObjectType type;
+  };
+
   osg::observer_ptr<simVis::ScenarioManager> scenarioManager_;
+  bool deferCreation_;
+  /// Queued entities, in data store add order
+  std::deque<PendingEntity> pending_;
+  /// IDs in pending_, for fast lookup on prefs changes and removals
+  std::set<simData::ObjectId> pendingIds_;
+  /// Icons already handed to the model cache for background loading
+  std::set<std::string> prefetchedIcons_;
 };
 
 // Observer for time clock mode changes
@@ -376,6 +494,7 @@ namespace simVis {
 
 // -----------------------------------------------------------------------
 ScenarioDataStoreAdapter::ScenarioDataStoreAdapter(simData::DataStore* dataStore, ScenarioManager* scenario)
+  : creationBudget_(0)
 {
   bind(dataStore, scenario);
 }
@@ -393,7 +512,9 @@ void ScenarioDataStoreAdapter::bind(simData::DataStore* dataStore, ScenarioManag
     {
       // set up notifications so we can react to data store actions:
       // the listener allows us to receive multiple notifications with a single object
-      simData::DataStore::ListenerPtr listener(new MyListener(scenario));
+      std::shared_ptr<MyListener> myListener(new MyListener(scenario));
+      myListener->setDeferCreation(creationBudget_ != 0);
+      simData::DataStore::ListenerPtr listener(myListener);
       dataStore->addListener(listener);
       listeners_[dataStore]= listener;
 
@@ -432,6 +553,7 @@ void ScenarioDataStoreAdapter::unbind(simData::DataStore* dataStore)
     std::map<simData::DataStore*, simData::DataStore::ListenerPtr>::iterator li = listeners_.find(dataStore);
     if (li != listeners_.end())
     {
+      // Entities still queued for this data store are abandoned along with the listener
       dataStore->removeListener(li->second);
       listeners_.erase(li);
     }
@@ -450,4 +572,48 @@ void ScenarioDataStoreAdapter::getBindings(std::set<simData::DataStore*>& output
   }
 }
 
+void ScenarioDataStoreAdapter::setCreationBudget(unsigned int entitiesPerFrame)
+{
+  if (creationBudget_ == entitiesPerFrame)
+    return;
+  // Leaving deferred mode must not strand queued entities
+  if (entitiesPerFrame == 0)
+    flushPendingEntities();
+  creationBudget_ = entitiesPerFrame;
+  // Only MyListener instances are stored in listeners_
+  for (auto i = listeners_.begin(); i != listeners_.end(); ++i)
+    std::static_pointer_cast<MyListener>(i->second)->setDeferCreation(creationBudget_ != 0);
+}
+
+unsigned int ScenarioDataStoreAdapter::creationBudget() const
+{
+  return creationBudget_;
+}
+
+size_t ScenarioDataStoreAdapter::numPendingEntities() const
+{
+  size_t rv = 0;
+  for (auto i = listeners_.begin(); i != listeners_.end(); ++i)
+    rv += std::static_pointer_cast<MyListener>(i->second)->numPending();
+  return rv;
+}
+
+size_t ScenarioDataStoreAdapter::processPendingEntities()
+{
+  return createPending_(creationBudget_);
+}
+
+size_t ScenarioDataStoreAdapter::flushPendingEntities()
+{
+  return createPending_(std::numeric_limits<size_t>::max());
+}
+
+size_t ScenarioDataStoreAdapter::createPending_(size_t maxCount)
+{
+  size_t numCreated = 0;
+  for (auto i = listeners_.begin(); i != listeners_.end() && numCreated < maxCount; ++i)
+    numCreated += std::static_pointer_cast<MyListener>(i->second)->createPending(*i->first, maxCount - numCreated);
+  return numCreated;
+}
+
 }
@@ -45,7 +45,7 @@ namespace simVis
     * Constructs a new data store adapter. The adapter won't do anything until
     * you bind it with a call to bind().
     */
-    ScenarioDataStoreAdapter() { }
+    ScenarioDataStoreAdapter() : creationBudget_(0) { }
 
     /**
     * Destructor
@@ -78,8 +78,40 @@ namespace simVis
     */
     void getBindings(std::set<simData::DataStore*>& output) const;
 
+    /**
+    * Sets the maximum number of entity nodes created per frame.  With the default of 0, nodes
+    * are created synchronously inside the data store's add notification.  Otherwise new entities
+    * are queued and created in add order by processPendingEntities(), which the ScenarioManager
+    * calls once per update traversal, so that large loads are amortized across frames.  Platform
+    * icons for queued entities begin loading in the background while they wait.
+    * @param entitiesPerFrame Maximum nodes to create per frame, or 0 to create immediately
+    */
+    void setCreationBudget(unsigned int entitiesPerFrame);
+
+    /** Returns the maximum number of entity nodes created per frame; 0 means immediate creation. */
+    unsigned int creationBudget() const;
+
+    /** Returns the number of entities across all bindings that are waiting for node creation. */
+    size_t numPendingEntities() const;
+
+    /**
+    * Creates up to creationBudget() queued entity nodes, in the order they were added.
+    * @return Number of entity nodes created
+    */
+    size_t processPendingEntities();
+
+    /**
+    * Creates all queued entity nodes immediately, regardless of the creation budget.
+    * @return Number of entity nodes created
+    */
+    size_t flushPendingEntities();
+
   private:
+    /** Creates up to maxCount queued entity nodes across all bindings */
+    size_t createPending_(size_t maxCount);
+
     std::map<simData::DataStore*, simData::DataStore::ListenerPtr> listeners_;
+    unsigned int creationBudget_;
   };
 
 } // namespace simVis
@@ -20,6 +20,8 @@
  * disclose, or release this software.
  *
  */
+#include <map>
+#include <tuple>
 #include "osg/BlendFunc"
 #include "osg/CullFace"
 #include "osg/Depth"
@@ -112,8 +114,13 @@ namespace
   {
   public:
     svPyramidOutline(simVis::SphericalVolume& sv, const osg::Vec3Array* vertexArray, unsigned int numPointsX, unsigned int numPointsZ, unsigned short farFaceOffset, unsigned short nearFaceOffset, bool drawWalls);
+    /// create an outline with the same layout in the specified sv, reading from the same vertex array
+    svPyramidOutline* clone(simVis::SphericalVolume& sv) const;
+    /// change the vertex array that the outline is generated from; caller must regenerate
+    void setVertexArray(const osg::Vec3Array* vertexArray);
     void regenerate();
     void hideSideOutlines(bool hideThem);
+    bool sideOutlinesHidden() const;
     void setColor(const osg::Vec4f& color);
     bool hasNearFace() const;
   protected:
@@ -224,6 +231,22 @@ namespace
 
   svPyramidOutline::~svPyramidOutline() {}
 
+  svPyramidOutline* svPyramidOutline::clone(simVis::SphericalVolume& sv) const
+  {
+    svPyramidOutline* outline = new svPyramidOutline(sv, vertexArray_.get(), numPointsX_, numPointsZ_, farFaceOffset_, nearFaceOffset_, drawWalls_);
+    outline->setColor(outlineColor_);
+    outline->regenerate();
+    outline->hideSideOutlines(sideOutlinesHidden());
+    return outline;
+  }
+
+  void svPyramidOutline::setVertexArray(const osg::Vec3Array* vertexArray)
+  {
+    // svPyramidOutline requires a non-nullptr vertex array
+    assert(vertexArray);
+    vertexArray_ = vertexArray;
+  }
+
   void svPyramidOutline::setColor(const osg::Vec4f& color)
   {
     outlineColor_ = color;
@@ -361,6 +384,80 @@ namespace
       nearRightOutline_->setNodeMask(newNodeMask);
   }
 
+  bool svPyramidOutline::sideOutlinesHidden() const
+  {
+    return farLeftOutline_.valid() && farLeftOutline_->getNodeMask() == 0u;
+  }
+
+  /// Geometric parameters of a spherical volume; volumes with equal keys have identical vertex data
+  struct SVPoolKey
+  {
+    int shape;
+    int drawMode;
+    unsigned int capRes;
+    unsigned int coneRes;
+    unsigned int wallRes;
+    bool drawCone;
+    bool drawAsSphereSegment;
+    double hfov;
+    double vfov;
+    float azimOffset;
+    float elevOffset;
+    float nearRange;
+    float farRange;
+    osg::Vec3 direction;
+
+    SVPoolKey(const simVis::SVData& d, const osg::Vec3& dir)
+      : shape(d.shape_),
+        drawMode(d.drawMode_),
+        capRes(d.capRes_),
+        coneRes(d.coneRes_),
+        wallRes(d.wallRes_),
+        drawCone(d.drawCone_),
+        drawAsSphereSegment(d.drawAsSphereSegment_),
+        hfov(d.hfov_deg_),
+        vfov(d.vfov_deg_),
+        azimOffset(d.azimOffset_deg_),
+        elevOffset(d.elevOffset_deg_),
+        nearRange(d.nearRange_),
+        farRange(d.farRange_),
+        direction(dir)
+    {
+    }
+
+    bool operator<(const SVPoolKey& rhs) const
+    {
+      return std::tie(shape, drawMode, capRes, coneRes, wallRes, drawCone, drawAsSphereSegment, hfov, vfov, azimOffset, elevOffset, nearRange, farRange, direction) <
+        std::tie(rhs.shape, rhs.drawMode, rhs.capRes, rhs.coneRes, rhs.wallRes, rhs.drawCone, rhs.drawAsSphereSegment, rhs.hfov, rhs.vfov, rhs.azimOffset, rhs.elevOffset, rhs.nearRange, rhs.farRange, rhs.direction);
+    }
+  };
+
+  /// Pooled volumes are never modified; each is kept alive by the volumes that share its vertex data
+  struct SVPool
+  {
+    std::map<SVPoolKey, osg::observer_ptr<simVis::SphericalVolume> > volumes;
+    unsigned int hits = 0;
+    unsigned int misses = 0;
+  };
+
+  SVPool& svPool()
+  {
+    static SVPool pool;
+    return pool;
+  }
+
+  /// Returns a copy of the geometry that shares its arrays, primitives and metadata, but has its own state and color
+  osg::Geometry* copySharedGeometry(const osg::Geometry& geom, const osg::Vec4f& color)
+  {
+    osg::Geometry* copy = new osg::Geometry(geom, osg::CopyOp::DEEP_COPY_STATESETS | osg::CopyOp::DEEP_COPY_STATEATTRIBUTES | osg::CopyOp::DEEP_COPY_UNIFORMS);
+    osg::Vec4Array* colorArray = new osg::Vec4Array(osg::Array::BIND_OVERALL, 1);
+    (*colorArray)[0] = color;
+    // own buffer object, so that the color is not appended to the shared vertex buffer object
+    colorArray->setVertexBufferObject(new osg::VertexBufferObject());
+    copy->setColorArray(colorArray);
+    return copy;
+  }
+
   class svPyramidFactory
   {
   private:
@@ -1136,6 +1233,156 @@ void SVFactory::createNode(SphericalVolume& sv, const SVData& d, const osg::Vec3
   updateStippling(&sv, ((SVData::DRAW_MODE_STIPPLE & d.drawMode_) == SVData::DRAW_MODE_STIPPLE));
 }
 
+void SVFactory::createPooledNode(SphericalVolume& sv, const SVData& d, const osg::Vec3& dir)
+{
+  if (sv.getNumChildren() > 0)
+  {
+    // dev error; the provided sv must be empty
+    assert(0);
+    return;
+  }
+
+  SVPool& pool = svPool();
+  const SVPoolKey key(d, dir);
+  osg::ref_ptr<SphericalVolume> pooled;
+  auto iter = pool.volumes.find(key);
+  if (iter != pool.volumes.end() && iter->second.lock(pooled))
+    ++pool.hits;
+  else
+  {
+    ++pool.misses;
+    // drop geometry that is no longer shared by any volume
+    for (iter = pool.volumes.begin(); iter != pool.volumes.end();)
+    {
+      if (iter->second.valid())
+        ++iter;
+      else
+        iter = pool.volumes.erase(iter);
+    }
+    pooled = createNode(d, dir);
+    pool.volumes[key] = pooled.get();
+  }
+
+  const osg::Geometry* pooledSolid = solidGeometry(pooled.get());
+  if (pooledSolid == nullptr)
+    return;
+  sv.pooledVolume_ = pooled;
+
+  // primary geode, with a solid geometry that shares the pooled vertex data
+  osg::ref_ptr<osg::Geode> geodeSolid = new osg::Geode();
+  geodeSolid->setName(pooled->getChild(0)->getName());
+  geodeSolid->addDrawable(copySharedGeometry(*pooledSolid, d.color_));
+  sv.addChild(geodeSolid.get());
+
+  // opaque group is either a pyramid outline that reads the shared vertices, or a wireframe that shares them
+  osg::Group* pooledOpaque = opaqueGroup(pooled.get());
+  if (pooledOpaque != nullptr)
+  {
+    const svPyramidOutline* pooledOutline = dynamic_cast<const svPyramidOutline*>(pooledOpaque);
+    if (pooledOutline)
+      pooledOutline->clone(sv)->setColor(d.color_);
+    else if (pooledOpaque->getNumChildren() == 1 && pooledOpaque->getChild(0)->asGeometry())
+    {
+      osg::Vec4f opaqueColor = d.color_;
+      opaqueColor.a() = 1.0f;
+      osg::Group* groupWire = new osg::Group();
+      groupWire->addChild(copySharedGeometry(*pooledOpaque->getChild(0)->asGeometry(), opaqueColor));
+      sv.addChild(groupWire);
+    }
+    else
+    {
+      // opaque group contents must be kept in sync with processWireframe_ and svPyramidFactory
+      assert(0);
+    }
+  }
+
+  // Turn off backface culling - we want to see the entire volume
+  sv.getOrCreateStateSet()->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
+
+  updateLighting(&sv, d.lightingEnabled_);
+  updateBlending(&sv, d.blendingEnabled_);
+  updateStippling(&sv, ((SVData::DRAW_MODE_STIPPLE & d.drawMode_) == SVData::DRAW_MODE_STIPPLE));
+}
+
+bool SVFactory::isShared(const SphericalVolume* sv)
+{
+  return sv != nullptr && sv->pooledVolume_.valid();
+}
+
+unsigned int SVFactory::poolHits()
+{
+  return svPool().hits;
+}
+
+unsigned int SVFactory::poolMisses()
+{
+  return svPool().misses;
+}
+
+unsigned int SVFactory::poolSize()
+{
+  unsigned int size = 0;
+  for (const auto& entry : svPool().volumes)
+  {
+    if (entry.second.valid())
+      ++size;
+  }
+  return size;
+}
+
+void SVFactory::resetPoolStatistics()
+{
+  svPool().hits = 0;
+  svPool().misses = 0;
+}
+
+void SVFactory::detach_(SphericalVolume* sv)
+{
+  if (!isShared(sv))
+    return;
+  sv->pooledVolume_ = nullptr;
+
+  osg::Geometry* geom = SVFactory::solidGeometry(sv);
+  if (geom == nullptr)
+    return;
+  const osg::Vec3Array* sharedVerts = static_cast<const osg::Vec3Array*>(geom->getVertexArray());
+  const osg::Vec3Array* sharedNormals = static_cast<const osg::Vec3Array*>(geom->getNormalArray());
+  const SVMetaContainer* sharedMeta = static_cast<const SVMetaContainer*>(geom->getUserData());
+  if (sharedVerts == nullptr || sharedNormals == nullptr || sharedMeta == nullptr)
+  {
+    // Assertion failure means internal consistency error
+    assert(0);
+    return;
+  }
+
+  // private copies, in their own buffer object
+  osg::VertexBufferObject* vbo = new osg::VertexBufferObject();
+  osg::Vec3Array* verts = new osg::Vec3Array(*sharedVerts, osg::CopyOp::DEEP_COPY_ALL);
+  verts->setVertexBufferObject(vbo);
+  osg::Vec3Array* normals = new osg::Vec3Array(*sharedNormals, osg::CopyOp::DEEP_COPY_ALL);
+  normals->setVertexBufferObject(vbo);
+  geom->setVertexArray(verts);
+  geom->setNormalArray(normals);
+  geom->setUserData(new SVMetaContainer(*sharedMeta));
+
+  osg::Group* opaque = SVFactory::opaqueGroup(sv);
+  if (opaque == nullptr)
+    return;
+  svPyramidOutline* pyramidOutline = dynamic_cast<svPyramidOutline*>(opaque);
+  if (pyramidOutline)
+  {
+    pyramidOutline->setVertexArray(verts);
+    return;
+  }
+  // wireframe geometry shares the solid geometry's vertex data
+  osg::Geometry* wireframe = (opaque->getNumChildren() == 1) ? opaque->getChild(0)->asGeometry() : nullptr;
+  if (wireframe)
+  {
+    wireframe->setVertexArray(verts);
+    wireframe->setNormalArray(normals);
+  }
+}
+
 void SVFactory::processWireframe_(SphericalVolume* sv, int drawMode)
 {
   if (SVData::DRAW_MODE_WIRE & drawMode)
@@ -1324,6 +1571,8 @@ void SVFactory::updateNearRange(SphericalVolume* sv, double nearRange)
     assert(0);
     return;
   }
+  // copy shared vertex data before modifying it
+  detach_(sv);
   osg::Vec3Array* verts = static_cast<osg::Vec3Array*>(geom->getVertexArray());
   // Assertion failure means internal consistency error, or caller has inconsistent input
   assert(verts);
@@ -1355,6 +1604,8 @@ void SVFactory::updateFarRange(SphericalVolume* sv, double farRange)
     assert(0);
     return;
   }
+  // copy shared vertex data before modifying it
+  detach_(sv);
   osg::Vec3Array* verts = static_cast<osg::Vec3Array*>(geom->getVertexArray());
   // Assertion failure means internal consistency error, or caller has inconsistent input
   assert(verts);
@@ -1386,6 +1637,21 @@ int SVFactory::updateHorizAngle(SphericalVolume* sv, double newAngleRad)
     assert(0);
     return 1;
   }
+  if (isShared(sv))
+  {
+    // nothing to do for an unchanged (clamped) angle; otherwise copy shared vertex data before modifying it
+    const SVMetaContainer* sharedMeta = static_cast<const SVMetaContainer*>(geom->getUserData());
+    if (sharedMeta && !sharedMeta->vertMeta_.empty())
+    {
+      const bool isCone = (sharedMeta->vertMeta_[0].usage_ == USAGE_CONEFAR);
+      // representation switch between cone to pyramid - need to rebuild the volume
+      if (isCone && newAngleRad > M_PI)
+        return 1;
+      if (sharedMeta->horizontalAngleRad_ == osg::clampBetween(newAngleRad, (0.01 * simCore::DEG2RAD), (isCone ? M_PI : M_TWOPI)))
+        return 0;
+    }
+    detach_(sv);
+  }
 
   osg::Vec3Array* verts = static_cast<osg::Vec3Array*>(geom->getVertexArray());
   SVMetaContainer* meta = static_cast<SVMetaContainer*>(geom->getUserData());
@@ -1553,6 +1819,14 @@ void SVFactory::updateVertAngle(SphericalVolume* sv, double newAngleRad)
     assert(0);
     return;
   }
+  if (isShared(sv))
+  {
+    // nothing to do for an unchanged (clamped) angle; otherwise copy shared vertex data before modifying it
+    const SVMetaContainer* sharedMeta = static_cast<const SVMetaContainer*>(geom->getUserData());
+    if (sharedMeta && sharedMeta->verticalAngleRad_ == osg::clampBetween(newAngleRad, (0.01 * simCore::DEG2RAD), M_PI))
+      return;
+    detach_(sv);
+  }
   osg::Vec3Array* verts = static_cast<osg::Vec3Array*>(geom->getVertexArray());
   SVMetaContainer* meta = static_cast<SVMetaContainer*>(geom->getUserData());
   osg::Vec3Array* normals = static_cast<osg::Vec3Array*>(geom->getNormalArray());
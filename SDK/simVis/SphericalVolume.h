@@ -44,6 +44,11 @@ class SphericalVolume : public osg::MatrixTransform
 protected:
   /// osg::Referenced-derived
   virtual ~SphericalVolume() {}
+
+private:
+  friend class SVFactory;
+  /// Pooled volume whose vertex data this volume shares; nullptr if this volume owns its vertex data
+  osg::ref_ptr<SphericalVolume> pooledVolume_;
 };
 
 /// Configuration data for creating volumetric geometry for beams and gates
@@ -132,6 +137,23 @@ public:
   static SphericalVolume* createNode(const SVData &data, const osg::Vec3& dir = osg::Y_AXIS);
   /// create a node visualizing the spherical volume given in 'data'
   static void createNode(SphericalVolume& sv, const SVData &data, const osg::Vec3& dir = osg::Y_AXIS);
+  /**
+  * Create a node visualizing the spherical volume given in 'data', sharing vertex data with all other pooled
+  * volumes that have identical geometric parameters.  Color, lighting, blending, stippling and the transform
+  * remain per volume.  In-place range and angle updates give the volume its own copy of the vertex data first.
+  */
+  static void createPooledNode(SphericalVolume& sv, const SVData &data, const osg::Vec3& dir = osg::Y_AXIS);
+
+  /// Returns true if the volume currently shares its vertex data with other pooled volumes
+  static bool isShared(const SphericalVolume* sv);
+  /// Number of pooled volumes created from existing geometry since the last reset
+  static unsigned int poolHits();
+  /// Number of pooled volumes that required new geometry since the last reset
+  static unsigned int poolMisses();
+  /// Number of distinct geometries currently in use by pooled volumes
+  static unsigned int poolSize();
+  /// Reset the pool hit and miss counts
+  static void resetPoolStatistics();
 
   /// set lighting
   static void updateLighting(SphericalVolume* sv, bool lighting);
@@ -168,6 +190,8 @@ private:
   static float calcYValue_(double x, double z);
   static void processWireframe_(SphericalVolume* sv, int drawMode);
   static void dirtyBound_(SphericalVolume* sv);
+  /// Give a pooled volume its own copy of the shared vertex data, prior to modifying it
+  static void detach_(SphericalVolume* sv);
   static void updateSideOutlines_(SphericalVolume* sv);
 };
 
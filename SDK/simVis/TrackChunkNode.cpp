@@ -171,6 +171,42 @@ bool TrackChunkNode::getNewestData(osg::Matrix& out_matrix, double& out_time) co
   return true;
 }
 
+unsigned int TrackChunkNode::recolor(double beginTime, double endTime, const std::function<osg::Vec4f(double)>& colorAt)
+{
+  unsigned int numRecolored = 0;
+  for (unsigned int i = offset_; i < offset_ + count_; ++i)
+  {
+    if (times_[i] < beginTime)
+      continue;
+    // times are in increasing order
+    if (times_[i] > endTime)
+      break;
+    setPointColor_(i, colorAt(times_[i]));
+    ++numRecolored;
+  }
+  return numRecolored;
+}
+
+void TrackChunkNode::setPointColor_(unsigned int i, const osg::Vec4& color)
+{
+  if (mode_ == simData::TrackPrefs_Mode_POINT)
+  {
+    centerPoints_->setColor(i, color);
+    return;
+  }
+  centerLine_->setColor(i, color);
+  if (mode_ == simData::TrackPrefs_Mode_BRIDGE)
+  {
+    drop_->setColor(2*i, color);
+    drop_->setColor(2*i+1, color);
+  }
+  else if (mode_ == simData::TrackPrefs_Mode_RIBBON)
+  {
+    for (unsigned int c = 0; c < 6; ++c)
+      ribbon_->setColor(6*i+c, color);
+  }
+}
+
 /// allocate the graphical elements for this chunk.
 void TrackChunkNode::allocate_()
 {
@@ -23,6 +23,7 @@
 #ifndef SIMVIS_TRACK_CHUNK_NODE_H
 #define SIMVIS_TRACK_CHUNK_NODE_H
 
+#include <functional>
 #include "osg/ref_ptr"
 #include "osgEarth/LineDrawable"
 #include "osgEarth/PointDrawable"
@@ -154,6 +155,15 @@ public:
   */
   bool getNewestData(osg::Matrix& out_matrix, double& out_time) const;
 
+  /**
+  * Changes the color of existing points with times in [beginTime, endTime], in increasing time order
+  * @param beginTime earliest point time to recolor
+  * @param endTime latest point time to recolor
+  * @param colorAt returns the color for a point time
+  * @return number of points recolored
+  */
+  unsigned int recolor(double beginTime, double endTime, const std::function<osg::Vec4f(double)>& colorAt);
+
   /** Return the proper library name */
   virtual const char* libraryName() const { return "simVis"; }
 
@@ -180,6 +190,8 @@ private:
   void appendPointLine_(unsigned int i, const osg::Vec3f& local, const osg::Vec4& color);
   /// Appends a new bridge element to each geometry set.
   void appendBridge_(unsigned int i, const osg::Vec3f& local, const osg::Vec3d& world, const osg::Vec4& color);
+  /// Sets the color of every vertex belonging to point i
+  void setPointColor_(unsigned int i, const osg::Vec4& color);
   /// Appends a new ribbon element to each geometry set.
   void appendRibbon_(unsigned int i, const osg::Matrixd& localMatrix, const osg::Vec4& color, const osg::Vec2& hostBounds);
 
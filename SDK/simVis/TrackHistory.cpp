@@ -21,15 +21,19 @@
  *
  */
 #include <cassert>
+#include <cmath>
+#include <limits>
 #include "osg/Depth"
 #include "osgEarth/Capabilities"
 #include "osgEarth/GLUtils"
 #include "osgEarth/Horizon"
+#include "osgEarth/NodeUtils"
 #include "osgEarth/LineDrawable"
 #include "osgEarth/Registry"
 #include "osgEarth/VirtualProgram"
 
 #include "simNotify/Notify.h"
+#include "simCore/Calc/Math.h"
 #include "simData/DataTable.h"
 #include "simVis/Constants.h"
 #include "simVis/Locator.h"
@@ -69,6 +73,7 @@ public:
     if (table != nullptr && table->tableId() == parent_.tableId_)
     {
       parent_.tableId_ = 0;
+      parent_.colorCursor_.setColumn(nullptr);
       table->removeObserver(parent_.colorChangeObserver_);
     }
   }
@@ -84,16 +89,29 @@ public:
     : parent_(parent)
   {}
 
-  virtual void onAddColumn(simData::DataTable& table, const simData::TableColumn& column) {}
+  virtual void onAddColumn(simData::DataTable& table, const simData::TableColumn& column)
+  {
+    // the color column is normally added after the table
+    if (column.name() == simData::INTERNAL_TRACK_HISTORY_COLOR_COLUMN)
+      parent_.colorCursor_.setColumn(&column);
+  }
 
   virtual void onAddRow(simData::DataTable& table, const simData::TableRow& row)
   {
+    parent_.colorCursor_.invalidate();
     parent_.checkColorHistoryChange_(table, row);
   }
 
-  virtual void onPreRemoveColumn(simData::DataTable& table, const simData::TableColumn& column) {}
+  virtual void onPreRemoveColumn(simData::DataTable& table, const simData::TableColumn& column)
+  {
+    if (column.name() == simData::INTERNAL_TRACK_HISTORY_COLOR_COLUMN)
+      parent_.colorCursor_.setColumn(nullptr);
+  }
 
-  virtual void onPreRemoveRow(simData::DataTable& table, double rowTime) {}
+  virtual void onPreRemoveRow(simData::DataTable& table, double rowTime)
+  {
+    parent_.colorCursor_.invalidate();
+  }
 
 private:
   TrackHistoryNode& parent_;
@@ -101,6 +119,78 @@ private:
 
 //----------------------------------------------------------------------------
 
+TrackColorCursor::TrackColorCursor(const osg::Vec4f& defaultColor)
+  : column_(nullptr),
+  defaultColor_(defaultColor),
+  color_(defaultColor),
+  validBegin_(0.0),
+  validEnd_(0.0),
+  numSearches_(0)
+{
+  invalidate();
+}
+
+void TrackColorCursor::setColumn(const simData::TableColumn* column)
+{
+  column_ = column;
+  invalidate();
+}
+
+void TrackColorCursor::invalidate()
+{
+  // empty range forces a search on the next lookup
+  validBegin_ = std::numeric_limits<double>::max();
+  validEnd_ = -std::numeric_limits<double>::max();
+}
+
+osg::Vec4f TrackColorCursor::colorAt(double time)
+{
+  // time may be negative in reverse clock mode, so alway adjust to normal time
+  time = fabs(time);
+  if (time >= validBegin_ && time < validEnd_)
+    return color_;
+
+  if (column_ == nullptr)
+  {
+    color_ = defaultColor_;
+    validBegin_ = -std::numeric_limits<double>::max();
+    validEnd_ = std::numeric_limits<double>::max();
+    return color_;
+  }
+
+  ++numSearches_;
+  simData::TableColumn::Iterator iter = column_->findAtOrBeforeTime(time);
+  if (!iter.hasNext())
+  {
+    // before the first row; default color applies up to the first row, if any
+    color_ = defaultColor_;
+    validBegin_ = -std::numeric_limits<double>::max();
+    simData::TableColumn::Iterator first = column_->begin();
+    validEnd_ = first.hasNext() ? first.peekNext()->time() : std::numeric_limits<double>::max();
+    return color_;
+  }
+
+  const simData::TableColumn::IteratorDataPtr data = iter.next();
+  uint32_t color;
+  if (data->getValue(color).isError())
+  {
+    assert(0); // getValue failed, but hasNext claims it exists
+    invalidate();
+    return defaultColor_;
+  }
+  color_ = simVis::Color(color, simVis::Color::RGBA);
+  validBegin_ = data->time();
+  validEnd_ = iter.hasNext() ? iter.peekNext()->time() : std::numeric_limits<double>::max();
+  return color_;
+}
+
+unsigned int TrackColorCursor::numSearches() const
+{
+  return numSearches_;
+}
+
+//----------------------------------------------------------------------------
+
 TrackHistoryNode::TrackHistoryNode(const simData::DataStore& ds, Locator* parentLocator, PlatformTspiFilterManager& platformTspiFilterManager, simData::ObjectId entityId)
   : ds_(ds),
   supportsShaders_(osgEarth::Registry::capabilities().supportsGLSL(3.3f)),
@@ -118,7 +208,13 @@ TrackHistoryNode::TrackHistoryNode(const simData::DataStore& ds, Locator* parent
   entityId_(entityId),
   tableId_(0),
   currentPointChunk_(nullptr),
-  parentLocator_(parentLocator)
+  parentLocator_(parentLocator),
+  colorCursor_(defaultColor_),
+  colorChangePending_(false),
+  colorChangeBegin_(0.0),
+  colorChangeEnd_(0.0),
+  numResets_(0),
+  numRecoloredPoints_(0)
 {
   updateSliceBase_ = ds_.platformUpdateSlice(entityId);
   assert(updateSliceBase_); // should be a valid update slice before track history is created
@@ -172,6 +268,35 @@ void TrackHistoryNode::reset()
   chunkGroup_ = new osg::Group();
   this->addChild(chunkGroup_);
   currentPointChunk_ = nullptr;
+  colorCursor_.invalidate();
+  // a rebuild picks up every pending color change
+  if (colorChangePending_)
+  {
+    colorChangePending_ = false;
+    ADJUST_UPDATE_TRAV_COUNT(this, -1);
+  }
+  ++numResets_;
+}
+
+void TrackHistoryNode::traverse(osg::NodeVisitor& nv)
+{
+  if (colorChangePending_ && nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
+  {
+    applyColorChanges_();
+    colorChangePending_ = false;
+    ADJUST_UPDATE_TRAV_COUNT(this, -1);
+  }
+  osg::Group::traverse(nv);
+}
+
+unsigned int TrackHistoryNode::numResets() const
+{
+  return numResets_;
+}
+
+unsigned int TrackHistoryNode::numRecoloredPoints() const
+{
+  return numRecoloredPoints_;
 }
 
 void TrackHistoryNode::checkColorHistoryChange_(const simData::DataTable& table, const simData::TableRow& row)
@@ -192,15 +317,55 @@ void TrackHistoryNode::checkColorHistoryChange_(const simData::DataTable& table,
   if (updateSlice == nullptr || updateSlice->current() == nullptr)
     return;
 
-  // if this row is not in the span of our slice, don't bother to reset
+  // if this row is not in the span of our slice, don't bother to recolor
   if (row.time() > updateSlice->current()->time() || row.time() < updateSlice->firstTime())
     return;
 
-  // a track history color changed, rebuild the history points
-  // NOTE: may want to queue up this reset request and execute it later, maybe using an OSG fire-once callback,
-  // to mitigate performance when many track color commands are merged in
-  reset();
-  update();
+  // the new color applies until the next color change
+  double endTime = std::numeric_limits<double>::max();
+  simData::TableColumn::Iterator next = col->upper_bound(row.time());
+  if (next.hasNext())
+    endTime = next.peekNext()->time();
+
+  // queue the recolor for the next update traversal, merging with other changes from this frame
+  if (!colorChangePending_)
+  {
+    colorChangePending_ = true;
+    colorChangeBegin_ = row.time();
+    colorChangeEnd_ = endTime;
+    ADJUST_UPDATE_TRAV_COUNT(this, 1);
+  }
+  else
+  {
+    colorChangeBegin_ = simCore::sdkMin(colorChangeBegin_, row.time());
+    colorChangeEnd_ = simCore::sdkMax(colorChangeEnd_, endTime);
+  }
+}
+
+void TrackHistoryNode::applyColorChanges_()
+{
+  // convert the update time range to draw times, which are negated in reverse mode
+  const double drawBegin = simCore::sdkMin(toDrawTime_(colorChangeBegin_), toDrawTime_(colorChangeEnd_));
+  const double drawEnd = simCore::sdkMax(toDrawTime_(colorChangeBegin_), toDrawTime_(colorChangeEnd_));
+  const std::function<osg::Vec4f(double)> colorAt = [this](double time) { return historyColorAtTime_(time); };
+
+  for (unsigned int k = 0; k < chunkGroup_->getNumChildren(); ++k)
+  {
+    TrackChunkNode* chunk = static_cast<TrackChunkNode*>(chunkGroup_->getChild(k));
+    // chunks are in draw time order
+    if (chunk->size() == 0 || chunk->getEndTime() < drawBegin)
+      continue;
+    if (chunk->getBeginTime() > drawEnd)
+      break;
+    numRecoloredPoints_ += chunk->recolor(drawBegin, drawEnd, colorAt);
+  }
+  if (currentPointChunk_.valid())
+    numRecoloredPoints_ += currentPointChunk_->recolor(drawBegin, drawEnd, colorAt);
+
+  // drop line follows the color at the current time
+  const simData::PlatformUpdateSlice* updateSlice = static_cast<const simData::PlatformUpdateSlice*>(updateSliceBase_);
+  if (dropVertsDrawable_.valid() && updateSlice != nullptr && updateSlice->current() != nullptr)
+    dropVertsDrawable_->setColor(historyColorAtTime_(updateSlice->current()->time()));
 }
 
 /**
@@ -228,39 +393,8 @@ osg::Vec4f TrackHistoryNode::historyColorAtTime_(double time)
   if (!supportsShaders_ && lastOverrideColor_.a() > 0.f)
     return lastOverrideColor_;
 
-  // time may be negative in reverse clock mode, so alway adjust to normal time
-  if (time < 0)
-    time *= -1;
-  if (tableId_ == 0)
-    return defaultColor_;
-
-  // find the table
-  // use the tableId_ if we have it
-  simData::DataTable* table = ds_.dataTableManager().getTable(tableId_);
-  // no color history table, simply return the default color
-  if (table == nullptr)
-  {
-    assert(0); // table id is no longer valid, somehow the table got removed
-    return defaultColor_;
-  }
-  simData::TableColumn* column = table->column(simData::INTERNAL_TRACK_HISTORY_COLOR_COLUMN);
-  if (column == nullptr)
-  {
-    assert(0); // found the table, but missing the expected data column
-    return defaultColor_;
-  }
-
-  simData::TableColumn::Iterator iter = column->findAtOrBeforeTime(time);
-  if (!iter.hasNext())
-    return defaultColor_;
-
-  uint32_t color;
-  if (iter.next()->getValue(color).isError())
-  {
-    assert(0); // getValue failed, but hasNext claims it exists
-    return defaultColor_;
-  }
-  return simVis::Color(color, simVis::Color::RGBA);
+  // the cursor holds the color column and only searches it when time moves past the cached color
+  return colorCursor_.colorAt(time);
 }
 
 void TrackHistoryNode::initializeTableId_()
@@ -273,6 +407,8 @@ void TrackHistoryNode::initializeTableId_()
     return;
   tableId_ = table->tableId();
   assert(tableId_ > 0); // a table was created with an invalid table id
+  // column may be nullptr here if it has not been added yet; see ColorChangeObserver::onAddColumn
+  colorCursor_.setColumn(table->column(simData::INTERNAL_TRACK_HISTORY_COLOR_COLUMN));
   colorChangeObserver_.reset(new ColorChangeObserver(*this));
   table->addObserver(colorChangeObserver_);
 }
@@ -664,6 +800,9 @@ void TrackHistoryNode::update()
   if (lastPlatformPrefs_.trackprefs().tracklength() == 0)
     return;
 
+  // color rows may have been flushed or limited since the last update
+  colorCursor_.invalidate();
+
   const simData::PlatformUpdateSlice* updateSlice = static_cast<const simData::PlatformUpdateSlice*>(updateSliceBase_);
   if (updateSlice == nullptr)
   {
@@ -50,6 +50,45 @@ class Locator;
 class TrackChunkNode;
 class PlatformTspiFilterManager;
 
+/**
+ * Looks up track history colors from the internal color column while walking track points in time order.
+ * The color found by a search remains valid until the next row in the column, so a run of points between
+ * two color changes costs a single search instead of one per point.
+ */
+class SDKVIS_EXPORT TrackColorCursor
+{
+public:
+  /**
+   * Constructor
+   * @param defaultColor Color for times before the first row, or when there is no column
+   */
+  explicit TrackColorCursor(const osg::Vec4f& defaultColor);
+
+  /** Changes the column to read, which may be nullptr; the column must outlive its use here */
+  void setColumn(const simData::TableColumn* column);
+  /** Discards the cached color; call when rows in the column change */
+  void invalidate();
+
+  /**
+   * Color at the given time.  Negative (reverse mode draw) times are treated as positive.
+   * @param time Time in seconds
+   * @return Color in the column at or before the given time, or the default color
+   */
+  osg::Vec4f colorAt(double time);
+
+  /** Number of column searches performed, for testing and diagnostics */
+  unsigned int numSearches() const;
+
+private:
+  const simData::TableColumn* column_;
+  osg::Vec4f defaultColor_;
+  /// cached color, valid for times in [validBegin_, validEnd_)
+  osg::Vec4f color_;
+  double validBegin_;
+  double validEnd_;
+  unsigned int numSearches_;
+};
+
 /**
   * Scene graph node that depicts a track history trail for a platform
   */
@@ -101,6 +140,14 @@ public:
     */
   void setPrefs(const simData::PlatformPrefs& platformPrefs, const simData::PlatformProperties& platformProps, bool force = false);
 
+  /** Applies pending color history changes during the update traversal */
+  virtual void traverse(osg::NodeVisitor& nv);
+
+  /** Number of full rebuilds, i.e. calls to reset(); for testing and diagnostics */
+  unsigned int numResets() const;
+  /** Number of points recolored in place after color history changes; for testing and diagnostics */
+  unsigned int numRecoloredPoints() const;
+
   /** Return the proper library name */
   virtual const char* libraryName() const { return "simVis"; }
 
@@ -120,12 +167,16 @@ private: // methods
   TrackHistoryNode(const TrackHistoryNode&);
 
   /**
-  * If the color history change is within the time span of the currently displayed track history, redraw all history points
+  * If the color history change is within the time span of the currently displayed track history, queue the
+  * affected time range for recoloring in the next update traversal.  Multiple changes merge into one range.
   * @param table  color track history data table
   * @param row  row that was added to the color track history data table
   */
   void checkColorHistoryChange_(const simData::DataTable& table, const simData::TableRow& row);
 
+  /** Recolors existing points in the pending color change range */
+  void applyColorChanges_();
+
   /**
   * Return a chunk to which you can add a new point
   * @return chunk that can accept a new point, or nullptr if a new one needs to be created
@@ -259,6 +310,15 @@ private: // data
   simData::DataTable::TableObserverPtr colorChangeObserver_;
   /// observer for when the internal track color data table is added/removed
   simData::DataTableManager::ManagerObserverPtr colorTableObserver_;
+  /// walks the track color column in step with the points being added
+  TrackColorCursor colorCursor_;
+  /// true if a color history change is waiting for the update traversal
+  bool colorChangePending_;
+  /// update time range of pending color history changes
+  double colorChangeBegin_;
+  double colorChangeEnd_;
+  unsigned int numResets_;
+  unsigned int numRecoloredPoints_;
 };
 
 } // namespace simVis
@@ -20,6 +20,7 @@
  * disclose, or release this software.
  *
  */
+#include <vector>
 #include "osg/Geode"
 #include "osg/Geometry"
 
@@ -39,17 +40,27 @@ namespace simVis
 {
 
 // --------------------------------------------------------------------------
-VelocityVector::VelocityVector(Locator* hostLocator, float lineWidth)
+VelocityVector::VelocityVector(Locator* hostLocator, float lineWidth, LineBatchGroup* lineBatches)
   : LocatorNode(new Locator(hostLocator, Locator::COMP_POSITION)),
     forceRebuild_(true),
-    lineWidth_(lineWidth)
+    lineWidth_(lineWidth),
+    lineBatchSlot_(LineBatch::INVALID_SLOT)
 {
   setName("VelocityVector");
   setNodeMask(DISPLAY_MASK_NONE);
+  if (lineBatches)
+  {
+    // This node supplies the frame and visibility; the batch draws the line
+    lineBatch_ = lineBatches->getOrCreate(lineWidth_, DISPLAY_MASK_PLATFORM);
+    lineBatchSlot_ = lineBatch_->allocate(1, this, this);
+  }
 }
 
 VelocityVector::~VelocityVector()
 {
+  osg::ref_ptr<LineBatch> lineBatch;
+  if (lineBatch_.lock(lineBatch))
+    lineBatch->release(lineBatchSlot_);
 }
 
 int VelocityVector::rebuild_(const simData::PlatformPrefs& prefs)
@@ -64,6 +75,18 @@ int VelocityVector::rebuild_(const simData::PlatformPrefs& prefs)
     return 1;
   }
 
+  osg::ref_ptr<LineBatch> lineBatch;
+  if (lineBatch_.lock(lineBatch))
+  {
+    // Batched lines are updated in place instead of rebuilt
+    std::vector<osg::Vec3f> points(2);
+    points[1] = velocityEndPoint_(prefs);
+    lineBatch->setSegments(lineBatchSlot_, points);
+    lineBatch->setColor(lineBatchSlot_, simVis::Color(prefs.velveccolor(), simVis::Color::RGBA));
+    setNodeMask(DISPLAY_MASK_PLATFORM);
+    return 0;
+  }
+
   osg::ref_ptr<osgEarth::LineGroup> lineGroup = new osgEarth::LineGroup();
   createVelocityVector_(prefs, lineGroup.get());
 
@@ -138,6 +161,9 @@ void VelocityVector::setPrefs(bool draw, const simData::PlatformPrefs& prefs, bo
       {
         SetLineColorVisitor setLineColor(simVis::Color(prefs.velveccolor(), simVis::Color::RGBA));
         accept(setLineColor);
+        osg::ref_ptr<LineBatch> lineBatch;
+        if (lineBatch_.lock(lineBatch))
+          lineBatch->setColor(lineBatchSlot_, simVis::Color(prefs.velveccolor(), simVis::Color::RGBA));
       }
 
       setNodeMask(DISPLAY_MASK_PLATFORM);
@@ -161,6 +187,20 @@ void VelocityVector::createVelocityVector_(const simData::PlatformPrefs& prefs,
   osg::ref_ptr<osgEarth::LineDrawable> geom = new osgEarth::LineDrawable(GL_LINES);
   geom->setName("simVis::VelocityVector");
 
+  // draw velocity vector
+  geom->allocate(2);
+  geom->setVertex(0, osg::Vec3());
+  geom->setVertex(1, velocityEndPoint_(prefs));
+  geom->setColor(simVis::Color(prefs.velveccolor(), simVis::Color::RGBA));
+  // set linewidth
+  geom->setLineWidth(lineWidth_);
+
+  // Add the drawable to the geode
+  group->addChild(geom.get());
+}
+
+osg::Vec3f VelocityVector::velocityEndPoint_(const simData::PlatformPrefs& prefs) const
+{
   simCore::Coordinate ecef;
   ecef.setCoordinateSystem(simCore::COORD_SYS_ECEF);
   ecef.setPosition(lastUpdate_.x(), lastUpdate_.y(), lastUpdate_.z());
@@ -190,16 +230,7 @@ void VelocityVector::createVelocityVector_(const simData::PlatformPrefs& prefs,
 
   simCore::v3Scale(scale, velocity, velocity);
 
-  // draw velocity vector
-  geom->allocate(2);
-  geom->setVertex(0, osg::Vec3());
-  geom->setVertex(1, osg::Vec3(velocity.x(), velocity.y(), velocity.z()));
-  geom->setColor(simVis::Color(prefs.velveccolor(), simVis::Color::RGBA));
-  // set linewidth
-  geom->setLineWidth(lineWidth_);
-
-  // Add the drawable to the geode
-  group->addChild(geom.get());
+  return osg::Vec3f(velocity.x(), velocity.y(), velocity.z());
 }
 
 }
@@ -24,8 +24,10 @@
 #define SIMVIS_VELOCITY_VECTOR_H
 
 #include <osg/Group>
+#include "osg/observer_ptr"
 #include "simCore/Common/Common.h"
 #include "simData/DataTypes.h"
+#include "simVis/LineBatch.h"
 #include "simVis/LocatorNode.h"
 
 namespace osg { class Geometry; }
@@ -41,8 +43,10 @@ public:
    * Construct a new velocity vector graphic.  Color will be pulled from prefs.
    * @param hostLocator location of host platform
    * @param lineWidth width of axis vector lines, in pixels
+   * @param lineBatches If non-nullptr, the vector is drawn in the scenario's shared line batch
+   *   for its width instead of in its own geometry
    */
-  explicit VelocityVector(Locator* hostLocator, float lineWidth = 2.0);
+  explicit VelocityVector(Locator* hostLocator, float lineWidth = 2.0, LineBatchGroup* lineBatches = nullptr);
 
   /**
    * Sets new preferences for this object.
@@ -76,10 +80,15 @@ private: // methods
   /// create the velocity vector line
   void createVelocityVector_(const simData::PlatformPrefs& prefs, osg::Group* group) const;
 
+  /// calculates the end point of the velocity vector, relative to the platform position
+  osg::Vec3f velocityEndPoint_(const simData::PlatformPrefs& prefs) const;
+
   simData::PlatformPrefs               lastPrefs_;          ///< last prefs update
   bool                                 forceRebuild_;       ///< flag to force a rebuild
   float                                lineWidth_;          ///< width of velocity vector lines
   simData::PlatformUpdate              lastUpdate_;         ///< Platform location and velocity
+  osg::observer_ptr<LineBatch>         lineBatch_;          ///< shared batch drawing the line, if batched
+  LineBatch::SlotId                    lineBatchSlot_;      ///< slot in lineBatch_
 };
 
 } // namespace simVis
@@ -23,8 +23,14 @@
 #include <algorithm>
 #include <cstring>
 #include <iterator>
+#include "OpenThreads/Thread"
+#include "osg/Timer"
+#include "osgDB/DatabasePager"
+#include "osgUtil/CullVisitor"
+#include "osgEarth/Threading"
 #include "simNotify/Notify.h"
 #include "simCore/Calc/Math.h"
+#include "simData/DataStore.h"
 #include "simVis/Gl3Utils.h"
 #include "simVis/Registry.h"
 #include "simVis/ViewManager.h"
@@ -32,6 +38,24 @@
 
 namespace
 {
+  /**
+   * Returns true if osgEarth has background jobs pending or running.  The terrain engine and layers load
+   * tiles through osgEarth's own job system rather than the osgDB::DatabasePager, and merge the results into
+   * the scene during the update traversal.
+   */
+  bool osgEarthJobsActive()
+  {
+#if OSGEARTH_SOVERSION >= 150
+    const jobs::metrics_t* metrics = jobs::get_metrics();
+    return metrics != nullptr && (metrics->total_pending() > 0 || metrics->total_running() > 0);
+#elif OSGEARTH_SOVERSION >= 120
+    const osgEarth::Threading::JobArena::Metrics& metrics = osgEarth::Threading::JobArena::allMetrics();
+    return metrics.totalJobsPending() > 0 || metrics.totalJobsRunning() > 0;
+#else
+    return false;
+#endif
+  }
+
   /**
    * GC realize operation that will propagate the initial window size
    * to all pre-configured views.
@@ -103,6 +127,9 @@ namespace
     int height_;
     osg::View* resizeView_;
   };
+
+  /** How long run() sleeps between checks for changes when no frame is needed, in seconds */
+  const double IDLE_POLL_INTERVAL = 0.01;
 }
 
 #if 0
@@ -203,16 +230,51 @@ AddEventHandlerToViews::~AddEventHandlerToViews()
 
 //........................................................................
 
+/** Marks the scene dirty on any data store change */
+class ViewManager::DataStoreListener : public simData::DataStore::DefaultListener
+{
+public:
+  explicit DataStoreListener(ViewManager& viewManager)
+    : viewManager_(&viewManager)
+  {
+  }
+
+  virtual void onAddEntity(simData::DataStore* source, simData::ObjectId newId, simData::ObjectType ot) override { dirty_(); }
+  virtual void onRemoveEntity(simData::DataStore* source, simData::ObjectId removedId, simData::ObjectType ot) override { dirty_(); }
+  virtual void onPrefsChange(simData::DataStore* source, simData::ObjectId id) override { dirty_(); }
+  virtual void onPropertiesChange(simData::DataStore* source, simData::ObjectId id) override { dirty_(); }
+  virtual void onChange(simData::DataStore* source) override { dirty_(); }
+  virtual void onCategoryDataChange(simData::DataStore* source, simData::ObjectId changedId, simData::ObjectType ot) override { dirty_(); }
+  virtual void onNameChange(simData::DataStore* source, simData::ObjectId changeId) override { dirty_(); }
+  virtual void onFlush(simData::DataStore* source, simData::ObjectId flushedId) override { dirty_(); }
+  virtual void onScenarioDelete(simData::DataStore* source) override { dirty_(); }
+
+private:
+  void dirty_()
+  {
+    osg::ref_ptr<ViewManager> viewManager;
+    if (viewManager_.lock(viewManager))
+      viewManager->redrawScheduler().requestRedraw(RedrawScheduler::SOURCE_DATA_STORE);
+  }
+
+  osg::observer_ptr<ViewManager> viewManager_;
+};
+
+//........................................................................
+
 ViewManager::ViewManager()
   : fatalRenderFlag_(false),
-    firstFrame_(true)
+    firstFrame_(true),
+    renderOnDemand_(false)
 {
   init_();
 }
 
 
 ViewManager::ViewManager(osg::ArgumentParser& args)
-  : fatalRenderFlag_(false)
+  : fatalRenderFlag_(false),
+    firstFrame_(true),
+    renderOnDemand_(false)
 {
   init_(args);
 }
@@ -220,6 +282,8 @@ ViewManager::ViewManager(osg::ArgumentParser& args)
 
 ViewManager::~ViewManager()
 {
+  for (const auto& dataStoreListener : dataStores_)
+    dataStoreListener.first->removeListener(dataStoreListener.second);
 }
 
 
@@ -421,7 +485,14 @@ int ViewManager::frame(double simulationTime)
   if (fabs(simulationTime) < MINIMUM_TIME)
     simulationTime = (simulationTime < 0 ? -MINIMUM_TIME : MINIMUM_TIME);
 
-  if (viewer_->getRunFrameScheme() == osgViewer::ViewerBase::CONTINUOUS ||
+  if (renderOnDemand_ && !needsFrame_(simulationTime))
+  {
+    redrawScheduler_.frameSkipped();
+    return 0;
+  }
+
+  // Render on demand does its own checks; the viewer's check always passes with entities needing update traversal
+  if (renderOnDemand_ || viewer_->getRunFrameScheme() == osgViewer::ViewerBase::CONTINUOUS ||
     viewer_->checkNeedToDoFrame())
   {
     try
@@ -454,6 +525,11 @@ int ViewManager::frame(double simulationTime)
 
 
       fatalRenderFlag_ = false;
+      if (renderOnDemand_)
+      {
+        getCameraMatrices_(lastCameraMatrices_);
+        redrawScheduler_.frameDrawn(osg::Timer::instance()->time_s());
+      }
     }
     catch (const std::exception& exc)
     {
@@ -471,7 +547,145 @@ int ViewManager::frame(double simulationTime)
 
 int ViewManager::run()
 {
-  return viewer_->ViewerBase::run();
+  if (!renderOnDemand_)
+    return viewer_->ViewerBase::run();
+
+  // Same loop as ViewerBase::run(), going through frame() so that unneeded frames are skipped
+  if (!viewer_->isRealized())
+    viewer_->realize();
+  while (!viewer_->done())
+  {
+    const double startTime = osg::Timer::instance()->time_s();
+    const uint64_t numDrawn = redrawScheduler_.numFramesDrawn();
+    if (frame(USE_REFERENCE_TIME) != 0)
+      return 1;
+
+    double sleepTime = 0.0;
+    if (redrawScheduler_.numFramesDrawn() == numDrawn)
+    {
+      // Nothing to draw; check for changes again shortly, or at the idle frame if that is sooner
+      sleepTime = IDLE_POLL_INTERVAL;
+      const double untilIdleFrame = redrawScheduler_.timeUntilIdleFrame(osg::Timer::instance()->time_s());
+      if (untilIdleFrame >= 0.0 && untilIdleFrame < sleepTime)
+        sleepTime = untilIdleFrame;
+    }
+    else if (viewer_->getRunMaxFrameRate() > 0.0)
+      sleepTime = 1.0 / viewer_->getRunMaxFrameRate() - (osg::Timer::instance()->time_s() - startTime);
+
+    if (sleepTime > 0.0)
+      OpenThreads::Thread::microSleep(static_cast<unsigned int>(sleepTime * 1e6));
+  }
+  return 0;
+}
+
+void ViewManager::setRenderOnDemand(bool onDemand)
+{
+  if (renderOnDemand_ == onDemand)
+    return;
+  renderOnDemand_ = onDemand;
+  // Start with a frame so that everything since the last frame shows up
+  redrawScheduler_.requestRedraw(RedrawScheduler::SOURCE_APPLICATION);
+  lastCameraMatrices_.clear();
+}
+
+bool ViewManager::renderOnDemand() const
+{
+  return renderOnDemand_;
+}
+
+RedrawScheduler& ViewManager::redrawScheduler()
+{
+  return redrawScheduler_;
+}
+
+void ViewManager::requestAnimationFrame(osg::NodeVisitor& nv)
+{
+  const osgUtil::CullVisitor* cv = dynamic_cast<const osgUtil::CullVisitor*>(&nv);
+  if (cv == nullptr || cv->getCurrentCamera() == nullptr)
+    return;
+  const simVis::View* view = dynamic_cast<const simVis::View*>(cv->getCurrentCamera()->getView());
+  ViewManager* viewManager = (view ? view->getViewManager() : nullptr);
+  if (viewManager)
+    viewManager->redrawScheduler().requestNextFrame(RedrawScheduler::SOURCE_ANIMATION);
+}
+
+void ViewManager::addDataStore(simData::DataStore* dataStore)
+{
+  if (dataStore == nullptr)
+    return;
+  for (const auto& dataStoreListener : dataStores_)
+  {
+    if (dataStoreListener.first == dataStore)
+      return;
+  }
+  std::shared_ptr<DataStoreListener> listener(new DataStoreListener(*this));
+  dataStore->addListener(listener);
+  dataStores_.push_back(std::make_pair(dataStore, listener));
+}
+
+void ViewManager::removeDataStore(simData::DataStore* dataStore)
+{
+  for (auto iter = dataStores_.begin(); iter != dataStores_.end(); ++iter)
+  {
+    if (iter->first == dataStore)
+    {
+      dataStore->removeListener(iter->second);
+      dataStores_.erase(iter);
+      return;
+    }
+  }
+}
+
+bool ViewManager::needsFrame_(double simulationTime)
+{
+  redrawScheduler_.setSimulationTime(simulationTime);
+
+  // Input events, and redraws or continuous updates requested by event handlers and manipulators
+  if (viewer_->getRequestRedraw() || viewer_->getRequestContinousUpdate() || viewer_->checkEvents())
+    redrawScheduler_.requestRedraw(RedrawScheduler::SOURCE_INPUT);
+
+  // Paging needs frames to merge its results into the scene; the settle frame merges the last results
+  if (osgEarthJobsActive())
+    redrawScheduler_.requestRedraw(RedrawScheduler::SOURCE_PAGING);
+  else
+  {
+    std::vector<osgViewer::View*> views;
+    viewer_->getViews(views);
+    for (auto* view : views)
+    {
+      const osgDB::DatabasePager* pager = view->getDatabasePager();
+      if (pager && (pager->requiresUpdateSceneGraph() || pager->getRequestsInProgress()))
+      {
+        redrawScheduler_.requestRedraw(RedrawScheduler::SOURCE_PAGING);
+        break;
+      }
+    }
+  }
+
+  // Cameras moved by manipulators or by the application
+  std::vector<osg::Matrixd> cameraMatrices;
+  getCameraMatrices_(cameraMatrices);
+  if (cameraMatrices != lastCameraMatrices_)
+    redrawScheduler_.requestRedraw(RedrawScheduler::SOURCE_CAMERA);
+
+  return firstFrame_ || redrawScheduler_.needsFrame(osg::Timer::instance()->time_s());
+}
+
+void ViewManager::getCameraMatrices_(std::vector<osg::Matrixd>& matrices) const
+{
+  matrices.clear();
+  std::vector<osgViewer::View*> views;
+  viewer_->getViews(views);
+  for (auto* view : views)
+  {
+    const osg::Camera* camera = view->getCamera();
+    if (!camera)
+      continue;
+    // The manipulator's matrix is applied to the camera during the update traversal
+    const osgGA::CameraManipulator* manipulator = view->getCameraManipulator();
+    matrices.push_back(manipulator ? manipulator->getInverseMatrix() : camera->getViewMatrix());
+    matrices.push_back(camera->getProjectionMatrix());
+  }
 }
 
 }
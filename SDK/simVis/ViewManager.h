@@ -25,12 +25,18 @@
 #define SIMVIS_VIEW_MANAGER_H 1
 
 #include <functional>
+#include <memory>
 #include <vector>
 #include "osg/ref_ptr"
 #include "osg/observer_ptr"
 #include "osg/ArgumentParser"
+#include "osg/Matrixd"
 #include "osgViewer/CompositeViewer"
 #include "simCore/Common/Common.h"
+#include "simVis/RedrawScheduler.h"
+
+namespace osg { class NodeVisitor; }
+namespace simData { class DataStore; }
 
 namespace simVis
 {
@@ -204,6 +210,30 @@ public:
   /** Enters a run loop that will automatically call frame() continuously. */
   virtual int run();
 
+  /**
+   * Enables or disables rendering on demand.  When enabled, frame() and run() skip drawing while nothing
+   * changed in the scene, drawing at least once per RedrawScheduler::maxIdleInterval().  Changes are picked
+   * up from the simulation time passed to frame(), camera and manipulator movement, input events and redraw
+   * requests made through the viewer, database paging and osgEarth loading jobs, animations that are drawn
+   * (see requestAnimationFrame()), and data stores added with addDataStore().  Other scene changes need a
+   * call to redrawScheduler().requestRedraw().  Off by default.
+   */
+  void setRenderOnDemand(bool onDemand);
+  /** Returns true if rendering on demand */
+  bool renderOnDemand() const;
+  /** Scheduler that decides which frames to draw when rendering on demand */
+  RedrawScheduler& redrawScheduler();
+  /**
+   * Requests the next frame from the scheduler of the view being culled, for animated nodes.  Call from the
+   * node's cull traversal, so that hidden and culled nodes do not keep views drawing.  No-op for other visitors.
+   */
+  static void requestAnimationFrame(osg::NodeVisitor& nv);
+
+  /** Marks the scene dirty on changes in the data store, for rendering on demand; call removeDataStore() before the data store is deleted */
+  void addDataStore(simData::DataStore* dataStore);
+  /** Stops watching a data store added with addDataStore() */
+  void removeDataStore(simData::DataStore* dataStore);
+
   /** Access the underlying OSG viewer */
   osgViewer::CompositeViewer* getViewer() const { return viewer_.get(); }
 
@@ -214,6 +244,11 @@ private:
   void init_();
   void init_(osg::ArgumentParser&);
 
+  /** Collects changes in the scene sources and returns true if the frame should be drawn */
+  bool needsFrame_(double simulationTime);
+  /** Fills in the view and projection matrices of all cameras */
+  void getCameraMatrices_(std::vector<osg::Matrixd>& matrices) const;
+
   osg::ref_ptr<osgViewer::CompositeViewer> viewer_;
 
   typedef std::vector<osg::ref_ptr<Callback> > Callbacks;
@@ -238,6 +273,14 @@ private:
   bool fatalRenderFlag_;
 
   bool firstFrame_;
+
+  class DataStoreListener;
+  /// Data stores watched for changes, with their listeners
+  std::vector<std::pair<simData::DataStore*, std::shared_ptr<DataStoreListener> > > dataStores_;
+  bool renderOnDemand_;
+  RedrawScheduler redrawScheduler_;
+  /// Camera matrices as of the last frame drawn on demand
+  std::vector<osg::Matrixd> lastCameraMatrices_;
 };
 
 /**
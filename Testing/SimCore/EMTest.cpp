@@ -21,11 +21,15 @@
  *
  */
 #include <iostream>
+#include <vector>
 #include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Math.h"
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/EM/AntennaPattern.h"
+#include "simCore/EM/Decibel.h"
 #include "simCore/EM/Propagation.h"
 #include "simCore/EM/RadarCrossSection.h"
+#include "simCore/Time/Utils.h"
 
 #define EXAMPLE_RCS_FILE                  "fake_rcs_3.rcs"
 
@@ -474,6 +478,116 @@ int testLossToPpf()
   return rv;
 }
 
+int testBatchPropagation()
+{
+  std::cout << "  testBatchPropagation..." << std::endl;
+  int rv = 0;
+  const double ACCURACY_DB = 1e-9;
+
+  // Ranges from a few meters out to 1000 km, with a zero range and a negative range to exercise the guards
+  const size_t count = 1000;
+  std::vector<double> ranges(count);
+  std::vector<double> xmtGains(count);
+  std::vector<double> rcvGains(count);
+  std::vector<double> ppfs(count);
+  std::vector<double> losses(count);
+  for (size_t k = 0; k < count; ++k)
+  {
+    ranges[k] = 5.0 + 1000.0 * k;
+    xmtGains[k] = 30.0 + 0.01 * k;
+    rcvGains[k] = 20.0 - 0.02 * k;
+    ppfs[k] = -20.0 + 0.04 * k;
+    losses[k] = 80.0 + 0.1 * k;
+  }
+  ranges[10] = 0.0;
+  ranges[11] = -2500.0;
+  losses[20] = simCore::SMALL_DB_VAL;
+
+  std::vector<double> out(count);
+  for (int oneWay = 0; oneWay < 2; ++oneWay)
+  {
+    simCore::getRcvdPowerFreeSpace(count, ranges.data(), xmtGains.data(), rcvGains.data(), 5000.0, 10000.0, 9.0, 5.0, oneWay != 0, out.data());
+    // Scalar form asserts on zero range and returns 0
+    rv += SDK_ASSERT(out[10] == 0.0);
+    int mismatches = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (ranges[k] == 0.0)
+        continue;
+      if (!simCore::areEqual(out[k], simCore::getRcvdPowerFreeSpace(ranges[k], 5000.0, 10000.0, xmtGains[k], rcvGains[k], 9.0, 5.0, oneWay != 0), ACCURACY_DB))
+        ++mismatches;
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+
+    // Missing gain arrays mean 0 dB
+    simCore::getRcvdPowerFreeSpace(count, ranges.data(), nullptr, nullptr, 5000.0, 10000.0, 9.0, 5.0, oneWay != 0, out.data());
+    rv += SDK_ASSERT(simCore::areEqual(out[100], simCore::getRcvdPowerFreeSpace(ranges[100], 5000.0, 10000.0, 0.0, 0.0, 9.0, 5.0, oneWay != 0), ACCURACY_DB));
+
+    simCore::getRcvdPowerBlake(count, ranges.data(), ppfs.data(), xmtGains.data(), rcvGains.data(), 3000.0, 2500.0, 1.0, 3.0, oneWay != 0, out.data());
+    mismatches = 0;
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (ranges[k] == 0.0)
+        continue;
+      if (!simCore::areEqual(out[k], simCore::getRcvdPowerBlake(ranges[k], 3000.0, 2500.0, xmtGains[k], rcvGains[k], 1.0, ppfs[k], 3.0, oneWay != 0), ACCURACY_DB))
+        ++mismatches;
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+  }
+
+  // Zero power hits the linear2dB() floor in both forms
+  simCore::getRcvdPowerFreeSpace(count, ranges.data(), xmtGains.data(), nullptr, 5000.0, 0.0, 9.0, 5.0, false, out.data());
+  rv += SDK_ASSERT(simCore::areEqual(out[50], simCore::getRcvdPowerFreeSpace(ranges[50], 5000.0, 0.0, xmtGains[50], 0.0, 9.0, 5.0, false), ACCURACY_DB));
+
+  // SNR keeps the SMALL_DB_VAL guard, and works in place
+  out[0] = simCore::SMALL_DB_VAL;
+  out[1] = -90.0;
+  simCore::getSignalToNoise(2, out.data(), -110.0, out.data());
+  rv += SDK_ASSERT(out[0] == simCore::SMALL_DB_VAL);
+  rv += SDK_ASSERT(simCore::areEqual(out[1], 20.0));
+
+  // PPF, skipping the zero and negative ranges that the scalar form asserts on
+  std::vector<double> ppfOut(count);
+  simCore::lossToPpf(count, ranges.data(), losses.data(), 3000.0, ppfOut.data());
+  int mismatches = 0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (ranges[k] <= 0.0)
+      continue;
+    if (!simCore::areEqual(ppfOut[k], simCore::lossToPpf(ranges[k], 3000.0, losses[k]), ACCURACY_DB))
+      ++mismatches;
+  }
+  rv += SDK_ASSERT(mismatches == 0);
+  rv += SDK_ASSERT(ppfOut[10] == simCore::SMALL_DB_VAL);
+  rv += SDK_ASSERT(ppfOut[11] == simCore::SMALL_DB_VAL);
+  rv += SDK_ASSERT(ppfOut[20] == simCore::SMALL_DB_VAL);
+
+  // Throughput of the array forms against per-point calls, e.g. a 1000 x 100 profile; only when SIMDIS_SDK_BENCHMARK is set
+  if (getenv("SIMDIS_SDK_BENCHMARK") == nullptr)
+    return rv;
+  const int passes = 100;
+  double sum = 0.0;
+  double startTime = simCore::getSystemTime();
+  for (int pass = 0; pass < passes; ++pass)
+  {
+    for (size_t k = 0; k < count; ++k)
+      sum += simCore::getRcvdPowerBlake(5.0 + 1000.0 * k, 3000.0, 2500.0, xmtGains[k], rcvGains[k], 1.0, ppfs[k], 3.0, false);
+  }
+  const double scalarTime = simCore::getSystemTime() - startTime;
+  for (size_t k = 0; k < count; ++k)
+    ranges[k] = 5.0 + 1000.0 * k;
+  startTime = simCore::getSystemTime();
+  for (int pass = 0; pass < passes; ++pass)
+  {
+    simCore::getRcvdPowerBlake(count, ranges.data(), ppfs.data(), xmtGains.data(), rcvGains.data(), 3000.0, 2500.0, 1.0, 3.0, false, out.data());
+    sum -= out[pass];
+  }
+  const double batchTime = simCore::getSystemTime() - startTime;
+  std::cout << "    " << count * passes << " two-way powers: scalar " << scalarTime << " s, batch " << batchTime << " s (" << sum << ")" << std::endl;
+
+  return rv;
+}
+
 int antennaPatternTest(int argc, char* argv[])
 {
   std::string filepath;
@@ -688,6 +802,7 @@ int EMTest(int argc, char* argv[])
   rv += testOneWayRcvdPowerFreeSpace();
   rv += testOneWayFreeSpaceRangeLoss();
   rv += testLossToPpf();
+  rv += testBatchPropagation();
   rv += antennaPatternTest(argc, argv);
 
   std::cout << "EMTests " << ((rv == 0) ? "Passed" : "Failed") << std::endl;
@@ -20,6 +20,10 @@
  * disclose, or release this software.
  *
  */
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Time/TimeClass.h"
 #include "simCore/Time/Utils.h"
@@ -1024,6 +1028,162 @@ int canConvertTest()
   return rv;
 }
 
+/** Time strings covering each built-in and deprecated format, plus near misses and garbage */
+std::vector<std::string> sampleTimeStrings()
+{
+  return {
+    "0", "12.5", "-3.25", "+7", " 86400.125 ", "\"1000\"", "1e3", "0x10", "", " ", "abc",
+    "0:00", "10:30.5", "-5:15", "+2:01", "61:59.999", "1:60", "1:.5", "1:+5", "::",
+    "0:00:00", "12:34:56.789", "-1:30:00", "+100:59:59.9", "1:60:00", "1:-1:00", "1:00:60", "23:59:59.99999",
+    "001 2004 00:00:00", "366 2004 23:59:59.5", "366 2005 00:00:00", "1 1970 1:02:03", "100 1899 00:00:00", "045 2010 24:00:00",
+    "\"  032   2020  12:00:00.25 \"", "001 2004 +1:00:00",
+    "Jan 1 2004 00:00:00", "Feb 29 2004 12:34:56.5", "Feb 30 2004 12:34:56", "Dec 31 1999 23:59:59.999",
+    "011234Z JAN 04", "312359Z DEC 99", "010000Z FOO 04",
+    "2004-01-01T00:00:00Z", "2019-12-31T23:59:59.5Z", "2004-02-30T00:00:00Z", "2004-01-01", "2004",
+    "001 00:00:00", "032 12:00:00 2004", "1 Jan 2004 00:00:00", "Jan 1 00:00:00 2004", "Thu Jan 1 00:00:00", "Thu Jan 1 00:00:00 2004",
+  };
+}
+
+/** Compares each formatter's tryFromString() to canConvert() followed by fromString() */
+int testTryFromString()
+{
+  int rv = 0;
+  std::vector<std::shared_ptr<simCore::TimeFormatter> > formatters = {
+    std::make_shared<simCore::SecondsTimeFormatter>(),
+    std::make_shared<simCore::MinutesTimeFormatter>(),
+    std::make_shared<simCore::MinutesWrappedTimeFormatter>(),
+    std::make_shared<simCore::HoursTimeFormatter>(),
+    std::make_shared<simCore::HoursWrappedTimeFormatter>(),
+    std::make_shared<simCore::OrdinalTimeFormatter>(),
+    std::make_shared<simCore::MonthDayTimeFormatter>(),
+    std::make_shared<simCore::DtgTimeFormatter>(),
+    std::make_shared<simCore::Iso8601TimeFormatter>(),
+    std::make_shared<simCore::Deprecated::DDD_HHMMSS_Formatter>(),
+    std::make_shared<simCore::Deprecated::DDD_HHMMSS_YYYY_Formatter>(),
+    std::make_shared<simCore::Deprecated::MD_MON_YYYY_HHMMSS_Formatter>(),
+    std::make_shared<simCore::Deprecated::MON_MD_HHMMSS_YYYY_Formatter>(),
+    std::make_shared<simCore::Deprecated::WKD_MON_MD_HHMMSS_Formatter>(),
+    std::make_shared<simCore::Deprecated::WKD_MON_MD_HHMMSS_YYYY_Formatter>(),
+  };
+
+  const std::vector<std::string> strings = sampleTimeStrings();
+  for (const auto& formatter : formatters)
+  {
+    for (const auto& str : strings)
+    {
+      const simCore::TimeStamp untouched(1999, 1234.5);
+      simCore::TimeStamp expected = untouched;
+      simCore::TimeStamp actual = untouched;
+      const int tryRv = formatter->tryFromString(str, actual, 2004);
+      if (!formatter->canConvert(str))
+      {
+        rv += SDK_ASSERT(tryRv == -1);
+        rv += SDK_ASSERT(actual == untouched);
+        continue;
+      }
+      const int expectedRv = formatter->fromString(str, expected, 2004);
+      rv += SDK_ASSERT(tryRv == expectedRv);
+      rv += SDK_ASSERT(actual == expected);
+      rv += SDK_ASSERT(actual.referenceYear() == expected.referenceYear());
+    }
+  }
+  return rv;
+}
+
+/** Converts a time string the way the registry did before single-pass conversion */
+int referenceFromString(const simCore::TimeFormatterRegistry& reg, const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear)
+{
+  return reg.formatter(timeString).fromString(timeString, timeStamp, referenceYear);
+}
+
+/** Registry fromString() and fromStrings() must match formatter() followed by fromString() */
+int testRegistryConversion(bool wrapped)
+{
+  int rv = 0;
+  const std::vector<std::string> samples = sampleTimeStrings();
+  // Build a column with runs of the same format interrupted by other formats, to exercise the locked formatter
+  std::vector<std::string> column;
+  for (size_t k = 0; k < samples.size(); ++k)
+  {
+    for (size_t run = 0; run < 3; ++run)
+      column.push_back(samples[k]);
+    column.push_back(samples[(k * 7) % samples.size()]);
+  }
+
+  simCore::TimeFormatterRegistry referenceReg(wrapped);
+  simCore::TimeFormatterRegistry singleReg(wrapped);
+  simCore::TimeFormatterRegistry bulkReg(wrapped);
+
+  std::vector<simCore::TimeStamp> bulkStamps;
+  std::vector<int> bulkErrors;
+  const size_t bulkFailures = bulkReg.fromStrings(column, bulkStamps, 2004, &bulkErrors);
+  rv += SDK_ASSERT(bulkStamps.size() == column.size());
+  rv += SDK_ASSERT(bulkErrors.size() == column.size());
+
+  size_t expectedFailures = 0;
+  for (size_t k = 0; k < column.size() && k < bulkStamps.size() && k < bulkErrors.size(); ++k)
+  {
+    simCore::TimeStamp expected;
+    simCore::TimeStamp single;
+    const int expectedRv = referenceFromString(referenceReg, column[k], expected, 2004);
+    const int singleRv = singleReg.fromString(column[k], single, 2004);
+    if (expectedRv != 0)
+      ++expectedFailures;
+    rv += SDK_ASSERT(singleRv == expectedRv);
+    rv += SDK_ASSERT(single == expected);
+    rv += SDK_ASSERT(bulkErrors[k] == expectedRv);
+    rv += SDK_ASSERT(bulkStamps[k] == expected);
+  }
+  rv += SDK_ASSERT(bulkFailures == expectedFailures);
+
+  // Errors vector is optional
+  std::vector<simCore::TimeStamp> noErrorStamps;
+  rv += SDK_ASSERT(bulkReg.fromStrings(column, noErrorStamps, 2004) == expectedFailures);
+  rv += SDK_ASSERT(noErrorStamps == bulkStamps);
+
+  // Empty column
+  rv += SDK_ASSERT(bulkReg.fromStrings(std::vector<std::string>(), noErrorStamps, 2004, &bulkErrors) == 0);
+  rv += SDK_ASSERT(noErrorStamps.empty() && bulkErrors.empty());
+  return rv;
+}
+
+/** Prints parse throughput for the two-pass, single-pass, and bulk conversion paths; not a pass/fail test, run only when SIMDIS_SDK_BENCHMARK is set */
+int benchmarkTimeParsing()
+{
+  const std::vector<std::pair<std::string, std::string> > formats = {
+    { "Seconds", "86400.125" },
+    { "Hours", "12:34:56.789" },
+    { "Ordinal", "032 2020 12:00:00.25" },
+    { "ISO-8601", "2019-12-31T23:59:59.5Z" },
+  };
+  const size_t numStrings = 20000;
+  for (const auto& format : formats)
+  {
+    const std::vector<std::string> column(numStrings, format.second);
+    simCore::TimeFormatterRegistry reg;
+    simCore::TimeStamp stamp;
+
+    double startTime = simCore::getSystemTime();
+    for (const auto& str : column)
+      referenceFromString(reg, str, stamp, 1970);
+    const double twoPass = simCore::getSystemTime() - startTime;
+
+    startTime = simCore::getSystemTime();
+    for (const auto& str : column)
+      reg.fromString(str, stamp, 1970);
+    const double singlePass = simCore::getSystemTime() - startTime;
+
+    std::vector<simCore::TimeStamp> stamps;
+    startTime = simCore::getSystemTime();
+    reg.fromStrings(column, stamps, 1970);
+    const double bulk = simCore::getSystemTime() - startTime;
+
+    std::cout << format.first << " parse of " << numStrings << " strings: two-pass " << twoPass
+      << "s, single-pass " << singlePass << "s, bulk " << bulk << "s" << std::endl;
+  }
+  return 0;
+}
+
 }
 
 int TimeStringTest(int argc, char* argv[])
@@ -1041,5 +1201,10 @@ int TimeStringTest(int argc, char* argv[])
   rv += SDK_ASSERT(testPrintIso8601() == 0);
   rv += SDK_ASSERT(testPrintDeprecated() == 0);
   rv += SDK_ASSERT(canConvertTest() == 0);
+  rv += SDK_ASSERT(testTryFromString() == 0);
+  rv += SDK_ASSERT(testRegistryConversion(false) == 0);
+  rv += SDK_ASSERT(testRegistryConversion(true) == 0);
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+    rv += SDK_ASSERT(benchmarkTimeParsing() == 0);
   return rv;
 }
@@ -20,14 +20,20 @@
  * disclose, or release this software.
  *
  */
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
 #include <string>
+#include <string_view>
 #include <sstream>
 #include <iostream>
 #include <limits>
 #include <typeinfo>
+#include <vector>
 #include "simCore/Common/Common.h"
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/String/ValidNumber.h"
+#include "simCore/Time/Utils.h"
 
 namespace
 {
@@ -796,6 +802,202 @@ int testTrueToken()
   return rv;
 }
 
+/// strtol()-based conversion previously used by isValidNumber(), used as a conformance reference
+template <typename T>
+bool legacyValidInteger(const std::string& token, T& val, bool permitPlusToken)
+{
+  val = 0;
+  const char* start = token.c_str();
+  char* end;
+  errno = 0;
+  const bool isUnsigned = !std::numeric_limits<T>::is_signed;
+  long long longVal = 0;
+  unsigned long long ulongVal = 0;
+  if (isUnsigned)
+    ulongVal = strtoull(start, &end, 10);
+  else
+    longVal = strtoll(start, &end, 10);
+  if ((errno != 0) || (end == start) || (*end != '\0') || isspace(static_cast<unsigned char>(*start)) ||
+    (isUnsigned && *start == '-') || (!permitPlusToken && *start == '+'))
+    return false;
+  if (isUnsigned)
+  {
+    if (ulongVal > static_cast<unsigned long long>(std::numeric_limits<T>::max()))
+      return false;
+    val = static_cast<T>(ulongVal);
+    return true;
+  }
+  if (longVal < static_cast<long long>(std::numeric_limits<T>::min()) || longVal > static_cast<long long>(std::numeric_limits<T>::max()))
+    return false;
+  val = static_cast<T>(longVal);
+  return true;
+}
+
+/// strtod()-based conversion previously used by isValidNumber(), used as a conformance reference
+bool legacyValidDouble(const std::string& token, double& val, bool permitPlusToken)
+{
+  const char* start = token.c_str();
+  char* end;
+  val = std::strtod(start, &end);
+  if ((end == start) || (*end != '\0') || isspace(static_cast<unsigned char>(*start)) || !std::isfinite(val) ||
+    token.find_first_of("xX") != std::string::npos || (!permitPlusToken && *start == '+'))
+  {
+    val = 0.0;
+    return false;
+  }
+  return true;
+}
+
+/** Returns the tokens used for conformance and benchmark testing */
+std::vector<std::string> conformanceTokens()
+{
+  std::vector<std::string> tokens = {
+    "", " ", "+", "-", "+-1", "-+1", "++1", "--1", "0", "-0", "+0", "00", "007", "1", "-1", "+1",
+    " 1", "1 ", "\t1", "1\n", "1a", "a1", "1.", ".1", "-.1", "+.1", ".", "-.", "1.5", "-1.5", "1e5",
+    "1E5", "1e+5", "1e-5", "1e", "1e+", "e5", "-e5", "1.5e3x", "0x10", "0X1A", "x", "1x", "inf", "-inf",
+    "INF", "infinity", "nan", "NaN", "nan(1)", "1e308", "1e309", "-1e309", "1e-300", "1e-320", "1e-400",
+    "127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768", "-32769", "65535", "65536",
+    "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296",
+    "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+    "18446744073709551615", "18446744073709551616", "99999999999999999999999", "3.4028235e38",
+    "3.5e38", "-3.5e38", "1,000", "1_000", "12 34", "0.1234567890123456789", "123456789.987654321"
+  };
+  // Add a spread of generated values in different notations
+  for (int k = -50; k <= 50; ++k)
+  {
+    tokens.push_back(std::to_string(k * 9973));
+    tokens.push_back(std::to_string(k * 1234567891LL));
+    std::ostringstream os;
+    os << (k * 0.731) << " " << std::scientific << (k * 1.37e15);
+    tokens.push_back(os.str().substr(0, os.str().find(' ')));
+    tokens.push_back(os.str().substr(os.str().find(' ') + 1));
+  }
+  return tokens;
+}
+
+template <typename T>
+int conformanceT(const std::vector<std::string>& tokens)
+{
+  int rv = 0;
+  for (const auto& token : tokens)
+  {
+    for (bool permitPlus : { true, false })
+    {
+      T val = 1;
+      T legacyVal = 1;
+      const bool valid = simCore::isValidNumber(token, val, permitPlus);
+      const bool legacyValid = legacyValidInteger(token, legacyVal, permitPlus);
+      if (valid != legacyValid || val != legacyVal)
+      {
+        std::cerr << "Mismatch on '" << token << "' for " << typeid(T).name() << std::endl;
+        ++rv;
+      }
+    }
+  }
+  return rv;
+}
+
+int testFromCharsConformance()
+{
+  int rv = 0;
+  const std::vector<std::string> tokens = conformanceTokens();
+  rv += SDK_ASSERT(conformanceT<uint64_t>(tokens) == 0);
+  rv += SDK_ASSERT(conformanceT<uint32_t>(tokens) == 0);
+  rv += SDK_ASSERT(conformanceT<uint16_t>(tokens) == 0);
+  rv += SDK_ASSERT(conformanceT<uint8_t>(tokens) == 0);
+  rv += SDK_ASSERT(conformanceT<int64_t>(tokens) == 0);
+  rv += SDK_ASSERT(conformanceT<int32_t>(tokens) == 0);
+  rv += SDK_ASSERT(conformanceT<int16_t>(tokens) == 0);
+  rv += SDK_ASSERT(conformanceT<int8_t>(tokens) == 0);
+
+  int doubleMismatches = 0;
+  for (const auto& token : tokens)
+  {
+    for (bool permitPlus : { true, false })
+    {
+      double val = 1.0;
+      double legacyVal = 1.0;
+      const bool valid = simCore::isValidNumber(token, val, permitPlus);
+      const bool legacyValid = legacyValidDouble(token, legacyVal, permitPlus);
+      if (valid != legacyValid || val != legacyVal)
+      {
+        std::cerr << "Mismatch on '" << token << "' for double" << std::endl;
+        ++doubleMismatches;
+      }
+    }
+  }
+  rv += SDK_ASSERT(doubleMismatches == 0);
+
+  // Substrings need not be null terminated
+  const std::string line = "12,-3.5e2,+7,x";
+  const std::string_view view(line);
+  int32_t intVal = 0;
+  double dblVal = 0.0;
+  rv += SDK_ASSERT(simCore::isValidNumber(view.substr(0, 2), intVal) && intVal == 12);
+  rv += SDK_ASSERT(simCore::isValidNumber(view.substr(3, 6), dblVal) && dblVal == -350.0);
+  rv += SDK_ASSERT(simCore::isValidNumber(view.substr(10, 2), intVal) && intVal == 7);
+  rv += SDK_ASSERT(!simCore::isValidNumber(view.substr(10, 2), intVal, false) && intVal == 0);
+  rv += SDK_ASSERT(!simCore::isValidNumber(view.substr(0, 3), intVal));
+  rv += SDK_ASSERT(!simCore::isValidNumber(view.substr(3, 7), dblVal) && dblVal == 0.0);
+  return rv;
+}
+
+/** Prints parse throughput of isValidNumber() against the strto*() reference; not a pass/fail test */
+int benchmarkParsing()
+{
+  std::vector<std::string> tokens;
+  for (int k = 0; k < 200000; ++k)
+  {
+    tokens.push_back(std::to_string(k * 7919 - 500000));
+    std::ostringstream os;
+    os.precision(12);
+    os << (k * 0.0137 - 1000.0);
+    tokens.push_back(os.str());
+  }
+
+  double sum = 0.0;
+  double startTime = simCore::getSystemTime();
+  for (const auto& token : tokens)
+  {
+    double val;
+    if (legacyValidDouble(token, val, true))
+      sum += val;
+  }
+  const double legacyTime = simCore::getSystemTime() - startTime;
+
+  startTime = simCore::getSystemTime();
+  for (const auto& token : tokens)
+  {
+    double val;
+    if (simCore::isValidNumber(token, val))
+      sum -= val;
+  }
+  const double fromCharsTime = simCore::getSystemTime() - startTime;
+
+  int64_t intSum = 0;
+  startTime = simCore::getSystemTime();
+  for (const auto& token : tokens)
+  {
+    int32_t val;
+    if (legacyValidInteger(token, val, true))
+      intSum += val;
+  }
+  const double legacyIntTime = simCore::getSystemTime() - startTime;
+
+  startTime = simCore::getSystemTime();
+  for (const auto& token : tokens)
+  {
+    int32_t val;
+    if (simCore::isValidNumber(token, val))
+      intSum -= val;
+  }
+  const double fromCharsIntTime = simCore::getSystemTime() - startTime;
+
+  std::cout << "Parsing " << tokens.size() << " tokens: double strtod " << legacyTime << "s, from_chars " << fromCharsTime
+    << "s; int32 strtol " << legacyIntTime << "s, from_chars " << fromCharsIntTime << "s (" << sum << ", " << intSum << ")" << std::endl;
+  return 0;
+}
+
 }
 
 int ValidNumberTest(int argc, char* argv[])
@@ -805,5 +1007,9 @@ int ValidNumberTest(int argc, char* argv[])
   rv += SDK_ASSERT(testPermitPlus() == 0);
   rv += SDK_ASSERT(testValidHexNumber() == 0);
   rv += SDK_ASSERT(testTrueToken() == 0);
+  rv += SDK_ASSERT(testFromCharsConformance() == 0);
+  // testFromCharsConformance() covers correctness; the timings are opt-in
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+    rv += SDK_ASSERT(benchmarkParsing() == 0);
   return rv;
 }
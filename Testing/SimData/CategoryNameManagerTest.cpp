@@ -0,0 +1,299 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
+#include "simData/CategoryData/CategoryNameManager.h"
+
+namespace
+{
+
+/** Counts notifications, and queries the manager from inside each callback */
+class CountingListener : public simData::CategoryNameManager::Listener
+{
+public:
+  explicit CountingListener(const simData::CategoryNameManager& mgr)
+    : mgr_(mgr),
+      numCategories(0),
+      numValues(0),
+      numClears(0),
+      numDoneClearing(0),
+      numBadLookups(0)
+  {
+  }
+
+  virtual void onAddCategory(int categoryIndex)
+  {
+    ++numCategories;
+    if (mgr_.nameIntToString(categoryIndex).empty())
+      ++numBadLookups;
+  }
+
+  virtual void onAddValue(int categoryIndex, int valueIndex)
+  {
+    ++numValues;
+    if (mgr_.valueIntToString(valueIndex).empty())
+      ++numBadLookups;
+    std::lock_guard<std::mutex> lock(pairsMutex_);
+    valuePairs.insert(std::make_pair(categoryIndex, valueIndex));
+  }
+
+  virtual void onClear() { ++numClears; }
+  virtual void doneClearing() { ++numDoneClearing; }
+
+  const simData::CategoryNameManager& mgr_;
+  std::atomic<int> numCategories;
+  std::atomic<int> numValues;
+  std::atomic<int> numClears;
+  std::atomic<int> numDoneClearing;
+  std::atomic<int> numBadLookups;
+  std::mutex pairsMutex_;
+  std::set<std::pair<int, int> > valuePairs;
+};
+
+int testMappings()
+{
+  int rv = 0;
+  simData::CategoryNameManager mgr;
+  std::shared_ptr<CountingListener> listener(new CountingListener(mgr));
+  mgr.addListener(listener);
+
+  const int color = mgr.addCategoryName("Color");
+  rv += SDK_ASSERT(color != simData::CategoryNameManager::NO_CATEGORY_NAME);
+  rv += SDK_ASSERT(mgr.addCategoryName("Color") == color);
+  rv += SDK_ASSERT(listener->numCategories == 1);
+
+  const int red = mgr.addCategoryValue(color, "Red");
+  const int blue = mgr.addCategoryValue(color, "Blue");
+  rv += SDK_ASSERT(mgr.addCategoryValue(color, "Red") == red);
+  rv += SDK_ASSERT(listener->numValues == 2);
+  rv += SDK_ASSERT(mgr.nameToInt("Color") == color);
+  rv += SDK_ASSERT(mgr.valueToInt("Blue") == blue);
+  rv += SDK_ASSERT(mgr.nameIntToString(color) == "Color");
+  rv += SDK_ASSERT(mgr.valueIntToString(red) == "Red");
+  rv += SDK_ASSERT(mgr.nameToInt("color") == simData::CategoryNameManager::NO_CATEGORY_NAME);
+  rv += SDK_ASSERT(mgr.valueIntToString(simData::CategoryNameManager::NO_CATEGORY_VALUE) == simData::CategoryNameManager::NO_CATEGORY_VALUE_STR);
+  rv += SDK_ASSERT(mgr.valueIntToString(simData::CategoryNameManager::UNLISTED_CATEGORY_VALUE) == simData::CategoryNameManager::UNLISTED_CATEGORY_VALUE_STR);
+  rv += SDK_ASSERT(mgr.valueIntToString(12345).empty());
+
+  // The same string used as a value in another category shares its ID, but notifies again
+  const int shape = mgr.addCategoryName("Shape");
+  rv += SDK_ASSERT(mgr.addCategoryValue(shape, "Red") == red);
+  rv += SDK_ASSERT(listener->numValues == 3);
+
+  // Values stay in insertion order; categories in ID order
+  const int green = mgr.addCategoryValue(color, "Green");
+  std::vector<int> ints;
+  mgr.allValueIntsInCategory(color, ints);
+  rv += SDK_ASSERT(ints == std::vector<int>({ red, blue, green }));
+  std::vector<std::string> strings;
+  mgr.allValuesInCategory(color, strings);
+  rv += SDK_ASSERT(strings == std::vector<std::string>({ "Red", "Blue", "Green" }));
+  strings.clear();
+  mgr.allCategoryNames(strings);
+  rv += SDK_ASSERT(strings == std::vector<std::string>({ "Color", "Shape" }));
+
+  // Removing a value allows it to be added, and notified, again
+  mgr.removeValue(color, blue);
+  ints.clear();
+  mgr.allValueIntsInCategory(color, ints);
+  rv += SDK_ASSERT(ints == std::vector<int>({ red, green }));
+  rv += SDK_ASSERT(mgr.addCategoryValue(color, "Blue") == blue);
+  rv += SDK_ASSERT(listener->numValues == 5);
+
+  // Removing a category keeps the string mapping
+  mgr.removeCategory(shape);
+  ints.clear();
+  mgr.allCategoryNameInts(ints);
+  rv += SDK_ASSERT(ints == std::vector<int>({ color }));
+  rv += SDK_ASSERT(mgr.nameToInt("Shape") == shape);
+  rv += SDK_ASSERT(mgr.addCategoryName("Shape") == shape);
+  rv += SDK_ASSERT(listener->numCategories == 3);
+
+  // Clear does not reuse IDs
+  mgr.clear();
+  rv += SDK_ASSERT(listener->numClears == 1 && listener->numDoneClearing == 1);
+  rv += SDK_ASSERT(mgr.nameToInt("Color") == simData::CategoryNameManager::NO_CATEGORY_NAME);
+  rv += SDK_ASSERT(mgr.valueIntToString(red).empty());
+  const int newColor = mgr.addCategoryName("Color");
+  rv += SDK_ASSERT(newColor > green);
+  rv += SDK_ASSERT(mgr.nameIntToString(newColor) == "Color");
+  rv += SDK_ASSERT(mgr.nameIntToString(color).empty());
+
+  rv += SDK_ASSERT(listener->numBadLookups == 0);
+  mgr.removeListener(listener);
+  return rv;
+}
+
+int testCaseInsensitive()
+{
+  int rv = 0;
+  simData::CategoryNameManager mgr;
+  rv += SDK_ASSERT(mgr.setCaseSensitive(false) == 0);
+  const int cat = mgr.addCategoryName("Color");
+  rv += SDK_ASSERT(mgr.addCategoryName("COLOR") == cat);
+  rv += SDK_ASSERT(mgr.nameToInt("color") == cat);
+  // Original case of the first string is kept
+  rv += SDK_ASSERT(mgr.nameIntToString(cat) == "Color");
+  // Cannot change once populated
+  rv += SDK_ASSERT(mgr.setCaseSensitive(true) != 0);
+  return rv;
+}
+
+/** Readers query while writers add overlapping names and values */
+int testConcurrentAccess()
+{
+  int rv = 0;
+  simData::CategoryNameManager mgr;
+  std::shared_ptr<CountingListener> listener(new CountingListener(mgr));
+  mgr.addListener(listener);
+
+  const int numCategories = 20;
+  const int numValues = 500;
+  const int numWriters = 3;
+  std::atomic<bool> done(false);
+  std::atomic<int> numMismatches(0);
+
+  // Writers add the same names and values, so each must be created and notified exactly once
+  std::vector<std::thread> writers;
+  for (int w = 0; w < numWriters; ++w)
+  {
+    writers.push_back(std::thread([&mgr, w]() {
+      for (int k = 0; k < numValues; ++k)
+      {
+        for (int c = 0; c < numCategories; ++c)
+        {
+          const int cat = mgr.addCategoryName("Category " + std::to_string((c + w) % numCategories));
+          mgr.addCategoryValue(cat, "Value " + std::to_string(k));
+        }
+      }
+    }));
+  }
+
+  // Readers check that every ID they see resolves back to the same string
+  std::vector<std::thread> readers;
+  for (int r = 0; r < 2; ++r)
+  {
+    readers.push_back(std::thread([&mgr, &done, &numMismatches]() {
+      while (!done)
+      {
+        for (int k = 0; k < numValues; k += 7)
+        {
+          const std::string value = "Value " + std::to_string(k);
+          const int valueInt = mgr.valueToInt(value);
+          if (valueInt != simData::CategoryNameManager::NO_CATEGORY_VALUE && mgr.valueIntToString(valueInt) != value)
+            ++numMismatches;
+        }
+        std::vector<int> cats;
+        mgr.allCategoryNameInts(cats);
+        for (int cat : cats)
+        {
+          std::vector<std::string> values;
+          mgr.allValuesInCategory(cat, values);
+          if (mgr.nameIntToString(cat).compare(0, 9, "Category ") != 0)
+            ++numMismatches;
+        }
+      }
+    }));
+  }
+
+  for (auto& writer : writers)
+    writer.join();
+  done = true;
+  for (auto& reader : readers)
+    reader.join();
+
+  rv += SDK_ASSERT(numMismatches == 0);
+  rv += SDK_ASSERT(listener->numBadLookups == 0);
+  rv += SDK_ASSERT(listener->numCategories == numCategories);
+  rv += SDK_ASSERT(listener->numValues == numCategories * numValues);
+  rv += SDK_ASSERT(static_cast<int>(listener->valuePairs.size()) == numCategories * numValues);
+
+  std::vector<int> cats;
+  mgr.allCategoryNameInts(cats);
+  rv += SDK_ASSERT(static_cast<int>(cats.size()) == numCategories);
+  for (int cat : cats)
+  {
+    std::vector<int> values;
+    mgr.allValueIntsInCategory(cat, values);
+    rv += SDK_ASSERT(static_cast<int>(values.size()) == numValues);
+  }
+  mgr.removeListener(listener);
+  return rv;
+}
+
+/** Prints lookup timings; not a pass/fail test, so it runs only when SIMDIS_SDK_BENCHMARK is set */
+int benchmarkLookups()
+{
+  simData::CategoryNameManager mgr;
+  const int numValues = 100000;
+  std::vector<std::string> values;
+  for (int k = 0; k < numValues; ++k)
+    values.push_back("Category Value " + std::to_string(k));
+
+  double startTime = simCore::getSystemTime();
+  const int cat = mgr.addCategoryName("Benchmark");
+  for (const auto& value : values)
+    mgr.addCategoryValue(cat, value);
+  const double insertTime = simCore::getSystemTime() - startTime;
+
+  startTime = simCore::getSystemTime();
+  size_t sum = 0;
+  for (const auto& value : values)
+    sum += mgr.valueToInt(value);
+  const double toIntTime = simCore::getSystemTime() - startTime;
+
+  startTime = simCore::getSystemTime();
+  for (int k = 1; k <= numValues; ++k)
+    sum += mgr.valueIntToString(k).size();
+  const double toStringTime = simCore::getSystemTime() - startTime;
+
+  std::cout << "CategoryNameManager with " << numValues << " values: insert " << insertTime << "s, valueToInt "
+    << toIntTime << "s, valueIntToString " << toStringTime << "s (" << sum << ")" << std::endl;
+  return 0;
+}
+
+}
+
+int CategoryNameManagerTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += testMappings();
+  rv += testCaseInsensitive();
+  rv += testConcurrentAccess();
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+    rv += benchmarkLookups();
+
+  std::cout << "CategoryNameManagerTest: " << (rv == 0 ? "PASSED" : "FAILED") << std::endl;
+
+  return rv;
+}
@@ -20,9 +20,13 @@
  * disclose, or release this software.
  *
  */
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
 #include <string>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Calc/Math.h"
+#include "simCore/Time/Utils.h"
 #include "simData/DataTable.h"
 #include "simData/MemoryDataStore.h"
 #include "simData/MemoryTable/DoubleBufferTimeContainer.h"
@@ -2248,6 +2252,143 @@ int testPartialFlush()
   return rv;
 }
 
+/** Per-cell reference for DataTable::resample() */
+double perCellValue(const simData::TableColumn& column, double time, simData::DataTable::ResampleMethod method, double noValue)
+{
+  double value = 0.0;
+  if (method == simData::DataTable::RESAMPLE_LINEAR)
+    return column.interpolate(value, time, nullptr).isSuccess() ? value : noValue;
+  simData::TableColumn::Iterator iter = column.findAtOrBeforeTime(time);
+  if (!iter.hasNext() || !iter.next()->getValue(value).isSuccess())
+    return noValue;
+  return value;
+}
+
+/** Fills a table whose columns are spread over several subtables, with some rows added out of order */
+void fillSparseTable(simData::DataTable& table, std::vector<simData::TableColumnId>& ids, size_t numRows)
+{
+  simData::TableColumn* every = nullptr;
+  simData::TableColumn* third = nullptr;
+  simData::TableColumn* sparse = nullptr;
+  simData::TableColumn* text = nullptr;
+  table.addColumn("Every", simData::VT_DOUBLE, 0, &every);
+  table.addColumn("Third", simData::VT_INT32, 0, &third);
+  table.addColumn("Sparse", simData::VT_FLOAT, 0, &sparse);
+  table.addColumn("Text", simData::VT_STRING, 0, &text);
+  ids = { every->columnId(), third->columnId(), sparse->columnId(), text->columnId() };
+
+  for (size_t k = 0; k < numRows; ++k)
+  {
+    // Mostly increasing times, with every 10th row landing before the previous rows
+    const double time = (k % 10 == 9) ? (k * 1.5 - 7.25) : (k * 1.5 + 0.5 * (k % 4));
+    simData::TableRow row;
+    row.setTime(time);
+    row.setValue(every->columnId(), std::sin(time));
+    if (k % 3 == 0)
+      row.setValue(third->columnId(), static_cast<int32_t>(k));
+    if (k % 7 == 2)
+      row.setValue(sparse->columnId(), static_cast<float>(time * 0.25));
+    if (k % 5 == 1)
+      row.setValue(text->columnId(), std::to_string(k));
+    table.addRow(row);
+  }
+}
+
+int resampleTest()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simData::DataTable* table = nullptr;
+  rv += SDK_ASSERT(ds.dataTableManager().addDataTable(1, "Resample Table", &table).isSuccess());
+  if (table == nullptr)
+    return rv;
+  std::vector<simData::TableColumnId> ids;
+  fillSparseTable(*table, ids, 200);
+
+  // Grid covers before the first row, exact row times, between rows, and past the end
+  std::vector<double> times;
+  for (double t = -10.0; t < 320.0; t += 0.75)
+    times.push_back(t);
+
+  const double NO_VALUE = -9999.0;
+  for (auto method : { simData::DataTable::RESAMPLE_SAMPLE_AND_HOLD, simData::DataTable::RESAMPLE_LINEAR })
+  {
+    std::vector<double> values;
+    rv += SDK_ASSERT(table->resample(ids, times, method, values, NO_VALUE).isSuccess());
+    rv += SDK_ASSERT(values.size() == ids.size() * times.size());
+    int mismatches = 0;
+    size_t numValid = 0;
+    for (size_t c = 0; c < ids.size() && values.size() == ids.size() * times.size(); ++c)
+    {
+      const simData::TableColumn* column = table->column(ids[c]);
+      for (size_t t = 0; t < times.size(); ++t)
+      {
+        const double expected = perCellValue(*column, times[t], method, NO_VALUE);
+        if (values[c * times.size() + t] != expected)
+          ++mismatches;
+        if (expected != NO_VALUE)
+          ++numValid;
+      }
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+    rv += SDK_ASSERT(numValid > times.size());
+  }
+
+  // Default no-value is NaN
+  std::vector<double> values;
+  rv += SDK_ASSERT(table->resample(ids, { -100.0, 10.0 }, simData::DataTable::RESAMPLE_LINEAR, values).isSuccess());
+  rv += SDK_ASSERT(values.size() == ids.size() * 2 && std::isnan(values[0]) && !std::isnan(values[1]));
+
+  // Invalid column is reported, but others are still filled
+  rv += SDK_ASSERT(table->resample({ ids[0], 12345 }, { 10.0 }, simData::DataTable::RESAMPLE_SAMPLE_AND_HOLD, values, NO_VALUE).isError());
+  rv += SDK_ASSERT(values.size() == 2 && values[0] != NO_VALUE && values[1] == NO_VALUE);
+
+  // Unsorted times are rejected
+  rv += SDK_ASSERT(table->resample(ids, { 10.0, 5.0 }, simData::DataTable::RESAMPLE_SAMPLE_AND_HOLD, values, NO_VALUE).isError());
+  rv += SDK_ASSERT(values.size() == ids.size() * 2 && values[0] == NO_VALUE);
+
+  // Empty inputs
+  rv += SDK_ASSERT(table->resample(ids, std::vector<double>(), simData::DataTable::RESAMPLE_LINEAR, values).isSuccess());
+  rv += SDK_ASSERT(values.empty());
+  return rv;
+}
+
+/** Prints timing of resample() against per-cell lookup; not a pass/fail test, enabled with SIMDIS_SDK_BENCHMARK */
+int resampleBenchmark()
+{
+  simData::MemoryDataStore ds;
+  simData::DataTable* table = nullptr;
+  ds.dataTableManager().addDataTable(1, "Resample Benchmark", &table);
+  std::vector<simData::TableColumnId> ids;
+  fillSparseTable(*table, ids, 50000);
+  std::vector<double> times;
+  for (double t = 0.0; t < 75000.0; t += 5.0)
+    times.push_back(t);
+
+  for (auto method : { simData::DataTable::RESAMPLE_SAMPLE_AND_HOLD, simData::DataTable::RESAMPLE_LINEAR })
+  {
+    double startTime = simCore::getSystemTime();
+    double sum = 0.0;
+    for (auto id : ids)
+    {
+      const simData::TableColumn* column = table->column(id);
+      for (double t : times)
+        sum += perCellValue(*column, t, method, 0.0);
+    }
+    const double perCell = simCore::getSystemTime() - startTime;
+
+    startTime = simCore::getSystemTime();
+    std::vector<double> values;
+    table->resample(ids, times, method, values, 0.0);
+    const double merged = simCore::getSystemTime() - startTime;
+
+    std::cout << (method == simData::DataTable::RESAMPLE_LINEAR ? "Linear" : "Sample-and-hold") << " resample of "
+      << ids.size() << " columns x " << times.size() << " times: per-cell " << perCell << "s, merged " << merged
+      << "s (" << sum << ")" << std::endl;
+  }
+  return 0;
+}
+
 }
 
 int MemoryDataTableTest(int argc, char* argv[])
@@ -2265,5 +2406,8 @@ int MemoryDataTableTest(int argc, char* argv[])
   rv += doubleBufferTimeContainerTest();
   rv += testPartialFlush();
   rv += getTimeRangeTest();
+  rv += resampleTest();
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+    rv += resampleBenchmark();
   return rv;
 }
@@ -0,0 +1,403 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/CategoryData/CategoryFilter.h"
+#include "simData/CategoryData/CategoryNameManager.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/PrefRuleIndex.h"
+#include "simData/PrefRulesManager.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Rule that counts the entities it is applied to */
+class MockPrefRule : public simData::PrefRule
+{
+public:
+  explicit MockPrefRule(simData::DataStore* ds)
+    : filter_(ds)
+  {
+  }
+
+  virtual std::string serialize() const { return filter_.serialize(); }
+  virtual int apply(uint64_t entityId, simData::DataStore& ds)
+  {
+    ++applied[entityId];
+    if (lastApplied)
+      (*lastApplied)[entityId] = this;
+    return 0;
+  }
+  virtual const simData::CategoryFilter* categoryFilter() const { return &filter_; }
+
+  simData::CategoryFilter& filter() { return filter_; }
+
+  std::map<uint64_t, int> applied;
+  /// Optional record of the last rule applied to each entity, standing in for a pref set by several rules
+  std::map<uint64_t, const MockPrefRule*>* lastApplied = nullptr;
+
+private:
+  simData::CategoryFilter filter_;
+};
+
+bool contains(const std::vector<simData::PrefRule*>& rules, const simData::PrefRule* rule)
+{
+  for (const simData::PrefRule* r : rules)
+  {
+    if (r == rule)
+      return true;
+  }
+  return false;
+}
+
+int testAffectedRules()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simData::CategoryNameManager& catMgr = ds.categoryNameManager();
+  const int color = catMgr.addCategoryName("Color");
+  const int red = catMgr.addCategoryValue(color, "Red");
+  const int blue = catMgr.addCategoryValue(color, "Blue");
+  const int green = catMgr.addCategoryValue(color, "Green");
+  const int size = catMgr.addCategoryName("Size");
+  const int big = catMgr.addCategoryValue(size, "Big");
+  const int small = catMgr.addCategoryValue(size, "Small");
+
+  // Matches Color=Red only
+  MockPrefRule redRule(&ds);
+  redRule.filter().setValue(color, red, true);
+  // Matches any Size except Small, including unlisted values
+  MockPrefRule sizeRule(&ds);
+  sizeRule.filter().setValue(size, small, false);
+  sizeRule.filter().setValue(size, simData::CategoryNameManager::UNLISTED_CATEGORY_VALUE, true);
+  // Matches entities without a Color
+  MockPrefRule noColorRule(&ds);
+  noColorRule.filter().setValue(color, simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, true);
+  // Matches everything
+  MockPrefRule allRule(&ds);
+
+  simData::PrefRuleIndex index;
+  index.addRule(&redRule);
+  index.addRule(&sizeRule);
+  index.addRule(&noColorRule);
+  index.addRule(&allRule);
+  index.addRule(&allRule);
+  rv += SDK_ASSERT(index.numRules() == 4);
+  rv += SDK_ASSERT(index.hasRule(&allRule));
+
+  std::vector<simData::PrefRule*> rules;
+  index.affectedRules(color, red, blue, rules);
+  rv += SDK_ASSERT(rules.size() == 1 && rules[0] == &redRule);
+  // Neither value is listed in any filter
+  index.affectedRules(color, blue, green, rules);
+  rv += SDK_ASSERT(rules.empty());
+  // No change
+  index.affectedRules(color, red, red, rules);
+  rv += SDK_ASSERT(rules.empty());
+  // Setting the first color affects both color rules, in the order added
+  index.affectedRules(color, simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, red, rules);
+  rv += SDK_ASSERT(rules.size() == 2 && rules[0] == &redRule && rules[1] == &noColorRule);
+  // Unlisted value entry makes the size rule sensitive to any change
+  index.affectedRules(size, big, simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, rules);
+  rv += SDK_ASSERT(rules.size() == 1 && rules[0] == &sizeRule);
+
+  // Multiple name changes are merged without duplicates
+  simData::CategoryFilter::CurrentCategoryValues oldValues;
+  simData::CategoryFilter::CurrentCategoryValues newValues;
+  oldValues[color] = red;
+  newValues[color] = blue;
+  newValues[size] = big;
+  index.affectedRules(oldValues, newValues, rules);
+  rv += SDK_ASSERT(rules.size() == 2 && rules[0] == &redRule && rules[1] == &sizeRule);
+  index.affectedRules(newValues, newValues, rules);
+  rv += SDK_ASSERT(rules.empty());
+
+  // Changing a filter requires updateRule(), which keeps the rule order
+  redRule.filter().setValue(color, green, true);
+  index.affectedRules(color, blue, green, rules);
+  rv += SDK_ASSERT(rules.empty());
+  index.updateRule(&redRule);
+  index.affectedRules(color, blue, green, rules);
+  rv += SDK_ASSERT(rules.size() == 1 && rules[0] == &redRule);
+  index.affectedRules(color, simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, red, rules);
+  rv += SDK_ASSERT(rules.size() == 2 && rules[0] == &redRule && rules[1] == &noColorRule);
+
+  index.removeRule(&redRule);
+  rv += SDK_ASSERT(!index.hasRule(&redRule));
+  index.affectedRules(color, simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, red, rules);
+  rv += SDK_ASSERT(rules.size() == 1 && rules[0] == &noColorRule);
+
+  index.clear();
+  rv += SDK_ASSERT(index.numRules() == 0);
+  index.affectedRules(size, big, small, rules);
+  rv += SDK_ASSERT(rules.empty());
+  return rv;
+}
+
+/** Every rule whose match result changes must be reported as affected */
+int testAffectedRulesComplete()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simData::CategoryNameManager& catMgr = ds.categoryNameManager();
+  const int noValue = simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME;
+  const int unlisted = simData::CategoryNameManager::UNLISTED_CATEGORY_VALUE;
+
+  std::vector<int> names;
+  std::map<int, std::vector<int> > values;
+  for (int n = 0; n < 3; ++n)
+  {
+    const int name = catMgr.addCategoryName("Name" + std::to_string(n));
+    names.push_back(name);
+    values[name].push_back(noValue);
+    for (int v = 0; v < 4; ++v)
+      values[name].push_back(catMgr.addCategoryValue(name, "Value" + std::to_string(v)));
+  }
+
+  // Build a deterministic variety of filters, each listing a subset of values plus the special entries
+  std::vector<std::unique_ptr<MockPrefRule> > mockRules;
+  simData::PrefRuleIndex index;
+  unsigned int seed = 12345;
+  for (int r = 0; r < 60; ++r)
+  {
+    mockRules.push_back(std::make_unique<MockPrefRule>(&ds));
+    simData::CategoryFilter& filter = mockRules.back()->filter();
+    for (int name : names)
+    {
+      seed = seed * 1103515245 + 12345;
+      if ((seed >> 16) % 3 == 0)
+        continue;
+      for (int value : values[name])
+      {
+        seed = seed * 1103515245 + 12345;
+        const unsigned int pick = (seed >> 16) % 4;
+        if (pick < 2)
+          filter.setValue(name, value, pick == 0);
+      }
+      seed = seed * 1103515245 + 12345;
+      const unsigned int unlistedPick = (seed >> 16) % 3;
+      if (unlistedPick < 2)
+        filter.setValue(name, unlisted, unlistedPick == 0);
+    }
+    index.addRule(mockRules.back().get());
+  }
+
+  // Exhaustively test single-name transitions from a fixed background
+  std::vector<simData::PrefRule*> rules;
+  for (int name : names)
+  {
+    for (int oldValue : values[name])
+    {
+      for (int newValue : values[name])
+      {
+        simData::CategoryFilter::CurrentCategoryValues oldValues;
+        simData::CategoryFilter::CurrentCategoryValues newValues;
+        for (int other : names)
+        {
+          if (other == name)
+            continue;
+          oldValues[other] = values[other][1];
+          newValues[other] = values[other][1];
+        }
+        if (oldValue != noValue)
+          oldValues[name] = oldValue;
+        if (newValue != noValue)
+          newValues[name] = newValue;
+
+        index.affectedRules(oldValues, newValues, rules);
+        for (const auto& rule : mockRules)
+        {
+          const bool changed = rule->filter().matchData(oldValues) != rule->filter().matchData(newValues);
+          if (changed)
+            rv += SDK_ASSERT(contains(rules, rule.get()));
+        }
+      }
+    }
+  }
+  return rv;
+}
+
+int testApplyChangedRules()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t plat1 = helper.addPlatform();
+  const uint64_t plat2 = helper.addPlatform();
+
+  simData::CategoryNameManager& catMgr = ds.categoryNameManager();
+  const int color = catMgr.addCategoryName("Color");
+  const int red = catMgr.addCategoryValue(color, "Red");
+
+  MockPrefRule redRule(&ds);
+  redRule.filter().setValue(color, red, true);
+  MockPrefRule allRule(&ds);
+  simData::PrefRuleIndex index;
+  index.addRule(&redRule);
+  index.addRule(&allRule);
+
+  helper.addCategoryData(plat1, "Color", "Red", 1.0);
+  helper.addCategoryData(plat1, "Color", "Blue", 2.0);
+  helper.addCategoryData(plat1, "Color", "Green", 3.0);
+  helper.addCategoryData(plat2, "Color", "Blue", 1.0);
+
+  ds.update(1.0);
+  rv += SDK_ASSERT(index.applyChangedRules(plat1, ds) == 0);
+  rv += SDK_ASSERT(index.applyChangedRules(plat2, ds) == 0);
+  rv += SDK_ASSERT(redRule.applied[plat1] == 1);
+  rv += SDK_ASSERT(redRule.applied.count(plat2) == 0);
+  // The later all rule follows any affected rule so it keeps precedence, but is not affected on its own
+  rv += SDK_ASSERT(allRule.applied[plat1] == 1);
+  rv += SDK_ASSERT(allRule.applied.count(plat2) == 0);
+
+  // Red to Blue changes the red rule's result
+  ds.update(2.0);
+  index.applyChangedRules(plat1, ds);
+  index.applyChangedRules(plat2, ds);
+  rv += SDK_ASSERT(redRule.applied[plat1] == 2);
+
+  // Blue to Green does not
+  ds.update(3.0);
+  index.applyChangedRules(plat1, ds);
+  rv += SDK_ASSERT(redRule.applied[plat1] == 2);
+
+  // Forgetting the entity treats it as new again
+  index.removeEntity(plat1);
+  ds.update(1.0);
+  index.applyChangedRules(plat1, ds);
+  rv += SDK_ASSERT(redRule.applied[plat1] == 3);
+  rv += SDK_ASSERT(allRule.applied[plat1] == 3);
+  rv += SDK_ASSERT(allRule.applied.count(plat2) == 0);
+  return rv;
+}
+
+/** Later rules setting the same pref must still win when only an earlier rule is affected */
+int testOverlappingRules()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t plat = helper.addPlatform();
+
+  simData::CategoryNameManager& catMgr = ds.categoryNameManager();
+  const int color = catMgr.addCategoryName("Color");
+  const int red = catMgr.addCategoryValue(color, "Red");
+  const int shape = catMgr.addCategoryName("Shape");
+  const int square = catMgr.addCategoryValue(shape, "Square");
+  const int circle = catMgr.addCategoryValue(shape, "Circle");
+
+  std::map<uint64_t, const MockPrefRule*> lastApplied;
+  MockPrefRule redRule(&ds);
+  redRule.filter().setValue(color, red, true);
+  redRule.lastApplied = &lastApplied;
+  MockPrefRule squareRule(&ds);
+  squareRule.filter().setValue(shape, square, true);
+  squareRule.lastApplied = &lastApplied;
+  MockPrefRule circleRule(&ds);
+  circleRule.filter().setValue(shape, circle, true);
+  circleRule.lastApplied = &lastApplied;
+  simData::PrefRuleIndex index;
+  index.addRule(&redRule);
+  index.addRule(&squareRule);
+  index.addRule(&circleRule);
+
+  helper.addCategoryData(plat, "Shape", "Square", 1.0);
+  helper.addCategoryData(plat, "Color", "Blue", 1.0);
+  helper.addCategoryData(plat, "Color", "Red", 2.0);
+
+  ds.update(1.0);
+  index.applyChangedRules(plat, ds);
+  rv += SDK_ASSERT(lastApplied[plat] == &squareRule);
+  rv += SDK_ASSERT(squareRule.applied[plat] == 1);
+
+  // Only the red rule is affected, but the later matching square rule is reapplied after it; circle does not match
+  ds.update(2.0);
+  rv += SDK_ASSERT(index.applyChangedRules(plat, ds) == 0);
+  rv += SDK_ASSERT(redRule.applied[plat] == 1);
+  rv += SDK_ASSERT(squareRule.applied[plat] == 2);
+  rv += SDK_ASSERT(circleRule.applied.count(plat) == 0);
+  rv += SDK_ASSERT(lastApplied[plat] == &squareRule);
+
+  // Rules added before the first affected rule are not reapplied
+  ds.update(1.0);
+  index.applyChangedRules(plat, ds);
+  rv += SDK_ASSERT(redRule.applied[plat] == 2);
+  rv += SDK_ASSERT(squareRule.applied[plat] == 3);
+  return rv;
+}
+
+int testEnforcement()
+{
+  int rv = 0;
+  simData::PrefEnforcementIndex enforced;
+  const std::deque<int> color = { 1, 2 };
+  const std::deque<int> colorPrefix = { 1 };
+  const std::deque<int> label = { 3, 4, 5 };
+
+  rv += SDK_ASSERT(!enforced.isPrefValueEnforced(1, color));
+  enforced.enforcePrefValue(1, color);
+  enforced.enforcePrefValue(1, color, true);
+  enforced.enforcePrefValue(1, label);
+  enforced.enforcePrefValue(2, color);
+  rv += SDK_ASSERT(enforced.size() == 3);
+  rv += SDK_ASSERT(enforced.isPrefValueEnforced(1, color));
+  rv += SDK_ASSERT(!enforced.isPrefValueEnforced(1, colorPrefix));
+  rv += SDK_ASSERT(enforced.isPrefValueEnforced(1, label));
+  rv += SDK_ASSERT(enforced.isPrefValueEnforced(2, color));
+  rv += SDK_ASSERT(!enforced.isPrefValueEnforced(2, label));
+  rv += SDK_ASSERT(!enforced.isPrefValueEnforced(3, color));
+
+  enforced.enforcePrefValue(1, color, false);
+  enforced.enforcePrefValue(3, color, false);
+  rv += SDK_ASSERT(!enforced.isPrefValueEnforced(1, color));
+  rv += SDK_ASSERT(enforced.size() == 2);
+
+  enforced.removeEntity(1);
+  rv += SDK_ASSERT(!enforced.isPrefValueEnforced(1, label));
+  rv += SDK_ASSERT(enforced.isPrefValueEnforced(2, color));
+  rv += SDK_ASSERT(enforced.size() == 1);
+
+  enforced.clear();
+  rv += SDK_ASSERT(enforced.size() == 0);
+  rv += SDK_ASSERT(!enforced.isPrefValueEnforced(2, color));
+  return rv;
+}
+
+}
+
+int PrefRuleIndexTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testAffectedRules();
+  rv += testAffectedRulesComplete();
+  rv += testApplyChangedRules();
+  rv += testOverlappingRules();
+  rv += testEnforcement();
+  return rv;
+}
@@ -0,0 +1,454 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
+#include "simData/CommandPrefsHistory.h"
+#include "simData/DataTypes.h"
+#include "simData/MemoryDataStore.h"
+#include "simData/MessageVisitor/Message.h"
+#include "simData/MessageVisitor/MessageVisitor.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Deterministic pseudo-random numbers, so failures are repeatable */
+class Random
+{
+public:
+  explicit Random(uint32_t seed) : state_(seed) {}
+  uint32_t next(uint32_t range)
+  {
+    state_ = state_ * 1664525u + 1013904223u;
+    return (state_ >> 8) % range;
+  }
+private:
+  uint32_t state_;
+};
+
+/** Collects the names of leaf fields that are set */
+class SetFieldsVisitor : public simData::protobuf::MessageVisitor::Visitor
+{
+public:
+  explicit SetFieldsVisitor(std::vector<std::string>& fields) : fields_(fields) {}
+  virtual void visit(const google::protobuf::Message& message, const google::protobuf::FieldDescriptor& descriptor, const std::string& variableName)
+  {
+    const google::protobuf::Reflection& reflection = *message.GetReflection();
+    if (descriptor.is_repeated() ? reflection.FieldSize(message, &descriptor) > 0 : reflection.HasField(message, &descriptor))
+      fields_.push_back(variableName);
+  }
+private:
+  std::vector<std::string>& fields_;
+};
+
+/** Replays commands up to the given time the way MemoryCommandSlice::advance_() does, for reference */
+simData::BeamPrefs replay(const std::vector<simData::BeamCommand>& commands, double time)
+{
+  simData::BeamPrefs cache;
+  for (const simData::BeamCommand& cmd : commands)
+  {
+    if (cmd.time() > time)
+      break;
+    if (cmd.isclearcommand())
+    {
+      std::vector<std::string> fields;
+      SetFieldsVisitor visitor(fields);
+      simData::protobuf::MessageVisitor::visit(cmd.updateprefs(), visitor);
+      for (const std::string& field : fields)
+        simData::protobuf::clearField(cache, field);
+    }
+    else
+    {
+      if (cmd.updateprefs().commonprefs().acceptprojectorids_size() != 0)
+        cache.mutable_commonprefs()->mutable_acceptprojectorids()->Clear();
+      cache.MergeFrom(cmd.updateprefs());
+    }
+  }
+  return cache;
+}
+
+/** Sets one of a variety of fields in the prefs, covering each field type and nesting level */
+void setRandomField(Random& random, simData::BeamPrefs& prefs)
+{
+  switch (random.next(11))
+  {
+  case 0:
+    prefs.mutable_commonprefs()->set_datadraw(random.next(2) == 0);
+    break;
+  case 1:
+    prefs.mutable_commonprefs()->set_color(0xff000000 | random.next(0xffffff));
+    break;
+  case 2:
+  {
+    const uint32_t count = 1 + random.next(3);
+    for (uint32_t k = 0; k < count; ++k)
+      prefs.mutable_commonprefs()->add_acceptprojectorids(1 + random.next(10));
+    break;
+  }
+  case 3:
+    prefs.mutable_commonprefs()->mutable_labelprefs()->set_draw(random.next(2) == 0);
+    break;
+  case 4:
+    prefs.set_beamdrawmode(random.next(2) == 0 ? simData::BeamPrefs::WIRE : simData::BeamPrefs::SOLID);
+    break;
+  case 5:
+    prefs.set_horizontalwidth(0.01 * random.next(100));
+    break;
+  case 6:
+    prefs.set_arepsfile("file" + std::to_string(random.next(5)));
+    break;
+  case 7:
+    prefs.set_targetid(random.next(20));
+    break;
+  case 8:
+    // Present but empty sub-message
+    prefs.mutable_beampositionoffset();
+    break;
+  case 9:
+    prefs.mutable_antennapattern()->set_type(simData::BeamPrefs::AntennaPattern::FILE);
+    break;
+  default:
+    prefs.set_verticalwidth(-0.5 * random.next(10));
+    break;
+  }
+}
+
+/** Creates a command stream with repeated times, clear commands, and all the field types above */
+std::vector<simData::BeamCommand> makeCommands(Random& random, size_t count)
+{
+  std::vector<simData::BeamCommand> commands;
+  double time = 0.0;
+  for (size_t k = 0; k < count; ++k)
+  {
+    // Occasionally repeat the time, which merges with the previous command
+    const bool sameTime = !commands.empty() && !commands.back().isclearcommand() && random.next(8) == 0;
+    if (!sameTime)
+      time += 0.5 + random.next(4);
+    simData::BeamCommand cmd;
+    cmd.set_time(time);
+    if (!sameTime && random.next(6) == 0)
+      cmd.set_isclearcommand(true);
+    const uint32_t fields = 1 + random.next(3);
+    for (uint32_t f = 0; f < fields; ++f)
+      setRandomField(random, *cmd.mutable_updateprefs());
+    commands.push_back(cmd);
+  }
+  return commands;
+}
+
+int testSeekMatchesReplay()
+{
+  int rv = 0;
+  Random random(42);
+  const std::vector<simData::BeamCommand> commands = makeCommands(random, 400);
+
+  simData::CommandPrefsHistory history;
+  for (const simData::BeamCommand& cmd : commands)
+    history.add(cmd.time(), cmd.isclearcommand(), cmd.updateprefs());
+  rv += SDK_ASSERT(history.isValid());
+  rv += SDK_ASSERT(history.numFields() > 10);
+  rv += SDK_ASSERT(history.numCommands() < commands.size());
+
+  size_t mismatches = 0;
+  const double endTime = commands.back().time() + 1.0;
+  for (double time = -1.0; time <= endTime; time += 0.25)
+  {
+    simData::BeamPrefs seekPrefs;
+    double lastTime = -1.0e10;
+    rv += SDK_ASSERT(history.seek(time, seekPrefs, lastTime));
+    const simData::BeamPrefs replayPrefs = replay(commands, time);
+    if (seekPrefs.SerializeAsString() != replayPrefs.SerializeAsString())
+      ++mismatches;
+
+    // Last command time is the latest command at or before time
+    double expectedTime = -1.0e10;
+    for (const simData::BeamCommand& cmd : commands)
+    {
+      if (cmd.time() <= time)
+        expectedTime = cmd.time();
+    }
+    if (lastTime != expectedTime)
+      ++mismatches;
+  }
+  rv += SDK_ASSERT(mismatches == 0);
+
+  rv += SDK_ASSERT(history.numCommands(commands.front().time(), commands.back().time()) == history.numCommands() - 1);
+  rv += SDK_ASSERT(history.numCommands(10.0, 5.0) == 0);
+  return rv;
+}
+
+int testInvalidation()
+{
+  int rv = 0;
+  simData::CommandPrefsHistory history;
+  simData::BeamPrefs prefs;
+  prefs.mutable_commonprefs()->set_datadraw(true);
+  history.add(2.0, false, prefs);
+  rv += SDK_ASSERT(history.isValid());
+
+  // Out of order
+  history.add(1.0, false, prefs);
+  rv += SDK_ASSERT(!history.isValid());
+  simData::BeamPrefs out;
+  double lastTime = 0.0;
+  rv += SDK_ASSERT(!history.seek(5.0, out, lastTime));
+  history.clear();
+  rv += SDK_ASSERT(history.isValid() && history.numCommands() == 0 && history.numRecords() == 0);
+
+  // Clear and set commands at the same time
+  history.add(1.0, false, prefs);
+  history.add(1.0, true, prefs);
+  rv += SDK_ASSERT(!history.isValid());
+
+  // Repeated strings append on replay, which is not supported
+  history.clear();
+  simData::PlatformPrefs platPrefs;
+  platPrefs.add_gogfile("a.gog");
+  history.add(1.0, false, platPrefs);
+  rv += SDK_ASSERT(!history.isValid());
+
+  history.clear();
+  history.invalidate();
+  rv += SDK_ASSERT(!history.isValid());
+  return rv;
+}
+
+/** Adds a color command to the beam or gate */
+void addColorCommand(simData::DataStore& ds, simData::ObjectId id, double time, uint32_t color, bool isBeam)
+{
+  simData::DataStore::Transaction t;
+  simData::CommonPrefs* commonPrefs = nullptr;
+  if (isBeam)
+  {
+    simData::BeamCommand* cmd = ds.addBeamCommand(id, &t);
+    cmd->set_time(time);
+    commonPrefs = cmd->mutable_updateprefs()->mutable_commonprefs();
+    commonPrefs->set_color(color);
+    commonPrefs->add_acceptprojectorids(color);
+  }
+  else
+  {
+    simData::GateCommand* cmd = ds.addGateCommand(id, &t);
+    cmd->set_time(time);
+    commonPrefs = cmd->mutable_updateprefs()->mutable_commonprefs();
+    commonPrefs->set_color(color);
+    commonPrefs->add_acceptprojectorids(color);
+  }
+  t.commit();
+}
+
+int checkColor(simData::DataStore& ds, simData::ObjectId id, double time, uint32_t color, bool isBeam)
+{
+  ds.update(time);
+  simData::DataStore::Transaction t;
+  const simData::CommonPrefs& commonPrefs = isBeam ? ds.beamPrefs(id, &t)->commonprefs() : ds.gatePrefs(id, &t)->commonprefs();
+  if (commonPrefs.color() != color)
+    return 1;
+  return (commonPrefs.acceptprojectorids_size() == 1 && commonPrefs.acceptprojectorids(0) == color) ? 0 : 1;
+}
+
+/** Seeks in random order through the data store, with history updates from live appends, out-of-order inserts and flushes */
+int testDataStoreSeek(bool seekHistory)
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  rv += SDK_ASSERT(!ds.commandSeekHistory());
+  ds.setCommandSeekHistory(seekHistory);
+  rv += SDK_ASSERT(ds.commandSeekHistory() == seekHistory);
+  simUtil::DataStoreTestHelper helper(&ds);
+  const uint64_t platId = helper.addPlatform();
+  const uint64_t beamId = helper.addBeam(platId);
+  const uint64_t gateId = helper.addGate(beamId);
+
+  for (bool isBeam : { true, false })
+  {
+    const uint64_t id = isBeam ? beamId : gateId;
+    // Colors at times 1..200, color value equal to time
+    for (uint32_t k = 1; k <= 200; ++k)
+      addColorCommand(ds, id, k, k, isBeam);
+
+    Random random(isBeam ? 7 : 8);
+    for (int k = 0; k < 300; ++k)
+    {
+      const uint32_t time = 1 + random.next(200);
+      rv += SDK_ASSERT(checkColor(ds, id, time + 0.5, time, isBeam) == 0);
+    }
+    rv += SDK_ASSERT(checkColor(ds, id, 300.0, 200, isBeam) == 0);
+
+    // Live append, merged into the last command at the same time
+    addColorCommand(ds, id, 201, 201, isBeam);
+    addColorCommand(ds, id, 201, 1201, isBeam);
+    rv += SDK_ASSERT(checkColor(ds, id, 201.0, 1201, isBeam) == 0);
+    rv += SDK_ASSERT(checkColor(ds, id, 50.0, 50, isBeam) == 0);
+
+    // Out of order insert, rebuilding the history
+    addColorCommand(ds, id, 49.5, 4950, isBeam);
+    rv += SDK_ASSERT(checkColor(ds, id, 49.75, 4950, isBeam) == 0);
+    rv += SDK_ASSERT(checkColor(ds, id, 49.25, 49, isBeam) == 0);
+    rv += SDK_ASSERT(checkColor(ds, id, 150.0, 150, isBeam) == 0);
+  }
+
+  // Flushing the range removes the commands from the history too
+  ds.flush(beamId, simData::DataStore::FLUSH_NONRECURSIVE, simData::DataStore::FLUSH_COMMANDS, 100.0, 150.0);
+  rv += SDK_ASSERT(checkColor(ds, beamId, 140.0, 99, true) == 0);
+  rv += SDK_ASSERT(checkColor(ds, beamId, 20.0, 20, true) == 0);
+  rv += SDK_ASSERT(checkColor(ds, beamId, 160.0, 160, true) == 0);
+  return rv;
+}
+
+/** Adds beam and gate color commands at times before, at and after -1 */
+void addNegativeTimeCommands(simData::MemoryDataStore& ds, uint64_t& beamId, uint64_t& gateId)
+{
+  simUtil::DataStoreTestHelper helper(&ds);
+  beamId = helper.addBeam(helper.addPlatform());
+  gateId = helper.addGate(beamId);
+  for (double time : { -5.0, -2.0, -1.0, -0.5, 0.0, 2.0, 4.0 })
+  {
+    const uint32_t color = static_cast<uint32_t>(100 + time * 10);
+    addColorCommand(ds, beamId, time, color, true);
+    addColorCommand(ds, gateId, time, color, false);
+  }
+}
+
+/** A backward seek applies the commands at time -1 and earlier, the same as playing forward from the start */
+int testBackwardSeekMatchesReplay(bool seekHistory)
+{
+  int rv = 0;
+  simData::MemoryDataStore seekDs;
+  seekDs.setCommandSeekHistory(seekHistory);
+  uint64_t seekBeam = 0;
+  uint64_t seekGate = 0;
+  addNegativeTimeCommands(seekDs, seekBeam, seekGate);
+
+  for (double time : { 10.0, 3.0, 0.0, -0.75, -1.0, -1.5, -3.0, -5.0 })
+  {
+    // Seek backward from the end of the data
+    seekDs.update(10.0);
+    seekDs.update(time);
+
+    // Full replay: a new data store playing forward from the start
+    simData::MemoryDataStore replayDs;
+    uint64_t replayBeam = 0;
+    uint64_t replayGate = 0;
+    addNegativeTimeCommands(replayDs, replayBeam, replayGate);
+    replayDs.update(time);
+
+    // A backward seek also resets the draw state, which no command here sets, so compare the rest
+    simData::DataStore::Transaction t;
+    simData::BeamPrefs seekBeamPrefs = *seekDs.beamPrefs(seekBeam, &t);
+    simData::BeamPrefs replayBeamPrefs = *replayDs.beamPrefs(replayBeam, &t);
+    seekBeamPrefs.mutable_commonprefs()->clear_datadraw();
+    replayBeamPrefs.mutable_commonprefs()->clear_datadraw();
+    rv += SDK_ASSERT(seekBeamPrefs.SerializeAsString() == replayBeamPrefs.SerializeAsString());
+    simData::GatePrefs seekGatePrefs = *seekDs.gatePrefs(seekGate, &t);
+    simData::GatePrefs replayGatePrefs = *replayDs.gatePrefs(replayGate, &t);
+    seekGatePrefs.mutable_commonprefs()->clear_datadraw();
+    replayGatePrefs.mutable_commonprefs()->clear_datadraw();
+    rv += SDK_ASSERT(seekGatePrefs.SerializeAsString() == replayGatePrefs.SerializeAsString());
+  }
+
+  // Commands at time -1 and earlier are in effect after a backward seek
+  rv += SDK_ASSERT(checkColor(seekDs, seekBeam, 10.0, 140, true) == 0);
+  rv += SDK_ASSERT(checkColor(seekDs, seekBeam, -1.5, 80, true) == 0);
+  rv += SDK_ASSERT(checkColor(seekDs, seekGate, -1.0, 90, false) == 0);
+  rv += SDK_ASSERT(checkColor(seekDs, seekGate, -4.0, 50, false) == 0);
+  return rv;
+}
+
+/** Prints memory and seek timing of the history against protobuf replay; not a pass/fail test, run when SIMDIS_SDK_BENCHMARK is set */
+int benchmarkSeek()
+{
+  Random random(1234);
+  const std::vector<simData::BeamCommand> commands = makeCommands(random, 5000);
+
+  simData::CommandPrefsHistory history;
+  size_t commandBytes = 0;
+  for (const simData::BeamCommand& cmd : commands)
+  {
+    history.add(cmd.time(), cmd.isclearcommand(), cmd.updateprefs());
+    commandBytes += cmd.SpaceUsedLong();
+  }
+  std::cout << "Beam command history: " << commands.size() << " commands use " << commandBytes << " bytes as protobuf, "
+    << history.numRecords() << " records in " << history.numFields() << " fields use " << history.memoryUsage() << " bytes" << std::endl;
+
+  std::vector<double> seekTimes;
+  for (int k = 0; k < 100; ++k)
+    seekTimes.push_back(random.next(static_cast<uint32_t>(commands.back().time())));
+
+  double startTime = simCore::getSystemTime();
+  size_t replayBytes = 0;
+  for (double time : seekTimes)
+    replayBytes += replay(commands, time).ByteSizeLong();
+  const double replayTime = simCore::getSystemTime() - startTime;
+
+  startTime = simCore::getSystemTime();
+  size_t seekBytes = 0;
+  simData::BeamPrefs prefs;
+  double lastTime = 0.0;
+  for (double time : seekTimes)
+  {
+    history.seek(time, prefs, lastTime);
+    seekBytes += prefs.ByteSizeLong();
+  }
+  const double seekTime = simCore::getSystemTime() - startTime;
+  std::cout << seekTimes.size() << " random seeks: replay " << replayTime << "s, history " << seekTime << "s ("
+    << replayBytes << "/" << seekBytes << ")" << std::endl;
+
+  // Same random seeks through the data store
+  for (bool seekHistory : { false, true })
+  {
+    simData::MemoryDataStore ds;
+    ds.setCommandSeekHistory(seekHistory);
+    simUtil::DataStoreTestHelper helper(&ds);
+    const uint64_t beamId = helper.addBeam(helper.addPlatform());
+    for (const simData::BeamCommand& cmd : commands)
+      helper.addBeamCommand(cmd, beamId);
+    startTime = simCore::getSystemTime();
+    for (double time : seekTimes)
+      ds.update(time);
+    std::cout << seekTimes.size() << " random data store updates " << (seekHistory ? "with" : "without") << " history: "
+      << (simCore::getSystemTime() - startTime) << "s" << std::endl;
+  }
+  return 0;
+}
+
+}
+
+int TestCommandPrefsHistory(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testSeekMatchesReplay();
+  rv += testInvalidation();
+  rv += testDataStoreSeek(true);
+  rv += testDataStoreSeek(false);
+  rv += testBackwardSeekMatchesReplay(true);
+  rv += testBackwardSeekMatchesReplay(false);
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+    rv += benchmarkSeek();
+  return rv;
+}
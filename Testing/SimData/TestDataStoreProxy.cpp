@@ -0,0 +1,322 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/DataStoreProxy.h"
+#include "simData/DataTable.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Counts every entity notification from the data store */
+class CountingListener : public simData::DataStore::DefaultListener
+{
+public:
+  virtual void onAddEntity(simData::DataStore* source, simData::ObjectId newId, simData::ObjectType ot) { ++adds; }
+  virtual void onRemoveEntity(simData::DataStore* source, simData::ObjectId removedId, simData::ObjectType ot) { ++removes; }
+  virtual void onPrefsChange(simData::DataStore* source, simData::ObjectId id) { ++prefs; }
+  virtual void onPropertiesChange(simData::DataStore* source, simData::ObjectId id) { ++properties; }
+  virtual void onCategoryDataChange(simData::DataStore* source, simData::ObjectId changedId, simData::ObjectType ot) { ++categories; }
+  virtual void onNameChange(simData::DataStore* source, simData::ObjectId changeId) { ++names; }
+  virtual void onFlush(simData::DataStore* source, simData::ObjectId id) { ++flushes; }
+  virtual void onScenarioDelete(simData::DataStore* source) { ++scenarioDeletes; }
+
+  /** Returns the total number of notifications */
+  int total() const
+  {
+    return adds + removes + prefs + properties + categories + names + flushes + scenarioDeletes;
+  }
+
+  void clear()
+  {
+    *this = CountingListener();
+  }
+
+  int adds = 0;
+  int removes = 0;
+  int prefs = 0;
+  int properties = 0;
+  int categories = 0;
+  int names = 0;
+  int flushes = 0;
+  int scenarioDeletes = 0;
+};
+
+uint64_t addPlatform(simUtil::DataStoreTestHelper& helper, uint64_t originalId, const std::string& name, int numUpdates)
+{
+  const uint64_t id = helper.addPlatform(originalId);
+  simData::PlatformPrefs prefs;
+  prefs.mutable_commonprefs()->set_name(name);
+  helper.updatePlatformPrefs(prefs, id);
+  for (int k = 0; k < numUpdates; ++k)
+    helper.addPlatformUpdate(k, id);
+  return id;
+}
+
+uint64_t addBeam(simUtil::DataStoreTestHelper& helper, uint64_t hostId, uint64_t originalId, const std::string& name)
+{
+  const uint64_t id = helper.addBeam(hostId, originalId);
+  simData::BeamPrefs prefs;
+  prefs.mutable_commonprefs()->set_name(name);
+  helper.updateBeamPrefs(prefs, id);
+  helper.addBeamUpdate(1.0, id);
+  return id;
+}
+
+/**
+ * Fills in a scenario: platforms one through four, with beams on one and four.  Platform one
+ * also has category data, generic data, and a data table.
+ */
+void fillScenario(simData::DataStore* dataStore)
+{
+  simUtil::DataStoreTestHelper helper(dataStore);
+  const uint64_t one = addPlatform(helper, 1, "one", 5);
+  helper.addCategoryData(one, "Color", "Red", 0.0);
+  helper.addCategoryData(one, "Shape", "Round", 2.0);
+  helper.addGenericData(one, "Fuel", "Full", 0.0);
+  helper.addDataTable(one, 3, "Table");
+  addBeam(helper, one, 10, "beam10");
+  addPlatform(helper, 2, "two", 5);
+  addPlatform(helper, 3, "three", 5);
+  const uint64_t four = addPlatform(helper, 4, "four", 5);
+  addBeam(helper, four, 40, "beam40");
+}
+
+/** Returns the ID of the entity with the given original ID, or 0 */
+uint64_t idFor(const simData::DataStore& dataStore, uint64_t originalId, simData::ObjectType type)
+{
+  simData::DataStore::IdList ids;
+  dataStore.idListByOriginalId(&ids, originalId, type);
+  return (ids.size() == 1) ? ids[0] : 0;
+}
+
+int testIdenticalReset()
+{
+  int rv = 0;
+  simData::DataStoreProxy proxy(new simData::MemoryDataStore());
+  fillScenario(&proxy);
+  auto listener = std::make_shared<CountingListener>();
+  proxy.addListener(listener);
+  const simData::DataStore* original = proxy.dataStore();
+  const uint64_t one = idFor(proxy, 1, simData::PLATFORM);
+  const uint64_t beam = idFor(proxy, 10, simData::BEAM);
+  const simData::TableId tableId = proxy.dataTableManager().findTable(one, "Table")->tableId();
+
+  simData::MemoryDataStore* incoming = new simData::MemoryDataStore();
+  fillScenario(incoming);
+  proxy.reset(incoming, simData::DataStoreProxy::RESET_DIFFERENTIAL);
+
+  // Same data store, same IDs, and not a single notification
+  rv += SDK_ASSERT(proxy.dataStore() == original);
+  rv += SDK_ASSERT(listener->total() == 0);
+  rv += SDK_ASSERT(idFor(proxy, 1, simData::PLATFORM) == one);
+  rv += SDK_ASSERT(idFor(proxy, 10, simData::BEAM) == beam);
+  rv += SDK_ASSERT(proxy.dataTableManager().findTable(one, "Table")->tableId() == tableId);
+  simData::DataStore::IdList ids;
+  proxy.idList(&ids);
+  rv += SDK_ASSERT(ids.size() == 6);
+  return rv;
+}
+
+int testDifferentialReset()
+{
+  int rv = 0;
+  simData::DataStoreProxy proxy(new simData::MemoryDataStore());
+  fillScenario(&proxy);
+  auto listener = std::make_shared<CountingListener>();
+  proxy.addListener(listener);
+  const uint64_t one = idFor(proxy, 1, simData::PLATFORM);
+  const uint64_t two = idFor(proxy, 2, simData::PLATFORM);
+  const uint64_t three = idFor(proxy, 3, simData::PLATFORM);
+  const uint64_t beam = idFor(proxy, 10, simData::BEAM);
+
+  // Platform two is renamed, three has more data, four and its beam are gone, five and a beam are new
+  simData::MemoryDataStore* incoming = new simData::MemoryDataStore();
+  {
+    simUtil::DataStoreTestHelper helper(incoming);
+    const uint64_t newOne = addPlatform(helper, 1, "one", 5);
+    helper.addCategoryData(newOne, "Shape", "Round", 2.0);
+    helper.addCategoryData(newOne, "Color", "Red", 0.0);
+    helper.addGenericData(newOne, "Fuel", "Full", 0.0);
+    helper.addDataTable(newOne, 3, "Table");
+    addPlatform(helper, 2, "two-renamed", 5);
+    addPlatform(helper, 3, "three", 7);
+    const uint64_t five = addPlatform(helper, 5, "five", 5);
+    addBeam(helper, five, 50, "beam50");
+    addBeam(helper, newOne, 10, "beam10");
+  }
+  proxy.reset(incoming, simData::DataStoreProxy::RESET_DIFFERENTIAL);
+
+  rv += SDK_ASSERT(listener->adds == 2);
+  rv += SDK_ASSERT(listener->removes == 2);
+  // Rename of two, and the prefs of the two new entities
+  rv += SDK_ASSERT(listener->prefs == 3);
+  rv += SDK_ASSERT(listener->names == 3);
+  rv += SDK_ASSERT(listener->properties == 0);
+  rv += SDK_ASSERT(listener->flushes == 1);
+  rv += SDK_ASSERT(listener->categories == 0);
+  rv += SDK_ASSERT(listener->scenarioDeletes == 0);
+
+  // Surviving entities keep their IDs
+  rv += SDK_ASSERT(idFor(proxy, 1, simData::PLATFORM) == one);
+  rv += SDK_ASSERT(idFor(proxy, 2, simData::PLATFORM) == two);
+  rv += SDK_ASSERT(idFor(proxy, 3, simData::PLATFORM) == three);
+  rv += SDK_ASSERT(idFor(proxy, 10, simData::BEAM) == beam);
+  rv += SDK_ASSERT(idFor(proxy, 4, simData::PLATFORM) == 0);
+  rv += SDK_ASSERT(idFor(proxy, 40, simData::BEAM) == 0);
+
+  // New entities are hosted correctly, and changes were applied
+  const uint64_t five = idFor(proxy, 5, simData::PLATFORM);
+  const uint64_t beam50 = idFor(proxy, 50, simData::BEAM);
+  rv += SDK_ASSERT(five != 0 && beam50 != 0);
+  rv += SDK_ASSERT(proxy.entityHostId(beam50) == five);
+  rv += SDK_ASSERT(proxy.beamUpdateSlice(beam50)->numItems() == 1);
+  simData::DataStore::Transaction txn;
+  rv += SDK_ASSERT(proxy.platformPrefs(two, &txn)->commonprefs().name() == "two-renamed");
+  rv += SDK_ASSERT(proxy.platformPrefs(five, &txn)->commonprefs().name() == "five");
+  rv += SDK_ASSERT(proxy.platformUpdateSlice(three)->numItems() == 7);
+  rv += SDK_ASSERT(proxy.platformUpdateSlice(two)->numItems() == 5);
+
+  // Only category data on platform one changes
+  listener->clear();
+  incoming = new simData::MemoryDataStore();
+  {
+    simUtil::DataStoreTestHelper helper(incoming);
+    const uint64_t newOne = addPlatform(helper, 1, "one", 5);
+    helper.addCategoryData(newOne, "Color", "Blue", 0.0);
+    helper.addGenericData(newOne, "Fuel", "Full", 0.0);
+    helper.addDataTable(newOne, 4, "Table");
+    addPlatform(helper, 2, "two-renamed", 5);
+    addPlatform(helper, 3, "three", 7);
+    const uint64_t newFive = addPlatform(helper, 5, "five", 5);
+    addBeam(helper, newFive, 50, "beam50");
+    addBeam(helper, newOne, 10, "beam10");
+  }
+  proxy.reset(incoming, simData::DataStoreProxy::RESET_DIFFERENTIAL);
+  rv += SDK_ASSERT(listener->flushes == 1);
+  rv += SDK_ASSERT(listener->total() == 1);
+  rv += SDK_ASSERT(proxy.platformUpdateSlice(one)->numItems() == 5);
+  proxy.update(3.0);
+  std::vector<std::pair<std::string, std::string> > categories;
+  proxy.categoryDataSlice(one)->allStrings(categories);
+  rv += SDK_ASSERT(categories.size() == 1 && categories[0].second == "Blue");
+  // Data table was replaced with the new contents
+  const simData::DataTable* table = proxy.dataTableManager().findTable(one, "Table");
+  rv += SDK_ASSERT(table != nullptr && table->column("Col0") != nullptr && table->column("Col0")->size() == 4);
+  return rv;
+}
+
+/** Adds generic data with the given duration */
+void addGenericData(simData::DataStore& dataStore, uint64_t id, const std::string& key, const std::string& value, double time, double duration)
+{
+  simData::DataStore::Transaction transaction;
+  simData::GenericData* data = dataStore.addGenericData(id, &transaction);
+  data->set_time(time);
+  data->set_duration(duration);
+  simData::GenericData_Entry* entry = data->add_entry();
+  entry->set_key(key);
+  entry->set_value(value);
+  transaction.complete(&data);
+}
+
+/** Collects the duration of each visited generic data entry, by key */
+class DurationVisitor : public simData::GenericDataSlice::Visitor
+{
+public:
+  virtual void operator()(const simData::GenericData* update)
+  {
+    for (int k = 0; k < update->entry_size(); ++k)
+      durations.push_back(std::make_pair(update->entry(k).key(), update->duration()));
+  }
+
+  std::vector<std::pair<std::string, double> > durations;
+};
+
+int testGenericDataDuration()
+{
+  int rv = 0;
+  simData::DataStoreProxy proxy(new simData::MemoryDataStore());
+  simUtil::DataStoreTestHelper helper(&proxy);
+  addPlatform(helper, 1, "one", 1);
+  helper.addGenericData(idFor(proxy, 1, simData::PLATFORM), "Fuel", "Full", 0.0);
+
+  // Same key and value at the same time, but with a finite duration, alongside an infinite one
+  simData::MemoryDataStore* incoming = new simData::MemoryDataStore();
+  simUtil::DataStoreTestHelper incomingHelper(incoming);
+  const uint64_t newOne = addPlatform(incomingHelper, 1, "one", 1);
+  addGenericData(*incoming, newOne, "Fuel", "Full", 0.0, 5.0);
+  addGenericData(*incoming, newOne, "Status", "Ready", 0.0, -1.0);
+  proxy.reset(incoming, simData::DataStoreProxy::RESET_DIFFERENTIAL);
+
+  // Copy keeps each duration, splitting entries at the same time by duration
+  DurationVisitor visitor;
+  proxy.genericDataSlice(idFor(proxy, 1, simData::PLATFORM))->visit(&visitor);
+  rv += SDK_ASSERT(visitor.durations.size() == 2);
+  for (const auto& keyDuration : visitor.durations)
+  {
+    if (keyDuration.first == "Fuel")
+      rv += SDK_ASSERT(keyDuration.second == 5.0);
+    else
+      rv += SDK_ASSERT(keyDuration.first == "Status" && keyDuration.second == -1.0);
+  }
+  return rv;
+}
+
+int testReplaceReset()
+{
+  int rv = 0;
+  simData::DataStoreProxy proxy(new simData::MemoryDataStore());
+  fillScenario(&proxy);
+  auto listener = std::make_shared<CountingListener>();
+  proxy.addListener(listener);
+
+  // Replacement swaps the data store outright, carrying the listeners over
+  simData::MemoryDataStore* incoming = new simData::MemoryDataStore();
+  proxy.reset(incoming);
+  rv += SDK_ASSERT(proxy.dataStore() == incoming);
+  simData::DataStore::IdList ids;
+  proxy.idList(&ids);
+  rv += SDK_ASSERT(ids.empty());
+  simUtil::DataStoreTestHelper helper(&proxy);
+  addPlatform(helper, 1, "one", 0);
+  rv += SDK_ASSERT(listener->adds == 1);
+  return rv;
+}
+
+}
+
+int TestDataStoreProxy(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testIdenticalReset() == 0);
+  rv += SDK_ASSERT(testDifferentialReset() == 0);
+  rv += SDK_ASSERT(testGenericDataDuration() == 0);
+  rv += SDK_ASSERT(testReplaceReset() == 0);
+  return rv;
+}
@@ -0,0 +1,301 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
+#include "simData/DataStoreHelpers.h"
+#include "simData/EntityActivity.h"
+#include "simData/MemoryDataStore.h"
+#include "simUtil/DataStoreTestHelper.h"
+
+namespace
+{
+
+/** Deterministic pseudo-random numbers, so failures are repeatable */
+class Random
+{
+public:
+  explicit Random(uint32_t seed) : state_(seed) {}
+  uint32_t next(uint32_t range)
+  {
+    state_ = state_ * 1664525u + 1013904223u;
+    return (state_ >> 8) % range;
+  }
+private:
+  uint32_t state_;
+};
+
+/** Builds a scenario of hosted entities with random draw and target commands */
+class Scenario
+{
+public:
+  Scenario(simUtil::DataStoreTestHelper& helper, uint32_t seed)
+    : helper_(helper),
+      random_(seed)
+  {
+  }
+
+  /** Adds platforms, each hosting beams, gates, lasers, LOB groups, projectors and custom renderings */
+  void build(int numPlatforms, int commandsPerEntity)
+  {
+    for (int k = 0; k < numPlatforms; ++k)
+    {
+      const uint64_t platformId = helper_.addPlatform();
+      platforms_.push_back(platformId);
+      // Some platforms are static, the rest span a random part of the scenario
+      if (random_.next(5) == 0)
+        helper_.addPlatformUpdate(-1.0, platformId);
+      else
+      {
+        helper_.addPlatformUpdate(random_.next(50), platformId);
+        helper_.addPlatformUpdate(50 + random_.next(50), platformId);
+      }
+    }
+
+    for (size_t k = 0; k < platforms_.size(); ++k)
+    {
+      const uint64_t platformId = platforms_[k];
+      for (int beamIndex = 0; beamIndex < 2; ++beamIndex)
+      {
+        const uint64_t beamId = helper_.addBeam(platformId, 0, beamIndex == 1);
+        beams_.push_back(beamId);
+        for (int command = 0; command < commandsPerEntity; ++command)
+          addBeamCommand(beamId, random_.next(100));
+        const uint64_t gateId = helper_.addGate(beamId);
+        gates_.push_back(gateId);
+        for (int command = 0; command < commandsPerEntity; ++command)
+          addGateCommand(gateId, random_.next(100));
+      }
+
+      const uint64_t laserId = helper_.addLaser(platformId);
+      for (int command = 0; command < commandsPerEntity; ++command)
+      {
+        simData::LaserCommand cmd;
+        cmd.set_time(random_.next(100));
+        cmd.mutable_updateprefs()->mutable_commonprefs()->set_datadraw(random_.next(2) == 0);
+        helper_.addLaserCommand(cmd, laserId);
+      }
+      helper_.addLOB(platformId);
+      helper_.addProjector(platformId);
+
+      // Custom renderings may also be top level
+      const uint64_t crId = helper_.addCustomRendering((k % 2) ? platformId : 0);
+      for (int command = 0; command < commandsPerEntity; ++command)
+      {
+        simData::CustomRenderingCommand cmd;
+        cmd.set_time(random_.next(100));
+        cmd.mutable_updateprefs()->mutable_commonprefs()->set_datadraw(random_.next(2) == 0);
+        helper_.addCustomRenderingCommand(cmd, crId);
+      }
+    }
+  }
+
+  /** Adds a beam command at the given time that may change draw state, target, or something unrelated */
+  void addBeamCommand(uint64_t beamId, double time)
+  {
+    simData::BeamCommand cmd;
+    cmd.set_time(time);
+    switch (random_.next(3))
+    {
+    case 0:
+      cmd.mutable_updateprefs()->mutable_commonprefs()->set_datadraw(random_.next(3) != 0);
+      break;
+    case 1:
+      cmd.mutable_updateprefs()->set_targetid(platforms_[random_.next(static_cast<uint32_t>(platforms_.size()))]);
+      break;
+    default:
+      cmd.mutable_updateprefs()->set_beamscale(1.0 + random_.next(10));
+      break;
+    }
+    helper_.addBeamCommand(cmd, beamId);
+  }
+
+  /** Adds a gate command at the given time that may change draw state */
+  void addGateCommand(uint64_t gateId, double time)
+  {
+    simData::GateCommand cmd;
+    cmd.set_time(time);
+    if (random_.next(2) == 0)
+      cmd.mutable_updateprefs()->mutable_commonprefs()->set_datadraw(random_.next(3) != 0);
+    else
+      cmd.mutable_updateprefs()->set_gatelighting(random_.next(2) == 0);
+    helper_.addGateCommand(cmd, gateId);
+  }
+
+  Random& random() { return random_; }
+  const std::vector<uint64_t>& beams() const { return beams_; }
+  const std::vector<uint64_t>& gates() const { return gates_; }
+
+private:
+  simUtil::DataStoreTestHelper& helper_;
+  Random random_;
+  std::vector<uint64_t> platforms_;
+  std::vector<uint64_t> beams_;
+  std::vector<uint64_t> gates_;
+};
+
+/** Compares bulk and single evaluation against DataStoreHelpers::isEntityActive() at the given times */
+int compareToHelper(const simData::DataStore& ds, simData::EntityActivity& activity, const std::vector<double>& times)
+{
+  int rv = 0;
+  simData::DataStore::IdList ids;
+  ds.idList(&ids);
+  std::vector<bool> active;
+  for (double time : times)
+  {
+    activity.evaluate(ids, time, active);
+    rv += SDK_ASSERT(active.size() == ids.size());
+    int mismatches = 0;
+    size_t numActive = 0;
+    for (size_t k = 0; k < ids.size() && k < active.size(); ++k)
+    {
+      const bool expected = simData::DataStoreHelpers::isEntityActive(ds, ids[k], time);
+      if (active[k] != expected || activity.isActive(ids[k], time) != expected)
+        ++mismatches;
+      if (expected)
+        ++numActive;
+    }
+    rv += SDK_ASSERT(mismatches == 0);
+
+    std::vector<simData::ObjectId> activeIds;
+    activity.activeEntities(time, activeIds);
+    rv += SDK_ASSERT(activeIds.size() == numActive);
+  }
+  return rv;
+}
+
+int testConsistency()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper helper;
+  Scenario scenario(helper, 1234u);
+  scenario.build(40, 8);
+
+  simData::DataStore& ds = *helper.dataStore();
+  simData::EntityActivity activity(ds);
+
+  // Integer times land exactly on commands and platform bounds; the rest fall between them
+  std::vector<double> times;
+  for (int k = -2; k <= 102; ++k)
+  {
+    times.push_back(k);
+    times.push_back(k + 0.5);
+  }
+  rv += compareToHelper(ds, activity, times);
+
+  // Reevaluation reuses the index
+  const size_t numBuilds = activity.numIndexBuilds();
+  rv += SDK_ASSERT(numBuilds > 0);
+  rv += compareToHelper(ds, activity, times);
+  rv += SDK_ASSERT(activity.numIndexBuilds() == numBuilds);
+
+  // New commands, including ones merged into existing times and ones out of order, rebuild the index
+  for (int k = 0; k < 200; ++k)
+  {
+    const auto& beams = scenario.beams();
+    const auto& gates = scenario.gates();
+    scenario.addBeamCommand(beams[scenario.random().next(static_cast<uint32_t>(beams.size()))], scenario.random().next(100));
+    scenario.addGateCommand(gates[scenario.random().next(static_cast<uint32_t>(gates.size()))], scenario.random().next(100));
+  }
+  rv += compareToHelper(ds, activity, times);
+  rv += SDK_ASSERT(activity.numIndexBuilds() > numBuilds);
+
+  // Flushing removes commands
+  ds.flush(0, simData::DataStore::FLUSH_RECURSIVE, simData::DataStore::FLUSH_COMMANDS, 0.0, 30.0);
+  rv += compareToHelper(ds, activity, times);
+
+  // Removed entities are no longer active
+  const simData::ObjectId removedBeam = scenario.beams().front();
+  ds.removeEntity(removedBeam);
+  rv += SDK_ASSERT(!activity.isActive(removedBeam, 75.0));
+  rv += compareToHelper(ds, activity, times);
+
+  // With data limiting, platforms follow their draw pref
+  ds.setDataLimiting(true);
+  rv += compareToHelper(ds, activity, times);
+  return rv;
+}
+
+int benchmark()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper helper;
+  Scenario scenario(helper, 42u);
+  scenario.build(1000, 50);
+
+  const simData::DataStore& ds = *helper.dataStore();
+  simData::DataStore::IdList ids;
+  ds.idList(&ids);
+  simData::EntityActivity activity(ds);
+  std::vector<bool> active;
+  // Build the index outside of the timing
+  activity.evaluate(ids, 0.0, active);
+
+  const int numPasses = 100;
+  double startTime = simCore::getSystemTime();
+  size_t helperActive = 0;
+  for (int pass = 0; pass < numPasses; ++pass)
+  {
+    for (auto id : ids)
+    {
+      if (simData::DataStoreHelpers::isEntityActive(ds, id, pass))
+        ++helperActive;
+    }
+  }
+  const double helperTime = simCore::getSystemTime() - startTime;
+
+  startTime = simCore::getSystemTime();
+  size_t bulkActive = 0;
+  for (int pass = 0; pass < numPasses; ++pass)
+  {
+    activity.evaluate(ids, pass, active);
+    for (bool isActive : active)
+    {
+      if (isActive)
+        ++bulkActive;
+    }
+  }
+  const double bulkTime = simCore::getSystemTime() - startTime;
+  rv += SDK_ASSERT(helperActive == bulkActive);
+
+  // The counts must agree on every run; the timings are only of interest when benchmarking
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+  {
+    std::cout << "Entity activity of " << ids.size() << " entities over " << numPasses << " times: isEntityActive "
+      << helperTime << "s, EntityActivity " << bulkTime << "s" << std::endl;
+  }
+  return rv;
+}
+
+}
+
+int TestEntityActivity(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testConsistency();
+  rv += benchmark();
+  return rv;
+}
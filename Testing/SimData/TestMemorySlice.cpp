@@ -21,7 +21,9 @@
  *
  */
 
+#include "simCore/Calc/Math.h"
 #include "simCore/Common/SDKAssert.h"
+#include "simData/MemoryDataSlice.h"
 #include "simUtil/DataStoreTestHelper.h"
 
 namespace
@@ -192,6 +194,143 @@ int testStaticPlatformUpdates()
   return rv;
 }
 
+/// Adds a LOB group update with the given number of points to the slice
+void addLobGroupUpdate(simData::LobGroupMemoryDataSlice& slice, double time, int numPoints)
+{
+  simData::LobGroupUpdate* update = new simData::LobGroupUpdate();
+  update->set_time(time);
+  for (int k = 0; k < numPoints; ++k)
+  {
+    simData::LobGroupUpdatePoint* point = update->add_datapoints();
+    point->set_azimuth(time + k * 0.01);
+    point->set_elevation(0.0);
+    point->set_range(1000.0);
+  }
+  slice.insert(update);
+}
+
+/// Returns 0 if the slice's current() contains exactly the points of updates in [startTime, endTime] (in order)
+int checkLobGroupWindow(const simData::LobGroupMemoryDataSlice& slice, double startTime, double endTime, int pointsPerUpdate)
+{
+  const simData::LobGroupUpdate* current = slice.current();
+  if (startTime > endTime)
+    return SDK_ASSERT(current == nullptr);
+  if (current == nullptr)
+    return SDK_ASSERT(current != nullptr);
+
+  int rv = 0;
+  const int numUpdates = static_cast<int>(endTime - startTime) + 1;
+  rv += SDK_ASSERT(current->datapoints_size() == numUpdates * pointsPerUpdate);
+  for (int k = 0; k < current->datapoints_size() && rv == 0; ++k)
+  {
+    const double expectedTime = startTime + (k / pointsPerUpdate);
+    rv += SDK_ASSERT(current->datapoints(k).time() == expectedTime);
+    rv += SDK_ASSERT(current->datapoints(k).azimuth() == expectedTime + (k % pointsPerUpdate) * 0.01);
+  }
+  return rv;
+}
+
+int testLobGroupIncrementalUpdate()
+{
+  int rv = 0;
+  const int pointsPerUpdate = 3;
+
+  simData::LobGroupMemoryDataSlice slice;
+  slice.setMaxDataSeconds(9.0);
+  for (int k = 1; k <= 100; ++k)
+    addLobGroupUpdate(slice, k, pointsPerUpdate);
+
+  // Before any data
+  slice.update(0.5);
+  rv += SDK_ASSERT(slice.current() == nullptr);
+  rv += SDK_ASSERT(!slice.hasChanged());
+
+  // Fill the window; each step copies only the update that entered the window
+  slice.update(1.0);
+  rv += SDK_ASSERT(slice.hasChanged());
+  rv += checkLobGroupWindow(slice, 1.0, 1.0, pointsPerUpdate);
+  rv += SDK_ASSERT(slice.numPointsCopied() == static_cast<size_t>(pointsPerUpdate));
+  const simData::LobGroupUpdate* firstCurrent = slice.current();
+  for (int k = 2; k <= 60; ++k)
+  {
+    const size_t copiedBefore = slice.numPointsCopied();
+    slice.update(k);
+    rv += SDK_ASSERT(slice.hasChanged());
+    rv += checkLobGroupWindow(slice, simCore::sdkMax(1.0, k - 9.0), k, pointsPerUpdate);
+    rv += SDK_ASSERT(slice.current()->time() == k);
+    rv += SDK_ASSERT(slice.numPointsCopied() - copiedBefore == static_cast<size_t>(pointsPerUpdate));
+  }
+  // Window was advanced in place
+  rv += SDK_ASSERT(slice.current() == firstCurrent);
+
+  // Same time is a no-op
+  size_t copiedBefore = slice.numPointsCopied();
+  slice.update(60.0);
+  rv += SDK_ASSERT(!slice.hasChanged());
+  rv += SDK_ASSERT(slice.numPointsCopied() == copiedBefore);
+
+  // Time between updates copies nothing, but still moves the window
+  slice.update(60.5);
+  rv += SDK_ASSERT(slice.hasChanged());
+  rv += SDK_ASSERT(slice.numPointsCopied() == copiedBefore);
+  rv += SDK_ASSERT(slice.current()->time() == 60.5);
+  rv += SDK_ASSERT(slice.current()->datapoints(0).time() == 52.0);
+
+  // Jumping forward past the whole window only copies the new window
+  slice.update(90.0);
+  rv += checkLobGroupWindow(slice, 81.0, 90.0, pointsPerUpdate);
+  rv += SDK_ASSERT(slice.numPointsCopied() - copiedBefore == static_cast<size_t>(10 * pointsPerUpdate));
+
+  // Going backwards in time rebuilds the window
+  copiedBefore = slice.numPointsCopied();
+  slice.update(30.0);
+  rv += checkLobGroupWindow(slice, 21.0, 30.0, pointsPerUpdate);
+  rv += SDK_ASSERT(slice.numPointsCopied() - copiedBefore == static_cast<size_t>(10 * pointsPerUpdate));
+
+  // Data inserted inside the window forces a rebuild that includes it
+  addLobGroupUpdate(slice, 25.5, pointsPerUpdate);
+  copiedBefore = slice.numPointsCopied();
+  slice.update(30.0);
+  rv += SDK_ASSERT(slice.hasChanged());
+  rv += SDK_ASSERT(slice.current()->datapoints_size() == 11 * pointsPerUpdate);
+  rv += SDK_ASSERT(slice.numPointsCopied() - copiedBefore == static_cast<size_t>(11 * pointsPerUpdate));
+
+  // Data inserted after the window is appended when time reaches it
+  addLobGroupUpdate(slice, 30.5, pointsPerUpdate);
+  copiedBefore = slice.numPointsCopied();
+  slice.update(30.5);
+  rv += SDK_ASSERT(slice.current()->datapoints_size() == 11 * pointsPerUpdate);
+  rv += SDK_ASSERT(slice.numPointsCopied() - copiedBefore == static_cast<size_t>(pointsPerUpdate));
+
+  // Point limiting is applied on top of the time window
+  slice.setMaxDataPoints(4);
+  slice.update(50.0);
+  rv += checkLobGroupWindow(slice, 47.0, 50.0, pointsPerUpdate);
+  copiedBefore = slice.numPointsCopied();
+  slice.update(51.0);
+  rv += checkLobGroupWindow(slice, 48.0, 51.0, pointsPerUpdate);
+  rv += SDK_ASSERT(slice.numPointsCopied() - copiedBefore == static_cast<size_t>(pointsPerUpdate));
+
+  // Moving past the end of the data keeps the last points until they age out
+  slice.update(105.0);
+  rv += checkLobGroupWindow(slice, 97.0, 100.0, pointsPerUpdate);
+  slice.update(120.0);
+  rv += SDK_ASSERT(slice.current() == nullptr);
+  rv += SDK_ASSERT(slice.hasChanged());
+  slice.update(121.0);
+  rv += SDK_ASSERT(slice.current() == nullptr);
+  rv += SDK_ASSERT(!slice.hasChanged());
+
+  // Flushing clears the current state
+  slice.update(100.0);
+  rv += SDK_ASSERT(slice.current() != nullptr);
+  slice.flush();
+  slice.update(100.0);
+  rv += SDK_ASSERT(slice.current() == nullptr);
+
+  return rv;
+}
+
 }
 
 int TestMemorySlice(int argc, char* argv[])
@@ -201,6 +340,7 @@ int TestMemorySlice(int argc, char* argv[])
   rv += testDeltaTime();
   rv += duplicatePoints();
   rv += testStaticPlatformUpdates();
+  rv += testLobGroupIncrementalUpdate();
 
   return rv;
 }
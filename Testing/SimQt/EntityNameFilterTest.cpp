@@ -0,0 +1,291 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <vector>
+#include <QRegExp>
+#include <QStringList>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
+#include "simQt/AbstractEntityTreeModel.h"
+#include "simQt/EntityNameFilter.h"
+
+namespace
+{
+
+/** Minimal entity tree of top level platforms with child entities, for exercising entity filters */
+class TestEntityTreeModel : public simQt::AbstractEntityTreeModel
+{
+public:
+  TestEntityTreeModel()
+    : AbstractEntityTreeModel(nullptr),
+      numDataCalls_(0)
+  {
+  }
+
+  /** Adds a top level entity */
+  void addPlatform(uint64_t id, const QString& name)
+  {
+    beginInsertRows(QModelIndex(), static_cast<int>(topLevel_.size()), static_cast<int>(topLevel_.size()));
+    topLevel_.push_back(newItem_(id, name, nullptr, static_cast<int>(topLevel_.size())));
+    endInsertRows();
+  }
+
+  /** Adds a child entity under the given host */
+  void addChild(uint64_t hostId, uint64_t id, const QString& name)
+  {
+    Item* host = items_[hostId].get();
+    const int row = static_cast<int>(host->children.size());
+    beginInsertRows(createIndex(host->row, 0, host), row, row);
+    host->children.push_back(newItem_(id, name, host, row));
+    endInsertRows();
+  }
+
+  /** Changes the name of an entity, notifying the same way the data store backed model does */
+  void rename(uint64_t id, const QString& name)
+  {
+    Item* item = items_[id].get();
+    item->name = name;
+    Q_EMIT dataChanged(createIndex(item->row, 0, item), createIndex(item->row, 2, item));
+  }
+
+  /** Number of times data() was called */
+  int numDataCalls() const
+  {
+    return numDataCalls_;
+  }
+
+  virtual QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const
+  {
+    const std::vector<Item*>& rows = parent.isValid() ? static_cast<Item*>(parent.internalPointer())->children : topLevel_;
+    if (row < 0 || row >= static_cast<int>(rows.size()) || column < 0 || column >= columnCount(parent))
+      return QModelIndex();
+    return createIndex(row, column, rows[row]);
+  }
+
+  virtual QModelIndex index(uint64_t id) const
+  {
+    auto it = items_.find(id);
+    if (it == items_.end())
+      return QModelIndex();
+    return createIndex(it->second->row, 0, it->second.get());
+  }
+
+  virtual QModelIndex index(uint64_t id)
+  {
+    return static_cast<const TestEntityTreeModel*>(this)->index(id);
+  }
+
+  virtual uint64_t uniqueId(const QModelIndex& index) const
+  {
+    if (!index.isValid())
+      return 0;
+    return static_cast<Item*>(index.internalPointer())->id;
+  }
+
+  virtual QModelIndex parent(const QModelIndex& child) const
+  {
+    if (!child.isValid())
+      return QModelIndex();
+    Item* parentItem = static_cast<Item*>(child.internalPointer())->parent;
+    if (parentItem == nullptr)
+      return QModelIndex();
+    return createIndex(parentItem->row, 0, parentItem);
+  }
+
+  virtual int rowCount(const QModelIndex& parent = QModelIndex()) const
+  {
+    if (!parent.isValid())
+      return static_cast<int>(topLevel_.size());
+    if (parent.column() != 0)
+      return 0;
+    return static_cast<int>(static_cast<Item*>(parent.internalPointer())->children.size());
+  }
+
+  virtual int columnCount(const QModelIndex& parent = QModelIndex()) const
+  {
+    return 3;
+  }
+
+  virtual QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const
+  {
+    ++numDataCalls_;
+    if (!index.isValid() || role != Qt::DisplayRole || index.column() != 0)
+      return QVariant();
+    return static_cast<Item*>(index.internalPointer())->name;
+  }
+
+  virtual bool useEntityIcons() const { return false; }
+  virtual int countEntityTypes(simData::ObjectType type) const { return static_cast<int>(items_.size()); }
+  virtual void setToTreeView() {}
+  virtual void setToListView() {}
+  virtual void toggleTreeView(bool useTree) {}
+  virtual void forceRefresh() {}
+  virtual void setUseEntityIcons(bool useIcons) {}
+
+private:
+  struct Item
+  {
+    uint64_t id;
+    QString name;
+    Item* parent;
+    int row;
+    std::vector<Item*> children;
+  };
+
+  Item* newItem_(uint64_t id, const QString& name, Item* parent, int row)
+  {
+    std::unique_ptr<Item> item(new Item);
+    item->id = id;
+    item->name = name;
+    item->parent = parent;
+    item->row = row;
+    Item* rv = item.get();
+    items_[id] = std::move(item);
+    return rv;
+  }
+
+  std::map<uint64_t, std::unique_ptr<Item> > items_;
+  std::vector<Item*> topLevel_;
+  mutable int numDataCalls_;
+};
+
+int testAcceptAndCache()
+{
+  int rv = 0;
+  TestEntityTreeModel model;
+  model.addPlatform(1, "alpha");
+  model.addChild(1, 2, "beam1");
+  model.addPlatform(3, "bravo");
+  model.addPlatform(4, "charlie");
+  model.addChild(4, 5, "gate-x");
+
+  simQt::EntityNameFilter filter(&model);
+  filter.setRegExp(QRegExp("beam"));
+
+  // Hosts pass when any child passes
+  rv += SDK_ASSERT(filter.acceptEntity(1));
+  rv += SDK_ASSERT(filter.acceptEntity(2));
+  rv += SDK_ASSERT(!filter.acceptEntity(3));
+  rv += SDK_ASSERT(!filter.acceptEntity(4));
+  rv += SDK_ASSERT(!filter.acceptEntity(5));
+  const unsigned int firstEvaluations = filter.numNameEvaluations();
+  const int firstDataCalls = model.numDataCalls();
+  rv += SDK_ASSERT(firstEvaluations == 5);
+
+  // Second pass with the same pattern is served from the cache
+  rv += SDK_ASSERT(filter.acceptEntity(1));
+  rv += SDK_ASSERT(!filter.acceptEntity(4));
+  rv += SDK_ASSERT(filter.numNameEvaluations() == firstEvaluations);
+  rv += SDK_ASSERT(model.numDataCalls() == firstDataCalls);
+
+  // Renaming a child re-evaluates only that entity, but updates its host
+  model.rename(5, "beam2");
+  rv += SDK_ASSERT(filter.acceptEntity(4));
+  rv += SDK_ASSERT(filter.acceptEntity(5));
+  rv += SDK_ASSERT(!filter.acceptEntity(3));
+  rv += SDK_ASSERT(filter.numNameEvaluations() == firstEvaluations + 1);
+  rv += SDK_ASSERT(model.numDataCalls() == firstDataCalls + 1);
+
+  // New children invalidate host results
+  model.addChild(3, 6, "beam3");
+  rv += SDK_ASSERT(filter.acceptEntity(3));
+
+  // Pattern change re-evaluates names, but does not fetch them again
+  const int dataCallsBeforePattern = model.numDataCalls();
+  filter.setRegExp(QRegExp("^b"));
+  rv += SDK_ASSERT(filter.acceptEntity(3));
+  rv += SDK_ASSERT(filter.acceptEntity(4));
+  rv += SDK_ASSERT(filter.acceptEntity(1));
+  rv += SDK_ASSERT(model.numDataCalls() == dataCallsBeforePattern);
+
+  filter.setRegExp(QRegExp("charlie"));
+  rv += SDK_ASSERT(!filter.acceptEntity(1));
+  rv += SDK_ASSERT(filter.acceptEntity(4));
+  rv += SDK_ASSERT(!filter.acceptEntity(5));
+
+  // Swapping the model drops the cache
+  TestEntityTreeModel otherModel;
+  otherModel.addPlatform(1, "charlie two");
+  filter.setModel(&otherModel);
+  rv += SDK_ASSERT(filter.acceptEntity(1));
+  filter.setModel(nullptr);
+  rv += SDK_ASSERT(!filter.acceptEntity(1));
+  return rv;
+}
+
+/** Prints timing of repeated filter passes over a large entity tree; not a pass/fail test */
+int benchmarkFilterPasses()
+{
+  const uint64_t numPlatforms = 10000;
+  const uint64_t childrenPerPlatform = 4;
+  TestEntityTreeModel model;
+  std::vector<uint64_t> ids;
+  uint64_t nextId = 1;
+  for (uint64_t k = 0; k < numPlatforms; ++k)
+  {
+    const uint64_t hostId = nextId++;
+    model.addPlatform(hostId, QString("platform %1").arg(k));
+    ids.push_back(hostId);
+    for (uint64_t c = 0; c < childrenPerPlatform; ++c)
+    {
+      model.addChild(hostId, nextId, QString("beam %1-%2").arg(k).arg(c));
+      ids.push_back(nextId++);
+    }
+  }
+
+  simQt::EntityNameFilter filter(&model);
+  const QStringList patterns = { "p", "pl", "pla", "plat", "platf", "platform 9" };
+  for (const QString& pattern : patterns)
+  {
+    filter.setRegExp(QRegExp(pattern));
+    double startTime = simCore::getSystemTime();
+    size_t numAccepted = 0;
+    for (uint64_t id : ids)
+      numAccepted += filter.acceptEntity(id) ? 1 : 0;
+    const double firstPass = simCore::getSystemTime() - startTime;
+
+    startTime = simCore::getSystemTime();
+    for (uint64_t id : ids)
+      filter.acceptEntity(id);
+    const double cachedPass = simCore::getSystemTime() - startTime;
+
+    std::cout << "Pattern \"" << pattern.toStdString() << "\" over " << ids.size() << " entities (" << numAccepted
+      << " accepted): first pass " << firstPass << "s, repeat pass " << cachedPass << "s" << std::endl;
+  }
+  return 0;
+}
+
+}
+
+int EntityNameFilterTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testAcceptAndCache() == 0);
+  // Timing output is opt-in so that CTest runs stay quiet
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+    rv += SDK_ASSERT(benchmarkFilterPasses() == 0);
+  return rv;
+}
@@ -0,0 +1,113 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/ClockImpl.h"
+#include "simData/MemoryDataStore.h"
+#include "simQt/EntityStateFilter.h"
+
+namespace
+{
+
+uint64_t addPlatform(simData::DataStore& dataStore, double startTime, double endTime)
+{
+  simData::DataStore::Transaction t;
+  simData::PlatformProperties* props = dataStore.addPlatform(&t);
+  const uint64_t id = props->id();
+  t.complete(&props);
+  for (double time : { startTime, endTime })
+  {
+    simData::PlatformUpdate* update = dataStore.addPlatformUpdate(id, &t);
+    update->set_time(time);
+    update->set_x(6378137.0);
+    update->set_y(0.0);
+    update->set_z(0.0);
+    t.complete(&update);
+  }
+  return id;
+}
+
+uint64_t addBeam(simData::DataStore& dataStore, uint64_t hostId)
+{
+  simData::DataStore::Transaction t;
+  simData::BeamProperties* props = dataStore.addBeam(&t);
+  props->set_hostid(hostId);
+  const uint64_t id = props->id();
+  t.complete(&props);
+  return id;
+}
+
+void addDataDrawCommand(simData::DataStore& dataStore, uint64_t beamId, double time, bool dataDraw)
+{
+  simData::DataStore::Transaction t;
+  simData::BeamCommand* command = dataStore.addBeamCommand(beamId, &t);
+  command->set_time(time);
+  command->mutable_updateprefs()->mutable_commonprefs()->set_datadraw(dataDraw);
+  t.complete(&command);
+}
+
+int testDataChangesAtSameTime()
+{
+  int rv = 0;
+  simData::MemoryDataStore dataStore;
+  simCore::ClockImpl clock;
+  simQt::EntityStateFilter filter(dataStore, clock);
+  filter.setStateFilter(simQt::EntityStateFilter::ACTIVE);
+
+  const uint64_t platformId = addPlatform(dataStore, 0.0, 10.0);
+  const uint64_t beamId = addBeam(dataStore, platformId);
+  addDataDrawCommand(dataStore, beamId, 0.0, true);
+  clock.setTime(simCore::TimeStamp(dataStore.referenceYear(), 5.0));
+  dataStore.update(5.0);
+  rv += SDK_ASSERT(filter.acceptEntity(platformId));
+  rv += SDK_ASSERT(filter.acceptEntity(beamId));
+
+  // A command at the current time turns the beam off while the clock is paused
+  addDataDrawCommand(dataStore, beamId, 5.0, false);
+  dataStore.update(5.0);
+  rv += SDK_ASSERT(filter.acceptEntity(platformId));
+  rv += SDK_ASSERT(!filter.acceptEntity(beamId));
+
+  // New data extends a platform to the current time
+  const uint64_t latePlatformId = addPlatform(dataStore, 6.0, 10.0);
+  dataStore.update(5.0);
+  rv += SDK_ASSERT(!filter.acceptEntity(latePlatformId));
+  simData::DataStore::Transaction t;
+  simData::PlatformUpdate* update = dataStore.addPlatformUpdate(latePlatformId, &t);
+  update->set_time(4.0);
+  update->set_x(6378137.0);
+  update->set_y(0.0);
+  update->set_z(0.0);
+  t.complete(&update);
+  dataStore.update(5.0);
+  rv += SDK_ASSERT(filter.acceptEntity(latePlatformId));
+  return rv;
+}
+
+}
+
+int EntityStateFilterTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testDataChangesAtSameTime();
+  return rv;
+}
@@ -0,0 +1,197 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <random>
+#include <vector>
+#include "osg/Camera"
+#include "osg/ref_ptr"
+#include "simCore/Common/SDKAssert.h"
+#include "simUtil/ScreenCoordinateCalculator.h"
+
+namespace {
+
+/** Camera with an 800x600 viewport in space over the equator, looking at the earth center */
+osg::ref_ptr<osg::Camera> newCamera()
+{
+  osg::ref_ptr<osg::Camera> camera = new osg::Camera;
+  camera->setViewport(0, 0, 800, 600);
+  camera->setProjectionMatrixAsPerspective(45.0, 800.0 / 600.0, 1000.0, 1e8);
+  camera->setViewMatrixAsLookAt(osg::Vec3d(2e7, 0.0, 0.0), osg::Vec3d(0.0, 0.0, 0.0), osg::Vec3d(0.0, 0.0, 1.0));
+  return camera;
+}
+
+int testBatchProjection()
+{
+  int rv = 0;
+  osg::ref_ptr<osg::Camera> camera = newCamera();
+  simUtil::ScreenCoordinateCalculator calc;
+  calc.updateMatrix(*camera);
+
+  // Points all around the earth, including behind the earth and behind the camera
+  std::mt19937 gen(1234);
+  std::uniform_real_distribution<double> coord(-2.5e7, 2.5e7);
+  std::vector<osg::Vec3d> ecef;
+  for (int k = 0; k < 1000; ++k)
+    ecef.push_back(osg::Vec3d(coord(gen), coord(gen), coord(gen)));
+
+  std::vector<simUtil::ScreenCoordinate> coords;
+  calc.calculateEcef(ecef, coords);
+  rv += SDK_ASSERT(coords.size() == ecef.size());
+  size_t numVisible = 0;
+  size_t numBehind = 0;
+  for (size_t k = 0; k < ecef.size() && k < coords.size(); ++k)
+  {
+    const simUtil::ScreenCoordinate single = calc.calculateEcef(simCore::Vec3(ecef[k].x(), ecef[k].y(), ecef[k].z()));
+    rv += SDK_ASSERT(single.position() == coords[k].position());
+    rv += SDK_ASSERT(single.isBehindCamera() == coords[k].isBehindCamera());
+    rv += SDK_ASSERT(single.isOffScreen() == coords[k].isOffScreen());
+    rv += SDK_ASSERT(single.isOverHorizon() == coords[k].isOverHorizon());
+    if (!single.isBehindCamera() && !single.isOffScreen() && !single.isOverHorizon())
+      ++numVisible;
+    if (single.isBehindCamera())
+      ++numBehind;
+  }
+  // Make sure the sample exercises both visible and hidden points
+  rv += SDK_ASSERT(numVisible > 0);
+  rv += SDK_ASSERT(numBehind > 0);
+
+  // Camera without a viewport cannot project
+  osg::ref_ptr<osg::Camera> noViewport = new osg::Camera;
+  simUtil::ScreenCoordinateCalculator invalidCalc;
+  invalidCalc.updateMatrix(*noViewport);
+  invalidCalc.calculateEcef(ecef, coords);
+  rv += SDK_ASSERT(coords.size() == ecef.size());
+  rv += SDK_ASSERT(!coords.empty() && coords.front().isOffScreen());
+  return rv;
+}
+
+/** Same selection rules as DynamicSelectionPicker, applied to the candidates in the order given */
+void pick(const std::vector<simUtil::ScreenCoordinate>& coords, const std::vector<size_t>& candidates, const osg::Vec2d& mouseXy,
+  double range, bool closest, std::vector<size_t>& picked)
+{
+  picked.clear();
+  double mouseRangeSquared = range * range;
+  for (size_t index : candidates)
+  {
+    const simUtil::ScreenCoordinate& pos = coords[index];
+    if (pos.isBehindCamera() || pos.isOffScreen() || pos.isOverHorizon())
+      continue;
+    const double rangeSquared = (mouseXy - osg::Vec2d(pos.position())).length2();
+    if (!closest)
+    {
+      if (rangeSquared <= mouseRangeSquared)
+        picked.push_back(index);
+    }
+    else if (rangeSquared < mouseRangeSquared)
+    {
+      mouseRangeSquared = rangeSquared;
+      picked = { index };
+    }
+    else if (rangeSquared == mouseRangeSquared)
+      picked.push_back(index);
+  }
+}
+
+int testBucketedPick()
+{
+  int rv = 0;
+
+  // Random screen positions, some hidden, with a few stacked on top of each other to create ties
+  std::mt19937 gen(5678);
+  std::uniform_real_distribution<double> x(-100.0, 1380.0);
+  std::uniform_real_distribution<double> y(-100.0, 1124.0);
+  std::uniform_int_distribution<int> hidden(0, 9);
+  std::vector<simUtil::ScreenCoordinate> coords;
+  for (int k = 0; k < 5000; ++k)
+  {
+    const osg::Vec3 pos(x(gen), y(gen), (hidden(gen) == 0) ? 1.5f : 0.5f);
+    const bool offScreen = pos.x() < 0 || pos.x() > 1280 || pos.y() < 0 || pos.y() > 1024;
+    coords.push_back(simUtil::ScreenCoordinate(pos, offScreen, hidden(gen) == 0));
+    if (k % 50 == 0)
+    {
+      const simUtil::ScreenCoordinate stacked = coords.back();
+      coords.push_back(stacked);
+    }
+  }
+
+  std::vector<size_t> everything;
+  for (size_t k = 0; k < coords.size(); ++k)
+    everything.push_back(k);
+
+  const double range = 40.0;
+  simUtil::ScreenCoordinateBuckets buckets(range);
+  buckets.build(coords);
+  rv += SDK_ASSERT(buckets.size() > 0 && buckets.size() < coords.size());
+
+  std::vector<size_t> candidates;
+  std::vector<size_t> expected;
+  std::vector<size_t> actual;
+  size_t totalCandidates = 0;
+  const int numMice = 500;
+  for (int k = 0; k < numMice; ++k)
+  {
+    // Alternate between random mouse positions and positions right on top of a coordinate
+    osg::Vec2d mouseXy(x(gen), y(gen));
+    if (k % 2)
+      mouseXy = coords[(k * 37) % coords.size()].position();
+
+    buckets.findNear(mouseXy, range, candidates);
+    totalCandidates += candidates.size();
+    for (size_t i = 1; i < candidates.size(); ++i)
+      rv += SDK_ASSERT(candidates[i - 1] < candidates[i]);
+
+    for (bool closest : { true, false })
+    {
+      pick(coords, everything, mouseXy, range, closest, expected);
+      pick(coords, candidates, mouseXy, range, closest, actual);
+      rv += SDK_ASSERT(expected == actual);
+    }
+  }
+  // Nearby buckets should hold only a small fraction of the coordinates
+  rv += SDK_ASSERT(totalCandidates < numMice * coords.size() / 20);
+
+  // Tiny buckets still work, even though the grid is coarsened to limit its size
+  buckets.setBucketSize(0.001);
+  buckets.build(coords);
+  const osg::Vec2d mouseXy = coords[10].position();
+  buckets.findNear(mouseXy, range, candidates);
+  pick(coords, everything, mouseXy, range, true, expected);
+  pick(coords, candidates, mouseXy, range, true, actual);
+  rv += SDK_ASSERT(expected == actual);
+
+  // No visible coordinates means no candidates
+  buckets.build(std::vector<simUtil::ScreenCoordinate>(3, simUtil::ScreenCoordinate(osg::Vec3(10.f, 10.f, 0.5f), true, false)));
+  buckets.findNear(osg::Vec2d(10.0, 10.0), range, candidates);
+  rv += SDK_ASSERT(buckets.size() == 0);
+  rv += SDK_ASSERT(candidates.empty());
+  return rv;
+}
+
+}
+
+int ScreenCoordinateTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testBatchProjection();
+  rv += testBucketedPick();
+  return rv;
+}
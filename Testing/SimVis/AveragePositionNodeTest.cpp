@@ -0,0 +1,242 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <vector>
+#include "osg/ref_ptr"
+#include "simCore/Calc/Coordinate.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simVis/AveragePositionNode.h"
+#include "simVis/Entity.h"
+#include "simVis/Locator.h"
+
+namespace
+{
+
+/// Minimal entity positioned by its own locator; counts position queries
+class TestEntityNode : public simVis::EntityNode
+{
+public:
+  explicit TestEntityNode(simData::ObjectId id)
+    : EntityNode(simData::PLATFORM, new simVis::Locator()),
+      id_(id),
+      numGetPosition_(0)
+  {
+  }
+
+  /// Moves the entity to the given ECEF position
+  void setPosition(double x, double y, double z)
+  {
+    getLocator()->setCoordinate(simCore::Coordinate(simCore::COORD_SYS_ECEF, simCore::Vec3(x, y, z)), 0.0);
+  }
+
+  unsigned int numGetPosition() const { return numGetPosition_; }
+
+  virtual int getPosition(simCore::Vec3* out_position, simCore::CoordinateSystem coordsys = simCore::COORD_SYS_ECEF) const
+  {
+    ++numGetPosition_;
+    return EntityNode::getPosition(out_position, coordsys);
+  }
+
+  virtual const std::string getEntityName(NameType nameType, bool allowBlankAlias = false) const { return ""; }
+  virtual std::string popupText() const { return ""; }
+  virtual std::string hookText() const { return ""; }
+  virtual std::string legendText() const { return ""; }
+  virtual unsigned int objectIndexTag() const { return 0; }
+  virtual simData::ObjectId getId() const { return id_; }
+  virtual bool getHostId(simData::ObjectId& hostId) const { hostId = id_; return true; }
+  virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force = false) { return false; }
+  virtual void flush() {}
+  virtual double range() const { return 0.0; }
+
+protected:
+  virtual ~TestEntityNode() {}
+
+private:
+  simData::ObjectId id_;
+  mutable unsigned int numGetPosition_;
+};
+
+/// Runs the average node's update callback, as the update traversal would
+void runUpdate(simVis::AveragePositionNode& avgNode)
+{
+  avgNode.getUpdateCallback()->run(&avgNode, nullptr);
+}
+
+/// Bounding sphere computed from scratch over the visible nodes, in tracking order
+osg::BoundingSphere fullComputation(const std::vector<osg::ref_ptr<TestEntityNode> >& nodes)
+{
+  osg::BoundingSphere sphere;
+  for (auto it = nodes.begin(); it != nodes.end(); ++it)
+  {
+    if (!(*it)->isVisible())
+      continue;
+    simCore::Vec3 pos;
+    if ((*it)->getPosition(&pos) == 0)
+      sphere.expandBy(osg::Vec3d(pos.x(), pos.y(), pos.z()));
+  }
+  return sphere;
+}
+
+/// Returns 0 if the average node matches the full computation exactly
+int matchesFull(const simVis::AveragePositionNode& avgNode, const std::vector<osg::ref_ptr<TestEntityNode> >& nodes)
+{
+  int rv = 0;
+  const osg::BoundingSphere expected = fullComputation(nodes);
+  rv += SDK_ASSERT(avgNode.boundingSphereRadius() == expected.radius());
+  rv += SDK_ASSERT(avgNode.getMatrix().getTrans() == expected.center());
+  return rv;
+}
+
+/// Total number of position queries across all nodes
+unsigned int totalGetPosition(const std::vector<osg::ref_ptr<TestEntityNode> >& nodes)
+{
+  unsigned int total = 0;
+  for (auto it = nodes.begin(); it != nodes.end(); ++it)
+    total += (*it)->numGetPosition();
+  return total;
+}
+
+/// Creates nodes scattered on a grid near the surface
+std::vector<osg::ref_ptr<TestEntityNode> > makeNodes(size_t numNodes)
+{
+  std::vector<osg::ref_ptr<TestEntityNode> > nodes;
+  for (size_t k = 0; k < numNodes; ++k)
+  {
+    osg::ref_ptr<TestEntityNode> node = new TestEntityNode(k + 1);
+    node->setPosition(6378137.0 + (k % 7) * 100.0, (k % 11) * 250.0 - 1000.0, (k / 11) * 300.0);
+    nodes.push_back(node);
+  }
+  return nodes;
+}
+
+int testMatchesFullComputation()
+{
+  int rv = 0;
+  std::vector<osg::ref_ptr<TestEntityNode> > nodes = makeNodes(50);
+  std::vector<simVis::EntityNode*> rawNodes;
+  for (auto it = nodes.begin(); it != nodes.end(); ++it)
+    rawNodes.push_back(it->get());
+  osg::ref_ptr<simVis::AveragePositionNode> avgNode = new simVis::AveragePositionNode(rawNodes);
+
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 1);
+  rv += SDK_ASSERT(totalGetPosition(nodes) == 50);
+  rv += matchesFull(*avgNode, nodes);
+
+  // Nothing moved: no positions read and no recalculation
+  unsigned int numQueries = totalGetPosition(nodes);
+  runUpdate(*avgNode);
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 1);
+  rv += SDK_ASSERT(totalGetPosition(nodes) == numQueries);
+
+  // Moving a few nodes only reads their positions
+  nodes[3]->setPosition(6378137.0, 5000.0, 0.0);
+  nodes[17]->setPosition(6378137.0, -200.0, 100.0);
+  nodes[42]->setPosition(6379137.0, 0.0, 2000.0);
+  numQueries = totalGetPosition(nodes);
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 2);
+  rv += SDK_ASSERT(totalGetPosition(nodes) == numQueries + 3);
+  rv += matchesFull(*avgNode, nodes);
+
+  // Hiding a node on the edge shrinks the sphere
+  nodes[3]->setNodeMask(0);
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 3);
+  rv += matchesFull(*avgNode, nodes);
+  nodes[3]->setNodeMask(~0);
+  runUpdate(*avgNode);
+  rv += matchesFull(*avgNode, nodes);
+
+  // Removing a node recalculates without it
+  avgNode->removeTrackedNode(nodes[42].get());
+  nodes.erase(nodes.begin() + 42);
+  runUpdate(*avgNode);
+  rv += matchesFull(*avgNode, nodes);
+  rv += SDK_ASSERT(avgNode->getNumTrackedNodes() == 49);
+
+  // Deleted nodes are dropped
+  nodes.pop_back();
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->getNumTrackedNodes() == 48);
+  rv += matchesFull(*avgNode, nodes);
+  return rv;
+}
+
+int testRecomputeInterval()
+{
+  int rv = 0;
+  std::vector<osg::ref_ptr<TestEntityNode> > nodes = makeNodes(20);
+  osg::ref_ptr<simVis::AveragePositionNode> avgNode = new simVis::AveragePositionNode;
+  for (auto it = nodes.begin(); it != nodes.end(); ++it)
+    avgNode->addTrackedNode(it->get());
+  avgNode->setRadiusRecomputeInterval(3);
+  rv += SDK_ASSERT(avgNode->radiusRecomputeInterval() == 3);
+
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 1);
+  rv += matchesFull(*avgNode, nodes);
+
+  // Move a node outward, then back; the sphere grows right away but does not shrink until the interval elapses
+  nodes[5]->setPosition(6378137.0, 50000.0, 0.0);
+  runUpdate(*avgNode);
+  const double grownRadius = avgNode->boundingSphereRadius();
+  rv += SDK_ASSERT(grownRadius > 20000.0);
+  nodes[5]->setPosition(6378137.0, 0.0, 0.0);
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 1);
+  rv += SDK_ASSERT(avgNode->boundingSphereRadius() >= grownRadius);
+
+  // The sphere always contains every node
+  const osg::Vec3d center = avgNode->getMatrix().getTrans();
+  for (auto it = nodes.begin(); it != nodes.end(); ++it)
+  {
+    simCore::Vec3 pos;
+    (*it)->getPosition(&pos);
+    rv += SDK_ASSERT((osg::Vec3d(pos.x(), pos.y(), pos.z()) - center).length() <= avgNode->boundingSphereRadius() + 1e-6);
+  }
+
+  // Deferred recalculation happens even without further motion
+  runUpdate(*avgNode);
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 2);
+  rv += matchesFull(*avgNode, nodes);
+
+  // And then stops until something changes
+  runUpdate(*avgNode);
+  runUpdate(*avgNode);
+  runUpdate(*avgNode);
+  runUpdate(*avgNode);
+  rv += SDK_ASSERT(avgNode->numRecomputes() == 2);
+  return rv;
+}
+
+}
+
+int AveragePositionNodeTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testMatchesFullComputation();
+  rv += testRecomputeInterval();
+  return rv;
+}
@@ -0,0 +1,152 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "osgEarth/Ephemeris"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/TimeClass.h"
+#include "simVis/EphemerisVector.h"
+
+namespace
+{
+
+/** Ephemeris that counts the number of evaluations of each body */
+class CountingEphemeris : public osgEarth::Ephemeris
+{
+public:
+  CountingEphemeris()
+    : sunCount(0),
+      moonCount(0)
+  {
+  }
+
+  virtual osgEarth::CelestialBody getSunPosition(const osgEarth::DateTime& dt) const
+  {
+    ++sunCount;
+    return osgEarth::Ephemeris::getSunPosition(dt);
+  }
+
+  virtual osgEarth::CelestialBody getMoonPosition(const osgEarth::DateTime& dt) const
+  {
+    ++moonCount;
+    return osgEarth::Ephemeris::getMoonPosition(dt);
+  }
+
+  mutable int sunCount;
+  mutable int moonCount;
+};
+
+int testOneEvaluationPerTime()
+{
+  int rv = 0;
+  osg::ref_ptr<CountingEphemeris> ephemeris = new CountingEphemeris;
+  osg::ref_ptr<simVis::EphemerisCache> cache = new simVis::EphemerisCache(ephemeris.get(), 8);
+
+  // Many platforms requesting the same time result in a single evaluation
+  const simCore::TimeStamp t1(2021, 86400.0);
+  const osg::Vec3d sun1 = cache->sunPosition(t1);
+  const osg::Vec3d moon1 = cache->moonPosition(t1);
+  for (int k = 0; k < 100; ++k)
+  {
+    rv += SDK_ASSERT(cache->sunPosition(t1) == sun1);
+    rv += SDK_ASSERT(cache->moonPosition(t1) == moon1);
+  }
+  rv += SDK_ASSERT(ephemeris->sunCount == 1);
+  rv += SDK_ASSERT(ephemeris->moonCount == 1);
+  rv += SDK_ASSERT(cache->size() == 1);
+
+  // Cached values match direct evaluation
+  const osgEarth::DateTime dateTime(t1.secondsSinceRefYear(1970).getSeconds());
+  osg::ref_ptr<osgEarth::Ephemeris> reference = new osgEarth::Ephemeris;
+  rv += SDK_ASSERT(sun1 == reference->getSunPosition(dateTime).geocentric);
+  rv += SDK_ASSERT(moon1 == reference->getMoonPosition(dateTime).geocentric);
+
+  // Sun-only consumers do not evaluate the moon
+  const simCore::TimeStamp t2(2021, 86460.0);
+  for (int k = 0; k < 10; ++k)
+    cache->sunPosition(t2);
+  rv += SDK_ASSERT(ephemeris->sunCount == 2);
+  rv += SDK_ASSERT(ephemeris->moonCount == 1);
+  rv += SDK_ASSERT(sun1 != cache->sunPosition(t2));
+
+  // One evaluation per distinct time
+  for (int k = 0; k < 6; ++k)
+  {
+    const simCore::TimeStamp t(2021, 90000.0 + k);
+    cache->sunPosition(t);
+    cache->sunPosition(t);
+  }
+  rv += SDK_ASSERT(ephemeris->sunCount == 8);
+  rv += SDK_ASSERT(cache->size() == 8);
+  return rv;
+}
+
+int testBoundedSize()
+{
+  int rv = 0;
+  osg::ref_ptr<CountingEphemeris> ephemeris = new CountingEphemeris;
+  osg::ref_ptr<simVis::EphemerisCache> cache = new simVis::EphemerisCache(ephemeris.get(), 4);
+  rv += SDK_ASSERT(cache->maxEntries() == 4);
+
+  for (int k = 0; k < 10; ++k)
+    cache->sunPosition(simCore::TimeStamp(2021, k));
+  rv += SDK_ASSERT(cache->size() == 4);
+  rv += SDK_ASSERT(ephemeris->sunCount == 10);
+
+  // Most recent times are retained
+  cache->sunPosition(simCore::TimeStamp(2021, 9));
+  cache->sunPosition(simCore::TimeStamp(2021, 6));
+  rv += SDK_ASSERT(ephemeris->sunCount == 10);
+  // Oldest times were discarded
+  cache->sunPosition(simCore::TimeStamp(2021, 0));
+  rv += SDK_ASSERT(ephemeris->sunCount == 11);
+  rv += SDK_ASSERT(cache->size() == 4);
+
+  // Shrinking discards oldest entries
+  cache->setMaxEntries(2);
+  rv += SDK_ASSERT(cache->size() == 2);
+  cache->sunPosition(simCore::TimeStamp(2021, 0));
+  cache->sunPosition(simCore::TimeStamp(2021, 9));
+  rv += SDK_ASSERT(ephemeris->sunCount == 11);
+  cache->sunPosition(simCore::TimeStamp(2021, 8));
+  rv += SDK_ASSERT(ephemeris->sunCount == 12);
+
+  // Size never drops below 1
+  cache->setMaxEntries(0);
+  rv += SDK_ASSERT(cache->maxEntries() == 1);
+  rv += SDK_ASSERT(cache->size() == 1);
+
+  cache->clear();
+  rv += SDK_ASSERT(cache->size() == 0);
+  cache->sunPosition(simCore::TimeStamp(2021, 8));
+  rv += SDK_ASSERT(ephemeris->sunCount == 13);
+  return rv;
+}
+
+}
+
+int EphemerisCacheTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testOneEvaluationPerTime();
+  rv += testBoundedSize();
+  return rv;
+}
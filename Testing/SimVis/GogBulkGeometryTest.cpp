@@ -0,0 +1,238 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <memory>
+#include <vector>
+#include "osg/ref_ptr"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/GOG/GogShape.h"
+#include "simVis/GOG/BulkGeometry.h"
+#include "simVis/GOG/GogNodeInterface.h"
+#include "simVis/GOG/LineSegs.h"
+#include "simVis/GOG/Points.h"
+
+namespace
+{
+
+/// Position at the given lat/lon in degrees and altitude in meters
+simCore::Vec3 llaDeg(double latDeg, double lonDeg, double alt)
+{
+  return simCore::Vec3(latDeg * simCore::DEG2RAD, lonDeg * simCore::DEG2RAD, alt);
+}
+
+/// ECEF bounds of the positions, computed directly through simCore
+osg::BoundingBoxd expectedBounds(const std::vector<simCore::Vec3>& lla, double altOffset)
+{
+  osg::BoundingBoxd bounds;
+  for (const simCore::Vec3& pos : lla)
+  {
+    simCore::Vec3 ecef;
+    simCore::CoordinateConverter::convertGeodeticPosToEcef(simCore::Vec3(pos.lat(), pos.lon(), pos.alt() + altOffset), ecef);
+    bounds.expandBy(osg::Vec3d(ecef.x(), ecef.y(), ecef.z()));
+  }
+  return bounds;
+}
+
+/// Returns true if the two boxes match to within a millimeter
+bool sameBounds(const osg::BoundingBoxd& a, const osg::BoundingBoxd& b)
+{
+  return a.valid() && b.valid() && (a._min - b._min).length() < 1e-3 && (a._max - b._max).length() < 1e-3;
+}
+
+/// Grid of positions around 30N 120E
+std::vector<simCore::Vec3> grid(unsigned int count)
+{
+  std::vector<simCore::Vec3> lla;
+  for (unsigned int k = 0; k < count; ++k)
+    lla.push_back(llaDeg(30.0 + 0.01 * (k % 100), 120.0 + 0.01 * (k / 100), 100.0 * (k % 7)));
+  return lla;
+}
+
+int testPoints()
+{
+  int rv = 0;
+  const std::vector<simCore::Vec3> lla = grid(1000);
+  osg::ref_ptr<simVis::GOG::BulkGeometry> points = new simVis::GOG::BulkGeometry(simVis::GOG::BulkGeometry::BULK_POINTS);
+  rv += SDK_ASSERT(points->numVertices() == 0);
+  points->setPositions(lla);
+  rv += SDK_ASSERT(points->numVertices() == 1000);
+  rv += SDK_ASSERT(points->numPrimitives() == 1000);
+  rv += SDK_ASSERT(sameBounds(points->ecefBounds(), expectedBounds(lla, 0.0)));
+  // Vertices are anchored at the center of their bounds
+  rv += SDK_ASSERT((points->getMatrix().getTrans() - points->ecefBounds().center()).length() < 1e-6);
+
+  // Altitude offset moves every vertex without changing the count
+  points->setPositions(lla, 500.0);
+  rv += SDK_ASSERT(points->numVertices() == 1000);
+  rv += SDK_ASSERT(sameBounds(points->ecefBounds(), expectedBounds(lla, 500.0)));
+
+  points->setPositions(std::vector<simCore::Vec3>());
+  rv += SDK_ASSERT(points->numVertices() == 0);
+  rv += SDK_ASSERT(!points->ecefBounds().valid());
+  return rv;
+}
+
+int testLines()
+{
+  int rv = 0;
+  std::vector<simCore::Vec3> lla;
+  lla.push_back(llaDeg(10.0, 10.0, 0.0));
+  lla.push_back(llaDeg(11.0, 10.0, 0.0));
+  // zero length segment is dropped
+  lla.push_back(llaDeg(12.0, 12.0, 0.0));
+  lla.push_back(llaDeg(12.0, 12.0, 0.0));
+  lla.push_back(llaDeg(13.0, 13.0, 50.0));
+  lla.push_back(llaDeg(14.0, 13.0, 50.0));
+  // trailing unpaired point is dropped
+  lla.push_back(llaDeg(-40.0, -40.0, 0.0));
+
+  osg::ref_ptr<simVis::GOG::BulkGeometry> lines = new simVis::GOG::BulkGeometry(simVis::GOG::BulkGeometry::BULK_LINES);
+  lines->setPositions(lla);
+  rv += SDK_ASSERT(lines->numVertices() == 4);
+  rv += SDK_ASSERT(lines->numPrimitives() == 2);
+
+  std::vector<simCore::Vec3> drawn;
+  drawn.push_back(lla[0]);
+  drawn.push_back(lla[1]);
+  drawn.push_back(lla[4]);
+  drawn.push_back(lla[5]);
+  rv += SDK_ASSERT(sameBounds(lines->ecefBounds(), expectedBounds(drawn, 0.0)));
+
+  lines->setColor(osg::Vec4f(0.f, 1.f, 0.f, 0.5f));
+  rv += SDK_ASSERT(lines->color() == osg::Vec4f(0.f, 1.f, 0.f, 0.5f));
+  return rv;
+}
+
+int testShapeSelection()
+{
+  int rv = 0;
+  const unsigned int oldMinimum = simVis::GOG::BulkGeometry::minimumBulkSize();
+  simVis::GOG::BulkGeometry::setMinimumBulkSize(100);
+
+  simCore::GOG::Points points(false);
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(points, 99, false));
+  rv += SDK_ASSERT(simVis::GOG::BulkGeometry::supportsShape(points, 100, false));
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(points, 100, true));
+  points.setVerticalDatum("wgs84");
+  rv += SDK_ASSERT(simVis::GOG::BulkGeometry::supportsShape(points, 100, false));
+  points.setVerticalDatum("egm96");
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(points, 100, false));
+  points.setVerticalDatum("");
+  points.setAltitudeMode(simCore::GOG::AltitudeMode::CLAMP_TO_GROUND);
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(points, 100, false));
+
+  simCore::GOG::Points relative(true);
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(relative, 100, false));
+
+  simCore::GOG::LineSegs segs(false);
+  rv += SDK_ASSERT(simVis::GOG::BulkGeometry::supportsShape(segs, 100, false));
+  segs.setTesssellation(simCore::GOG::TessellationStyle::RHUMBLINE);
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(segs, 100, false));
+
+  simVis::GOG::BulkGeometry::setMinimumBulkSize(0);
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(points, 100000, false));
+  simVis::GOG::BulkGeometry::setMinimumBulkSize(oldMinimum);
+  return rv;
+}
+
+int testLoaderPath()
+{
+  int rv = 0;
+  const unsigned int oldMinimum = simVis::GOG::BulkGeometry::minimumBulkSize();
+  simVis::GOG::BulkGeometry::setMinimumBulkSize(100);
+
+  const std::vector<simCore::Vec3> lla = grid(200);
+  std::shared_ptr<simCore::GOG::Points> shape = std::make_shared<simCore::GOG::Points>(false);
+  for (const simCore::Vec3& pos : lla)
+    shape->addPoint(pos);
+  shape->setPointSize(4);
+  shape->setColor(simCore::GOG::Color(0, 0, 255, 255));
+
+  // No map node needed for the bulk path
+  std::unique_ptr<simVis::GOG::GogNodeInterface> node(simVis::GOG::Points::createPoints(*shape, false, simCore::Vec3(), nullptr));
+  rv += SDK_ASSERT(node != nullptr);
+  if (!node)
+    return rv;
+  node->setShapeObject(shape);
+  simVis::GOG::BulkGeometry* bulk = dynamic_cast<simVis::GOG::BulkGeometry*>(node->osgNode());
+  rv += SDK_ASSERT(bulk != nullptr);
+  if (!bulk)
+    return rv;
+  rv += SDK_ASSERT(bulk->numVertices() == 200);
+  rv += SDK_ASSERT(sameBounds(bulk->ecefBounds(), expectedBounds(lla, 0.0)));
+
+  // Attributes from the shape reach the drawable and the interface
+  rv += SDK_ASSERT(bulk->color() == osg::Vec4f(0.f, 0.f, 1.f, 1.f));
+  int pointSize = 0;
+  rv += SDK_ASSERT(node->getPointSize(pointSize) == 0);
+  rv += SDK_ASSERT(pointSize == 4);
+
+  // Center of the lon/lat extents, in degrees
+  osg::Vec3d center;
+  rv += SDK_ASSERT(node->getPosition(center) == 0);
+  rv += SDK_ASSERT(simCore::areEqual(center.x(), 120.0 + 0.005, 1e-9));
+  rv += SDK_ASSERT(simCore::areEqual(center.y(), 30.0 + 0.495, 1e-9));
+
+  // Altitude offset rebuilds the vertices from the original positions
+  node->setAltOffset(1000.0);
+  rv += SDK_ASSERT(sameBounds(bulk->ecefBounds(), expectedBounds(lla, 1000.0)));
+  node->setAltOffset(0.0);
+  rv += SDK_ASSERT(sameBounds(bulk->ecefBounds(), expectedBounds(lla, 0.0)));
+
+  // Clamping and extrusion cannot be drawn from the packed vertices, so they are rejected
+  simVis::GOG::AltitudeMode altMode = simVis::GOG::ALTITUDE_EXTRUDE;
+  rv += SDK_ASSERT(node->setAltitudeMode(simVis::GOG::ALTITUDE_GROUND_CLAMPED) != 0);
+  rv += SDK_ASSERT(node->setAltitudeMode(simVis::GOG::ALTITUDE_GROUND_RELATIVE) != 0);
+  rv += SDK_ASSERT(node->setAltitudeMode(simVis::GOG::ALTITUDE_EXTRUDE) != 0);
+  rv += SDK_ASSERT(node->getAltitudeMode(altMode) == 0);
+  rv += SDK_ASSERT(altMode == simVis::GOG::ALTITUDE_NONE);
+  rv += SDK_ASSERT(node->setExtrude(true) != 0);
+  rv += SDK_ASSERT(node->getAltitudeMode(altMode) == 0);
+  rv += SDK_ASSERT(altMode == simVis::GOG::ALTITUDE_NONE);
+  rv += SDK_ASSERT(sameBounds(bulk->ecefBounds(), expectedBounds(lla, 0.0)));
+  rv += SDK_ASSERT(node->setAltitudeMode(simVis::GOG::ALTITUDE_NONE) == 0);
+  rv += SDK_ASSERT(node->setExtrude(false) == 0);
+
+  // Small shapes still use the feature pipeline
+  simCore::GOG::LineSegs segs(false);
+  segs.addPoint(llaDeg(0.0, 0.0, 0.0));
+  segs.addPoint(llaDeg(1.0, 1.0, 0.0));
+  rv += SDK_ASSERT(!simVis::GOG::BulkGeometry::supportsShape(segs, segs.points().size(), false));
+
+  simVis::GOG::BulkGeometry::setMinimumBulkSize(oldMinimum);
+  return rv;
+}
+
+}
+
+int GogBulkGeometryTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testPoints() == 0);
+  rv += SDK_ASSERT(testLines() == 0);
+  rv += SDK_ASSERT(testShapeSelection() == 0);
+  rv += SDK_ASSERT(testLoaderPath() == 0);
+  return rv;
+}
@@ -0,0 +1,225 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <sstream>
+#include "osg/ref_ptr"
+#include "simCore/Common/SDKAssert.h"
+#include "simVis/LabelContentCache.h"
+
+namespace
+{
+
+/** Formats the update values for platforms and beams, counting calls and reporting the default inputs */
+class CountingCallback : public simVis::LabelContentCallback
+{
+public:
+  explicit CountingCallback(bool useDefaultInputs)
+    : useDefaultInputs_(useDefaultInputs),
+      beamInputs_(simVis::LABEL_INPUT_ORIENTATION),
+      numCalls_(0)
+  {
+  }
+
+  virtual std::string createString(const simData::PlatformPrefs& prefs, const simData::PlatformUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+  {
+    ++numCalls_;
+    std::stringstream ss;
+    if (fields.xlat())
+      ss << "X " << lastUpdate.x() << "\n";
+    if (fields.yaw())
+      ss << "Yaw " << lastUpdate.psi() << "\n";
+    if (fields.speed())
+      ss << "VX " << lastUpdate.vx() << "\n";
+    return ss.str();
+  }
+
+  virtual std::string createString(const simData::BeamPrefs& prefs, const simData::BeamUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+  {
+    ++numCalls_;
+    std::stringstream ss;
+    ss << "Az " << lastUpdate.azimuth();
+    return ss.str();
+  }
+
+  virtual std::string createString(const simData::GatePrefs& prefs, const simData::GateUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields) { return ""; }
+  virtual std::string createString(const simData::LaserPrefs& prefs, const simData::LaserUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields) { return ""; }
+  virtual std::string createString(const simData::LobGroupPrefs& prefs, const simData::LobGroupUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields) { return ""; }
+  virtual std::string createString(const simData::ProjectorPrefs& prefs, const simData::ProjectorUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields) { return ""; }
+  virtual std::string createString(simData::ObjectId id, const simData::CustomRenderingPrefs& prefs, const simData::LabelPrefs_DisplayFields& fields) { return ""; }
+
+  virtual unsigned int labelInputs(simData::ObjectType type, const simData::LabelPrefs& labelPrefs, const simData::LabelPrefs_DisplayFields& fields) const
+  {
+    if (!useDefaultInputs_)
+      return simVis::LabelContentCallback::labelInputs(type, labelPrefs, fields);
+    if (type == simData::BEAM)
+      return beamInputs_;
+    return simVis::LabelContentCache::defaultInputs(labelPrefs, fields);
+  }
+
+  unsigned int numCalls() const { return numCalls_; }
+
+private:
+  bool useDefaultInputs_;
+  unsigned int beamInputs_;
+  unsigned int numCalls_;
+};
+
+simData::PlatformUpdate makeUpdate(double time, double x, double yaw, double vx)
+{
+  simData::PlatformUpdate update;
+  update.set_time(time);
+  update.set_x(x);
+  update.set_y(2.0);
+  update.set_z(3.0);
+  update.set_psi(yaw);
+  update.set_theta(0.1);
+  update.set_phi(0.2);
+  update.set_vx(vx);
+  update.set_vy(0.0);
+  update.set_vz(0.0);
+  return update;
+}
+
+int testDefaultInputs()
+{
+  int rv = 0;
+  simData::LabelPrefs labelPrefs;
+  simData::LabelPrefs_DisplayFields fields;
+  rv += SDK_ASSERT(simVis::LabelContentCache::defaultInputs(labelPrefs, fields) == simVis::LABEL_INPUT_NONE);
+
+  fields.set_xlat(true);
+  rv += SDK_ASSERT(simVis::LabelContentCache::defaultInputs(labelPrefs, fields) == simVis::LABEL_INPUT_POSITION);
+  fields.set_yaw(true);
+  rv += SDK_ASSERT(simVis::LabelContentCache::defaultInputs(labelPrefs, fields) == (simVis::LABEL_INPUT_POSITION | simVis::LABEL_INPUT_ORIENTATION));
+
+  // ECI values rotate with time
+  labelPrefs.set_coordinatesystem(simData::ECI);
+  rv += SDK_ASSERT((simVis::LabelContentCache::defaultInputs(labelPrefs, fields) & simVis::LABEL_INPUT_TIME) != 0);
+  labelPrefs.set_coordinatesystem(simData::LLA);
+
+  // Sun position depends on time
+  simData::LabelPrefs_DisplayFields solar;
+  solar.set_solarelevation(true);
+  rv += SDK_ASSERT(simVis::LabelContentCache::defaultInputs(labelPrefs, solar) == (simVis::LABEL_INPUT_TIME | simVis::LABEL_INPUT_POSITION));
+
+  // Category data is outside the update
+  fields.set_categorydata(true);
+  rv += SDK_ASSERT(simVis::LabelContentCache::defaultInputs(labelPrefs, fields) == simVis::LABEL_INPUT_EXTERNAL);
+  return rv;
+}
+
+int testPlatformFormatCounts()
+{
+  int rv = 0;
+  osg::ref_ptr<CountingCallback> callback = new CountingCallback(true);
+  simData::PlatformPrefs prefs;
+  simData::LabelPrefs_DisplayFields fields;
+  fields.set_xlat(true);
+
+  simVis::LabelContentCache cache;
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, makeUpdate(1.0, 10.0, 0.5, 100.0), fields) == "X 10\n");
+  rv += SDK_ASSERT(cache.numFormats() == 1);
+
+  // New time, orientation and velocity do not affect a position-only label
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, makeUpdate(2.0, 10.0, 0.6, 110.0), fields) == "X 10\n");
+  rv += SDK_ASSERT(cache.numFormats() == 1);
+  rv += SDK_ASSERT(callback->numCalls() == 1);
+
+  // Position change formats again
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, makeUpdate(3.0, 11.0, 0.6, 110.0), fields) == "X 11\n");
+  rv += SDK_ASSERT(cache.numFormats() == 2);
+
+  // Prefs changes are reported through invalidate(), which picks up the new fields
+  fields.set_yaw(true);
+  cache.invalidate();
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, makeUpdate(3.0, 11.0, 0.6, 110.0), fields) == "X 11\nYaw 0.6\n");
+  rv += SDK_ASSERT(cache.numFormats() == 3);
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, makeUpdate(4.0, 11.0, 0.7, 110.0), fields) == "X 11\nYaw 0.7\n");
+  rv += SDK_ASSERT(cache.numFormats() == 4);
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, makeUpdate(5.0, 11.0, 0.7, 120.0), fields) == "X 11\nYaw 0.7\n");
+  rv += SDK_ASSERT(cache.numFormats() == 4);
+
+  // External inputs format every time
+  fields.set_categorydata(true);
+  cache.invalidate();
+  for (int k = 0; k < 3; ++k)
+    cache.createString(*callback, prefs, makeUpdate(5.0, 11.0, 0.7, 120.0), fields);
+  rv += SDK_ASSERT(cache.numFormats() == 7);
+  fields.set_categorydata(false);
+  cache.invalidate();
+
+  // Switching callbacks formats with the new callback, which by default depends on everything
+  osg::ref_ptr<CountingCallback> everyUpdate = new CountingCallback(false);
+  for (int k = 0; k < 3; ++k)
+    cache.createString(*everyUpdate, prefs, makeUpdate(5.0, 11.0, 0.7, 120.0), fields);
+  rv += SDK_ASSERT(everyUpdate->numCalls() == 3);
+  rv += SDK_ASSERT(cache.numFormats() == 10);
+
+  // Separate caches for separate field sets, e.g. label and hover
+  simVis::LabelContentCache hoverCache;
+  simData::LabelPrefs_DisplayFields hoverFields;
+  hoverFields.set_speed(true);
+  const unsigned int numCalls = callback->numCalls();
+  rv += SDK_ASSERT(hoverCache.createString(*callback, prefs, makeUpdate(6.0, 11.0, 0.8, 120.0), hoverFields) == "VX 120\n");
+  rv += SDK_ASSERT(hoverCache.createString(*callback, prefs, makeUpdate(7.0, 11.0, 0.9, 120.0), hoverFields) == "VX 120\n");
+  rv += SDK_ASSERT(hoverCache.createString(*callback, prefs, makeUpdate(8.0, 11.0, 0.9, 130.0), hoverFields) == "VX 130\n");
+  rv += SDK_ASSERT(hoverCache.numFormats() == 2);
+  rv += SDK_ASSERT(callback->numCalls() == numCalls + 2);
+  return rv;
+}
+
+int testBeamFormatCounts()
+{
+  int rv = 0;
+  osg::ref_ptr<CountingCallback> callback = new CountingCallback(true);
+  simData::BeamPrefs prefs;
+  simData::LabelPrefs_DisplayFields fields;
+  simData::BeamUpdate update;
+  update.set_time(1.0);
+  update.set_range(1000.0);
+  update.set_azimuth(0.25);
+  update.set_elevation(0.0);
+
+  simVis::LabelContentCache cache;
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, update, fields) == "Az 0.25");
+
+  // Callback only depends on beam orientation
+  update.set_time(2.0);
+  update.set_range(2000.0);
+  cache.createString(*callback, prefs, update, fields);
+  rv += SDK_ASSERT(cache.numFormats() == 1);
+  update.set_azimuth(0.5);
+  rv += SDK_ASSERT(cache.createString(*callback, prefs, update, fields) == "Az 0.5");
+  rv += SDK_ASSERT(cache.numFormats() == 2);
+  return rv;
+}
+
+}
+
+int LabelContentCacheTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testDefaultInputs();
+  rv += testPlatformFormatCounts();
+  rv += testBeamFormatCounts();
+  return rv;
+}
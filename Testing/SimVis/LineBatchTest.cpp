@@ -0,0 +1,274 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <vector>
+#include "osg/Group"
+#include "osg/MatrixTransform"
+#include "osg/ref_ptr"
+#include "simCore/Common/SDKAssert.h"
+#include "simVis/Constants.h"
+#include "simVis/LineBatch.h"
+
+namespace
+{
+
+/// Returns true if two vectors are within a small tolerance
+bool closeTo(const osg::Vec3f& a, const osg::Vec3f& b)
+{
+  return (a - b).length() < 1e-3f;
+}
+
+/// Two-point segment list from the origin to the given end point
+std::vector<osg::Vec3f> segmentTo(const osg::Vec3f& end)
+{
+  std::vector<osg::Vec3f> points(2);
+  points[1] = end;
+  return points;
+}
+
+int testPacking()
+{
+  int rv = 0;
+  osg::ref_ptr<simVis::LineBatch> batch = new simVis::LineBatch(2.f);
+  rv += SDK_ASSERT(batch->lineWidth() == 2.f);
+
+  // Frames place slots in the world; owners live under a common parent
+  osg::ref_ptr<osg::Group> scene = new osg::Group;
+  osg::ref_ptr<osg::MatrixTransform> frameA = new osg::MatrixTransform(osg::Matrixd::translate(1000., 0., 0.));
+  osg::ref_ptr<osg::MatrixTransform> frameB = new osg::MatrixTransform(osg::Matrixd::translate(0., 2000., 0.));
+  scene->addChild(frameA.get());
+  scene->addChild(frameB.get());
+
+  const simVis::LineBatch::SlotId a = batch->allocate(1, frameA.get(), frameA.get());
+  const simVis::LineBatch::SlotId b = batch->allocate(3, frameB.get(), frameB.get());
+  rv += SDK_ASSERT(a != simVis::LineBatch::INVALID_SLOT);
+  rv += SDK_ASSERT(b != simVis::LineBatch::INVALID_SLOT);
+  rv += SDK_ASSERT(batch->allocate(0, frameA.get(), nullptr) == simVis::LineBatch::INVALID_SLOT);
+  rv += SDK_ASSERT(batch->allocate(1, nullptr, nullptr) == simVis::LineBatch::INVALID_SLOT);
+  rv += SDK_ASSERT(batch->numSlots() == 2);
+  rv += SDK_ASSERT(batch->numVertices() == 8);
+  rv += SDK_ASSERT(batch->firstVertex(a) == 0);
+  rv += SDK_ASSERT(batch->firstVertex(b) == 2);
+
+  // Segment counts must match the slot size
+  rv += SDK_ASSERT(batch->setSegments(b, segmentTo(osg::Vec3f(1.f, 0.f, 0.f))) != 0);
+  std::vector<osg::Vec3f> bPoints;
+  for (int k = 0; k < 3; ++k)
+  {
+    bPoints.push_back(osg::Vec3f(0.f, 0.f, 10.f * k));
+    bPoints.push_back(osg::Vec3f(0.f, 0.f, 10.f * (k + 1)));
+  }
+  rv += SDK_ASSERT(batch->setSegments(a, segmentTo(osg::Vec3f(0.f, 100.f, 0.f))) == 0);
+  rv += SDK_ASSERT(batch->setSegments(b, bPoints) == 0);
+  batch->setColor(a, osg::Vec4f(1.f, 0.f, 0.f, 1.f));
+  batch->setColor(b, osg::Vec4f(0.f, 0.f, 1.f, 1.f));
+  batch->update();
+
+  // Vertices are world positions relative to the anchor, the first frame origin drawn
+  rv += SDK_ASSERT(batch->numAnchorGroups() == 1);
+  rv += SDK_ASSERT(batch->anchor() == osg::Vec3d(1000., 0., 0.));
+  rv += SDK_ASSERT(closeTo(batch->vertex(0), osg::Vec3f()));
+  rv += SDK_ASSERT(closeTo(batch->vertex(1), osg::Vec3f(0.f, 100.f, 0.f)));
+  rv += SDK_ASSERT(closeTo(batch->vertex(2), osg::Vec3f(-1000.f, 2000.f, 0.f)));
+  rv += SDK_ASSERT(closeTo(batch->vertex(7), osg::Vec3f(-1000.f, 2000.f, 30.f)));
+  rv += SDK_ASSERT(batch->vertexColor(1) == osg::Vec4f(1.f, 0.f, 0.f, 1.f));
+  rv += SDK_ASSERT(batch->vertexColor(7) == osg::Vec4f(0.f, 0.f, 1.f, 1.f));
+  rv += SDK_ASSERT(batch->numVertexWrites() == 8);
+
+  // Nothing changed: nothing is rewritten
+  batch->update();
+  rv += SDK_ASSERT(batch->numVertexWrites() == 8);
+
+  // Moving one frame rewrites only that slot's range
+  frameA->setMatrix(osg::Matrixd::translate(1000., 0., 50.));
+  batch->update();
+  rv += SDK_ASSERT(batch->numVertexWrites() == 10);
+  rv += SDK_ASSERT(closeTo(batch->vertex(1), osg::Vec3f(0.f, 100.f, 50.f)));
+  rv += SDK_ASSERT(closeTo(batch->vertex(2), osg::Vec3f(-1000.f, 2000.f, 0.f)));
+
+  // Color changes are applied in place
+  batch->setColor(b, osg::Vec4f(0.f, 1.f, 0.f, 1.f));
+  batch->update();
+  rv += SDK_ASSERT(batch->numVertexWrites() == 16);
+  rv += SDK_ASSERT(batch->vertexColor(4) == osg::Vec4f(0.f, 1.f, 0.f, 1.f));
+  rv += SDK_ASSERT(batch->vertexColor(0) == osg::Vec4f(1.f, 0.f, 0.f, 1.f));
+  return rv;
+}
+
+int testVisibility()
+{
+  int rv = 0;
+  osg::ref_ptr<simVis::LineBatch> batch = new simVis::LineBatch(1.f);
+  osg::ref_ptr<osg::Group> host = new osg::Group;
+  osg::ref_ptr<osg::MatrixTransform> frame = new osg::MatrixTransform;
+  host->addChild(frame.get());
+
+  const simVis::LineBatch::SlotId slot = batch->allocate(1, frame.get(), frame.get());
+  batch->setSegments(slot, segmentTo(osg::Vec3f(5.f, 0.f, 0.f)));
+  batch->setColor(slot, osg::Vec4f(1.f, 1.f, 0.f, 1.f));
+  batch->update();
+  rv += SDK_ASSERT(batch->vertexColor(0).a() == 1.f);
+
+  // Hiding an ancestor of the owner hides the slot
+  host->setNodeMask(simVis::DISPLAY_MASK_NONE);
+  batch->update();
+  rv += SDK_ASSERT(batch->vertexColor(0).a() == 0.f);
+  rv += SDK_ASSERT(batch->vertexColor(1).a() == 0.f);
+  rv += SDK_ASSERT(closeTo(batch->vertex(1), osg::Vec3f()));
+
+  // Showing it again restores the segments and color
+  host->setNodeMask(simVis::DISPLAY_MASK_PLATFORM);
+  batch->update();
+  rv += SDK_ASSERT(batch->vertexColor(1) == osg::Vec4f(1.f, 1.f, 0.f, 1.f));
+  rv += SDK_ASSERT(closeTo(batch->vertex(1), osg::Vec3f(5.f, 0.f, 0.f)));
+
+  // Explicit visibility works independently of the owner
+  batch->setVisible(slot, false);
+  batch->update();
+  rv += SDK_ASSERT(batch->vertexColor(0).a() == 0.f);
+  batch->setVisible(slot, true);
+  batch->update();
+  rv += SDK_ASSERT(batch->vertexColor(0).a() == 1.f);
+
+  // Losing the frame hides the slot
+  host->removeChild(frame.get());
+  frame = nullptr;
+  batch->update();
+  rv += SDK_ASSERT(batch->vertexColor(0).a() == 0.f);
+  return rv;
+}
+
+int testReuse()
+{
+  int rv = 0;
+  osg::ref_ptr<simVis::LineBatch> batch = new simVis::LineBatch(1.f);
+  osg::ref_ptr<osg::MatrixTransform> frame = new osg::MatrixTransform;
+
+  const simVis::LineBatch::SlotId a = batch->allocate(2, frame.get(), nullptr);
+  const simVis::LineBatch::SlotId b = batch->allocate(1, frame.get(), nullptr);
+  batch->setSegments(b, segmentTo(osg::Vec3f(1.f, 0.f, 0.f)));
+  batch->update();
+  rv += SDK_ASSERT(batch->numVertices() == 6);
+
+  // Released ranges are cleared and reused by an allocation of the same size
+  batch->release(a);
+  rv += SDK_ASSERT(batch->numSlots() == 1);
+  batch->update();
+  rv += SDK_ASSERT(batch->vertexColor(0).a() == 0.f);
+  const simVis::LineBatch::SlotId c = batch->allocate(2, frame.get(), nullptr);
+  rv += SDK_ASSERT(batch->firstVertex(c) == 0);
+  rv += SDK_ASSERT(batch->numVertices() == 6);
+
+  // A different size appends
+  const simVis::LineBatch::SlotId d = batch->allocate(3, frame.get(), nullptr);
+  rv += SDK_ASSERT(batch->firstVertex(d) == 6);
+  rv += SDK_ASSERT(batch->numVertices() == 12);
+
+  // Releasing twice and using released slots are harmless
+  batch->release(d);
+  batch->release(d);
+  rv += SDK_ASSERT(batch->setSegments(d, segmentTo(osg::Vec3f())) != 0);
+  rv += SDK_ASSERT(batch->numSlots() == 2);
+  return rv;
+}
+
+int testAnchorGroups()
+{
+  int rv = 0;
+  osg::ref_ptr<simVis::LineBatch> batch = new simVis::LineBatch(1.f);
+  // Earth-scale positions, far beyond float precision of each other
+  osg::ref_ptr<osg::MatrixTransform> frameA = new osg::MatrixTransform(osg::Matrixd::translate(6378137., 0., 0.));
+  osg::ref_ptr<osg::MatrixTransform> frameB = new osg::MatrixTransform(osg::Matrixd::translate(0., 6378137., 0.));
+  const simVis::LineBatch::SlotId a = batch->allocate(1, frameA.get(), nullptr);
+  const simVis::LineBatch::SlotId b = batch->allocate(1, frameB.get(), nullptr);
+  batch->setSegments(a, segmentTo(osg::Vec3f(0.25f, 0.f, 0.f)));
+  batch->setSegments(b, segmentTo(osg::Vec3f(0.f, 0.25f, 0.f)));
+  batch->update();
+
+  // Each slot is anchored on its own frame, keeping sub-meter detail
+  rv += SDK_ASSERT(batch->numAnchorGroups() == 2);
+  const unsigned int groupA = batch->anchorGroup(a);
+  const unsigned int groupB = batch->anchorGroup(b);
+  rv += SDK_ASSERT(groupA != groupB);
+  rv += SDK_ASSERT(batch->anchor(groupA) == osg::Vec3d(6378137., 0., 0.));
+  rv += SDK_ASSERT(batch->anchor(groupB) == osg::Vec3d(0., 6378137., 0.));
+  rv += SDK_ASSERT(closeTo(batch->vertex(batch->firstVertex(a) + 1, groupA), osg::Vec3f(0.25f, 0.f, 0.f)));
+  rv += SDK_ASSERT(closeTo(batch->vertex(batch->firstVertex(b) + 1, groupB), osg::Vec3f(0.f, 0.25f, 0.f)));
+
+  // Nearby slots share an anchor
+  osg::ref_ptr<osg::MatrixTransform> frameC = new osg::MatrixTransform(osg::Matrixd::translate(6378137., 5000., 0.));
+  const simVis::LineBatch::SlotId c = batch->allocate(1, frameC.get(), nullptr);
+  rv += SDK_ASSERT(batch->anchorGroup(c) == groupA);
+  batch->setSegments(c, segmentTo(osg::Vec3f(0.f, 0.f, 0.5f)));
+  batch->update();
+  rv += SDK_ASSERT(closeTo(batch->vertex(batch->firstVertex(c) + 1, groupA), osg::Vec3f(0.f, 5000.f, 0.5f)));
+
+  // A slot that moves out of range joins the group near its new position, clearing its old range
+  const unsigned int oldFirst = batch->firstVertex(b);
+  frameB->setMatrix(osg::Matrixd::translate(6378137., -2000., 0.));
+  batch->update();
+  rv += SDK_ASSERT(batch->anchorGroup(b) == groupA);
+  rv += SDK_ASSERT(batch->vertexColor(oldFirst, groupB).a() == 0.f);
+  rv += SDK_ASSERT(closeTo(batch->vertex(batch->firstVertex(b) + 1, groupA), osg::Vec3f(0.f, -1999.75f, 0.f)));
+
+  // An empty group is re-anchored before another is created
+  frameB->setMatrix(osg::Matrixd::translate(0., 0., 6356752.));
+  batch->update();
+  rv += SDK_ASSERT(batch->numAnchorGroups() == 2);
+  rv += SDK_ASSERT(batch->anchorGroup(b) == groupB);
+  rv += SDK_ASSERT(batch->anchor(groupB) == osg::Vec3d(0., 0., 6356752.));
+  rv += SDK_ASSERT(closeTo(batch->vertex(batch->firstVertex(b) + 1, groupB), osg::Vec3f(0.f, 0.25f, 0.f)));
+
+  // Moving within range keeps the group and anchor
+  frameA->setMatrix(osg::Matrixd::translate(6378137., 0., 50000.));
+  batch->update();
+  rv += SDK_ASSERT(batch->anchorGroup(a) == groupA);
+  rv += SDK_ASSERT(closeTo(batch->vertex(batch->firstVertex(a) + 1, groupA), osg::Vec3f(0.25f, 0.f, 50000.f)));
+  return rv;
+}
+
+int testBatchGroup()
+{
+  int rv = 0;
+  osg::ref_ptr<simVis::LineBatchGroup> group = new simVis::LineBatchGroup;
+  simVis::LineBatch* laser2 = group->getOrCreate(2.f, simVis::DISPLAY_MASK_LASER);
+  rv += SDK_ASSERT(laser2 != nullptr);
+  rv += SDK_ASSERT(group->getOrCreate(2.f, simVis::DISPLAY_MASK_LASER) == laser2);
+  rv += SDK_ASSERT(group->getOrCreate(3.f, simVis::DISPLAY_MASK_LASER) != laser2);
+  rv += SDK_ASSERT(group->getOrCreate(2.f, simVis::DISPLAY_MASK_PLATFORM) != laser2);
+  rv += SDK_ASSERT(group->getNumChildren() == 3);
+  rv += SDK_ASSERT(laser2->getNodeMask() == simVis::DISPLAY_MASK_LASER);
+  return rv;
+}
+
+}
+
+int LineBatchTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testPacking();
+  rv += testVisibility();
+  rv += testReuse();
+  rv += testAnchorGroups();
+  rv += testBatchGroup();
+  return rv;
+}
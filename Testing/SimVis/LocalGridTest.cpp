@@ -0,0 +1,223 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "osg/MatrixTransform"
+#include "osg/ref_ptr"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/DataTypes.h"
+#include "simVis/Constants.h"
+#include "simVis/EntityNode.h"
+#include "simVis/LocalGrid.h"
+#include "simVis/Locator.h"
+
+namespace
+{
+
+/// Minimal host entity, needed for speed ring calculations
+class TestHostNode : public simVis::EntityNode
+{
+public:
+  explicit TestHostNode(simVis::Locator* locator)
+    : EntityNode(simData::PLATFORM, locator)
+  {
+  }
+
+  virtual const std::string getEntityName(NameType nameType, bool allowBlankAlias = false) const { return ""; }
+  virtual std::string popupText() const { return ""; }
+  virtual std::string hookText() const { return ""; }
+  virtual std::string legendText() const { return ""; }
+  virtual unsigned int objectIndexTag() const { return 0; }
+  virtual simData::ObjectId getId() const { return 1; }
+  virtual bool getHostId(simData::ObjectId& hostId) const { hostId = 1; return true; }
+  virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force = false) { return false; }
+  virtual void flush() {}
+  virtual double range() const { return 0.0; }
+
+protected:
+  virtual ~TestHostNode() {}
+};
+
+/// Returns the geometry (or speed ring transform) attached to the grid's graphics group
+const osg::Node* gridGeometry(const simVis::LocalGridNode& grid)
+{
+  const osg::Group* graphics = grid.getChild(0)->asGroup();
+  return (graphics && graphics->getNumChildren() > 0) ? graphics->getChild(0) : nullptr;
+}
+
+simData::LocalGridPrefs defaultPrefs(simData::LocalGridPrefs_Type gridType)
+{
+  simData::LocalGridPrefs prefs;
+  prefs.set_drawgrid(true);
+  prefs.set_gridtype(gridType);
+  // labels need fonts, which are not needed to test geometry
+  prefs.set_gridlabeldraw(false);
+  prefs.set_size(2.0);
+  prefs.set_sizeunits(simData::UNITS_KILOMETERS);
+  return prefs;
+}
+
+int testSharedGeometry()
+{
+  int rv = 0;
+  osg::ref_ptr<simVis::Locator> hostLocator = new simVis::Locator();
+  osg::ref_ptr<simVis::LocalGridNode> grid1 = new simVis::LocalGridNode(hostLocator.get());
+  osg::ref_ptr<simVis::LocalGridNode> grid2 = new simVis::LocalGridNode(hostLocator.get());
+
+  simData::LocalGridPrefs prefs = defaultPrefs(simData::LocalGridPrefs_Type_POLAR);
+  prefs.set_gridcolor(0xff0000ff);
+  grid1->setPrefs(prefs);
+  grid2->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(grid2->numGeometryBuilds() == 0);
+  rv += SDK_ASSERT(grid2->numGeometryCacheHits() == 1);
+  rv += SDK_ASSERT(gridGeometry(*grid1) != nullptr);
+  rv += SDK_ASSERT(gridGeometry(*grid1) == gridGeometry(*grid2));
+
+  // changes that do not affect geometry do not rebuild it
+  prefs.set_followyaw(false);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 1);
+  prefs.set_gridlabelprecision(3);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(gridGeometry(*grid1) == gridGeometry(*grid2));
+
+  // speed ring values are ignored for fixed size grids
+  prefs.mutable_speedring()->set_speedtouse(25.0);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 1);
+
+  // geometry-affecting change makes a new geometry for that grid only
+  prefs.set_gridcolor(0x00ff00ff);
+  grid2->setPrefs(prefs);
+  rv += SDK_ASSERT(grid2->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(gridGeometry(*grid1) != gridGeometry(*grid2));
+
+  // returning to the original color reuses the geometry still held by grid1
+  prefs.set_gridcolor(0xff0000ff);
+  grid2->setPrefs(prefs);
+  rv += SDK_ASSERT(grid2->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(gridGeometry(*grid1) == gridGeometry(*grid2));
+
+  // a forced rebuild still uses the shared geometry
+  grid2->setPrefs(prefs, true);
+  rv += SDK_ASSERT(grid2->numGeometryBuilds() == 1);
+
+  // sector angle is not relevant to range rings, but is to polar grids
+  simData::LocalGridPrefs ringPrefs = defaultPrefs(simData::LocalGridPrefs_Type_RANGE_RINGS);
+  osg::ref_ptr<simVis::LocalGridNode> ring1 = new simVis::LocalGridNode(hostLocator.get());
+  osg::ref_ptr<simVis::LocalGridNode> ring2 = new simVis::LocalGridNode(hostLocator.get());
+  ring1->setPrefs(ringPrefs);
+  ringPrefs.mutable_gridsettings()->set_sectorangle(45.0);
+  ring2->setPrefs(ringPrefs);
+  rv += SDK_ASSERT(ring1->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(ring2->numGeometryBuilds() == 0);
+
+  // same size in different units is the same geometry
+  simData::LocalGridPrefs cartPrefs = defaultPrefs(simData::LocalGridPrefs_Type_CARTESIAN);
+  osg::ref_ptr<simVis::LocalGridNode> cart1 = new simVis::LocalGridNode(hostLocator.get());
+  osg::ref_ptr<simVis::LocalGridNode> cart2 = new simVis::LocalGridNode(hostLocator.get());
+  cart1->setPrefs(cartPrefs);
+  cartPrefs.set_size(2000.0);
+  cartPrefs.set_sizeunits(simData::UNITS_METERS);
+  cart2->setPrefs(cartPrefs);
+  rv += SDK_ASSERT(cart1->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(cart2->numGeometryBuilds() == 0);
+  rv += SDK_ASSERT(gridGeometry(*cart1) == gridGeometry(*cart2));
+  return rv;
+}
+
+int testSpeedRingRescale()
+{
+  int rv = 0;
+  osg::ref_ptr<simVis::Locator> platformLocator = new simVis::Locator();
+  osg::ref_ptr<simVis::Locator> hostLocator = new simVis::Locator(platformLocator.get());
+  osg::ref_ptr<TestHostNode> host = new TestHostNode(hostLocator.get());
+  osg::ref_ptr<simVis::LocalGridNode> grid1 = new simVis::LocalGridNode(hostLocator.get(), host.get());
+  osg::ref_ptr<simVis::LocalGridNode> grid2 = new simVis::LocalGridNode(hostLocator.get(), host.get());
+
+  // 10 m/s for 60 seconds: 600 m rings
+  simData::LocalGridPrefs prefs = defaultPrefs(simData::LocalGridPrefs_Type_SPEED_RINGS);
+  prefs.mutable_speedring()->set_useplatformspeed(false);
+  prefs.mutable_speedring()->set_speedtouse(10.0);
+  prefs.mutable_speedring()->set_speedunits(simData::UNITS_METERS_PER_SECOND);
+  prefs.mutable_speedring()->set_timeformat(simData::ELAPSED_SECONDS);
+  prefs.mutable_speedring()->set_radius(60.0);
+  grid1->setPrefs(prefs);
+  grid2->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(grid2->numGeometryBuilds() == 0);
+
+  const osg::MatrixTransform* xform = dynamic_cast<const osg::MatrixTransform*>(gridGeometry(*grid1));
+  rv += SDK_ASSERT(xform != nullptr);
+  if (!xform)
+    return rv;
+  rv += SDK_ASSERT(simCore::areEqual(xform->getMatrix()(0, 0), 600.0));
+  const osg::Node* unitGeometry = xform->getChild(0);
+
+  // small size changes only rescale
+  prefs.mutable_speedring()->set_speedtouse(11.0);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(xform == gridGeometry(*grid1));
+  rv += SDK_ASSERT(xform->getChild(0) == unitGeometry);
+  rv += SDK_ASSERT(simCore::areEqual(xform->getMatrix()(0, 0), 660.0));
+  prefs.mutable_speedring()->set_radius(90.0);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 1);
+  rv += SDK_ASSERT(simCore::areEqual(xform->getMatrix()(0, 0), 990.0));
+
+  // doubling the size needs more ring segments
+  prefs.mutable_speedring()->set_speedtouse(22.0);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 2);
+  rv += SDK_ASSERT(xform->getChild(0) != unitGeometry);
+  rv += SDK_ASSERT(simCore::areEqual(xform->getMatrix()(0, 0), 1980.0));
+
+  // going back down reuses the geometry that grid2 still holds
+  prefs.mutable_speedring()->set_speedtouse(10.0);
+  prefs.mutable_speedring()->set_radius(60.0);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 2);
+  rv += SDK_ASSERT(xform->getChild(0) == unitGeometry);
+
+  // an invalid speed hides the display without rebuilding
+  prefs.mutable_speedring()->set_speedtouse(0.0);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(xform->getNodeMask() == simVis::DISPLAY_MASK_NONE);
+  prefs.mutable_speedring()->set_speedtouse(10.0);
+  grid1->setPrefs(prefs);
+  rv += SDK_ASSERT(xform->getNodeMask() != simVis::DISPLAY_MASK_NONE);
+  rv += SDK_ASSERT(grid1->numGeometryBuilds() == 2);
+  return rv;
+}
+
+}
+
+int LocalGridTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testSharedGeometry() == 0);
+  rv += SDK_ASSERT(testSpeedRingRescale() == 0);
+  return rv;
+}
@@ -0,0 +1,310 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
+#include "simVis/PlatformFilter.h"
+
+namespace
+{
+
+/// Creates an ECEF platform update from the given LLA position
+simData::PlatformUpdate makeUpdate(double time, double latDeg, double lonDeg, double alt, double yawDeg)
+{
+  const simCore::Coordinate lla(simCore::COORD_SYS_LLA, simCore::Vec3(latDeg * simCore::DEG2RAD, lonDeg * simCore::DEG2RAD, alt),
+    simCore::Vec3(yawDeg * simCore::DEG2RAD, 0.0, 0.0), simCore::Vec3(10.0, 0.0, 0.0));
+  simCore::Coordinate ecef;
+  simCore::CoordinateConverter::convertGeodeticToEcef(lla, ecef);
+  simData::PlatformUpdate update;
+  update.set_time(time);
+  update.setPosition(ecef.position());
+  update.setOrientation(ecef.orientation());
+  update.setVelocity(ecef.velocity());
+  return update;
+}
+
+/// Returns 0 if the two updates hold the same TSPI
+int sameUpdate(const simData::PlatformUpdate& a, const simData::PlatformUpdate& b)
+{
+  int rv = 0;
+  rv += SDK_ASSERT(a.x() == b.x() && a.y() == b.y() && a.z() == b.z());
+  rv += SDK_ASSERT(a.psi() == b.psi() && a.theta() == b.theta() && a.phi() == b.phi());
+  rv += SDK_ASSERT(a.vx() == b.vx() && a.vy() == b.vy() && a.vz() == b.vz());
+  return rv;
+}
+
+int testApplicabilityCache()
+{
+  int rv = 0;
+  simVis::PlatformTspiFilterManager manager;
+  simData::PlatformProperties props;
+  props.set_id(1);
+  simData::PlatformPrefs prefs;
+
+  // No clamping prefs means no conversion
+  simData::PlatformUpdate update = makeUpdate(0.0, 10.0, 20.0, 5000.0, 45.0);
+  rv += SDK_ASSERT(manager.filter(update, prefs, props, 1) == simVis::PlatformTspiFilterManager::POINT_UNCHANGED);
+  rv += SDK_ASSERT(manager.numConversions() == 0);
+
+  // Applicability is cached until the prefs revision changes
+  prefs.set_useclampalt(true);
+  prefs.set_clampvalaltmax(1000.0);
+  prefs.set_clampvalaltmin(0.0);
+  rv += SDK_ASSERT(manager.filter(update, prefs, props, 1) == simVis::PlatformTspiFilterManager::POINT_UNCHANGED);
+  rv += SDK_ASSERT(manager.numConversions() == 0);
+  rv += SDK_ASSERT(manager.filter(update, prefs, props, 2) == simVis::PlatformTspiFilterManager::POINT_CHANGED);
+  rv += SDK_ASSERT(manager.numConversions() == 1);
+
+  // Invalidating the filters recomputes applicability even with the same revision
+  prefs.set_useclampalt(false);
+  update = makeUpdate(1.0, 10.0, 20.0, 5000.0, 45.0);
+  manager.invalidateApplicability();
+  rv += SDK_ASSERT(manager.filter(update, prefs, props, 2) == simVis::PlatformTspiFilterManager::POINT_UNCHANGED);
+  rv += SDK_ASSERT(manager.numConversions() == 1);
+  return rv;
+}
+
+int testSharedConversion()
+{
+  int rv = 0;
+  simVis::PlatformTspiFilterManager manager;
+  simData::PlatformProperties props;
+  props.set_id(5);
+  simData::PlatformPrefs prefs;
+  prefs.set_useclampyaw(true);
+  prefs.set_clampvalyaw(0.5);
+
+  const simData::PlatformUpdate original = makeUpdate(0.0, 30.0, -70.0, 100.0, 90.0);
+  simData::PlatformUpdate platformUpdate = original;
+  rv += SDK_ASSERT(manager.filter(platformUpdate, prefs, props, 1) == simVis::PlatformTspiFilterManager::POINT_CHANGED);
+  rv += SDK_ASSERT(manager.numConversions() == 1);
+
+  // Another consumer (e.g. track history) filtering the same point shares the conversion and gets the same answer
+  simData::PlatformUpdate trackUpdate = original;
+  rv += SDK_ASSERT(manager.filter(trackUpdate, prefs, props) == simVis::PlatformTspiFilterManager::POINT_CHANGED);
+  rv += SDK_ASSERT(manager.numConversions() == 1);
+  rv += sameUpdate(platformUpdate, trackUpdate);
+
+  // Consumers of the current point's position share the conversion, before or after filtering
+  simCore::Vec3 llaPos;
+  rv += SDK_ASSERT(manager.lastGeodetic(5, simCore::Vec3(original.x(), original.y(), original.z()), llaPos));
+  rv += SDK_ASSERT(simCore::areEqual(llaPos.lat() * simCore::RAD2DEG, 30.0));
+  rv += SDK_ASSERT(simCore::areEqual(llaPos.lon() * simCore::RAD2DEG, -70.0));
+  rv += SDK_ASSERT(manager.lastGeodetic(5, simCore::Vec3(platformUpdate.x(), platformUpdate.y(), platformUpdate.z()), llaPos));
+  rv += SDK_ASSERT(simCore::areEqual(llaPos.alt(), 100.0));
+  rv += SDK_ASSERT(!manager.lastGeodetic(6, simCore::Vec3(original.x(), original.y(), original.z()), llaPos));
+
+  // Historical points (e.g. older track history points) convert without replacing the current point's conversion
+  simData::PlatformUpdate historyUpdate = makeUpdate(-1.0, 29.9, -70.0, 100.0, 90.0);
+  manager.filter(historyUpdate, prefs, props);
+  rv += SDK_ASSERT(manager.numConversions() == 2);
+  rv += SDK_ASSERT(!manager.lastGeodetic(5, simCore::Vec3(historyUpdate.x(), historyUpdate.y(), historyUpdate.z()), llaPos));
+  trackUpdate = original;
+  rv += SDK_ASSERT(manager.filter(trackUpdate, prefs, props) == simVis::PlatformTspiFilterManager::POINT_CHANGED);
+  rv += SDK_ASSERT(manager.numConversions() == 2);
+  rv += sameUpdate(platformUpdate, trackUpdate);
+
+  // New position requires a new conversion
+  simData::PlatformUpdate nextUpdate = makeUpdate(1.0, 30.1, -70.0, 100.0, 90.0);
+  manager.filter(nextUpdate, prefs, props, 1);
+  rv += SDK_ASSERT(manager.numConversions() == 3);
+
+  // Removing the entity drops its conversion
+  manager.removeEntity(5);
+  rv += SDK_ASSERT(!manager.lastGeodetic(5, simCore::Vec3(nextUpdate.x(), nextUpdate.y(), nextUpdate.z()), llaPos));
+  trackUpdate = makeUpdate(1.0, 30.1, -70.0, 100.0, 90.0);
+  manager.filter(trackUpdate, prefs, props);
+  rv += SDK_ASSERT(manager.numConversions() == 4);
+  return rv;
+}
+
+/// Fills in platforms with a mix of clamping prefs
+void makeScenario(size_t numPlatforms, std::vector<simData::PlatformProperties>& props, std::vector<simData::PlatformPrefs>& prefs)
+{
+  props.resize(numPlatforms);
+  prefs.resize(numPlatforms);
+  for (size_t k = 0; k < numPlatforms; ++k)
+  {
+    props[k].set_id(k + 1);
+    switch (k % 4)
+    {
+    case 0:
+      // no clamping
+      break;
+    case 1:
+      prefs[k].set_useclampalt(true);
+      prefs[k].set_clampvalaltmin(200.0);
+      prefs[k].set_clampvalaltmax(800.0);
+      break;
+    case 2:
+      prefs[k].set_useclamppitch(true);
+      prefs[k].set_clampvalpitch(0.1);
+      prefs[k].set_useclamproll(true);
+      prefs[k].set_clampvalroll(-0.1);
+      break;
+    case 3:
+      prefs[k].set_useclampalt(true);
+      prefs[k].set_clampvalaltmax(500.0);
+      prefs[k].set_clamporientationatlowvelocity(true);
+      break;
+    }
+  }
+}
+
+int testCachedMatchesSingle()
+{
+  int rv = 0;
+  const size_t numPlatforms = 40;
+  std::vector<simData::PlatformProperties> props;
+  std::vector<simData::PlatformPrefs> prefs;
+  makeScenario(numPlatforms, props, prefs);
+
+  simVis::PlatformTspiFilterManager singleManager;
+  simVis::PlatformTspiFilterManager cachedManager;
+  for (int frame = 0; frame < 5; ++frame)
+  {
+    for (size_t k = 0; k < numPlatforms; ++k)
+    {
+      simData::PlatformUpdate singleUpdate = makeUpdate(frame, 0.5 * k, frame, 100.0 * k, 3.0 * frame);
+      simData::PlatformUpdate cachedUpdate = singleUpdate;
+      rv += SDK_ASSERT(singleManager.filter(singleUpdate, prefs[k], props[k]) == cachedManager.filter(cachedUpdate, prefs[k], props[k], 1));
+      rv += sameUpdate(singleUpdate, cachedUpdate);
+    }
+  }
+  // Platforms without clamping never convert
+  rv += SDK_ASSERT(cachedManager.numConversions() == 5 * 30);
+  return rv;
+}
+
+int testBatchMatchesSingle()
+{
+  int rv = 0;
+  const size_t numPlatforms = 40;
+  std::vector<simData::PlatformProperties> props;
+  std::vector<simData::PlatformPrefs> prefs;
+  makeScenario(numPlatforms, props, prefs);
+
+  simVis::PlatformTspiFilterManager singleManager;
+  simVis::PlatformTspiFilterManager batchManager;
+  std::vector<simVis::PlatformTspiFilterManager::BatchEntry> entries;
+  for (int frame = 0; frame < 5; ++frame)
+  {
+    // Entries are reused across frames, as the scenario does
+    entries.clear();
+    for (size_t k = 0; k < numPlatforms; ++k)
+    {
+      simVis::PlatformTspiFilterManager::BatchEntry entry;
+      entry.update = makeUpdate(frame, 0.5 * k, frame, 100.0 * k, 3.0 * frame);
+      entry.prefs = &prefs[k];
+      entry.props = &props[k];
+      entry.prefsRevision = 1;
+      entry.response = simVis::PlatformTspiFilterManager::POINT_DROPPED;
+      entries.push_back(entry);
+    }
+    batchManager.filterBatch(entries);
+
+    for (size_t k = 0; k < numPlatforms; ++k)
+    {
+      simData::PlatformUpdate singleUpdate = makeUpdate(frame, 0.5 * k, frame, 100.0 * k, 3.0 * frame);
+      rv += SDK_ASSERT(singleManager.filter(singleUpdate, prefs[k], props[k]) == entries[k].response);
+      rv += sameUpdate(singleUpdate, entries[k].update);
+      // The conversion is shared for the filtered position of each applicable platform
+      simCore::Vec3 llaPos;
+      rv += SDK_ASSERT(batchManager.lastGeodetic(props[k].id(), simCore::Vec3(singleUpdate.x(), singleUpdate.y(), singleUpdate.z()), llaPos) == (k % 4 != 0));
+    }
+  }
+  // Platforms without clamping never convert
+  rv += SDK_ASSERT(batchManager.numConversions() == 5 * 30);
+  return rv;
+}
+
+/// Compares the cost of single and cached filtering; timings are printed only if SIMDIS_SDK_BENCHMARK is set
+int benchmarkCached()
+{
+  const size_t numPlatforms = 2000;
+  const int numFrames = 20;
+  std::vector<simData::PlatformProperties> props;
+  std::vector<simData::PlatformPrefs> prefs;
+  makeScenario(numPlatforms, props, prefs);
+  std::vector<std::vector<simData::PlatformUpdate> > updates(numFrames);
+  for (int frame = 0; frame < numFrames; ++frame)
+  {
+    updates[frame].resize(numPlatforms);
+    for (size_t k = 0; k < numPlatforms; ++k)
+      updates[frame][k] = makeUpdate(frame, 0.01 * k, 0.02 * k + 0.001 * frame, 1.0 * k, 0.0);
+  }
+
+  // Each frame, the platform and its track history both filter the current point
+  simVis::PlatformTspiFilterManager singleManager;
+  double start = simCore::getSystemTime();
+  for (int frame = 0; frame < numFrames; ++frame)
+  {
+    for (size_t k = 0; k < numPlatforms; ++k)
+    {
+      simData::PlatformUpdate platformUpdate = updates[frame][k];
+      singleManager.filter(platformUpdate, prefs[k], props[k]);
+      simData::PlatformUpdate trackUpdate = updates[frame][k];
+      singleManager.filter(trackUpdate, prefs[k], props[k]);
+    }
+  }
+  const double singleTime = simCore::getSystemTime() - start;
+
+  simVis::PlatformTspiFilterManager cachedManager;
+  start = simCore::getSystemTime();
+  for (int frame = 0; frame < numFrames; ++frame)
+  {
+    for (size_t k = 0; k < numPlatforms; ++k)
+    {
+      simData::PlatformUpdate platformUpdate = updates[frame][k];
+      cachedManager.filter(platformUpdate, prefs[k], props[k], 1);
+      simData::PlatformUpdate trackUpdate = updates[frame][k];
+      cachedManager.filter(trackUpdate, prefs[k], props[k]);
+    }
+  }
+  const double cachedTime = simCore::getSystemTime() - start;
+
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+  {
+    std::cout << "PlatformTspiFilterManager: " << numPlatforms << " platforms x " << numFrames << " frames: single "
+      << singleTime << " s, cached " << cachedTime << " s, conversions " << cachedManager.numConversions() << std::endl;
+  }
+  // Platform and track share one conversion per frame per applicable platform (3 of every 4)
+  return SDK_ASSERT(cachedManager.numConversions() == numFrames * numPlatforms * 3 / 4);
+}
+}
+
+int PlatformFilterTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testApplicabilityCache();
+  rv += testSharedConversion();
+  rv += testCachedMatchesSingle();
+  rv += testBatchMatchesSingle();
+  rv += benchmarkCached();
+  return rv;
+}
@@ -0,0 +1,198 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <memory>
+#include "osg/ref_ptr"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Coordinate.h"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/MemoryDataStore.h"
+#include "simVis/Locator.h"
+#include "simVis/Projector.h"
+
+namespace
+{
+
+const simData::ObjectId HOST_ID = 1;
+const simData::ObjectId PROJECTOR_ID = 2;
+
+/// Minimal always-active host entity for the projector
+class TestHostNode : public simVis::EntityNode
+{
+public:
+  explicit TestHostNode(simVis::Locator* locator)
+    : EntityNode(simData::PLATFORM, locator)
+  {
+  }
+
+  virtual const std::string getEntityName(NameType nameType, bool allowBlankAlias = false) const { return ""; }
+  virtual std::string popupText() const { return ""; }
+  virtual std::string hookText() const { return ""; }
+  virtual std::string legendText() const { return ""; }
+  virtual unsigned int objectIndexTag() const { return 0; }
+  virtual simData::ObjectId getId() const { return HOST_ID; }
+  virtual bool getHostId(simData::ObjectId& hostId) const { hostId = HOST_ID; return true; }
+  virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force = false) { return false; }
+  virtual void flush() {}
+  virtual double range() const { return 0.0; }
+
+protected:
+  virtual ~TestHostNode() {}
+};
+
+/// Moves the locator to the given position, looking down at the ground to the north
+void moveHost(simVis::Locator& locator, double latDeg, double lonDeg, double alt)
+{
+  const simCore::Coordinate lla(simCore::COORD_SYS_LLA, simCore::Vec3(latDeg * simCore::DEG2RAD, lonDeg * simCore::DEG2RAD, alt),
+    simCore::Vec3(0.0, -45.0 * simCore::DEG2RAD, 0.0));
+  simCore::Coordinate ecef;
+  simCore::CoordinateConverter::convertGeodeticToEcef(lla, ecef);
+  locator.setCoordinate(ecef, 0.0);
+}
+
+/// Adds a projector update with the given field of view (degrees)
+void addProjectorUpdate(simData::DataStore& ds, double time, double fovDeg)
+{
+  simData::DataStore::Transaction txn;
+  simData::ProjectorUpdate* update = ds.addProjectorUpdate(PROJECTOR_ID, &txn);
+  update->set_time(time);
+  update->set_fov(fovDeg * simCore::DEG2RAD);
+  txn.complete(&update);
+}
+
+/// Creates the calculator the ProjectorManager would provide
+std::shared_ptr<osgEarth::Util::EllipsoidIntersector> makeCalculator()
+{
+#if OSGEARTH_SOVERSION >= 110
+  const osgEarth::Ellipsoid wgs84EllipsoidModel;
+  return std::make_shared<osgEarth::Util::EllipsoidIntersector>(wgs84EllipsoidModel);
+#else
+  const osg::EllipsoidModel wgs84EllipsoidModel;
+  return std::make_shared<osgEarth::Util::EllipsoidIntersector>(&wgs84EllipsoidModel);
+#endif
+}
+
+int testProjectionDirtyTracking()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  {
+    simData::DataStore::Transaction txn;
+    simData::PlatformProperties* hostProps = ds.addPlatform(&txn);
+    hostProps->set_id(HOST_ID);
+    txn.complete(&hostProps);
+    simData::ProjectorProperties* props = ds.addProjector(&txn);
+    props->set_id(PROJECTOR_ID);
+    props->set_hostid(HOST_ID);
+    txn.complete(&props);
+  }
+  // FOV is constant for the first three updates, then changes
+  addProjectorUpdate(ds, 0.0, 20.0);
+  addProjectorUpdate(ds, 1.0, 20.0);
+  addProjectorUpdate(ds, 2.0, 20.0);
+  addProjectorUpdate(ds, 3.0, 30.0);
+
+  osg::ref_ptr<simVis::Locator> hostLocator = new simVis::Locator();
+  moveHost(*hostLocator, 10.0, 20.0, 5000.0);
+  osg::ref_ptr<TestHostNode> host = new TestHostNode(hostLocator.get());
+
+  simData::ProjectorProperties props;
+  props.set_id(PROJECTOR_ID);
+  props.set_hostid(HOST_ID);
+  osg::ref_ptr<simVis::ProjectorNode> projector = new simVis::ProjectorNode(props, hostLocator.get(), host.get());
+  projector->setCalculator(makeCalculator());
+
+  simData::ProjectorPrefs prefs;
+  prefs.mutable_commonprefs()->set_draw(true);
+  prefs.mutable_commonprefs()->set_datadraw(true);
+  projector->setPrefs(prefs);
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 0);
+  rv += SDK_ASSERT(!projector->getProjectionBound().valid());
+
+  // First update activates the projector and computes the projection
+  const simData::ProjectorUpdateSlice* slice = ds.projectorUpdateSlice(PROJECTOR_ID);
+  ds.update(0.0);
+  rv += SDK_ASSERT(projector->updateFromDataStore(slice));
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 1);
+  rv += SDK_ASSERT(projector->getProjectionBound().valid());
+  const osg::Matrixd texGen = projector->getTexGenMatrix();
+
+  // New data store updates with the same FOV and a stationary host do not recompute
+  ds.update(1.0);
+  rv += SDK_ASSERT(projector->updateFromDataStore(slice));
+  ds.update(2.0);
+  rv += SDK_ASSERT(projector->updateFromDataStore(slice));
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 1);
+  rv += SDK_ASSERT(projector->getTexGenMatrix() == texGen);
+
+  // Explicit syncs with nothing changed are free
+  projector->syncWithLocator();
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 1);
+
+  // Host motion recomputes once, through the locator callback
+  moveHost(*hostLocator, 10.1, 20.0, 5000.0);
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 2);
+  rv += SDK_ASSERT(projector->getTexGenMatrix() != texGen);
+  projector->syncWithLocator();
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 2);
+
+  // FOV change recomputes
+  ds.update(3.0);
+  rv += SDK_ASSERT(projector->updateFromDataStore(slice));
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 3);
+
+  // Prefs that do not affect the projection do not recompute, but FOV overrides and far plane do
+  prefs.set_projectoralpha(0.5f);
+  projector->setPrefs(prefs);
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 3);
+  prefs.set_overridefov(true);
+  prefs.set_overridefovangle(10.0 * simCore::DEG2RAD);
+  projector->setPrefs(prefs);
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 4);
+  const double oldRadius = projector->getProjectionBound().radius();
+  prefs.set_maxdrawrange(50000.0);
+  projector->setPrefs(prefs);
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 5);
+  rv += SDK_ASSERT(projector->getProjectionBound().radius() < oldRadius);
+
+  // The bound contains the projector position
+  simCore::Vec3 hostPos;
+  hostLocator->getLocatorPosition(&hostPos);
+  rv += SDK_ASSERT(projector->getProjectionBound().contains(osg::Vec3d(hostPos.x(), hostPos.y(), hostPos.z())));
+
+  // Inactive projectors do not recompute on host motion
+  prefs.mutable_commonprefs()->set_datadraw(false);
+  projector->setPrefs(prefs);
+  moveHost(*hostLocator, 10.2, 20.0, 5000.0);
+  rv += SDK_ASSERT(projector->numProjectionUpdates() == 5);
+  return rv;
+}
+
+}
+
+int ProjectorTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testProjectionDirtyTracking();
+  return rv;
+}
@@ -0,0 +1,260 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/TimeClass.h"
+#include "simCore/Time/Utils.h"
+#include "simData/LinearInterpolator.h"
+#include "simData/MemoryDataStore.h"
+#include "simVis/Locator.h"
+#include "simVis/Measurement.h"
+#include "simVis/RangeToolState.h"
+#include "simVis/RangeToolTimeSeries.h"
+
+namespace
+{
+
+const simData::ObjectId BEGIN_ID = 1;
+const simData::ObjectId END_ID = 2;
+
+/// Adds a platform with the given ID to the data store
+void addPlatform(simData::DataStore& ds, simData::ObjectId id)
+{
+  simData::DataStore::Transaction txn;
+  simData::PlatformProperties* props = ds.addPlatform(&txn);
+  props->set_id(id);
+  txn.complete(&props);
+}
+
+/// Adds an update for the platform at the given LLA position, moving along the given course
+void addUpdate(simData::DataStore& ds, simData::ObjectId id, double time, double latDeg, double lonDeg, double alt, double yawDeg, double speed)
+{
+  const simCore::Coordinate lla(simCore::COORD_SYS_LLA, simCore::Vec3(latDeg * simCore::DEG2RAD, lonDeg * simCore::DEG2RAD, alt),
+    simCore::Vec3(yawDeg * simCore::DEG2RAD, 0.05, 0.0),
+    simCore::Vec3(speed * std::sin(yawDeg * simCore::DEG2RAD), speed * std::cos(yawDeg * simCore::DEG2RAD), 0.0));
+  simCore::Coordinate ecef;
+  simCore::CoordinateConverter::convertGeodeticToEcef(lla, ecef);
+
+  simData::DataStore::Transaction txn;
+  simData::PlatformUpdate* update = ds.addPlatformUpdate(id, &txn);
+  update->set_time(time);
+  update->setPosition(ecef.position());
+  update->setOrientation(ecef.orientation());
+  update->setVelocity(ecef.velocity());
+  txn.complete(&update);
+}
+
+/// Two platforms flying crossing courses; the end platform starts at time 20
+void loadScenario(simData::DataStore& ds)
+{
+  addPlatform(ds, BEGIN_ID);
+  addPlatform(ds, END_ID);
+  for (int k = 0; k <= 10; ++k)
+  {
+    const double time = k * 10.0;
+    addUpdate(ds, BEGIN_ID, time, 20.0 + 0.01 * k, 30.0, 1000.0 + 5.0 * k, 0.0, 110.0);
+    if (time >= 20.0)
+      addUpdate(ds, END_ID, time, 20.2, 30.2 - 0.01 * k, 3000.0, 270.0, 105.0);
+  }
+}
+
+/// Measurements covering position, orientation and velocity; the beam measurement never accepts platforms
+simVis::MeasurementVector makeMeasurements()
+{
+  simVis::MeasurementVector measurements;
+  measurements.push_back(new simVis::GroundDistanceMeasurement);
+  measurements.push_back(new simVis::SlantDistanceMeasurement);
+  measurements.push_back(new simVis::TrueAzimuthMeasurement);
+  measurements.push_back(new simVis::DownRangeMeasurement);
+  measurements.push_back(new simVis::RelOriAzimuthMeasurement);
+  measurements.push_back(new simVis::RelVelElevationMeasurement);
+  measurements.push_back(new simVis::ClosingVelocityMeasurement);
+  measurements.push_back(new simVis::BeamGroundDistanceMeasurement);
+  return measurements;
+}
+
+/// Fills in the entity state the way the interactive Range Tool does, through the platform's locator
+int populateFromLocator(simData::ObjectId id, const simData::PlatformUpdate& update, simVis::Locator& locator, simVis::EntityState& state)
+{
+  const simCore::Coordinate ecef(simCore::COORD_SYS_ECEF,
+    simCore::Vec3(update.x(), update.y(), update.z()),
+    simCore::Vec3(update.psi(), update.theta(), update.phi()),
+    simCore::Vec3(update.vx(), update.vy(), update.vz()));
+  locator.setCoordinate(ecef, update.time());
+
+  state.id_ = id;
+  state.hostId_ = id;
+  state.type_ = simData::PLATFORM;
+  if (!locator.getLocatorPositionOrientation(&state.lla_, &state.ypr_, simCore::COORD_SYS_LLA))
+    return 1;
+
+  simCore::Coordinate needVelocity;
+  simCore::CoordinateConverter::convertEcefToGeodetic(ecef, needVelocity);
+  state.vel_ = needVelocity.velocity();
+  return 0;
+}
+
+/// Returns true if the values match, treating NaN as equal to NaN
+bool sameValue(double a, double b, double tolerance)
+{
+  if (std::isnan(a) || std::isnan(b))
+    return std::isnan(a) && std::isnan(b);
+  return (a == b) || simCore::areEqual(a, b, tolerance);
+}
+
+int testSampleTimes()
+{
+  int rv = 0;
+  const std::vector<double> times = simVis::RangeToolTimeSeries::sampleTimes(0.0, 100.0, 2.5);
+  rv += SDK_ASSERT(times.size() == 41);
+  if (times.size() == 41)
+  {
+    rv += SDK_ASSERT(times.front() == 0.0);
+    rv += SDK_ASSERT(times[10] == 25.0);
+    rv += SDK_ASSERT(times.back() == 100.0);
+  }
+  rv += SDK_ASSERT(simVis::RangeToolTimeSeries::sampleTimes(0.0, 1.0, 0.0).empty());
+  rv += SDK_ASSERT(simVis::RangeToolTimeSeries::sampleTimes(1.0, 0.0, 0.1).empty());
+  rv += SDK_ASSERT(simVis::RangeToolTimeSeries::sampleTimes(5.0, 5.0, 1.0).size() == 1);
+  return rv;
+}
+
+int testMatchesInteractive()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simData::LinearInterpolator interpolator;
+  ds.setInterpolator(&interpolator);
+  ds.enableInterpolation(true);
+  loadScenario(ds);
+
+  const std::vector<double> times = simVis::RangeToolTimeSeries::sampleTimes(0.0, 110.0, 2.5);
+  const simVis::MeasurementVector measurements = makeMeasurements();
+
+  simVis::RangeToolTimeSeries series(ds);
+  series.setNumThreads(1);
+  std::vector<std::vector<double> > values;
+  rv += SDK_ASSERT(series.evaluate(BEGIN_ID, END_ID, times, measurements, values) == 0);
+  rv += SDK_ASSERT(values.size() == measurements.size());
+  if (values.size() != measurements.size())
+    return rv;
+
+  // Reproduce each sample by scrubbing the data store clock and going through locators like the scene does
+  osg::ref_ptr<simVis::Locator> beginLocator = new simVis::Locator();
+  osg::ref_ptr<simVis::Locator> endLocator = new simVis::Locator();
+  simVis::RangeToolState state(new simVis::EntityState, new simVis::EntityState);
+  state.earthModel_ = simCore::WGS_84;
+  for (size_t k = 0; k < times.size(); ++k)
+  {
+    ds.update(times[k]);
+    const simData::PlatformUpdate* beginUpdate = ds.platformUpdateSlice(BEGIN_ID)->current();
+    const simData::PlatformUpdate* endUpdate = ds.platformUpdateSlice(END_ID)->current();
+    // End platform is not valid until time 20
+    rv += SDK_ASSERT((endUpdate != nullptr) == (times[k] >= 20.0));
+    if (beginUpdate == nullptr || endUpdate == nullptr)
+    {
+      for (size_t m = 0; m < measurements.size(); ++m)
+        rv += SDK_ASSERT(std::isnan(values[m][k]));
+      continue;
+    }
+
+    rv += SDK_ASSERT(populateFromLocator(BEGIN_ID, *beginUpdate, *beginLocator, *state.beginEntity_) == 0);
+    rv += SDK_ASSERT(populateFromLocator(END_ID, *endUpdate, *endLocator, *state.endEntity_) == 0);
+    state.timeStamp_ = simCore::TimeStamp(ds.referenceYear(), times[k]);
+    state.setLocalFrame(beginLocator->getLocatorMatrix(simVis::Locator::COMP_POSITION));
+
+    for (size_t m = 0; m < measurements.size(); ++m)
+    {
+      const double expected = measurements[m]->willAccept(state) ? measurements[m]->value(state) : std::numeric_limits<double>::quiet_NaN();
+      rv += SDK_ASSERT(sameValue(values[m][k], expected, 1e-6));
+    }
+  }
+
+  // Beam measurement never accepts a platform pair
+  for (size_t k = 0; k < times.size(); ++k)
+    rv += SDK_ASSERT(std::isnan(values.back()[k]));
+  return rv;
+}
+
+int testParallelMatchesSequential()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  simData::LinearInterpolator interpolator;
+  ds.setInterpolator(&interpolator);
+  ds.enableInterpolation(true);
+  loadScenario(ds);
+
+  const std::vector<double> times = simVis::RangeToolTimeSeries::sampleTimes(-5.0, 120.0, 0.01);
+  const simVis::MeasurementVector measurements = makeMeasurements();
+
+  simVis::RangeToolTimeSeries series(ds);
+  series.setNumThreads(1);
+  std::vector<std::vector<double> > sequential;
+  double startTime = simCore::getSystemTime();
+  rv += SDK_ASSERT(series.evaluate(BEGIN_ID, END_ID, times, measurements, sequential) == 0);
+  const double sequentialSeconds = simCore::getSystemTime() - startTime;
+
+  series.setNumThreads(4);
+  std::vector<std::vector<double> > parallel;
+  startTime = simCore::getSystemTime();
+  rv += SDK_ASSERT(series.evaluate(BEGIN_ID, END_ID, times, measurements, parallel) == 0);
+  const double parallelSeconds = simCore::getSystemTime() - startTime;
+
+  rv += SDK_ASSERT(sequential.size() == parallel.size());
+  for (size_t m = 0; m < sequential.size() && m < parallel.size(); ++m)
+  {
+    rv += SDK_ASSERT(sequential[m].size() == times.size());
+    for (size_t k = 0; k < sequential[m].size(); ++k)
+      rv += SDK_ASSERT(sameValue(sequential[m][k], parallel[m][k], 0.0));
+  }
+
+  // Timings are for manual comparison only, so they stay out of the normal test output
+  if (getenv("SIMDIS_SDK_BENCHMARK") != nullptr)
+  {
+    std::cout << "RangeToolTimeSeries: " << times.size() << " samples x " << measurements.size() << " measurements, "
+      << sequentialSeconds << " s with 1 thread, " << parallelSeconds << " s with 4 threads" << std::endl;
+  }
+
+  // Unknown entities and non-platforms are rejected
+  std::vector<std::vector<double> > values;
+  rv += SDK_ASSERT(series.evaluate(BEGIN_ID, 99, times, measurements, values) != 0);
+  return rv;
+}
+
+}
+
+int RangeToolTimeSeriesTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testSampleTimes();
+  rv += testMatchesInteractive();
+  rv += testParallelMatchesSequential();
+  return rv;
+}
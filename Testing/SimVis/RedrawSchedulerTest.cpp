@@ -0,0 +1,153 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "simCore/Common/SDKAssert.h"
+#include "simVis/RedrawScheduler.h"
+
+namespace
+{
+
+int testFirstFrame()
+{
+  int rv = 0;
+  simVis::RedrawScheduler scheduler;
+  rv += SDK_ASSERT(scheduler.needsFrame(0.0));
+  scheduler.frameDrawn(0.0);
+  // Nothing was marked dirty, so there is no settle frame
+  rv += SDK_ASSERT(!scheduler.needsFrame(0.1));
+  rv += SDK_ASSERT(scheduler.pendingSources() == simVis::RedrawScheduler::SOURCE_NONE);
+  return rv;
+}
+
+int testSources()
+{
+  int rv = 0;
+  simVis::RedrawScheduler scheduler;
+  scheduler.setMaxIdleInterval(0.0);
+  scheduler.frameDrawn(0.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(100.0));
+
+  scheduler.requestRedraw(simVis::RedrawScheduler::SOURCE_DATA_STORE);
+  scheduler.requestRedraw(simVis::RedrawScheduler::SOURCE_CAMERA);
+  rv += SDK_ASSERT(scheduler.needsFrame(1.0));
+  rv += SDK_ASSERT(scheduler.pendingSources() == (simVis::RedrawScheduler::SOURCE_DATA_STORE | simVis::RedrawScheduler::SOURCE_CAMERA));
+
+  // Frame with changes is followed by one settle frame, then goes idle
+  scheduler.frameDrawn(1.0);
+  rv += SDK_ASSERT(scheduler.pendingSources() == simVis::RedrawScheduler::SOURCE_NONE);
+  rv += SDK_ASSERT(scheduler.needsFrame(1.1));
+  scheduler.frameDrawn(1.1);
+  rv += SDK_ASSERT(!scheduler.needsFrame(1.2));
+  scheduler.frameSkipped();
+  rv += SDK_ASSERT(scheduler.numFramesDrawn() == 3);
+  rv += SDK_ASSERT(scheduler.numFramesSkipped() == 1);
+  return rv;
+}
+
+int testClock()
+{
+  int rv = 0;
+  simVis::RedrawScheduler scheduler;
+  scheduler.setMaxIdleInterval(0.0);
+  scheduler.setSimulationTime(10.0);
+  rv += SDK_ASSERT(scheduler.pendingSources() == simVis::RedrawScheduler::SOURCE_CLOCK);
+  scheduler.frameDrawn(0.0);
+  scheduler.frameDrawn(0.1);
+
+  // Paused clock does not need frames
+  scheduler.setSimulationTime(10.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(0.2));
+  scheduler.setSimulationTime(10.5);
+  rv += SDK_ASSERT(scheduler.needsFrame(0.2));
+  rv += SDK_ASSERT(scheduler.pendingSources() == simVis::RedrawScheduler::SOURCE_CLOCK);
+  return rv;
+}
+
+int testIdleInterval()
+{
+  int rv = 0;
+  simVis::RedrawScheduler scheduler;
+  rv += SDK_ASSERT(scheduler.maxIdleInterval() == 1.0);
+  scheduler.setMaxIdleInterval(2.0);
+  rv += SDK_ASSERT(scheduler.timeUntilIdleFrame(5.0) == 0.0);
+  scheduler.frameDrawn(5.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(6.0));
+  rv += SDK_ASSERT(scheduler.timeUntilIdleFrame(6.0) == 1.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(6.99));
+  rv += SDK_ASSERT(scheduler.needsFrame(7.0));
+  rv += SDK_ASSERT(scheduler.timeUntilIdleFrame(8.0) == 0.0);
+
+  // Idle frames do not lead to settle frames
+  scheduler.frameDrawn(7.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(7.5));
+
+  // Disabling the interval never forces a frame
+  scheduler.setMaxIdleInterval(0.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(1000.0));
+  rv += SDK_ASSERT(scheduler.timeUntilIdleFrame(1000.0) < 0.0);
+  return rv;
+}
+
+int testAnimations()
+{
+  int rv = 0;
+  simVis::RedrawScheduler scheduler;
+  scheduler.setMaxIdleInterval(0.0);
+  scheduler.frameDrawn(0.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(0.5));
+
+  // Animated nodes request the next frame each time they are culled, during the frame being drawn
+  for (int k = 1; k < 5; ++k)
+  {
+    scheduler.requestNextFrame(simVis::RedrawScheduler::SOURCE_ANIMATION);
+    scheduler.frameDrawn(k);
+    rv += SDK_ASSERT(scheduler.needsFrame(k + 0.5));
+    rv += SDK_ASSERT(scheduler.pendingSources() == simVis::RedrawScheduler::SOURCE_ANIMATION);
+  }
+
+  // Animation no longer culled, for example hidden or off screen; one settle frame, then idle
+  scheduler.frameDrawn(5.0);
+  rv += SDK_ASSERT(scheduler.pendingSources() == simVis::RedrawScheduler::SOURCE_NONE);
+  rv += SDK_ASSERT(scheduler.needsFrame(5.5));
+  scheduler.frameDrawn(6.0);
+  rv += SDK_ASSERT(!scheduler.needsFrame(7.0));
+
+  // Next frame requests do not mark the frame being drawn
+  scheduler.requestNextFrame(simVis::RedrawScheduler::SOURCE_ANIMATION);
+  rv += SDK_ASSERT(!scheduler.needsFrame(7.0));
+  scheduler.frameDrawn(7.0);
+  rv += SDK_ASSERT(scheduler.needsFrame(7.5));
+  return rv;
+}
+
+}
+
+int RedrawSchedulerTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testFirstFrame();
+  rv += testSources();
+  rv += testClock();
+  rv += testIdleInterval();
+  rv += testAnimations();
+  return rv;
+}
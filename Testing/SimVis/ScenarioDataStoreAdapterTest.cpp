@@ -0,0 +1,194 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <vector>
+#include "osg/ref_ptr"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/MemoryDataStore.h"
+#include "simVis/Beam.h"
+#include "simVis/Platform.h"
+#include "simVis/ProjectorManager.h"
+#include "simVis/Scenario.h"
+#include "simVis/ScenarioDataStoreAdapter.h"
+
+namespace
+{
+
+simData::ObjectId addPlatform(simData::DataStore& ds, const std::string& name)
+{
+  simData::DataStore::Transaction txn;
+  simData::PlatformProperties* props = ds.addPlatform(&txn);
+  const simData::ObjectId id = props->id();
+  txn.complete(&props);
+
+  simData::PlatformPrefs* prefs = ds.mutable_platformPrefs(id, &txn);
+  prefs->mutable_commonprefs()->set_name(name);
+  txn.complete(&prefs);
+  return id;
+}
+
+simData::ObjectId addBeam(simData::DataStore& ds, simData::ObjectId hostId)
+{
+  simData::DataStore::Transaction txn;
+  simData::BeamProperties* props = ds.addBeam(&txn);
+  const simData::ObjectId id = props->id();
+  props->set_hostid(hostId);
+  txn.complete(&props);
+  return id;
+}
+
+/// Returns the number of leading IDs that have nodes; fails if any node exists past the first missing one
+int countCreatedPrefix(const simVis::ScenarioManager& scenario, const std::vector<simData::ObjectId>& ids, size_t& prefix)
+{
+  prefix = 0;
+  while (prefix < ids.size() && scenario.find(ids[prefix]) != nullptr)
+    ++prefix;
+  int rv = 0;
+  for (size_t k = prefix; k < ids.size(); ++k)
+    rv += SDK_ASSERT(scenario.find(ids[k]) == nullptr);
+  return rv;
+}
+
+int testImmediateCreation()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  osg::ref_ptr<simVis::ProjectorManager> projMan = new simVis::ProjectorManager;
+  osg::ref_ptr<simVis::ScenarioManager> scenario = new simVis::ScenarioManager(projMan.get());
+  scenario->bind(&ds);
+
+  // Default behavior creates nodes inside the add notification
+  rv += SDK_ASSERT(scenario->getDataStoreAdapter().creationBudget() == 0);
+  const simData::ObjectId id = addPlatform(ds, "Immediate");
+  rv += SDK_ASSERT(scenario->find<simVis::PlatformNode>(id) != nullptr);
+  rv += SDK_ASSERT(scenario->getDataStoreAdapter().numPendingEntities() == 0);
+  rv += SDK_ASSERT(scenario->getDataStoreAdapter().processPendingEntities() == 0);
+
+  scenario->unbind(&ds, true);
+  return rv;
+}
+
+int testDeferredCreation()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  osg::ref_ptr<simVis::ProjectorManager> projMan = new simVis::ProjectorManager;
+  osg::ref_ptr<simVis::ScenarioManager> scenario = new simVis::ScenarioManager(projMan.get());
+  simVis::ScenarioDataStoreAdapter& adapter = scenario->getDataStoreAdapter();
+  adapter.setCreationBudget(3);
+  scenario->bind(&ds);
+
+  // Hosts are added before their beams, so in-order creation always finds the host
+  std::vector<simData::ObjectId> ids;
+  for (int k = 0; k < 7; ++k)
+    ids.push_back(addPlatform(ds, "Platform"));
+  ids.push_back(addBeam(ds, ids[0]));
+  rv += SDK_ASSERT(adapter.numPendingEntities() == ids.size());
+  for (auto it = ids.begin(); it != ids.end(); ++it)
+    rv += SDK_ASSERT(scenario->find(*it) == nullptr);
+
+  // Removing a queued entity drops it without ever creating a node
+  const simData::ObjectId removedId = ids[4];
+  ds.removeEntity(removedId);
+  ids.erase(ids.begin() + 4);
+  rv += SDK_ASSERT(adapter.numPendingEntities() == ids.size());
+
+  // Prefs changes while queued are applied when the node is created
+  simData::DataStore::Transaction txn;
+  simData::PlatformPrefs* prefs = ds.mutable_platformPrefs(ids[5], &txn);
+  prefs->mutable_commonprefs()->set_name("Renamed");
+  txn.complete(&prefs);
+
+  // Each frame creates at most the budget, always the oldest entities first
+  size_t lastPrefix = 0;
+  int numFrames = 0;
+  while (adapter.numPendingEntities() > 0)
+  {
+    const size_t created = adapter.processPendingEntities();
+    ++numFrames;
+    rv += SDK_ASSERT(created > 0 && created <= 3);
+    size_t prefix = 0;
+    rv += countCreatedPrefix(*scenario, ids, prefix);
+    rv += SDK_ASSERT(prefix == lastPrefix + created);
+    lastPrefix = prefix;
+  }
+  rv += SDK_ASSERT(numFrames == 3);
+  rv += SDK_ASSERT(lastPrefix == ids.size());
+  rv += SDK_ASSERT(scenario->find(removedId) == nullptr);
+
+  const simVis::PlatformNode* renamed = scenario->find<simVis::PlatformNode>(ids[5]);
+  rv += SDK_ASSERT(renamed != nullptr && renamed->getPrefs().commonprefs().name() == "Renamed");
+  const simVis::BeamNode* beam = scenario->find<simVis::BeamNode>(ids.back());
+  rv += SDK_ASSERT(beam != nullptr);
+
+  // Flushing creates everything regardless of the budget
+  for (int k = 0; k < 10; ++k)
+    addPlatform(ds, "Flushed");
+  rv += SDK_ASSERT(adapter.numPendingEntities() == 10);
+  rv += SDK_ASSERT(adapter.flushPendingEntities() == 10);
+  rv += SDK_ASSERT(adapter.numPendingEntities() == 0);
+
+  // Returning to immediate creation drains the queue first
+  const simData::ObjectId lastQueued = addPlatform(ds, "Queued");
+  rv += SDK_ASSERT(scenario->find(lastQueued) == nullptr);
+  adapter.setCreationBudget(0);
+  rv += SDK_ASSERT(scenario->find(lastQueued) != nullptr);
+  rv += SDK_ASSERT(adapter.numPendingEntities() == 0);
+
+  scenario->unbind(&ds, true);
+  return rv;
+}
+
+int testBindQueuesExisting()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  std::vector<simData::ObjectId> ids;
+  for (int k = 0; k < 5; ++k)
+    ids.push_back(addPlatform(ds, "Existing"));
+
+  osg::ref_ptr<simVis::ProjectorManager> projMan = new simVis::ProjectorManager;
+  osg::ref_ptr<simVis::ScenarioManager> scenario = new simVis::ScenarioManager(projMan.get());
+  scenario->getDataStoreAdapter().setCreationBudget(2);
+  scenario->bind(&ds);
+
+  // Entities already in the data store are queued on bind as well
+  rv += SDK_ASSERT(scenario->getDataStoreAdapter().numPendingEntities() == ids.size());
+  rv += SDK_ASSERT(scenario->getDataStoreAdapter().processPendingEntities() == 2);
+  size_t prefix = 0;
+  rv += countCreatedPrefix(*scenario, ids, prefix);
+  rv += SDK_ASSERT(prefix == 2);
+
+  scenario->unbind(&ds, true);
+  return rv;
+}
+
+}
+
+int ScenarioDataStoreAdapterTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testImmediateCreation();
+  rv += testDeferredCreation();
+  rv += testBindQueuesExisting();
+  return rv;
+}
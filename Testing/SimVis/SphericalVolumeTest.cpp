@@ -0,0 +1,264 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "osg/Geometry"
+#include "osg/Uniform"
+#include "osg/ref_ptr"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/DataTypes.h"
+#include "simVis/Beam.h"
+#include "simVis/Gate.h"
+#include "simVis/Locator.h"
+#include "simVis/SphericalVolume.h"
+
+namespace
+{
+
+const osg::Vec3Array* vertices(simVis::SphericalVolume* sv)
+{
+  const osg::Geometry* geom = simVis::SVFactory::solidGeometry(sv);
+  return geom ? dynamic_cast<const osg::Vec3Array*>(geom->getVertexArray()) : nullptr;
+}
+
+const osg::Vec4Array* colors(simVis::SphericalVolume* sv)
+{
+  const osg::Geometry* geom = simVis::SVFactory::solidGeometry(sv);
+  return geom ? dynamic_cast<const osg::Vec4Array*>(geom->getColorArray()) : nullptr;
+}
+
+/// Distance from the beam origin in meters that BeamPulse.vert.glsl computes for the vertex, which sets the pulse spacing
+double pulseDistance(simVis::BeamVolume* beam, const osg::Vec3f& vertex)
+{
+  float rangeScale = 0.f;
+  const osg::StateSet* stateSet = beam->getStateSet();
+  const osg::Uniform* uniform = (stateSet ? stateSet->getUniform("simvis_beampulse_rangescale") : nullptr);
+  if (uniform == nullptr || !uniform->get(rangeScale))
+    return 0.0;
+  return rangeScale * vertex.y();
+}
+
+osg::ref_ptr<simVis::SphericalVolume> createPooled(const simVis::SVData& data)
+{
+  osg::ref_ptr<simVis::SphericalVolume> sv = new simVis::SphericalVolume();
+  simVis::SVFactory::createPooledNode(*sv, data);
+  return sv;
+}
+
+int testConePool()
+{
+  int rv = 0;
+  simVis::SVFactory::resetPoolStatistics();
+  const unsigned int initialSize = simVis::SVFactory::poolSize();
+
+  simVis::SVData data;
+  data.shape_ = simVis::SVData::SHAPE_CONE;
+  data.drawMode_ = simVis::SVData::DRAW_MODE_SOLID | simVis::SVData::DRAW_MODE_WIRE;
+  data.farRange_ = 1000.f;
+  osg::ref_ptr<simVis::SphericalVolume> sv1 = createPooled(data);
+  data.color_.set(0.f, 1.f, 0.f, 0.5f);
+  osg::ref_ptr<simVis::SphericalVolume> sv2 = createPooled(data);
+
+  // color does not affect the geometry
+  rv += SDK_ASSERT(simVis::SVFactory::poolMisses() == 1);
+  rv += SDK_ASSERT(simVis::SVFactory::poolHits() == 1);
+  rv += SDK_ASSERT(simVis::SVFactory::poolSize() == initialSize + 1);
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(sv1.get()));
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(sv2.get()));
+  rv += SDK_ASSERT(vertices(sv1.get()) != nullptr);
+  rv += SDK_ASSERT(vertices(sv1.get()) == vertices(sv2.get()));
+
+  // but color and state remain per volume
+  rv += SDK_ASSERT(colors(sv1.get()) != colors(sv2.get()));
+  rv += SDK_ASSERT(simVis::SVFactory::solidGeometry(sv1.get())->getStateSet() != simVis::SVFactory::solidGeometry(sv2.get())->getStateSet());
+  simVis::SVFactory::updateColor(sv2.get(), osg::Vec4f(0.f, 0.f, 1.f, 1.f));
+  rv += SDK_ASSERT((*colors(sv1.get()))[0] == osg::Vec4f(1.f, 1.f, 0.f, 0.5f));
+  rv += SDK_ASSERT((*colors(sv2.get()))[0] == osg::Vec4f(0.f, 0.f, 1.f, 1.f));
+  rv += SDK_ASSERT(simVis::SVFactory::opaqueGroup(sv1.get()) != nullptr);
+  rv += SDK_ASSERT(simVis::SVFactory::opaqueGroup(sv1.get()) != simVis::SVFactory::opaqueGroup(sv2.get()));
+
+  // unchanged angle leaves the volume shared
+  rv += SDK_ASSERT(simVis::SVFactory::updateHorizAngle(sv2.get(), data.hfov_deg_ * simCore::DEG2RAD) == 0);
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(sv2.get()));
+
+  // changing geometry in place gives the volume its own copy, without affecting the other
+  const osg::Vec3Array* sharedVerts = vertices(sv1.get());
+  simVis::SVFactory::updateFarRange(sv2.get(), 2000.0);
+  rv += SDK_ASSERT(!simVis::SVFactory::isShared(sv2.get()));
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(sv1.get()));
+  rv += SDK_ASSERT(vertices(sv1.get()) == sharedVerts);
+  rv += SDK_ASSERT(vertices(sv2.get()) != sharedVerts);
+  // far face center is the first cone vertex
+  rv += SDK_ASSERT(simCore::areEqual((*vertices(sv1.get()))[0].length(), 1000.0, 0.01));
+  rv += SDK_ASSERT(simCore::areEqual((*vertices(sv2.get()))[0].length(), 2000.0, 0.01));
+  // wireframe follows the detached vertices
+  const osg::Geometry* wireframe = simVis::SVFactory::opaqueGroup(sv2.get())->getChild(0)->asGeometry();
+  rv += SDK_ASSERT(wireframe != nullptr && wireframe->getVertexArray() == vertices(sv2.get()));
+
+  // different shape is a different geometry
+  data.hfov_deg_ = 20.0;
+  osg::ref_ptr<simVis::SphericalVolume> sv3 = createPooled(data);
+  rv += SDK_ASSERT(simVis::SVFactory::poolMisses() == 2);
+  rv += SDK_ASSERT(vertices(sv3.get()) != sharedVerts);
+
+  // geometry leaves the pool once no volume shares it
+  sv1 = nullptr;
+  sv2 = nullptr;
+  sv3 = nullptr;
+  rv += SDK_ASSERT(simVis::SVFactory::poolSize() == initialSize);
+  return rv;
+}
+
+int testPyramidOutlinePool()
+{
+  int rv = 0;
+  simVis::SVFactory::resetPoolStatistics();
+
+  // gate-like pyramid with outline and near face
+  simVis::SVData data;
+  data.shape_ = simVis::SVData::SHAPE_PYRAMID;
+  data.drawMode_ = simVis::SVData::DRAW_MODE_SOLID | simVis::SVData::DRAW_MODE_OUTLINE;
+  data.nearRange_ = 100.f;
+  data.farRange_ = 1000.f;
+  osg::ref_ptr<simVis::SphericalVolume> sv1 = createPooled(data);
+  osg::ref_ptr<simVis::SphericalVolume> sv2 = createPooled(data);
+  rv += SDK_ASSERT(simVis::SVFactory::poolHits() == 1);
+  rv += SDK_ASSERT(vertices(sv1.get()) == vertices(sv2.get()));
+  // each volume has its own outline
+  rv += SDK_ASSERT(simVis::SVFactory::opaqueGroup(sv1.get()) != nullptr);
+  rv += SDK_ASSERT(simVis::SVFactory::opaqueGroup(sv2.get()) != nullptr);
+  rv += SDK_ASSERT(simVis::SVFactory::opaqueGroup(sv1.get()) != simVis::SVFactory::opaqueGroup(sv2.get()));
+
+  simVis::SVFactory::updateNearRange(sv1.get(), 200.0);
+  rv += SDK_ASSERT(!simVis::SVFactory::isShared(sv1.get()));
+  rv += SDK_ASSERT(vertices(sv1.get()) != vertices(sv2.get()));
+  return rv;
+}
+
+int testBeamVolumes()
+{
+  int rv = 0;
+  simVis::SVFactory::resetPoolStatistics();
+
+  simData::BeamPrefs prefs;
+  prefs.set_horizontalwidth(10.0 * simCore::DEG2RAD);
+  prefs.set_verticalwidth(5.0 * simCore::DEG2RAD);
+  simData::BeamUpdate update;
+  update.set_range(1000.0);
+  osg::ref_ptr<simVis::BeamVolume> beam1 = new simVis::BeamVolume(prefs, update);
+  update.set_range(5000.0);
+  osg::ref_ptr<simVis::BeamVolume> beam2 = new simVis::BeamVolume(prefs, update);
+
+  // range is carried by the transform, so both beams share one geometry
+  rv += SDK_ASSERT(simVis::SVFactory::poolMisses() == 1);
+  rv += SDK_ASSERT(simVis::SVFactory::poolHits() == 1);
+  rv += SDK_ASSERT(vertices(beam1.get()) == vertices(beam2.get()));
+  rv += SDK_ASSERT(simCore::areEqual(beam1->getMatrix().getScale().x(), 1000.0));
+  rv += SDK_ASSERT(simCore::areEqual(beam2->getMatrix().getScale().x(), 5000.0));
+  // pulses are spaced in meters of range, though the shared geometry is built at unit range; far face center is the first vertex
+  const osg::Vec3f farCenter = (*vertices(beam1.get()))[0];
+  rv += SDK_ASSERT(simCore::areEqual(pulseDistance(beam1.get(), farCenter), 1000.0, 0.01));
+  rv += SDK_ASSERT(simCore::areEqual(pulseDistance(beam2.get(), farCenter), 5000.0, 0.01));
+
+  // range updates rescale without modifying the shared geometry
+  simData::BeamUpdate update2(update);
+  update2.set_range(3000.0);
+  beam2->performInPlaceUpdates(&update, &update2);
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(beam2.get()));
+  rv += SDK_ASSERT(simCore::areEqual(beam2->getMatrix().getScale().x(), 3000.0));
+  rv += SDK_ASSERT(simCore::areEqual(pulseDistance(beam2.get(), farCenter), 3000.0, 0.01));
+
+  // beam scale combines with range
+  simData::BeamPrefs prefs2(prefs);
+  prefs2.set_beamscale(2.0);
+  beam2->performInPlacePrefChanges(&prefs, &prefs2);
+  rv += SDK_ASSERT(simCore::areEqual(beam2->getMatrix().getScale().x(), 6000.0));
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(beam2.get()));
+  // beam scale does not change pulse spacing, matching beams built at full range
+  rv += SDK_ASSERT(simCore::areEqual(pulseDistance(beam2.get(), farCenter), 3000.0, 0.01));
+
+  // width changes select the shared geometry for the new shape in place, keeping the transform
+  simData::BeamPrefs prefs3(prefs2);
+  prefs3.set_horizontalwidth(20.0 * simCore::DEG2RAD);
+  beam2->performInPlacePrefChanges(&prefs2, &prefs3);
+  osg::ref_ptr<simVis::BeamVolume> beam3 = new simVis::BeamVolume(prefs3, update2);
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(beam2.get()));
+  rv += SDK_ASSERT(vertices(beam2.get()) == vertices(beam3.get()));
+  rv += SDK_ASSERT(vertices(beam2.get()) != vertices(beam1.get()));
+  rv += SDK_ASSERT(simCore::areEqual(beam2->getMatrix().getScale().x(), 6000.0));
+
+  // crossing the cone/pyramid threshold is also in place
+  simData::BeamPrefs prefs4(prefs3);
+  prefs4.set_horizontalwidth(200.0 * simCore::DEG2RAD);
+  beam2->performInPlacePrefChanges(&prefs3, &prefs4);
+  rv += SDK_ASSERT(simVis::SVFactory::isShared(beam2.get()));
+  rv += SDK_ASSERT(vertices(beam2.get()) != vertices(beam3.get()));
+  rv += SDK_ASSERT(simVis::SVFactory::solidGeometry(beam2.get()) != nullptr);
+  return rv;
+}
+
+int testGateVolumes()
+{
+  int rv = 0;
+  simVis::SVFactory::resetPoolStatistics();
+
+  simData::GatePrefs prefs;
+  prefs.set_fillpattern(simData::GatePrefs_FillPattern_ALPHA);
+  simData::GateUpdate update;
+  update.set_azimuth(0.0);
+  update.set_elevation(0.0);
+  update.set_width(10.0 * simCore::DEG2RAD);
+  update.set_height(5.0 * simCore::DEG2RAD);
+  update.set_minrange(100.0);
+  update.set_maxrange(1000.0);
+  osg::ref_ptr<simVis::Locator> locator = new simVis::Locator();
+
+  // gates whose shape does not change share geometry
+  osg::ref_ptr<simVis::GateVolume> gate1 = new simVis::GateVolume(locator.get(), &prefs, &update);
+  osg::ref_ptr<simVis::GateVolume> gate2 = new simVis::GateVolume(locator.get(), &prefs, &update);
+  rv += SDK_ASSERT(gate1->isShared());
+  rv += SDK_ASSERT(gate2->isShared());
+  rv += SDK_ASSERT(simVis::SVFactory::poolHits() == 1);
+
+  // gates that change shape are built outside the pool, so their updates do not copy shared geometry
+  osg::ref_ptr<simVis::GateVolume> gate3 = new simVis::GateVolume(locator.get(), &prefs, &update, false);
+  rv += SDK_ASSERT(!gate3->isShared());
+  rv += SDK_ASSERT(simVis::SVFactory::poolHits() == 1);
+  simData::GateUpdate update2(update);
+  update2.set_maxrange(2000.0);
+  gate3->performInPlaceUpdates(&update, &update2);
+  rv += SDK_ASSERT(!gate3->isShared());
+  rv += SDK_ASSERT(gate1->isShared());
+  return rv;
+}
+
+}
+
+int SphericalVolumeTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += SDK_ASSERT(testConePool() == 0);
+  rv += SDK_ASSERT(testPyramidOutlinePool() == 0);
+  rv += SDK_ASSERT(testBeamVolumes() == 0);
+  rv += SDK_ASSERT(testGateVolumes() == 0);
+  return rv;
+}
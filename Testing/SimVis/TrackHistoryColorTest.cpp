@@ -0,0 +1,198 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code is in accompanying LICENSE.txt file. If you did
+ * not receive a LICENSE.txt with this code, email simdis@nrl.navy.mil.
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <limits>
+#include "osg/ref_ptr"
+#include "osgUtil/UpdateVisitor"
+#include "simCore/Calc/CoordinateConverter.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/DataTable.h"
+#include "simData/MemoryDataStore.h"
+#include "simVis/Locator.h"
+#include "simVis/PlatformFilter.h"
+#include "simVis/TrackHistory.h"
+#include "simVis/Types.h"
+
+namespace
+{
+
+const simData::ObjectId PLATFORM_ID = 1;
+const uint32_t RED = 0xff0000ff;
+const uint32_t GREEN = 0x00ff00ff;
+const uint32_t BLUE = 0x0000ffff;
+
+/// Adds a platform with one update per second from time 0 to lastTime
+void addPlatform(simData::DataStore& ds, int lastTime)
+{
+  simData::DataStore::Transaction txn;
+  simData::PlatformProperties* props = ds.addPlatform(&txn);
+  props->set_id(PLATFORM_ID);
+  txn.complete(&props);
+
+  for (int k = 0; k <= lastTime; ++k)
+  {
+    const simCore::Coordinate lla(simCore::COORD_SYS_LLA, simCore::Vec3(20.0 * simCore::DEG2RAD, (30.0 + 0.001 * k) * simCore::DEG2RAD, 1000.0));
+    simCore::Coordinate ecef;
+    simCore::CoordinateConverter::convertGeodeticToEcef(lla, ecef);
+
+    simData::PlatformUpdate* update = ds.addPlatformUpdate(PLATFORM_ID, &txn);
+    update->set_time(k);
+    update->setPosition(ecef.position());
+    txn.complete(&update);
+  }
+}
+
+/// Returns the track history color column, creating the table and column if needed
+simData::TableColumn* colorColumn(simData::DataStore& ds)
+{
+  simData::DataTable* table = ds.dataTableManager().findTable(PLATFORM_ID, simData::INTERNAL_TRACK_HISTORY_TABLE);
+  if (table == nullptr && ds.dataTableManager().addDataTable(PLATFORM_ID, simData::INTERNAL_TRACK_HISTORY_TABLE, &table).isError())
+    return nullptr;
+  simData::TableColumn* column = table->column(simData::INTERNAL_TRACK_HISTORY_COLOR_COLUMN);
+  if (column == nullptr && table->addColumn(simData::INTERNAL_TRACK_HISTORY_COLOR_COLUMN, simData::VT_UINT32, 0, &column).isError())
+    return nullptr;
+  return column;
+}
+
+/// Adds a color command at the given time
+void addColor(simData::DataStore& ds, double time, uint32_t color)
+{
+  simData::TableColumn* column = colorColumn(ds);
+  if (column == nullptr)
+    return;
+  simData::TableRow row;
+  row.setTime(time);
+  row.setValue(column->columnId(), color);
+  ds.dataTableManager().findTable(PLATFORM_ID, simData::INTERNAL_TRACK_HISTORY_TABLE)->addRow(row);
+}
+
+int testColorCursor()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  addPlatform(ds, 0);
+  const osg::Vec4f defaultColor = simVis::Color::White;
+
+  simVis::TrackColorCursor cursor(defaultColor);
+  // no column means default color without any searches
+  rv += SDK_ASSERT(cursor.colorAt(5.0) == defaultColor);
+  rv += SDK_ASSERT(cursor.numSearches() == 0);
+
+  addColor(ds, 10.0, RED);
+  addColor(ds, 20.0, GREEN);
+  addColor(ds, 30.0, BLUE);
+  cursor.setColumn(colorColumn(ds));
+
+  // walking 0 through 40 in order searches once per color segment: default, red, green, blue
+  for (int k = 0; k <= 40; ++k)
+  {
+    const osg::Vec4f color = cursor.colorAt(k);
+    if (k < 10)
+      rv += SDK_ASSERT(color == defaultColor);
+    else if (k < 20)
+      rv += SDK_ASSERT(color == simVis::Color(RED, simVis::Color::RGBA));
+    else if (k < 30)
+      rv += SDK_ASSERT(color == simVis::Color(GREEN, simVis::Color::RGBA));
+    else
+      rv += SDK_ASSERT(color == simVis::Color(BLUE, simVis::Color::RGBA));
+  }
+  rv += SDK_ASSERT(cursor.numSearches() == 4);
+
+  // reverse mode draw times are negative
+  rv += SDK_ASSERT(cursor.colorAt(-15.0) == simVis::Color(RED, simVis::Color::RGBA));
+  rv += SDK_ASSERT(cursor.numSearches() == 5);
+  rv += SDK_ASSERT(cursor.colorAt(-12.0) == simVis::Color(RED, simVis::Color::RGBA));
+  rv += SDK_ASSERT(cursor.numSearches() == 5);
+
+  // new rows are only seen after invalidating
+  addColor(ds, 15.0, BLUE);
+  cursor.invalidate();
+  rv += SDK_ASSERT(cursor.colorAt(16.0) == simVis::Color(BLUE, simVis::Color::RGBA));
+  rv += SDK_ASSERT(cursor.colorAt(14.0) == simVis::Color(RED, simVis::Color::RGBA));
+  rv += SDK_ASSERT(cursor.numSearches() == 7);
+
+  // removing the column falls back to the default color
+  cursor.setColumn(nullptr);
+  rv += SDK_ASSERT(cursor.colorAt(35.0) == defaultColor);
+  rv += SDK_ASSERT(cursor.numSearches() == 7);
+  return rv;
+}
+
+int testPartialRecolor()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  const int lastTime = 99;
+  addPlatform(ds, lastTime);
+  ds.update(lastTime);
+
+  osg::ref_ptr<simVis::Locator> locator = new simVis::Locator();
+  simVis::PlatformTspiFilterManager filterManager;
+  osg::ref_ptr<simVis::TrackHistoryNode> track = new simVis::TrackHistoryNode(ds, locator.get(), filterManager, PLATFORM_ID);
+
+  simData::PlatformPrefs prefs;
+  prefs.mutable_trackprefs()->set_trackdrawmode(simData::TrackPrefs_Mode_POINT);
+  prefs.mutable_trackprefs()->set_tracklength(-1);
+  simData::PlatformProperties props;
+  props.set_id(PLATFORM_ID);
+  track->setPrefs(prefs, props, true);
+  track->update();
+  const unsigned int numResets = track->numResets();
+  const unsigned int numUpdateTraversals = track->getNumChildrenRequiringUpdateTraversal();
+
+  // several color commands in one frame are queued without rebuilding
+  addColor(ds, 40.0, RED);
+  addColor(ds, 60.0, GREEN);
+  addColor(ds, 50.0, BLUE);
+  rv += SDK_ASSERT(track->numResets() == numResets);
+  rv += SDK_ASSERT(track->numRecoloredPoints() == 0);
+  rv += SDK_ASSERT(track->getNumChildrenRequiringUpdateTraversal() == numUpdateTraversals + 1);
+
+  // update traversal recolors the points from time 40 through the end in one pass
+  osgUtil::UpdateVisitor uv;
+  track->accept(uv);
+  rv += SDK_ASSERT(track->numResets() == numResets);
+  rv += SDK_ASSERT(track->numRecoloredPoints() == static_cast<unsigned int>(lastTime - 40 + 1));
+  rv += SDK_ASSERT(track->getNumChildrenRequiringUpdateTraversal() == numUpdateTraversals);
+
+  // nothing pending, so another traversal does not recolor
+  track->accept(uv);
+  rv += SDK_ASSERT(track->numRecoloredPoints() == static_cast<unsigned int>(lastTime - 40 + 1));
+
+  // a change at the first point only touches points up to the next color change at time 40
+  addColor(ds, 0.0, BLUE);
+  track->accept(uv);
+  rv += SDK_ASSERT(track->numRecoloredPoints() == static_cast<unsigned int>(lastTime - 40 + 1 + 41));
+  rv += SDK_ASSERT(track->numResets() == numResets);
+  return rv;
+}
+
+}
+
+int TrackHistoryColorTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testColorCursor();
+  rv += testPartialRecolor();
+  return rv;
+}